@@ -0,0 +1,52 @@
+#include "act_allocator.h"
+#include "act_hash.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// The number of bytes hashed for every key size.
+static const size_t BYTES_PER_SIZE = 1 << 28;
+
+/// Returns the current time in seconds.
+static double nowSecs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+  const size_t KEY_SIZES[] = {4,   8,   16,   24,   32,   64,
+                              128, 256, 1024, 4096, 65536};
+  const size_t MAX_KEY_SIZE = 65536;
+
+  uint8_t *buf = (*GPA.alloc)(MAX_KEY_SIZE + 64, sizeof(*buf));
+  if (buf == NULL) {
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < MAX_KEY_SIZE + 64; i++) {
+    buf[i] = (uint8_t)(i * 131 + 17);
+  }
+
+  printf("%10s %12s %12s\n", "key bytes", "GB/s", "ns/hash");
+  for (size_t k = 0; k < sizeof(KEY_SIZES) / sizeof(*KEY_SIZES); k++) {
+    size_t key_size = KEY_SIZES[k];
+    size_t num_hashes = BYTES_PER_SIZE / key_size;
+
+    // Vary the offset and chain the seed, so no hash can be skipped
+    uint64_t seed = ACT_HASH_DEFAULT_SEED;
+    double start = nowSecs();
+    for (size_t i = 0; i < num_hashes; i++) {
+      seed = act_hashBytes(buf + (i & 63), key_size, seed);
+    }
+    double secs = nowSecs() - start;
+
+    printf("%10zu %12.2f %12.2f  (%016llx)\n", key_size,
+           (double)BYTES_PER_SIZE / secs * 1e-9,
+           secs * 1e9 / (double)num_hashes, (unsigned long long)seed);
+  }
+
+  (*GPA.free)(buf);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+#include "act_allocator.h"
+#include "act_iter.h"
+#include "act_vector.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// The number of elements in the benchmarked vector.
+static const size_t NUM_VALUES = 1 << 23;
+
+/// Returns the current time in seconds.
+static double nowSecs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/// Drops the multiples of three.
+static bool notMultipleOf3(const void *element, void *arg) {
+  (void)arg;
+  return *(const uint64_t *)element % 3 != 0;
+}
+
+/// Drops the multiples of five.
+static bool notMultipleOf5(const void *element, void *arg) {
+  (void)arg;
+  return *(const uint64_t *)element % 5 != 0;
+}
+
+/// Scales a value.
+static void scale(const void *element, void *out, void *arg) {
+  (void)arg;
+  *(uint64_t *)out = *(const uint64_t *)element * 2 + 1;
+}
+
+/// Adds a value to the accumulator.
+static void addValue(void *acc, const void *element, void *arg) {
+  (void)arg;
+  *(uint64_t *)acc += *(const uint64_t *)element;
+}
+
+static void printRow(const char *name, double secs, uint64_t check) {
+  printf("%-36s %10.3f %12.1f %8llu\n", name, secs,
+         (double)NUM_VALUES / secs / 1e6,
+         (unsigned long long)(check % 100000000));
+}
+
+/// Runs filter, map, filter and sum, materializing every step in a vector.
+static uint64_t runMaterialized(const uint64_t *values, int *err) {
+  ACT_VEC(uint64_t) kept = ACT_VEC_WCAP(uint64_t, &GPA, 0, err);
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    if (notMultipleOf3(&values[i], NULL)) {
+      ACT_VEC_PUSH(kept, values[i], err);
+    }
+  }
+
+  size_t len = act_vectorLen(kept, err);
+  ACT_VEC(uint64_t) scaled = ACT_VEC_WCAP(uint64_t, &GPA, 0, err);
+  for (size_t i = 0; i < len; i++) {
+    uint64_t value;
+    scale(&kept[i], &value, NULL);
+    ACT_VEC_PUSH(scaled, value, err);
+  }
+
+  ACT_VEC(uint64_t) rest = ACT_VEC_WCAP(uint64_t, &GPA, 0, err);
+  for (size_t i = 0; i < len; i++) {
+    if (notMultipleOf5(&scaled[i], NULL)) {
+      ACT_VEC_PUSH(rest, scaled[i], err);
+    }
+  }
+
+  uint64_t sum = 0;
+  len = act_vectorLen(rest, err);
+  for (size_t i = 0; i < len; i++) {
+    addValue(&sum, &rest[i], NULL);
+  }
+
+  act_vectorFree(rest, err);
+  act_vectorFree(scaled, err);
+  act_vectorFree(kept, err);
+  return sum;
+}
+
+/// Runs the same steps as one act_Iter pipeline.
+static uint64_t runFused(const uint64_t *values, int *err) {
+  act_Iter source = act_iterFromVector(values, err);
+  act_Iter kept = act_iterFilter(&source, notMultipleOf3, NULL, err);
+  act_Iter scaled = act_iterMap(&kept, sizeof(uint64_t), scale, NULL, err);
+  act_Iter rest = act_iterFilter(&scaled, notMultipleOf5, NULL, err);
+
+  uint64_t sum = 0;
+  act_iterReduce(&rest, &sum, addValue, NULL, err);
+  return sum;
+}
+
+int main(void) {
+  int err = ACT_VECTOR_ERROR_SUCCESS;
+  ACT_VEC(uint64_t) values = ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err);
+  uint64_t state = 42;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    ACT_VEC_PUSH(values, state >> 40, &err);
+  }
+
+  char title[64];
+  snprintf(title, sizeof(title), "%zu u64", NUM_VALUES);
+  printf("%-36s %10s %12s %8s\n", title, "secs", "Melems/s", "check");
+
+  double start = nowSecs();
+  uint64_t sum = runMaterialized(values, &err);
+  printRow("filter-map-filter-sum (vectors)", nowSecs() - start, sum);
+
+  start = nowSecs();
+  sum = runFused(values, &err);
+  printRow("filter-map-filter-sum (act_Iter)", nowSecs() - start, sum);
+
+  act_vectorFree(values, &err);
+  if (err != ACT_VECTOR_ERROR_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include "act_allocator.h"
+#include "act_parallel.h"
+#include "act_thread_pool.h"
+#include "act_vector.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// The number of elements in the benchmarked vector.
+static const size_t NUM_VALUES = 1 << 23;
+
+/// Returns the current time in seconds.
+static double nowSecs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/// Keeps the even values.
+static bool isEven(const void *element, void *arg) {
+  (void)arg;
+  return *(const uint64_t *)element % 2 == 0;
+}
+
+/// Adds two values, through a function pointer.
+static void addValues(void *acc, const void *element, void *arg) {
+  (void)arg;
+  *(uint64_t *)acc += *(const uint64_t *)element;
+}
+
+static void printRow(const char *name, size_t threads, double secs,
+                     uint64_t check) {
+  char label[64];
+  if (threads == 0) {
+    snprintf(label, sizeof(label), "%s (serial)", name);
+  } else {
+    snprintf(label, sizeof(label), "%s (%zu threads)", name, threads);
+  }
+  printf("%-36s %10.3f %12.1f %8llu\n", label, secs,
+         (double)NUM_VALUES / secs / 1e6,
+         (unsigned long long)(check % 100000000));
+}
+
+/// Runs every algorithm serially (@em threads zero) or on a pool.
+static void runRows(const uint64_t *values, size_t threads) {
+  int err = ACT_PARALLEL_ERROR_SUCCESS;
+  act_ThreadPool pool = {0};
+  if (threads != 0) {
+    pool = act_threadPoolNew(&GPA, threads, false, &err);
+  }
+
+  double start = nowSecs();
+  uint64_t sum = 0;
+  if (threads == 0) {
+    for (size_t i = 0; i < NUM_VALUES; i++) {
+      sum += values[i];
+    }
+  } else {
+    sum = act_parallelSumU64(&pool, values, &err);
+  }
+  printRow("sum u64", threads, nowSecs() - start, sum);
+
+  start = nowSecs();
+  uint64_t zero = 0;
+  sum = 0;
+  if (threads == 0) {
+    for (size_t i = 0; i < NUM_VALUES; i++) {
+      addValues(&sum, &values[i], NULL);
+    }
+  } else {
+    act_parallelReduce(&pool, values, &zero, &sum, addValues, NULL, &err);
+  }
+  printRow("reduce (function)", threads, nowSecs() - start, sum);
+
+  start = nowSecs();
+  size_t kept = 0;
+  if (threads == 0) {
+    ACT_VEC(uint64_t) evens =
+        ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err);
+    for (size_t i = 0; i < NUM_VALUES; i++) {
+      if (isEven(&values[i], NULL)) {
+        evens[kept++] = values[i];
+      }
+    }
+    act_vectorFree(evens, &err);
+  } else {
+    act_Vector *evens = act_parallelFilter(&pool, values, isEven, NULL, &err);
+    kept = act_vectorLen(evens, &err);
+    act_vectorFree(evens, &err);
+  }
+  printRow("filter evens", threads, nowSecs() - start, kept);
+
+  ACT_VEC(uint64_t) prefixes =
+      ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err);
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    ACT_VEC_PUSH(prefixes, values[i], &err);
+  }
+  start = nowSecs();
+  if (threads == 0) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < NUM_VALUES; i++) {
+      prefix += prefixes[i];
+      prefixes[i] = prefix;
+    }
+  } else {
+    act_parallelInclusiveScanU64(&pool, prefixes, &err);
+  }
+  printRow("inclusive scan u64", threads, nowSecs() - start,
+           prefixes[NUM_VALUES - 1]);
+  act_vectorFree(prefixes, &err);
+
+  if (threads != 0) {
+    act_threadPoolFree(&pool, &err);
+  }
+  if (err != ACT_PARALLEL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+int main(void) {
+  int err = ACT_VECTOR_ERROR_SUCCESS;
+  ACT_VEC(uint64_t) values = ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err);
+  uint64_t state = 42;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    ACT_VEC_PUSH(values, state >> 40, &err);
+  }
+
+  char title[64];
+  snprintf(title, sizeof(title), "%zu u64", NUM_VALUES);
+  printf("%-36s %10s %12s %8s\n", title, "secs", "Melems/s", "check");
+  const size_t THREADS[] = {0, 1, 2, 4, 8};
+  for (size_t t = 0; t < sizeof(THREADS) / sizeof(*THREADS); t++) {
+    runRows(values, THREADS[t]);
+  }
+
+  act_vectorFree(values, &err);
+  return EXIT_SUCCESS;
+}
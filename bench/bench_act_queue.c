@@ -0,0 +1,263 @@
+#include "act_allocator.h"
+#include "act_deque.h"
+#include "act_queue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// The number of elements handed over per row of the throughput table.
+static const size_t NUM_ITEMS = 1 << 22;
+
+/// The number of round trips per row of the latency table.
+static const size_t NUM_ROUND_TRIPS = 1 << 16;
+
+/// The capacity of every queue.
+static const size_t CAPACITY = 1024;
+
+/// Returns the current time in seconds.
+static double nowSecs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/// The handover that queues replace: an #act_Deque behind a mutex.
+typedef struct LockedDeque {
+  pthread_mutex_t lock;
+  act_Deque deque;
+} LockedDeque;
+
+/// The kinds of queue compared.
+typedef enum Kind { KIND_LOCKED, KIND_SPSC, KIND_MPMC } Kind;
+
+/// A queue of any kind.
+typedef struct Queue {
+  Kind kind;
+  LockedDeque locked;
+  act_SpscQueue spsc;
+  act_MpmcQueue mpmc;
+} Queue;
+
+static Queue queueNew(Kind kind) {
+  int err = ACT_QUEUE_ERROR_SUCCESS;
+  Queue queue = {.kind = kind};
+  if (kind == KIND_LOCKED) {
+    pthread_mutex_init(&queue.locked.lock, NULL);
+    queue.locked.deque = ACT_DEQUE_NEW(uint64_t, &GPA, &err);
+    act_dequeReserve(&queue.locked.deque, CAPACITY, &err);
+  } else if (kind == KIND_SPSC) {
+    queue.spsc = act_spscQueueNew(&GPA, sizeof(uint64_t), CAPACITY, &err);
+  } else {
+    queue.mpmc = act_mpmcQueueNew(&GPA, sizeof(uint64_t), CAPACITY, &err);
+  }
+  if (err != ACT_QUEUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+  return queue;
+}
+
+static void queueFree(Queue *queue) {
+  int err = ACT_QUEUE_ERROR_SUCCESS;
+  if (queue->kind == KIND_LOCKED) {
+    pthread_mutex_destroy(&queue->locked.lock);
+    act_dequeFree(&queue->locked.deque, &err);
+  } else if (queue->kind == KIND_SPSC) {
+    act_spscQueueFree(&queue->spsc, &err);
+  } else {
+    act_mpmcQueueFree(&queue->mpmc, &err);
+  }
+}
+
+/// Pushes as many of the elements as fit, returning how many did.
+static size_t queuePush(Queue *queue, const uint64_t *elements,
+                        size_t count) {
+  int err = ACT_QUEUE_ERROR_SUCCESS;
+  if (queue->kind == KIND_SPSC) {
+    return count == 1 ? act_spscQueuePush(&queue->spsc, elements, &err)
+                      : act_spscQueuePushMany(&queue->spsc, elements, count,
+                                              &err);
+  }
+  if (queue->kind == KIND_MPMC) {
+    return count == 1 ? act_mpmcQueuePush(&queue->mpmc, elements, &err)
+                      : act_mpmcQueuePushMany(&queue->mpmc, elements, count,
+                                              &err);
+  }
+
+  pthread_mutex_lock(&queue->locked.lock);
+  size_t room = CAPACITY - act_dequeLen(&queue->locked.deque);
+  size_t pushed = count < room ? count : room;
+  act_dequePushBackMany(&queue->locked.deque, elements, pushed, &err);
+  pthread_mutex_unlock(&queue->locked.lock);
+  return pushed;
+}
+
+/// Pops up to @em max elements, returning how many it did.
+static size_t queuePop(Queue *queue, uint64_t *elements, size_t max) {
+  int err = ACT_QUEUE_ERROR_SUCCESS;
+  if (queue->kind == KIND_SPSC) {
+    return max == 1 ? act_spscQueuePop(&queue->spsc, elements, &err)
+                    : act_spscQueuePopMany(&queue->spsc, elements, max, &err);
+  }
+  if (queue->kind == KIND_MPMC) {
+    return max == 1 ? act_mpmcQueuePop(&queue->mpmc, elements, &err)
+                    : act_mpmcQueuePopMany(&queue->mpmc, elements, max, &err);
+  }
+
+  pthread_mutex_lock(&queue->locked.lock);
+  size_t popped =
+      act_dequePopFrontMany(&queue->locked.deque, elements, max, &err);
+  pthread_mutex_unlock(&queue->locked.lock);
+  return popped;
+}
+
+/// The state shared by the threads of one row.
+typedef struct Run {
+  Queue queue;
+  size_t batch;
+  size_t per_producer;
+  atomic_size_t consumed;
+  atomic_uint_least64_t checksum;
+} Run;
+
+static void *producer(void *arg) {
+  Run *run = arg;
+  uint64_t batch[64];
+  for (size_t next = 0; next < run->per_producer;) {
+    size_t count = run->per_producer - next;
+    count = count < run->batch ? count : run->batch;
+    for (size_t i = 0; i < count; i++) {
+      batch[i] = next + i;
+    }
+    size_t pushed = queuePush(&run->queue, batch, count);
+    if (pushed == 0) {
+      sched_yield();
+    }
+    next += pushed;
+  }
+  return NULL;
+}
+
+static void *consumer(void *arg) {
+  Run *run = arg;
+  uint64_t batch[64];
+  uint64_t checksum = 0;
+  while (atomic_load_explicit(&run->consumed, memory_order_relaxed) <
+         NUM_ITEMS) {
+    size_t popped = queuePop(&run->queue, batch, run->batch);
+    if (popped == 0) {
+      sched_yield();
+      continue;
+    }
+    for (size_t i = 0; i < popped; i++) {
+      checksum += batch[i];
+    }
+    atomic_fetch_add_explicit(&run->consumed, popped, memory_order_relaxed);
+  }
+  atomic_fetch_add(&run->checksum, checksum);
+  return NULL;
+}
+
+/// Hands #NUM_ITEMS elements from @em threads producers to as many
+/// consumers, and prints the throughput.
+static void throughputRow(const char *name, Kind kind, size_t threads,
+                          size_t batch) {
+  Run run = {
+      .queue = queueNew(kind),
+      .batch = batch,
+      .per_producer = NUM_ITEMS / threads,
+  };
+  atomic_init(&run.consumed, 0);
+  atomic_init(&run.checksum, 0);
+
+  pthread_t producers[8];
+  pthread_t consumers[8];
+  double start = nowSecs();
+  for (size_t i = 0; i < threads; i++) {
+    pthread_create(&consumers[i], NULL, consumer, &run);
+    pthread_create(&producers[i], NULL, producer, &run);
+  }
+  for (size_t i = 0; i < threads; i++) {
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], NULL);
+  }
+  double secs = nowSecs() - start;
+
+  char title[64];
+  snprintf(title, sizeof(title), "%s (%zuP/%zuC, batch %zu)", name, threads,
+           threads, batch);
+  printf("%-36s %10.3f %12.2f %8llu\n", title, secs, NUM_ITEMS / secs * 1e-6,
+         (unsigned long long)(atomic_load(&run.checksum) % 1000));
+  queueFree(&run.queue);
+}
+
+/// The queues of a ping-pong between two threads.
+typedef struct PingPong {
+  Queue there;
+  Queue back;
+} PingPong;
+
+static void *ponger(void *arg) {
+  PingPong *ping_pong = arg;
+  uint64_t value = 0;
+  for (size_t i = 0; i < NUM_ROUND_TRIPS; i++) {
+    while (queuePop(&ping_pong->there, &value, 1) == 0) {
+      sched_yield();
+    }
+    while (queuePush(&ping_pong->back, &value, 1) == 0) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+/// Bounces an element between two threads, and prints the time of a round
+/// trip.
+static void latencyRow(const char *name, Kind kind) {
+  PingPong ping_pong = {.there = queueNew(kind), .back = queueNew(kind)};
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, ponger, &ping_pong);
+  double start = nowSecs();
+  uint64_t value = 0;
+  for (size_t i = 0; i < NUM_ROUND_TRIPS; i++) {
+    while (queuePush(&ping_pong.there, &i, 1) == 0) {
+      sched_yield();
+    }
+    while (queuePop(&ping_pong.back, &value, 1) == 0) {
+      sched_yield();
+    }
+  }
+  double secs = nowSecs() - start;
+  pthread_join(thread, NULL);
+
+  printf("%-36s %10.3f %12.1f\n", name, secs, secs / NUM_ROUND_TRIPS * 1e9);
+  queueFree(&ping_pong.there);
+  queueFree(&ping_pong.back);
+}
+
+int main(void) {
+  char title[64];
+  snprintf(title, sizeof(title), "throughput (%zu u64)", NUM_ITEMS);
+  printf("%-36s %10s %12s %8s\n", title, "secs", "Melems/s", "check");
+  throughputRow("act_SpscQueue", KIND_SPSC, 1, 1);
+  throughputRow("act_SpscQueue", KIND_SPSC, 1, 32);
+  const size_t THREADS[] = {1, 2, 4};
+  for (size_t t = 0; t < sizeof(THREADS) / sizeof(*THREADS); t++) {
+    throughputRow("mutex + act_Deque", KIND_LOCKED, THREADS[t], 1);
+    throughputRow("mutex + act_Deque", KIND_LOCKED, THREADS[t], 32);
+    throughputRow("act_MpmcQueue", KIND_MPMC, THREADS[t], 1);
+    throughputRow("act_MpmcQueue", KIND_MPMC, THREADS[t], 32);
+  }
+
+  snprintf(title, sizeof(title), "round trip (%zu)", NUM_ROUND_TRIPS);
+  printf("\n%-36s %10s %12s\n", title, "secs", "ns/trip");
+  latencyRow("mutex + act_Deque", KIND_LOCKED);
+  latencyRow("act_SpscQueue", KIND_SPSC);
+  latencyRow("act_MpmcQueue", KIND_MPMC);
+
+  return EXIT_SUCCESS;
+}
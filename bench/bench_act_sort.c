@@ -0,0 +1,146 @@
+#include "act_allocator.h"
+#include "act_sort.h"
+#include "act_string.h"
+#include "act_vector.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/// The number of elements sorted.
+static const size_t NUM_ELEMS = 1 << 24;
+
+/// Returns the current time in seconds.
+static double nowSecs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int compareView(const void *a, const void *b) {
+  return act_stringViewLexCompare(*(const act_StringView *)a,
+                                  *(const act_StringView *)b);
+}
+
+/// The number of strings sorted.
+static const size_t NUM_STRINGS = 1 << 21;
+
+/// Fills the vector with the same URL-like strings every time.
+static void fillUrls(act_StringView *views, char *storage) {
+  uint64_t state = 1;
+  for (size_t i = 0; i < NUM_STRINGS; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    char *url = storage + i * 64;
+    int len = snprintf(url, 64, "https://example.com/items/%llu/view",
+                       (unsigned long long)(state >> 40));
+    views[i] = (act_StringView){.data = url, .len = (size_t)len};
+  }
+}
+
+/// Fills the vector with the same pseudorandom values every time.
+static void fill(uint64_t *vec) {
+  uint64_t state = 1;
+  for (size_t i = 0; i < NUM_ELEMS; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    vec[i] = state >> 11;
+  }
+}
+
+int main(void) {
+  int err = ACT_VECTOR_ERROR_SUCCESS;
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, NUM_ELEMS, &err);
+  for (size_t i = 0; i < NUM_ELEMS; i++) {
+    ACT_VEC_PUSH(vec, i, &err);
+  }
+  if (err != ACT_VECTOR_ERROR_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+
+  printf("%-28s %10s %12s\n", "sort (u64)", "secs", "Melems/s");
+
+  fill(vec);
+  double start = nowSecs();
+  qsort(vec, NUM_ELEMS, sizeof(*vec), compareU64);
+  double secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "qsort", secs, NUM_ELEMS / secs * 1e-6);
+
+  fill(vec);
+  start = nowSecs();
+  act_vectorSort(vec, compareU64, &err);
+  secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "act_vectorSort", secs,
+         NUM_ELEMS / secs * 1e-6);
+
+  fill(vec);
+  start = nowSecs();
+  act_vectorSortStable(vec, compareU64, &err);
+  secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "act_vectorSortStable", secs,
+         NUM_ELEMS / secs * 1e-6);
+
+  fill(vec);
+  start = nowSecs();
+  act_vectorRadixSortU64(vec, NULL, &err);
+  secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "act_vectorRadixSortU64", secs,
+         NUM_ELEMS / secs * 1e-6);
+
+  const size_t THREADS[] = {1, 2, 4, 8, 16};
+  for (size_t t = 0; t < sizeof(THREADS) / sizeof(*THREADS); t++) {
+    char name[64];
+    snprintf(name, sizeof(name), "act_vectorSortParallel x%zu", THREADS[t]);
+
+    fill(vec);
+    start = nowSecs();
+    act_vectorSortParallel(vec, compareU64, THREADS[t], &err);
+    secs = nowSecs() - start;
+    printf("%-28s %10.3f %12.2f\n", name, secs, NUM_ELEMS / secs * 1e-6);
+  }
+
+  act_vectorFree(vec, &err);
+
+  char *storage = (*GPA.alloc)(NUM_STRINGS, 64);
+  ACT_VEC(act_StringView) views =
+      ACT_VEC_WCAP(act_StringView, &GPA, NUM_STRINGS, &err);
+  for (size_t i = 0; i < NUM_STRINGS; i++) {
+    act_StringView view = {0};
+    ACT_VEC_PUSH(views, view, &err);
+  }
+  if (storage == NULL || err != ACT_VECTOR_ERROR_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+
+  printf("\n%-28s %10s %12s\n", "sort (URLs)", "secs", "Melems/s");
+
+  fillUrls(views, storage);
+  start = nowSecs();
+  qsort(views, NUM_STRINGS, sizeof(*views), compareView);
+  secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "qsort", secs, NUM_STRINGS / secs * 1e-6);
+
+  fillUrls(views, storage);
+  start = nowSecs();
+  act_vectorSortStringViews(views, &err);
+  secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "act_vectorSortStringViews", secs,
+         NUM_STRINGS / secs * 1e-6);
+
+  fillUrls(views, storage);
+  start = nowSecs();
+  act_vectorSortStringViewsParallel(views, 0, &err);
+  secs = nowSecs() - start;
+  printf("%-28s %10.3f %12.2f\n", "act_vectorSortStringViewsPar", secs,
+         NUM_STRINGS / secs * 1e-6);
+
+  act_vectorFree(views, &err);
+  (*GPA.free)(storage);
+
+  return EXIT_SUCCESS;
+}
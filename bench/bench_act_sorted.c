@@ -0,0 +1,190 @@
+#include "act_allocator.h"
+#include "act_sorted.h"
+#include "act_vector.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// The number of searches per table.
+static const size_t NUM_QUERIES = 1 << 22;
+
+/// Returns the current time in seconds.
+static double nowSecs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/// Fills the queries with the same pseudorandom values (below @em max) every
+/// time.
+static void fillQueries(uint64_t *queries, uint64_t max) {
+  uint64_t state = 1;
+  for (size_t i = 0; i < NUM_QUERIES; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    queries[i] = (state >> 11) % max;
+  }
+}
+
+/// Prints one row of the table; the checksum keeps the searches from being
+/// optimized out.
+static void report(const char *name, double secs, uint64_t checksum) {
+  printf("%-36s %10.3f %12.2f %8llu\n", name, secs,
+         NUM_QUERIES / secs * 1e-6, (unsigned long long)(checksum % 1000));
+}
+
+/// The number of times each intersection is repeated.
+static const size_t NUM_ROUNDS = 50;
+
+/// Returns a posting list of @em len document ids, spread over @em universe
+/// ids, the same every time.
+static ACT_VEC(uint32_t)
+    makePostings(size_t len, uint32_t universe, uint64_t seed, int *err) {
+  ACT_VEC(uint32_t) postings = ACT_VEC_WCAP(uint32_t, &GPA, len, err);
+  uint64_t state = seed;
+  uint32_t doc = 0;
+  uint32_t max_gap = (uint32_t)(2 * (universe / len) - 1);
+  for (size_t i = 0; i < len; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    doc += 1 + (uint32_t)((state >> 33) % max_gap);
+    ACT_VEC_PUSH(postings, doc, err);
+  }
+  return postings;
+}
+
+/// The merge that intersections are usually written as.
+static size_t intersectMerge(const uint32_t *a, size_t a_len,
+                             const uint32_t *b, size_t b_len, uint32_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  while (i < a_len && j < b_len) {
+    if (a[i] < b[j]) {
+      i++;
+    } else if (b[j] < a[i]) {
+      j++;
+    } else {
+      out[count++] = a[i];
+      i++;
+      j++;
+    }
+  }
+  return count;
+}
+
+/// Benchmarks intersecting posting lists of the given lengths.
+static void benchIntersect(size_t a_len, size_t b_len) {
+  int err = ACT_VECTOR_ERROR_SUCCESS;
+  const uint32_t universe = 1 << 24;
+  ACT_VEC(uint32_t) a = makePostings(a_len, universe, 1, &err);
+  ACT_VEC(uint32_t) b = makePostings(b_len, universe, 2, &err);
+  ACT_VEC(uint32_t) dst = ACT_VEC_NEW(uint32_t, &GPA, &err);
+  uint32_t *out = (*GPA.alloc)(a_len < b_len ? a_len : b_len, sizeof(*out));
+
+  char title[64];
+  snprintf(title, sizeof(title), "intersect (%zu x %zu u32)", a_len, b_len);
+  printf("%-36s %10s %12s %8s\n", title, "secs", "Melems/s", "found");
+  double elems = (double)(a_len + b_len) * (double)NUM_ROUNDS;
+
+  double start = nowSecs();
+  size_t found = 0;
+  for (size_t r = 0; r < NUM_ROUNDS; r++) {
+    found = intersectMerge(a, a_len, b, b_len, out);
+  }
+  double secs = nowSecs() - start;
+  printf("%-36s %10.3f %12.2f %8zu\n", "merge", secs, elems / secs * 1e-6,
+         found);
+
+  start = nowSecs();
+  for (size_t r = 0; r < NUM_ROUNDS; r++) {
+    dst = act_vectorIntersectU32(dst, a, b, &err);
+  }
+  secs = nowSecs() - start;
+  printf("%-36s %10.3f %12.2f %8zu\n\n", "act_vectorIntersectU32", secs,
+         elems / secs * 1e-6, act_vectorLen(dst, &err));
+
+  (*GPA.free)(out);
+  act_vectorFree(a, &err);
+  act_vectorFree(b, &err);
+  act_vectorFree(dst, &err);
+}
+
+int main(void) {
+  int err = ACT_VECTOR_ERROR_SUCCESS;
+  uint64_t *queries = (*GPA.alloc)(NUM_QUERIES, sizeof(uint64_t));
+  if (queries == NULL) {
+    return EXIT_FAILURE;
+  }
+
+  const size_t LENS[] = {1 << 10, 1 << 16, 1 << 20, 1 << 24};
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    const size_t LEN = LENS[l];
+    ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, LEN, &err);
+    for (size_t i = 0; i < LEN; i++) {
+      uint64_t value = i * 3;
+      ACT_VEC_PUSH(vec, value, &err);
+    }
+    act_EytzingerIndex index = act_eytzingerIndexNew(vec, compareU64, &err);
+    if (err != ACT_SORTED_ERROR_SUCCESS) {
+      return EXIT_FAILURE;
+    }
+    fillQueries(queries, LEN * 3);
+
+    char title[64];
+    snprintf(title, sizeof(title), "lower bound (%zu u64)", LEN);
+    printf("%-36s %10s %12s %8s\n", title, "secs", "Mqueries/s", "check");
+
+    double start = nowSecs();
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; i++) {
+      const uint64_t *found =
+          bsearch(&queries[i], vec, LEN, sizeof(uint64_t), compareU64);
+      checksum += found != NULL ? *found : 0;
+    }
+    report("bsearch (exact matches only)", nowSecs() - start, checksum);
+
+    start = nowSecs();
+    checksum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; i++) {
+      size_t idx = act_vectorLowerBound(vec, &queries[i], compareU64, &err);
+      checksum += idx < LEN ? vec[idx] : 0;
+    }
+    report("act_vectorLowerBound", nowSecs() - start, checksum);
+
+    start = nowSecs();
+    checksum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; i++) {
+      const uint64_t *found =
+          act_eytzingerIndexLowerBound(&index, &queries[i], &err);
+      checksum += found != NULL ? *found : 0;
+    }
+    report("act_eytzingerIndexLowerBound", nowSecs() - start, checksum);
+
+    start = nowSecs();
+    checksum = 0;
+    for (size_t i = 0; i < NUM_QUERIES; i++) {
+      const uint64_t *found =
+          act_eytzingerIndexLowerBoundU64(&index, queries[i], &err);
+      checksum += found != NULL ? *found : 0;
+    }
+    report("act_eytzingerIndexLowerBoundU64", nowSecs() - start, checksum);
+    printf("\n");
+
+    act_eytzingerIndexFree(&index, &err);
+    act_vectorFree(vec, &err);
+  }
+
+  (*GPA.free)(queries);
+
+  benchIntersect(1 << 20, 1 << 20);
+  benchIntersect(1 << 22, 1 << 18);
+  benchIntersect(1 << 22, 1 << 12);
+
+  return EXIT_SUCCESS;
+}
@@ -7,7 +7,23 @@
 /// headers.
 
 #include "core/act_allocator.h"
+#include "core/act_btree.h"
+#include "core/act_concurrent_map.h"
+#include "core/act_deque.h"
+#include "core/act_flat_map.h"
+#include "core/act_hash.h"
+#include "core/act_hash_map.h"
+#include "core/act_heap.h"
+#include "core/act_iter.h"
+#include "core/act_parallel.h"
+#include "core/act_queue.h"
+#include "core/act_rope.h"
+#include "core/act_sort.h"
+#include "core/act_sorted.h"
 #include "core/act_string.h"
+#include "core/act_string_builder.h"
+#include "core/act_string_interner.h"
+#include "core/act_thread_pool.h"
 #include "core/act_utils.h"
 #include "core/act_vector.h"
 #include "interfaces/act_showable.h"
@@ -0,0 +1,295 @@
+#ifndef ACT_BTREE_H
+#define ACT_BTREE_H
+
+#include "act_allocator.h"
+#include "act_sort.h"
+#include "act_utils.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_btree.h
+///
+/// This header defines a B+tree: an ordered map with generic key and value
+/// sizes, where all entries live in the leaves and the leaves are linked in
+/// key order.
+///
+/// Every node is a single allocation of the same size, a whole number of
+/// cache lines, and holds as many keys as fit in it. A lookup touches one node
+/// per level, and binary searches the keys inside it. Insertion and removal
+/// take O(log n) time, and range scans walk the linked leaves in either
+/// direction.
+///
+/// Nodes are made with the tree's #act_Allocator, always one at a time and of
+/// the size returned by #act_btreeNodeSize, so a fixed-size pool allocator
+/// suits them.
+
+/// The size (in bytes) a node of an #act_BTree is made to fit, unless its keys
+/// and values are too large for the minimum fanout.
+#define ACT_BTREE_NODE_SIZE 512
+
+/// The minimum number of keys in a full node of an #act_BTree.
+#define ACT_BTREE_MIN_FANOUT 4
+
+/// @brief A node of the tree (either a leaf or an internal node).
+///
+/// This type is private; its definition is only visible to the B+tree
+/// implementation.
+typedef struct act__BTreeNode act__BTreeNode;
+
+/// @brief **[PRIVATE]** An ordered map stored in a B+tree.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_btreeInsert, #act_btreeGet, #act_btreeRange
+typedef struct act_BTree {
+  /// @cond
+  /// @internal The allocator used to make the nodes.
+  const act_Allocator *_allocator;
+
+  /// @internal The root of the tree (**NULL** until the first insert).
+  act__BTreeNode *_root;
+
+  /// @internal The number of entries.
+  size_t _len;
+
+  /// @internal The size of a key.
+  size_t _key_size;
+
+  /// @internal The size of a value.
+  size_t _value_size;
+
+  /// @internal The comparator that orders the keys.
+  act_SortCompareFn _compare;
+
+  /// @internal The max number of entries in a leaf.
+  size_t _leaf_capacity;
+
+  /// @internal The max number of keys in an internal node.
+  size_t _internal_capacity;
+
+  /// @internal The offset of the values in a leaf.
+  size_t _values_offset;
+
+  /// @internal The offset of the children in an internal node.
+  size_t _children_offset;
+
+  /// @internal The size of a node.
+  size_t _node_size;
+  /// @endcond
+} act_BTree;
+
+/// @brief **[PRIVATE]** An iterator over a range of the entries of an
+/// #act_BTree, in ascending or descending key order.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use #act_btreeIterNext instead.
+///
+/// @sa #act_btreeRange, #act_btreeRangeReverse
+typedef struct act_BTreeIter {
+  /// @cond
+  /// @internal The tree being iterated over.
+  const act_BTree *_tree;
+
+  /// @internal The leaf of the next entry (**NULL** once done).
+  const act__BTreeNode *_leaf;
+
+  /// @internal The index of the next entry in its leaf.
+  size_t _idx;
+
+  /// @internal The key iteration stops at (**NULL** if unbounded).
+  const void *_stop;
+
+  /// @internal Whether the iteration is in descending order.
+  bool _reverse;
+  /// @endcond
+} act_BTreeIter;
+
+/// @brief The possible error values.
+typedef enum act_BTreeError {
+  /// Successful operation.
+  ACT_BTREE_ERROR_SUCCESS = 0x0,
+
+  /// The given tree was **NULL**.
+  ACT_BTREE_ERROR_NULL_TREE,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_BTREE_ERROR_NULL_ALLOCATOR,
+
+  /// The given key or value was **NULL**.
+  ACT_BTREE_ERROR_NULL_KEY,
+
+  /// The given comparator was **NULL**.
+  ACT_BTREE_ERROR_NULL_COMPARATOR,
+
+  /// A failure during allocation.
+  ACT_BTREE_ERROR_ALLOCATION_FAILED,
+
+  /// The key is not in the tree.
+  ACT_BTREE_ERROR_NOT_FOUND,
+
+  /// The key size was zero.
+  ACT_BTREE_ERROR_INVALID_KEY_SIZE,
+} act_BTreeError;
+
+/// @brief Creates a new, empty #act_BTree.
+///
+/// @param[in]  allocator   The allocator used to make the nodes.
+/// @param[in]  key_size    The size of a key.
+/// @param[in]  value_size  The size of a value (may be zero for a set).
+/// @param[in]  compare     The comparator that orders the keys.
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation.
+///
+/// @return A new, empty tree.
+///
+/// @note This function does not allocate any memory until the first insert.
+///
+/// @sa #act_btreeFree, #ACT_BTREE_NEW
+act_BTree act_btreeNew(const act_Allocator *allocator, size_t key_size,
+                       size_t value_size, act_SortCompareFn compare,
+                       int *error_code);
+
+/// @brief Frees all nodes of the #act_BTree.
+///
+/// @param[in]  tree        The tree to free.
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation.
+void act_btreeFree(act_BTree *tree, int *error_code);
+
+/// @brief Returns the number of entries in the #act_BTree.
+///
+/// @param tree The tree to get the length of.
+///
+/// @return The number of entries.
+size_t act_btreeLen(const act_BTree *tree);
+
+/// @brief Returns the size of every node the #act_BTree allocates.
+///
+/// @param tree The tree to get the node size of.
+///
+/// @return The size (in bytes) of a node, a multiple of 64.
+size_t act_btreeNodeSize(const act_BTree *tree);
+
+/// @brief Inserts a key and value into the #act_BTree, overwriting the value
+/// if the key already exists.
+///
+/// @param[in]  tree        The tree to insert into.
+/// @param[in]  key         The key (of the tree's key size) to copy in.
+/// @param[in]  value       The value (of the tree's value size) to copy in.
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation.
+///
+/// @return **true** if the key was new, **false** if its value was replaced
+/// (or the insert failed).
+///
+/// @note This function @em possibly allocates nodes, if the nodes on the path
+/// to the key are full.
+bool act_btreeInsert(act_BTree *tree, const void *key, const void *value,
+                     int *error_code);
+
+/// @brief Looks up the value of a key in the #act_BTree.
+///
+/// @param[in]  tree        The tree to search.
+/// @param[in]  key         The key to look for.
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation; #ACT_BTREE_ERROR_NOT_FOUND if the key
+///                         is not in the tree.
+///
+/// @return A pointer to the value, valid until the tree is next modified, or
+/// **NULL** if the key is not in the tree.
+void *act_btreeGet(const act_BTree *tree, const void *key, int *error_code);
+
+/// @brief Checks if the #act_BTree contains the given key.
+///
+/// @param tree The tree to search.
+/// @param key The key to look for.
+///
+/// @return **true** if the key is in the tree, **false** otherwise.
+bool act_btreeContains(const act_BTree *tree, const void *key);
+
+/// @brief Removes a key (and its value) from the #act_BTree.
+///
+/// @param[in]  tree        The tree to remove from.
+/// @param[in]  key         The key to remove.
+/// @param[out] value       Where to copy the removed value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation; #ACT_BTREE_ERROR_NOT_FOUND if the key
+///                         is not in the tree.
+///
+/// @return **true** if the key was removed, **false** if it was not found.
+///
+/// @note This function frees the nodes that are merged away.
+bool act_btreeRemove(act_BTree *tree, const void *key, void *value,
+                     int *error_code);
+
+/// @brief Creates an iterator over the entries of the #act_BTree with keys in
+/// [@em low, @em high), in ascending order.
+///
+/// The iterator is invalidated by any modification of the tree, and keeps a
+/// pointer to @em high, which must stay valid while it is used.
+///
+/// @param[in]  tree        The tree to iterate over.
+/// @param[in]  low         The lowest key of the range (**NULL** for no lower
+///                         bound).
+/// @param[in]  high        The key after the range (**NULL** for no upper
+///                         bound).
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation.
+///
+/// @return An iterator positioned before the first entry of the range.
+///
+/// @sa #act_btreeIterNext, #act_btreeRangeReverse
+act_BTreeIter act_btreeRange(const act_BTree *tree, const void *low,
+                             const void *high, int *error_code);
+
+/// @brief Creates an iterator over the entries of the #act_BTree with keys in
+/// [@em low, @em high), in descending order.
+///
+/// The iterator is invalidated by any modification of the tree, and keeps a
+/// pointer to @em low, which must stay valid while it is used.
+///
+/// @param[in]  tree        The tree to iterate over.
+/// @param[in]  low         The lowest key of the range (**NULL** for no lower
+///                         bound).
+/// @param[in]  high        The key after the range (**NULL** for no upper
+///                         bound).
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation.
+///
+/// @return An iterator positioned before the last entry of the range.
+///
+/// @sa #act_btreeIterNext, #act_btreeRange
+act_BTreeIter act_btreeRangeReverse(const act_BTree *tree, const void *low,
+                                    const void *high, int *error_code);
+
+/// @brief Advances the iterator to the next entry of its range.
+///
+/// @param[in]  iter  The iterator to advance.
+/// @param[out] key   The key of the next entry; may be **NULL**.
+/// @param[out] value The value of the next entry; may be **NULL**.
+///
+/// @return **true** if an entry was returned, **false** once the range has
+/// been visited.
+bool act_btreeIterNext(act_BTreeIter *iter, const void **key, void **value);
+
+/// @brief Create a new #act_BTree with keys of type @em K and values of type
+/// @em V.
+///
+/// This macro calls #act_btreeNew with the sizes of @em K and @em V.
+///
+/// @param[in]  K           The type of the keys.
+/// @param[in]  V           The type of the values.
+/// @param[in]  compare     The comparator that orders the keys.
+/// @param[in]  allocator   The #act_Allocator used to make the nodes.
+/// @param[out] error_code  The error code (#act_BTreeError) of the
+///                         operation.
+///
+/// @return A new, empty tree.
+///
+/// @sa #act_btreeFree
+#define ACT_BTREE_NEW(K, V, compare, allocator, error_code)                    \
+  act_btreeNew(allocator, sizeof(K), sizeof(V), compare, error_code)
+
+#endif /* !ACT_BTREE_H */
@@ -0,0 +1,320 @@
+#ifndef ACT_QUEUE_H
+#define ACT_QUEUE_H
+
+#include "act_allocator.h"
+#include "act_utils.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_queue.h
+///
+/// This header defines bounded, lock-free queues with generic element sizes,
+/// for handing elements between threads.
+///
+/// An #act_SpscQueue has a single producer and a single consumer. It is a ring
+/// buffer where each side owns one index and only reads the other's, so every
+/// operation is wait-free; each side also caches the other's index, and only
+/// reloads it when the ring looks full (or empty).
+///
+/// An #act_MpmcQueue has any number of producers and consumers. It is
+/// Vyukov's bounded queue: every slot has a sequence number that says whether
+/// it is ready to be written or read in the current lap of the ring, so
+/// threads claim slots with a single compare-and-swap of a shared index.
+///
+/// In both queues the indices written by different threads are kept on
+/// separate cache lines, and the batch functions claim (or publish) a whole
+/// run of slots at once.
+
+/// @brief The indices of a queue, on separate cache lines.
+///
+/// This type is private; its definition is only visible to the queue
+/// implementation.
+typedef struct act__QueueIndices act__QueueIndices;
+
+/// @brief **[PRIVATE]** A bounded, wait-free, single-producer
+/// single-consumer queue.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_spscQueuePush, #act_spscQueuePop
+typedef struct act_SpscQueue {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The indices of the producer and the consumer.
+  act__QueueIndices *_indices;
+
+  /// @internal The ring of elements.
+  char *_buffer;
+
+  /// @internal The number of slots minus one (the number is a power of two).
+  size_t _mask;
+
+  /// @internal The size of an element.
+  size_t _data_size;
+  /// @endcond
+} act_SpscQueue;
+
+/// @brief **[PRIVATE]** A bounded, lock-free, multi-producer multi-consumer
+/// queue.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_mpmcQueuePush, #act_mpmcQueuePop
+typedef struct act_MpmcQueue {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The indices of the producers and the consumers.
+  act__QueueIndices *_indices;
+
+  /// @internal The ring of slots, each a sequence number and an element.
+  char *_slots;
+
+  /// @internal The number of slots minus one (the number is a power of two).
+  size_t _mask;
+
+  /// @internal The size of an element.
+  size_t _data_size;
+
+  /// @internal The distance between slots.
+  size_t _stride;
+  /// @endcond
+} act_MpmcQueue;
+
+/// @brief The possible error values.
+typedef enum act_QueueError {
+  /// Successful operation.
+  ACT_QUEUE_ERROR_SUCCESS = 0x0,
+
+  /// The given queue was **NULL**.
+  ACT_QUEUE_ERROR_NULL_QUEUE,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_QUEUE_ERROR_NULL_ALLOCATOR,
+
+  /// The given element (or output) was **NULL**.
+  ACT_QUEUE_ERROR_NULL_ELEMENT,
+
+  /// A failure during allocation.
+  ACT_QUEUE_ERROR_ALLOCATION_FAILED,
+
+  /// The data size was zero.
+  ACT_QUEUE_ERROR_INVALID_DATA_SIZE,
+
+  /// The capacity was zero, or too large.
+  ACT_QUEUE_ERROR_INVALID_CAPACITY,
+
+  /// The queue was full.
+  ACT_QUEUE_ERROR_FULL,
+
+  /// The queue was empty.
+  ACT_QUEUE_ERROR_EMPTY,
+} act_QueueError;
+
+/// @brief Creates a new, empty #act_SpscQueue.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  data_size   The size of an element.
+/// @param[in]  capacity    The number of elements the queue holds (rounded up
+///                         to a power of two).
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation.
+///
+/// @return A new, empty queue.
+///
+/// @note This function allocates the ring and the indices.
+///
+/// @sa #act_spscQueueFree
+act_SpscQueue act_spscQueueNew(const act_Allocator *allocator,
+                               size_t data_size, size_t capacity,
+                               int *error_code);
+
+/// @brief Frees all memory allocated by the #act_SpscQueue.
+///
+/// No other thread may be using the queue.
+///
+/// @param[in]  queue       The queue to free.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation.
+void act_spscQueueFree(act_SpscQueue *queue, int *error_code);
+
+/// @brief Returns the number of elements the #act_SpscQueue holds.
+///
+/// @param queue The queue to get the capacity of.
+///
+/// @return The capacity (a power of two).
+size_t act_spscQueueCapacity(const act_SpscQueue *queue);
+
+/// @brief Returns the number of elements in the #act_SpscQueue.
+///
+/// The result is only a snapshot if other threads are using the queue.
+///
+/// @param queue The queue to get the length of.
+///
+/// @return The number of elements.
+size_t act_spscQueueLen(const act_SpscQueue *queue);
+
+/// @brief Copies an element onto the back of the #act_SpscQueue; only called
+/// by the producer.
+///
+/// @param[in]  queue       The queue to push to.
+/// @param[in]  element     The element (of the queue's data size) to copy in.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_FULL if the queue was
+///                         full.
+///
+/// @return **true** if the element was pushed, **false** otherwise.
+bool act_spscQueuePush(act_SpscQueue *queue, const void *element,
+                       int *error_code);
+
+/// @brief Removes the element at the front of the #act_SpscQueue; only called
+/// by the consumer.
+///
+/// @param[in]  queue       The queue to pop from.
+/// @param[out] element     Where to copy the element.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_EMPTY if the queue was
+///                         empty.
+///
+/// @return **true** if an element was popped, **false** otherwise.
+bool act_spscQueuePop(act_SpscQueue *queue, void *element, int *error_code);
+
+/// @brief Copies as many of @em count elements as fit onto the back of the
+/// #act_SpscQueue, in order; only called by the producer.
+///
+/// @param[in]  queue       The queue to push to.
+/// @param[in]  elements    The elements to copy in.
+/// @param[in]  count       The number of elements.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_FULL if not all of the
+///                         elements fit.
+///
+/// @return The number of elements pushed.
+size_t act_spscQueuePushMany(act_SpscQueue *queue, const void *elements,
+                             size_t count, int *error_code);
+
+/// @brief Removes up to @em max elements from the front of the
+/// #act_SpscQueue, copying them out in order; only called by the consumer.
+///
+/// @param[in]  queue       The queue to pop from.
+/// @param[out] elements    Where to copy the elements.
+/// @param[in]  max         The max number of elements to pop.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_EMPTY if the queue was
+///                         empty.
+///
+/// @return The number of elements popped.
+size_t act_spscQueuePopMany(act_SpscQueue *queue, void *elements, size_t max,
+                            int *error_code);
+
+/// @brief Creates a new, empty #act_MpmcQueue.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  data_size   The size of an element.
+/// @param[in]  capacity    The number of elements the queue holds (rounded up
+///                         to a power of two, of at least two).
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation.
+///
+/// @return A new, empty queue.
+///
+/// @note This function allocates the ring and the indices.
+///
+/// @sa #act_mpmcQueueFree
+act_MpmcQueue act_mpmcQueueNew(const act_Allocator *allocator,
+                               size_t data_size, size_t capacity,
+                               int *error_code);
+
+/// @brief Frees all memory allocated by the #act_MpmcQueue.
+///
+/// No other thread may be using the queue.
+///
+/// @param[in]  queue       The queue to free.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation.
+void act_mpmcQueueFree(act_MpmcQueue *queue, int *error_code);
+
+/// @brief Returns the number of elements the #act_MpmcQueue holds.
+///
+/// @param queue The queue to get the capacity of.
+///
+/// @return The capacity (a power of two).
+size_t act_mpmcQueueCapacity(const act_MpmcQueue *queue);
+
+/// @brief Returns the number of elements in the #act_MpmcQueue.
+///
+/// The result is only a snapshot if other threads are using the queue, and
+/// counts the elements that are being pushed or popped.
+///
+/// @param queue The queue to get the length of.
+///
+/// @return The number of elements.
+size_t act_mpmcQueueLen(const act_MpmcQueue *queue);
+
+/// @brief Copies an element onto the back of the #act_MpmcQueue.
+///
+/// @param[in]  queue       The queue to push to.
+/// @param[in]  element     The element (of the queue's data size) to copy in.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_FULL if the queue was
+///                         full.
+///
+/// @return **true** if the element was pushed, **false** otherwise.
+bool act_mpmcQueuePush(act_MpmcQueue *queue, const void *element,
+                       int *error_code);
+
+/// @brief Removes the element at the front of the #act_MpmcQueue.
+///
+/// @param[in]  queue       The queue to pop from.
+/// @param[out] element     Where to copy the element.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_EMPTY if the queue was
+///                         empty.
+///
+/// @return **true** if an element was popped, **false** otherwise.
+bool act_mpmcQueuePop(act_MpmcQueue *queue, void *element, int *error_code);
+
+/// @brief Copies as many of @em count elements as fit onto the back of the
+/// #act_MpmcQueue.
+///
+/// The elements are claimed as one run of slots, so they stay in order and
+/// are not interleaved with the elements of other producers.
+///
+/// @param[in]  queue       The queue to push to.
+/// @param[in]  elements    The elements to copy in.
+/// @param[in]  count       The number of elements.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_FULL if not all of the
+///                         elements fit.
+///
+/// @return The number of elements pushed.
+size_t act_mpmcQueuePushMany(act_MpmcQueue *queue, const void *elements,
+                             size_t count, int *error_code);
+
+/// @brief Removes up to @em max elements from the front of the
+/// #act_MpmcQueue, copying them out in order.
+///
+/// The elements are claimed as one run of slots, of the elements whose
+/// pushes have finished.
+///
+/// @param[in]  queue       The queue to pop from.
+/// @param[out] elements    Where to copy the elements.
+/// @param[in]  max         The max number of elements to pop.
+/// @param[out] error_code  The error code (#act_QueueError) of the
+///                         operation; #ACT_QUEUE_ERROR_EMPTY if the queue was
+///                         empty.
+///
+/// @return The number of elements popped.
+size_t act_mpmcQueuePopMany(act_MpmcQueue *queue, void *elements, size_t max,
+                            int *error_code);
+
+#endif /* !ACT_QUEUE_H */
@@ -0,0 +1,327 @@
+#ifndef ACT_SORT_H
+#define ACT_SORT_H
+
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_sort.h
+///
+/// This header defines functions that sort the elements of an #act_Vector.
+///
+/// #act_vectorSort is a pattern-defeating quicksort: a quicksort that detects
+/// already sorted runs and many equal elements, and falls back to heapsort if
+/// too many of its partitions are unbalanced, so it's O(n log n) in the worst
+/// case. #act_vectorSortStable is a merge sort that keeps equal elements in
+/// their original order.
+///
+/// The parallel variants sort one chunk of the vector per thread, then merge
+/// the chunks pairwise; every merge is split evenly across all threads, so the
+/// last merges don't leave threads idle.
+///
+/// Elements are moved with fixed-size copies when their size is 4, 8 or 16
+/// bytes.
+///
+/// Vectors of fixed-width keys can instead be radix sorted, which needs no
+/// comparator: one pass builds a histogram of every byte of the keys, then one
+/// pass per byte (skipping bytes that are the same in every key) scatters the
+/// elements into a scratch buffer, least significant byte first.
+///
+/// Vectors of strings are sorted with multikey quicksort, which partitions on
+/// a few bytes of each string at a time, cached next to it, and so never
+/// compares the prefix that a group of strings is known to share again.
+
+/// @brief The comparator used to order the elements of a sorted #act_Vector.
+///
+/// @param a The first element.
+/// @param b The second element.
+///
+/// @return A negative value if @em a should come before @em b, a positive
+/// value if it should come after, and zero if they are equivalent.
+typedef int (*act_SortCompareFn)(const void *a, const void *b);
+
+/// @brief Extracts the key that an element of a radix sorted #act_Vector is
+/// ordered by.
+///
+/// @param element The element.
+///
+/// @return The key; elements are sorted by unsigned key.
+typedef uint64_t (*act_SortKeyFn)(const void *element);
+
+/// @brief The possible error values.
+typedef enum act_SortError {
+  /// Successful operation.
+  ACT_SORT_ERROR_SUCCESS = 0x0,
+
+  /// The given vector was **NULL**.
+  ACT_SORT_ERROR_NULL_VECTOR,
+
+  /// The given comparator was **NULL**.
+  ACT_SORT_ERROR_NULL_COMPARATOR,
+
+  /// A failure during allocation.
+  ACT_SORT_ERROR_ALLOCATION_FAILED,
+
+  /// The vector's data size doesn't match the type being sorted.
+  ACT_SORT_ERROR_INVALID_DATA_SIZE,
+
+  /// The given key function was **NULL**.
+  ACT_SORT_ERROR_NULL_KEY_FN,
+
+  /// The given index was past the end of the vector.
+  ACT_SORT_ERROR_INDEX_OUT_OF_BOUNDS,
+} act_SortError;
+
+/// @brief Sorts the elements of the #act_Vector in place, in O(n log n).
+///
+/// The order of equivalent elements is unspecified.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function only allocates memory for elements larger than 64
+/// bytes (space for one element).
+///
+/// @sa #act_vectorSortStable, #act_vectorSortParallel
+void act_vectorSort(act_Vector *vec, act_SortCompareFn compare,
+                    int *error_code);
+
+/// @brief Sorts the elements of the #act_Vector in place, keeping equivalent
+/// elements in their original order.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates a buffer as large as the vector's elements.
+///
+/// @sa #act_vectorSort, #act_vectorSortStableParallel
+void act_vectorSortStable(act_Vector *vec, act_SortCompareFn compare,
+                          int *error_code);
+
+/// @brief Sorts the elements of the #act_Vector in place, on many threads.
+///
+/// The order of equivalent elements is unspecified. Small vectors are sorted
+/// on the calling thread.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[in]  compare     The comparator that orders the elements; it is
+///                         called from many threads at once.
+/// @param[in]  num_threads The number of threads to sort with (including the
+///                         calling thread), or zero to use one per online CPU.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates a buffer as large as the vector's elements.
+///
+/// @sa #act_vectorSort
+void act_vectorSortParallel(act_Vector *vec, act_SortCompareFn compare,
+                            size_t num_threads, int *error_code);
+
+/// @brief Sorts the elements of the #act_Vector in place, on many threads,
+/// keeping equivalent elements in their original order.
+///
+/// Small vectors are sorted on the calling thread.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[in]  compare     The comparator that orders the elements; it is
+///                         called from many threads at once.
+/// @param[in]  num_threads The number of threads to sort with (including the
+///                         calling thread), or zero to use one per online CPU.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates a buffer as large as the vector's elements.
+///
+/// @sa #act_vectorSortStable
+void act_vectorSortStableParallel(act_Vector *vec, act_SortCompareFn compare,
+                                  size_t num_threads, int *error_code);
+
+/// @brief Partially sorts the #act_Vector so that the element at @em nth is
+/// the one that would be there if it were sorted, in O(n) on average.
+///
+/// No element before @em nth comes after it, and no element after it comes
+/// before it; the order within either side is unspecified. Like
+/// #act_vectorSort, this falls back to heapsort (so it's O(n log n) in the
+/// worst case).
+///
+/// @param[in]  vec         The vector to partially sort.
+/// @param[in]  nth         The index of the element to put in place.
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function only allocates memory for elements larger than 64
+/// bytes (space for one element).
+///
+/// @sa #act_vectorPartialSort
+void act_vectorNthElement(act_Vector *vec, size_t nth,
+                          act_SortCompareFn compare, int *error_code);
+
+/// @brief Sorts the first @em k elements of the #act_Vector: afterwards they
+/// are its @em k smallest elements, in order, in O(n + k log k).
+///
+/// The order of the remaining elements is unspecified.
+///
+/// @param[in]  vec         The vector to partially sort.
+/// @param[in]  k           The number of elements to sort (clamped to the
+///                         vector's length).
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function only allocates memory for elements larger than 64
+/// bytes (space for one element).
+///
+/// @sa #act_vectorNthElement, #act_TopK
+void act_vectorPartialSort(act_Vector *vec, size_t k,
+                           act_SortCompareFn compare, int *error_code);
+
+/// @brief Radix sorts an #act_Vector of **uint32_t**.
+///
+/// @param[in]  vec               The vector to sort.
+/// @param[in]  scratch_allocator The allocator for the scratch buffer, or
+///                               **NULL** to use the vector's allocator.
+/// @param[out] error_code        The error code (#act_SortError) of the
+///                               operation.
+///
+/// @note This function allocates a scratch buffer as large as the vector's
+/// elements.
+void act_vectorRadixSortU32(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code);
+
+/// @brief Radix sorts an #act_Vector of **uint64_t**.
+///
+/// @param[in]  vec               The vector to sort.
+/// @param[in]  scratch_allocator The allocator for the scratch buffer, or
+///                               **NULL** to use the vector's allocator.
+/// @param[out] error_code        The error code (#act_SortError) of the
+///                               operation.
+///
+/// @note This function allocates a scratch buffer as large as the vector's
+/// elements.
+void act_vectorRadixSortU64(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code);
+
+/// @brief Radix sorts an #act_Vector of **int64_t**.
+///
+/// @param[in]  vec               The vector to sort.
+/// @param[in]  scratch_allocator The allocator for the scratch buffer, or
+///                               **NULL** to use the vector's allocator.
+/// @param[out] error_code        The error code (#act_SortError) of the
+///                               operation.
+///
+/// @note This function allocates a scratch buffer as large as the vector's
+/// elements.
+void act_vectorRadixSortI64(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code);
+
+/// @brief Radix sorts an #act_Vector of **double**.
+///
+/// Values are in IEEE 754 total order: -0.0 comes before 0.0, NaNs with the
+/// sign bit set come first, and other NaNs come last.
+///
+/// @param[in]  vec               The vector to sort.
+/// @param[in]  scratch_allocator The allocator for the scratch buffer, or
+///                               **NULL** to use the vector's allocator.
+/// @param[out] error_code        The error code (#act_SortError) of the
+///                               operation.
+///
+/// @note This function allocates a scratch buffer as large as the vector's
+/// elements.
+void act_vectorRadixSortF64(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code);
+
+/// @brief Radix sorts an #act_Vector of any element type by an extracted
+/// key, keeping elements with equal keys in their original order.
+///
+/// The key function is called exactly once per element.
+///
+/// @param[in]  vec               The vector to sort.
+/// @param[in]  key               The function that extracts the key of an
+///                               element.
+/// @param[in]  scratch_allocator The allocator for the scratch buffers, or
+///                               **NULL** to use the vector's allocator.
+/// @param[out] error_code        The error code (#act_SortError) of the
+///                               operation.
+///
+/// @note This function allocates scratch buffers for two (key, index) pairs
+/// per element, and a copy of the vector's elements.
+void act_vectorRadixSortByKey(act_Vector *vec, act_SortKeyFn key,
+                              const act_Allocator *scratch_allocator,
+                              int *error_code);
+
+/// @brief Sorts an #act_Vector of #act_String in lexicographic order.
+///
+/// The order is that of #act_stringLexCompare; the order of equal strings is
+/// unspecified.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates 32 bytes per string, and a scratch buffer of
+/// the larger of 32 bytes and the element size per string.
+///
+/// @sa #act_vectorSortStringViews
+void act_vectorSortStrings(act_Vector *vec, int *error_code);
+
+/// @brief Sorts an #act_Vector of #act_StringView in lexicographic order.
+///
+/// The order is that of #act_stringViewLexCompare; the order of equal views
+/// is unspecified.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates 32 bytes per view, and a scratch buffer of
+/// the larger of 32 bytes and the element size per view.
+///
+/// @sa #act_vectorSortStrings
+void act_vectorSortStringViews(act_Vector *vec, int *error_code);
+
+/// @brief Sorts an #act_Vector of #act_String in lexicographic order, on many
+/// threads.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[in]  num_threads The number of threads to sort with (including the
+///                         calling thread), or zero to use one per online CPU.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates 32 bytes per string, and a scratch buffer of
+/// the larger of 32 bytes and the element size per string.
+///
+/// @sa #act_vectorSortStrings
+void act_vectorSortStringsParallel(act_Vector *vec, size_t num_threads,
+                                   int *error_code);
+
+/// @brief Sorts an #act_Vector of #act_StringView in lexicographic order, on
+/// many threads.
+///
+/// @param[in]  vec         The vector to sort.
+/// @param[in]  num_threads The number of threads to sort with (including the
+///                         calling thread), or zero to use one per online CPU.
+/// @param[out] error_code  The error code (#act_SortError) of the
+///                         operation.
+///
+/// @note This function allocates 32 bytes per view, and a scratch buffer of
+/// the larger of 32 bytes and the element size per view.
+///
+/// @sa #act_vectorSortStringViews
+void act_vectorSortStringViewsParallel(act_Vector *vec, size_t num_threads,
+                                       int *error_code);
+
+#endif /* !ACT_SORT_H */
@@ -9,15 +9,42 @@
 /// TODO: DOCUMENT ALL ALLOCATING/RESIZING FUNCTIONS!!
 /// TODO: DOCUMENT ALL FUNCTIONS THAT RETURN NULLSTR!!
 /// TODO: Add `shrink_to_fit` function
-/// TODO: Add `insert_at_index` function
-/// TODO: Add `delete_from_index` function
 
 #include "act_allocator.h"
+#include "act_hash.h"
 #include "act_utils.h"
+#include "act_vector.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/// @brief **[PRIVATE]** Bookkeeping attached to an #act_String's buffer.
+///
+/// It is allocated the first time a string is shared (#act_stringShare) or
+/// edited in the middle (#act_stringInsertCstrAtIdx,
+/// #act_stringDeleteFromIdx), and lives as long as the buffer.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly.
+typedef struct act__StringMeta {
+  /// @cond
+  /// @internal The number of strings sharing the buffer.
+  _Atomic size_t refcount;
+
+  /// @internal Whether copies share the buffer instead of cloning it.
+  bool shared;
+
+  /// @internal The index of the gap in the buffer.
+  size_t gap_start;
+
+  /// @internal The size of the gap (zero when the buffer is contiguous).
+  size_t gap_len;
+  /// @endcond
+} act__StringMeta;
+
 /// @brief **[PRIVATE]** Represents the a heap allocated string.
 ///
 /// @param allocator  An allocator for making internal allocations
@@ -25,6 +52,9 @@
 /// @param len        The length of the allocated string.
 /// @param capacity   The total number of bytes allocated for the string.
 /// @param data       The actual C-string being stored.
+/// @param meta       The reference count and gap of @a data, or **NULL**
+///                   if the buffer is neither shared nor being edited.
+/// @param hash       The cached hash of the string (see #act_stringHash).
 ///
 /// @note All parameters of this struct are **private** and should not be
 /// accessed directly; use the associated functions to access them instead.
@@ -43,9 +73,35 @@ typedef struct act_String {
 
   /// @internal The actual string.
   char *_data;
+
+  /// @internal The bookkeeping of `_data` (**NULL** if not needed).
+  act__StringMeta *_meta;
+
+  /// @internal The cached hash of the string.
+  uint64_t _hash;
+
+  /// @internal Whether `_hash` is up to date.
+  bool _has_hash;
   /// @endcond
 } act_String;
 
+/// @brief A borrowed, non-owning view into a sequence of characters.
+///
+/// A view does not own its data and is never freed; it is only valid as long
+/// as the memory it points to is alive and unmodified.
+///
+/// @note The data pointed to by a view is @em not necessarily
+/// null-terminated.
+///
+/// @sa #act_stringAsView, #act_stringViewFromCstr
+typedef struct act_StringView {
+  /// The first character of the view.
+  const char *data;
+
+  /// The number of characters in the view.
+  size_t len;
+} act_StringView;
+
 /// @brief The possible error values.
 typedef enum act_StringError {
   /// Successful operation.
@@ -77,8 +133,36 @@ typedef enum act_StringError {
 
   /// The index was out of bounds.
   ACT_STRING_ERROR_INDEX_OUT_OF_BOUNDS,
+
+  /// The given vector (#act_Vector) was **NULL**.
+  ACT_STRING_ERROR_NULL_VECTOR,
+
+  /// The string was not valid UTF-8.
+  ACT_STRING_ERROR_INVALID_UTF8,
 } act_StringError;
 
+/// The codepoint (U+FFFD) yielded in place of invalid UTF-8 sequences.
+#define ACT_STRING_REPLACEMENT_CHAR 0xFFFD
+
+/// @brief **[PRIVATE]** An iterator over the UTF-8 codepoints of a string.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use #act_stringCodepointIterNext instead.
+///
+/// @sa #act_stringCodepointIter, #act_stringViewCodepointIter
+typedef struct act_StringCodepointIter {
+  /// @cond
+  /// @internal The bytes being decoded.
+  const char *_data;
+
+  /// @internal The number of bytes being decoded.
+  size_t _len;
+
+  /// @internal The index of the next byte to decode.
+  size_t _pos;
+  /// @endcond
+} act_StringCodepointIter;
+
 /// @brief Possible return values from #act_stringCompare.
 typedef enum act_StringComparison {
   /// The strings are equal.
@@ -143,8 +227,27 @@ act_String act_stringWithCapacity(const act_Allocator *allocator,
 act_String act_stringFromCstr(const act_Allocator *allocator, const char *cstr,
                               int *error_code);
 
+/// @brief Creates a new #act_String from the given #act_StringView.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  view        The characters to copy into the #act_String.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @return A heap allocated string.
+///
+/// @note This function allocates ```view.len + 1``` bytes.
+///
+/// @sa #act_stringFree, #act_stringFromCstr
+act_String act_stringFromView(const act_Allocator *allocator,
+                              act_StringView view, int *error_code);
+
 /// @brief Frees all memory allocated by the #act_String.
 ///
+/// If the buffer is shared (see #act_stringShare), only this reference is
+/// released; the buffer is freed once its last reference is released.
+///
 /// @param[in]  string      The string to free.
 /// @param[out] error_code  The error code (#act_StringError) of the
 ///                         operation.
@@ -166,11 +269,29 @@ size_t act_stringCapacity(act_String string);
 
 /// @brief Returns the underlying string stored in the #act_String.
 ///
+/// If the string has been edited in the middle, its gap is moved to the end
+/// first, so that the contents are contiguous and null-terminated.
+///
 /// @param string The string to get the C-string from.
 ///
 /// @return A C-string (null-terminated @em const @em char).
 const char *act_stringAsCstr(act_String string);
 
+/// @brief Returns a view (#act_StringView) over the contents of the
+/// #act_String.
+///
+/// @param string The string to view.
+///
+/// @return A view of @a string, valid until @a string is modified or freed.
+act_StringView act_stringAsView(act_String string);
+
+/// @brief Returns a view (#act_StringView) over the given C-string.
+///
+/// @param cstr The null-terminated C-string to view.
+///
+/// @return A view of @a cstr (not including the null terminator).
+act_StringView act_stringViewFromCstr(const char *cstr);
+
 /// @brief Shrinks the capacity to fit the length of the #act_String (plus one
 /// for null terminator).
 ///
@@ -225,6 +346,74 @@ void act_stringPushCstr(act_String *string, const char *cstr, int *error_code);
 /// @sa #act_stringPushChar
 char act_stringPopChar(act_String *string, int *error_code);
 
+/// @brief Inserts a C-string into the #act_String at the given index.
+///
+/// The string switches to a gap-buffer layout: the free space sits at the
+/// last edit point and moves with it, so clustered edits (e.g. typing at a
+/// cursor) cost amortized O(1) instead of shifting the rest of the string.
+/// The gap is moved out of the way lazily, when the contents are next read
+/// as a whole (e.g. #act_stringAsCstr).
+///
+/// @warning Reading an edited string writes to its buffer to close the gap,
+/// so it must not be read from several threads at once until it has been
+/// compacted (#act_stringCompact). Shared strings (#act_stringShare) never
+/// hold a gap.
+///
+/// @param[in]  string      The string to insert into.
+/// @param[in]  idx         The index to insert at (at most the length).
+/// @param[in]  cstr        The C-string to insert.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the gap is too small.
+///
+/// @sa #act_stringDeleteFromIdx
+void act_stringInsertCstrAtIdx(act_String *string, size_t idx,
+                               const char *cstr, int *error_code);
+
+/// @brief Inserts a character into the #act_String at the given index.
+///
+/// @param[in]  string      The string to insert into.
+/// @param[in]  idx         The index to insert at (at most the length).
+/// @param[in]  c           The character to insert.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the gap is too small.
+///
+/// @sa #act_stringInsertCstrAtIdx
+void act_stringInsertCharAtIdx(act_String *string, size_t idx, char c,
+                               int *error_code);
+
+/// @brief Deletes characters from the #act_String, starting at the given
+/// index.
+///
+/// The deleted characters are absorbed into the gap, so deleting next to the
+/// previous edit point costs O(1).
+///
+/// @param[in]  string      The string to delete from.
+/// @param[in]  idx         The index of the first character to delete.
+/// @param[in]  len         The number of characters to delete.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @sa #act_stringInsertCstrAtIdx
+void act_stringDeleteFromIdx(act_String *string, size_t idx, size_t len,
+                             int *error_code);
+
+/// @brief Closes the gap left in the #act_String by mid-string edits, so that
+/// its contents are contiguous and reading it never writes to its buffer.
+///
+/// Call this once editing is done and before the string is read from several
+/// threads.
+///
+/// @param[in]  string      The string to compact.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @sa #act_stringInsertCstrAtIdx, #act_stringDeleteFromIdx
+void act_stringCompact(act_String *string, int *error_code);
+
 /// @brief Finds the index where the given character first occurs in the
 /// #act_String.
 ///
@@ -266,20 +455,52 @@ act_String *act_stringSplitAtIdx(act_String string, size_t idx,
 act_StringComparison act_stringCompare(act_String str1, act_String str2,
                                        int *error_code);
 
-/// @brief Deep copy the given string.
+/// @brief Copy the given string.
 ///
-/// @param[in]  string      The string to create a deep copy of.
+/// Unshared strings are deep copied. Strings in shared-buffer mode (see
+/// #act_stringShare) are copied in O(1) by bumping the reference count of
+/// the shared buffer.
+///
+/// @param[in]  string      The string to copy.
 /// @param[out] error_code  The error code (#act_StringError) of the
 ///                         operation.
 ///
-/// @return A deep-copied version of the input string.
+/// @return A copy of the input string.
 ///
 /// @note This function allocates as much space as the length of the input
-/// string.
+/// string, unless the string is shared.
 ///
-/// @sa #act_stringFree
+/// @sa #act_stringFree, #act_stringShare
 act_String act_stringCopy(const act_String *string, int *error_code);
 
+/// @brief Switches the #act_String to shared-buffer mode, and returns a copy
+/// that shares its buffer.
+///
+/// Shared copies are made in O(1) by bumping an atomic reference count.
+/// Mutating a string whose buffer is shared (#act_stringPushChar,
+/// #act_stringPushCstr, #act_stringPopChar, ...) first clones the buffer, so
+/// the other references never observe the change. Each copy must be freed
+/// with #act_stringFree.
+///
+/// @param[in]  string      The string to share.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @return A copy of @a string that shares its buffer.
+///
+/// @note This function allocates the reference count the first time the
+/// string is shared.
+///
+/// @sa #act_stringFree, #act_stringRefCount
+act_String act_stringShare(act_String *string, int *error_code);
+
+/// @brief Returns the number of strings sharing the #act_String's buffer.
+///
+/// @param string The string to get the reference count of.
+///
+/// @return The reference count (1 if the buffer is not shared).
+size_t act_stringRefCount(act_String string);
+
 /// @brief Concatenate the two strings into a new one.
 ///
 /// This function does not modify the input parameters.
@@ -297,4 +518,317 @@ act_String act_stringCopy(const act_String *string, int *error_code);
 /// @sa #act_stringFree
 act_String act_stringConcat(const act_String *str1, const act_String *str2,
                             int *error_code);
+
+/// @brief Joins a vector of #act_String into a new string, placing the
+/// separator between consecutive strings.
+///
+/// The total length is computed up front, so the result is allocated exactly
+/// once.
+///
+/// @param[in]  strings     The vector (#act_Vector) of strings to join.
+/// @param[in]  separator   The C-string placed between the strings.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @return The joined string, allocated with the vector's allocator.
+///
+/// @note This function allocates as much space as the length of the joined
+/// string (plus one for the null terminator).
+///
+/// @sa #act_stringFree, #act_stringSplitAll
+act_String act_stringJoin(const ACT_VEC(act_String) strings,
+                          const char *separator, int *error_code);
+
+/// @brief Splits the given #act_StringView at every occurrence of the
+/// delimiter.
+///
+/// No strings are allocated; each token is a view into @a view. Consecutive
+/// delimiters produce empty tokens, so the number of tokens is always one
+/// more than the number of delimiters.
+///
+/// @param[in]  allocator   The allocator used to allocate the returned vector.
+/// @param[in]  view        The view to split.
+/// @param[in]  delimiter   The character to split at.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @return A vector (#act_Vector) of views, one per token.
+///
+/// @note This function allocates a single vector, sized exactly to the number
+/// of tokens.
+///
+/// @sa #act_vectorFree
+ACT_VEC(act_StringView)
+act_stringViewSplitAll(const act_Allocator *allocator, act_StringView view,
+                       char delimiter, int *error_code);
+
+/// @brief Splits the given #act_String at every occurrence of the delimiter.
+///
+/// @param[in]  string      The string to split.
+/// @param[in]  delimiter   The character to split at.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @return A vector (#act_Vector) of views into @a string, one per token.
+///
+/// @note This function allocates a single vector with the string's
+/// allocator; the views are only valid while @a string is alive and
+/// unmodified.
+///
+/// @sa #act_stringViewSplitAll, #act_vectorFree
+ACT_VEC(act_StringView)
+act_stringSplitAll(act_String string, char delimiter, int *error_code);
+
+/// @brief Checks if the given #act_StringView is valid UTF-8.
+///
+/// Overlong encodings, surrogates, codepoints above U+10FFFF, and truncated
+/// sequences are all rejected. On x86 CPUs with SSSE3, 16 bytes are checked
+/// at a time using lookup tables, and runs of ASCII are skipped.
+///
+/// @param[in]  view        The view to validate.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation; #ACT_STRING_ERROR_INVALID_UTF8 if the
+///                         view is not valid UTF-8.
+///
+/// @return **true** if @a view is valid UTF-8, **false** otherwise.
+///
+/// @sa #act_stringValidateUtf8
+bool act_stringViewValidateUtf8(act_StringView view, int *error_code);
+
+/// @brief Checks if the given #act_String is valid UTF-8.
+///
+/// @param[in]  string      The string to validate.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation; #ACT_STRING_ERROR_INVALID_UTF8 if the
+///                         string is not valid UTF-8.
+///
+/// @return **true** if @a string is valid UTF-8, **false** otherwise.
+///
+/// @sa #act_stringViewValidateUtf8
+bool act_stringValidateUtf8(act_String string, int *error_code);
+
+/// @brief Returns the number of UTF-8 codepoints in the #act_StringView.
+///
+/// Only the bytes that start a codepoint are counted, so the result is only
+/// meaningful for valid UTF-8 (see #act_stringViewValidateUtf8).
+///
+/// @param view The view to count the codepoints of.
+///
+/// @return The number of codepoints in @a view.
+size_t act_stringViewCountCodepoints(act_StringView view);
+
+/// @brief Returns the number of UTF-8 codepoints in the #act_String.
+///
+/// @param string The string to count the codepoints of.
+///
+/// @return The number of codepoints in @a string.
+///
+/// @sa #act_stringViewCountCodepoints
+size_t act_stringCountCodepoints(act_String string);
+
+/// @brief Creates an iterator over the UTF-8 codepoints of the
+/// #act_StringView.
+///
+/// @param view The view to iterate over.
+///
+/// @return An iterator positioned before the first codepoint.
+///
+/// @sa #act_stringCodepointIterNext
+act_StringCodepointIter act_stringViewCodepointIter(act_StringView view);
+
+/// @brief Creates an iterator over the UTF-8 codepoints of the #act_String.
+///
+/// The iterator is invalidated by any modification of the string.
+///
+/// @param string The string to iterate over.
+///
+/// @return An iterator positioned before the first codepoint.
+///
+/// @sa #act_stringCodepointIterNext
+act_StringCodepointIter act_stringCodepointIter(act_String string);
+
+/// @brief Decodes the next codepoint and advances the iterator.
+///
+/// Each invalid sequence (as long as it could have been the prefix of a valid
+/// one) is decoded as a single #ACT_STRING_REPLACEMENT_CHAR.
+///
+/// @param[in]  iter      The iterator to advance.
+/// @param[out] codepoint The next codepoint, if there is one.
+///
+/// @return **true** if a codepoint was returned, **false** once the end of
+/// the string has been reached.
+bool act_stringCodepointIterNext(act_StringCodepointIter *iter,
+                                 uint32_t *codepoint);
+
+/// @brief Converts the ASCII letters of the #act_String to lowercase, in
+/// place.
+///
+/// Bytes outside of `A-Z` (including all non-ASCII bytes) are left untouched,
+/// so UTF-8 stays valid. Blocks of 16 bytes are converted at a time with SSE2.
+///
+/// @param[in]  string      The string to convert.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note This function only allocates if the string's buffer is shared.
+///
+/// @sa #act_stringToUpper, #act_stringViewToLower
+void act_stringToLower(act_String *string, int *error_code);
+
+/// @brief Converts the ASCII letters of the #act_String to uppercase, in
+/// place.
+///
+/// @param[in]  string      The string to convert.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note This function only allocates if the string's buffer is shared.
+///
+/// @sa #act_stringToLower, #act_stringViewToUpper
+void act_stringToUpper(act_String *string, int *error_code);
+
+/// @brief Writes the #act_StringView, with its ASCII letters converted to
+/// lowercase, to the given buffer.
+///
+/// @param[in]  view        The view to convert.
+/// @param[out] out         The buffer to write to, of at least
+///                         ```view.len``` bytes (may be ```view.data``` itself
+///                         to convert a mutable buffer in place).
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note No null terminator is written.
+///
+/// @sa #act_stringToLower
+void act_stringViewToLower(act_StringView view, char *out, int *error_code);
+
+/// @brief Writes the #act_StringView, with its ASCII letters converted to
+/// uppercase, to the given buffer.
+///
+/// @param[in]  view        The view to convert.
+/// @param[out] out         The buffer to write to, of at least
+///                         ```view.len``` bytes (may be ```view.data``` itself
+///                         to convert a mutable buffer in place).
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note No null terminator is written.
+///
+/// @sa #act_stringToUpper
+void act_stringViewToUpper(act_StringView view, char *out, int *error_code);
+
+/// @brief Checks if two views are equal, ignoring the case of ASCII letters.
+///
+/// @param view1 The first view to compare.
+/// @param view2 The second view to compare.
+///
+/// @return **true** if the views are equal up to ASCII case, **false**
+/// otherwise.
+///
+/// @sa #act_stringEqualsIgnoreCase
+bool act_stringViewEqualsIgnoreCase(act_StringView view1, act_StringView view2);
+
+/// @brief Checks if two strings are equal, ignoring the case of ASCII
+/// letters.
+///
+/// @param str1 The first string to compare.
+/// @param str2 The second string to compare.
+///
+/// @return **true** if the strings are equal up to ASCII case, **false**
+/// otherwise.
+///
+/// @sa #act_stringViewEqualsIgnoreCase, #act_stringCompare
+bool act_stringEqualsIgnoreCase(act_String str1, act_String str2);
+
+/// @brief Compares two views lexicographically, byte by byte.
+///
+/// Bytes are compared as unsigned values, and a view that is a prefix of the
+/// other comes first.
+///
+/// @param view1 The first view to compare.
+/// @param view2 The second view to compare.
+///
+/// @return A negative value if @a view1 comes before @a view2, a positive
+/// value if it comes after, and zero if they are equal.
+///
+/// @sa #act_stringLexCompare
+int act_stringViewLexCompare(act_StringView view1, act_StringView view2);
+
+/// @brief Compares two strings lexicographically, byte by byte.
+///
+/// Unlike #act_stringCompare, this is a total order suitable for sorting.
+///
+/// @param str1 The first string to compare.
+/// @param str2 The second string to compare.
+///
+/// @return A negative value if @a str1 comes before @a str2, a positive value
+/// if it comes after, and zero if they are equal.
+///
+/// @sa #act_stringViewLexCompare, #act_vectorSortStrings
+int act_stringLexCompare(act_String str1, act_String str2);
+
+/// @brief Hashes the contents of the #act_StringView.
+///
+/// @param view The view to hash.
+///
+/// @return The hash (#act_hashBytes with #ACT_HASH_DEFAULT_SEED) of @a view.
+///
+/// @sa #act_stringHash
+uint64_t act_stringViewHash(act_StringView view);
+
+/// @brief Hashes the contents of the #act_String, caching the result.
+///
+/// The hash is stored in the string, so hashing it again (e.g. for repeated
+/// hash table lookups) is O(1) until the string is next modified. The hash is
+/// equal to #act_stringViewHash of the string's view.
+///
+/// @param string The string to hash.
+///
+/// @return The hash of @a string.
+uint64_t act_stringHash(act_String *string);
+
+// PRIVATE
+// ============================================================================
+
+/// @internal
+/// @brief [PRIVATE] Moves the gap of a gap-buffer #act_String to the end, so
+/// that its contents are contiguous and null-terminated.
+///
+/// This only touches the (heap allocated) buffer and bookkeeping, so it is
+/// visible through every copy of the string struct. It must be called before
+/// reading the string's buffer directly; it writes to the buffer, which is
+/// why reading an edited string is not thread-safe.
+///
+/// @param[in]  string      The string to compact.
+void act__stringCompact(act_String *string);
+
+/// @internal
+/// @brief [PRIVATE] Ensures that no other string shares the #act_String's
+/// buffer, cloning it if necessary.
+///
+/// Every function that modifies a string calls this first, so it also drops
+/// the string's cached hash.
+///
+/// This must be called before any mutation of the string's buffer.
+///
+/// @param[in]  string      The string to make unique.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note This function allocates a new buffer if the string is shared.
+void act__stringMakeUnique(act_String *string, int *error_code);
+
+/// @internal
+/// @brief [PRIVATE] Makes the #act_String the sole owner of its buffer, and
+/// takes it out of shared-buffer mode.
+///
+/// This is for consumers that take ownership of the raw buffer.
+///
+/// @param[in]  string      The string to detach.
+/// @param[out] error_code  The error code (#act_StringError) of the
+///                         operation.
+///
+/// @note This function allocates a new buffer if the string is shared.
+void act__stringDetach(act_String *string, int *error_code);
+
 #endif /* !ACT_STRING_H */
@@ -0,0 +1,247 @@
+#ifndef ACT_STRING_BUILDER_H
+#define ACT_STRING_BUILDER_H
+
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/// @file act_string_builder.h
+///
+/// This header defines a string builder that accumulates chunks of text and
+/// materializes them only once, either into an exactly sized #act_String or
+/// directly into a file descriptor.
+
+/// @brief **[PRIVATE]** A buffer owned by an #act_StringBuilder, with the
+/// allocator that must free it.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly.
+typedef struct act__StringBuilderBuffer {
+  /// @cond
+  /// @internal The owned buffer.
+  char *_data;
+
+  /// @internal The allocator the buffer was allocated with.
+  const act_Allocator *_allocator;
+  /// @endcond
+} act__StringBuilderBuffer;
+
+/// @brief **[PRIVATE]** Accumulates chunks of text to be joined later.
+///
+/// @param allocator      An allocator for making internal allocations
+///                       #act_Allocator.
+/// @param chunks         The chunks (#act_StringView) pushed so far.
+/// @param owned          The buffers owned (and freed) by the builder, with
+///                       their allocators.
+/// @param scratch        The current block used for small copied pieces.
+/// @param scratch_len    The number of bytes used in the scratch block.
+/// @param scratch_cap    The number of bytes allocated for the scratch block.
+/// @param len            The total length of all chunks.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_stringBuilderLen, #act_stringBuilderNumChunks
+typedef struct act_StringBuilder {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The chunks pushed to the builder, in order.
+  ACT_VEC(act_StringView) _chunks;
+
+  /// @internal The buffers owned by the builder, with their allocators.
+  ACT_VEC(act__StringBuilderBuffer) _owned;
+
+  /// @internal The current block used for copied pieces.
+  char *_scratch;
+
+  /// @internal The number of bytes used in the scratch block.
+  size_t _scratch_len;
+
+  /// @internal The number of bytes allocated for the scratch block.
+  size_t _scratch_cap;
+
+  /// @internal The total length of all chunks.
+  size_t _len;
+  /// @endcond
+} act_StringBuilder;
+
+/// @brief The possible error values.
+typedef enum act_StringBuilderError {
+  /// Successful operation.
+  ACT_STRING_BUILDER_ERROR_SUCCESS = 0x0,
+
+  /// The given builder was **NULL**.
+  ACT_STRING_BUILDER_ERROR_NULL_BUILDER,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_STRING_BUILDER_ERROR_NULL_ALLOCATOR,
+
+  /// The given string was **NULL**.
+  ACT_STRING_BUILDER_ERROR_NULL_STRING,
+
+  /// A failure during allocation.
+  ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED,
+
+  /// A failure while pushing a chunk to the builder.
+  ACT_STRING_BUILDER_ERROR_PUSH_FAILED,
+
+  /// **@em writev** returned an error.
+  ACT_STRING_BUILDER_ERROR_WRITE_FAILED,
+} act_StringBuilderError;
+
+/// @brief Creates a new #act_StringBuilder.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @return A new, empty string builder.
+///
+/// @note This function allocates the (empty) chunk list.
+///
+/// @sa #act_stringBuilderFree
+act_StringBuilder act_stringBuilderNew(const act_Allocator *allocator,
+                                       int *error_code);
+
+/// @brief Frees all memory allocated by the #act_StringBuilder, including any
+/// owned pieces.
+///
+/// Borrowed chunks are not freed.
+///
+/// @param[in]  builder     The builder to free.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+void act_stringBuilderFree(act_StringBuilder *builder, int *error_code);
+
+/// @brief Returns the total length of the chunks in the #act_StringBuilder.
+///
+/// @param builder The builder to get the length of.
+///
+/// @return The length of the string that would be built.
+size_t act_stringBuilderLen(const act_StringBuilder *builder);
+
+/// @brief Returns the number of chunks stored in the #act_StringBuilder.
+///
+/// @param builder The builder to get the number of chunks of.
+///
+/// @return The number of chunks.
+size_t act_stringBuilderNumChunks(const act_StringBuilder *builder);
+
+/// @brief Pushes a borrowed view to the end of the #act_StringBuilder.
+///
+/// The data is @em not copied; it must stay alive and unmodified until the
+/// builder is built, written, or freed.
+///
+/// @param[in]  builder     The builder to push the view to.
+/// @param[in]  view        The view to push.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the chunk list is
+/// resized.
+void act_stringBuilderPushView(act_StringBuilder *builder, act_StringView view,
+                               int *error_code);
+
+/// @brief Pushes a borrowed C-string to the end of the #act_StringBuilder.
+///
+/// @param[in]  builder     The builder to push the C-string to.
+/// @param[in]  cstr        The C-string to push.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @sa #act_stringBuilderPushView
+void act_stringBuilderPushCstr(act_StringBuilder *builder, const char *cstr,
+                               int *error_code);
+
+/// @brief Pushes a borrowed #act_String to the end of the #act_StringBuilder.
+///
+/// @param[in]  builder     The builder to push the string to.
+/// @param[in]  string      The string to push.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @sa #act_stringBuilderPushView
+void act_stringBuilderPushString(act_StringBuilder *builder,
+                                 const act_String *string, int *error_code);
+
+/// @brief Pushes an #act_String to the end of the #act_StringBuilder,
+/// transferring ownership of its buffer to the builder.
+///
+/// The string must not be used or freed by the caller afterwards; its buffer
+/// is freed by #act_stringBuilderFree, with the string's own allocator (or
+/// right away if the push fails).
+///
+/// @param[in]  builder     The builder to push the string to.
+/// @param[in]  string      The string to hand over to the builder.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+void act_stringBuilderPushOwnedString(act_StringBuilder *builder,
+                                      act_String string, int *error_code);
+
+/// @brief Copies the given view into memory owned by the #act_StringBuilder,
+/// and pushes it to the end.
+///
+/// Small pieces are packed into shared blocks, and consecutive copies are
+/// merged into a single chunk.
+///
+/// @param[in]  builder     The builder to push the copy to.
+/// @param[in]  view        The data to copy.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the current block is
+/// full.
+void act_stringBuilderPushCopy(act_StringBuilder *builder, act_StringView view,
+                               int *error_code);
+
+/// @brief Pushes a single character to the end of the #act_StringBuilder.
+///
+/// @param[in]  builder     The builder to push the character to.
+/// @param[in]  c           The character to push.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @sa #act_stringBuilderPushCopy
+void act_stringBuilderPushChar(act_StringBuilder *builder, char c,
+                               int *error_code);
+
+/// @brief Materializes the chunks into a new #act_String.
+///
+/// The result is allocated once, with a capacity of exactly its length (plus
+/// one for the null terminator). The builder is left untouched.
+///
+/// @param[in]  builder     The builder to build the string from.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @return A heap allocated string containing all chunks in order.
+///
+/// @note This function allocates ```act_stringBuilderLen(builder) + 1```
+/// bytes.
+///
+/// @sa #act_stringFree
+act_String act_stringBuilderBuild(const act_StringBuilder *builder,
+                                  int *error_code);
+
+/// @brief Writes the chunks directly to a file descriptor using **@em
+/// writev**, without materializing them.
+///
+/// Short writes and interrupted calls are retried until all bytes have been
+/// written.
+///
+/// @param[in]  builder     The builder to write.
+/// @param[in]  fd          The file descriptor to write to.
+/// @param[out] error_code  The error code (#act_StringBuilderError) of the
+///                         operation.
+///
+/// @return The number of bytes written.
+size_t act_stringBuilderWriteFd(const act_StringBuilder *builder, int fd,
+                                int *error_code);
+
+#endif /* !ACT_STRING_BUILDER_H */
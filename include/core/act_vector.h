@@ -136,6 +136,25 @@ size_t act_vectorDataSize(const act_Vector *vec, int *error_code);
 const act_Allocator *act_vectorAllocator(const act_Vector *vec,
                                          int *error_code);
 
+/// @brief Ensures the #act_Vector has room for @em additional more elements.
+///
+/// The capacity grows geometrically (to at least double), so reserving in a
+/// loop doesn't reallocate on every call.
+///
+/// @param[in]  vec         The vector to reserve space in.
+/// @param[in]  additional  The number of elements to make room for, past the
+///                         current length.
+/// @param[out] error_code  The error code (#act_VectorError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) vector; @em vec must not be used
+/// afterwards.
+///
+/// @note This function @em possibly allocates memory if the capacity is too
+/// small.
+act_Vector *act_vectorReserve(act_Vector *vec, size_t additional,
+                              int *error_code);
+
 /// @brief Create a new #act_Vector that stores elements of type @em T.
 ///
 /// This macro calls #act_vector_new, and passes the size of @em T as the @em
@@ -356,6 +375,18 @@ void act__vectorIncrLen(act_Vector *vec, int *error_code);
 /// @sa #ACT_VEC_PUSH, #ACT_VEC_POP
 void act__vectorDecrLen(act_Vector *vec, int *error_code);
 
+/// @internal
+/// @brief [PRIVATE] Sets the length of the #act_Vector.
+///
+/// The new length must not exceed the capacity; any new elements are left
+/// uninitialized.
+///
+/// @param[in]  vec         The vector to set the length of.
+/// @param[in]  len         The new length.
+/// @param[out] error_code  The error code (#act_VectorError) of the
+///                         operation.
+void act__vectorSetLen(act_Vector *vec, size_t len, int *error_code);
+
 /// @internal
 /// @brief [PRIVATE] Resizes the given #act_Vector by doubling its capacity.
 ///
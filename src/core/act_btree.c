@@ -0,0 +1,637 @@
+#include "act_btree.h"
+#include <string.h>
+
+/// The alignment of the keys, values and children in a node.
+#define ACT__BTREE_ALIGN 16
+
+/// The size of a cache line, which the node size is a multiple of.
+#define ACT__BTREE_CACHE_LINE 64
+
+/// The header of a node, followed by its keys and then either its values (in
+/// a leaf) or its children (in an internal node).
+struct act__BTreeNode {
+  /// The previous leaf in key order (**NULL** for internal nodes).
+  act__BTreeNode *prev;
+
+  /// The next leaf in key order (**NULL** for internal nodes).
+  act__BTreeNode *next;
+
+  /// The number of keys (an internal node has one more child).
+  size_t len;
+
+  /// Whether the node is a leaf.
+  bool leaf;
+};
+
+/// Rounds @em size up to a multiple of @em align (a power of two).
+static inline size_t act__btreeRoundUp(size_t size, size_t align) {
+  return (size + align - 1) & ~(align - 1);
+}
+
+/// The offset of the keys in a node.
+#define ACT__BTREE_KEYS_OFFSET                                                 \
+  act__btreeRoundUp(sizeof(act__BTreeNode), ACT__BTREE_ALIGN)
+
+/// Returns a pointer to the key at @em idx of a node.
+static inline char *act__btreeKeyAt(const act_BTree *tree,
+                                    const act__BTreeNode *node, size_t idx) {
+  return (char *)node + ACT__BTREE_KEYS_OFFSET + idx * tree->_key_size;
+}
+
+/// Returns a pointer to the value at @em idx of a leaf.
+static inline char *act__btreeValueAt(const act_BTree *tree,
+                                      const act__BTreeNode *leaf, size_t idx) {
+  return (char *)leaf + tree->_values_offset + idx * tree->_value_size;
+}
+
+/// Returns the children of an internal node.
+static inline act__BTreeNode **
+act__btreeChildren(const act_BTree *tree, const act__BTreeNode *node) {
+  return (act__BTreeNode **)((char *)node + tree->_children_offset);
+}
+
+/// Returns the size of a node holding @em capacity keys, each followed by
+/// @em payload bytes (plus @em extra bytes).
+static size_t act__btreeNodeBytes(size_t key_size, size_t payload,
+                                  size_t capacity, size_t extra) {
+  return ACT__BTREE_KEYS_OFFSET +
+         act__btreeRoundUp(capacity * key_size, ACT__BTREE_ALIGN) +
+         capacity * payload + extra;
+}
+
+/// Returns the number of keys that fit in #ACT_BTREE_NODE_SIZE bytes (but at
+/// least #ACT_BTREE_MIN_FANOUT).
+static size_t act__btreeCapacity(size_t key_size, size_t payload,
+                                 size_t extra) {
+  size_t capacity = ACT_BTREE_NODE_SIZE / (key_size + payload);
+  while (capacity > ACT_BTREE_MIN_FANOUT &&
+         act__btreeNodeBytes(key_size, payload, capacity, extra) >
+             ACT_BTREE_NODE_SIZE) {
+    capacity--;
+  }
+  return capacity < ACT_BTREE_MIN_FANOUT ? ACT_BTREE_MIN_FANOUT : capacity;
+}
+
+/// Returns whether a node is full.
+static inline bool act__btreeIsFull(const act_BTree *tree,
+                                    const act__BTreeNode *node) {
+  return node->len ==
+         (node->leaf ? tree->_leaf_capacity : tree->_internal_capacity);
+}
+
+/// Returns whether a node has as few keys as it may have (besides the root),
+/// so it can't lose one.
+static inline bool act__btreeIsMinimal(const act_BTree *tree,
+                                       const act__BTreeNode *node) {
+  return node->len <= (node->leaf ? tree->_leaf_capacity / 2
+                                  : (tree->_internal_capacity - 1) / 2);
+}
+
+/// Returns the index of the first key of a node that is not less than
+/// @em key, or (if @em upper) that is greater than it.
+static size_t act__btreeSearch(const act_BTree *tree,
+                               const act__BTreeNode *node, const void *key,
+                               bool upper) {
+  size_t low = 0;
+  size_t high = node->len;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    int cmp = tree->_compare(act__btreeKeyAt(tree, node, mid), key);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/// Returns the leaf whose range holds @em key.
+static act__BTreeNode *act__btreeFindLeaf(const act_BTree *tree,
+                                          const void *key) {
+  act__BTreeNode *node = tree->_root;
+  while (node != NULL && !node->leaf) {
+    node = act__btreeChildren(tree, node)[act__btreeSearch(tree, node, key,
+                                                           true)];
+  }
+  return node;
+}
+
+/// Makes a new, empty node.
+static act__BTreeNode *act__btreeNewNode(const act_BTree *tree, bool leaf) {
+  act__BTreeNode *node = tree->_allocator->alloc(1, tree->_node_size);
+  if (node != NULL) {
+    *node = (act__BTreeNode){.leaf = leaf};
+  }
+  return node;
+}
+
+/// Frees a node and all of its descendants.
+static void act__btreeFreeNode(const act_BTree *tree, act__BTreeNode *node) {
+  if (!node->leaf) {
+    act__BTreeNode **children = act__btreeChildren(tree, node);
+    for (size_t i = 0; i <= node->len; i++) {
+      act__btreeFreeNode(tree, children[i]);
+    }
+  }
+  tree->_allocator->free(node);
+}
+
+/// Moves @em count keys of a node from @em from to @em to.
+static inline void act__btreeMoveKeys(const act_BTree *tree,
+                                      act__BTreeNode *dst, size_t to,
+                                      const act__BTreeNode *src, size_t from,
+                                      size_t count) {
+  memmove(act__btreeKeyAt(tree, dst, to), act__btreeKeyAt(tree, src, from),
+          count * tree->_key_size);
+}
+
+/// Moves @em count entries (keys and values) between leaves.
+static inline void act__btreeMoveEntries(const act_BTree *tree,
+                                         act__BTreeNode *dst, size_t to,
+                                         const act__BTreeNode *src,
+                                         size_t from, size_t count) {
+  act__btreeMoveKeys(tree, dst, to, src, from, count);
+  memmove(act__btreeValueAt(tree, dst, to),
+          act__btreeValueAt(tree, src, from), count * tree->_value_size);
+}
+
+/// Moves @em count children between internal nodes.
+static inline void act__btreeMoveChildren(const act_BTree *tree,
+                                          act__BTreeNode *dst, size_t to,
+                                          const act__BTreeNode *src,
+                                          size_t from, size_t count) {
+  memmove(act__btreeChildren(tree, dst) + to,
+          act__btreeChildren(tree, src) + from, count * sizeof(void *));
+}
+
+/// Splits the full child at @em idx of a non-full internal node in two,
+/// adding the separator between them to the parent.
+static bool act__btreeSplitChild(const act_BTree *tree,
+                                 act__BTreeNode *parent, size_t idx) {
+  act__BTreeNode *child = act__btreeChildren(tree, parent)[idx];
+  act__BTreeNode *right = act__btreeNewNode(tree, child->leaf);
+  if (right == NULL) {
+    return false;
+  }
+
+  // A leaf keeps every key, and copies the first key of its right half up.
+  // An internal node moves its middle key up.
+  const char *separator = NULL;
+  if (child->leaf) {
+    size_t mid = child->len / 2;
+    right->len = child->len - mid;
+    act__btreeMoveEntries(tree, right, 0, child, mid, right->len);
+    child->len = mid;
+
+    right->prev = child;
+    right->next = child->next;
+    if (child->next != NULL) {
+      child->next->prev = right;
+    }
+    child->next = right;
+    separator = act__btreeKeyAt(tree, right, 0);
+  } else {
+    size_t mid = child->len / 2;
+    right->len = child->len - mid - 1;
+    act__btreeMoveKeys(tree, right, 0, child, mid + 1, right->len);
+    act__btreeMoveChildren(tree, right, 0, child, mid + 1, right->len + 1);
+    child->len = mid;
+    separator = act__btreeKeyAt(tree, child, mid);
+  }
+
+  act__btreeMoveKeys(tree, parent, idx + 1, parent, idx, parent->len - idx);
+  act__btreeMoveChildren(tree, parent, idx + 2, parent, idx + 1,
+                         parent->len - idx);
+  memcpy(act__btreeKeyAt(tree, parent, idx), separator, tree->_key_size);
+  act__btreeChildren(tree, parent)[idx + 1] = right;
+  parent->len++;
+
+  return true;
+}
+
+/// Merges the child at @em idx + 1 of an internal node into the child at
+/// @em idx, and frees it.
+static void act__btreeMergeChildren(const act_BTree *tree,
+                                    act__BTreeNode *parent, size_t idx) {
+  act__BTreeNode **children = act__btreeChildren(tree, parent);
+  act__BTreeNode *left = children[idx];
+  act__BTreeNode *right = children[idx + 1];
+
+  if (left->leaf) {
+    act__btreeMoveEntries(tree, left, left->len, right, 0, right->len);
+    left->len += right->len;
+    left->next = right->next;
+    if (right->next != NULL) {
+      right->next->prev = left;
+    }
+  } else {
+    // The separator comes back down between the two halves
+    act__btreeMoveKeys(tree, left, left->len, parent, idx, 1);
+    act__btreeMoveKeys(tree, left, left->len + 1, right, 0, right->len);
+    act__btreeMoveChildren(tree, left, left->len + 1, right, 0,
+                           right->len + 1);
+    left->len += right->len + 1;
+  }
+
+  act__btreeMoveKeys(tree, parent, idx, parent, idx + 1,
+                     parent->len - idx - 1);
+  act__btreeMoveChildren(tree, parent, idx + 1, parent, idx + 2,
+                         parent->len - idx - 1);
+  parent->len--;
+  tree->_allocator->free(right);
+}
+
+/// Moves the last entry of the child at @em idx - 1 of an internal node to
+/// the front of the child at @em idx.
+static void act__btreeBorrowLeft(const act_BTree *tree,
+                                 act__BTreeNode *parent, size_t idx) {
+  act__BTreeNode **children = act__btreeChildren(tree, parent);
+  act__BTreeNode *left = children[idx - 1];
+  act__BTreeNode *child = children[idx];
+
+  if (child->leaf) {
+    act__btreeMoveEntries(tree, child, 1, child, 0, child->len);
+    act__btreeMoveEntries(tree, child, 0, left, left->len - 1, 1);
+    act__btreeMoveKeys(tree, parent, idx - 1, child, 0, 1);
+  } else {
+    act__btreeMoveKeys(tree, child, 1, child, 0, child->len);
+    act__btreeMoveChildren(tree, child, 1, child, 0, child->len + 1);
+    act__btreeMoveKeys(tree, child, 0, parent, idx - 1, 1);
+    act__btreeMoveChildren(tree, child, 0, left, left->len, 1);
+    act__btreeMoveKeys(tree, parent, idx - 1, left, left->len - 1, 1);
+  }
+  left->len--;
+  child->len++;
+}
+
+/// Moves the first entry of the child at @em idx + 1 of an internal node to
+/// the back of the child at @em idx.
+static void act__btreeBorrowRight(const act_BTree *tree,
+                                  act__BTreeNode *parent, size_t idx) {
+  act__BTreeNode **children = act__btreeChildren(tree, parent);
+  act__BTreeNode *child = children[idx];
+  act__BTreeNode *right = children[idx + 1];
+
+  if (child->leaf) {
+    act__btreeMoveEntries(tree, child, child->len, right, 0, 1);
+    act__btreeMoveEntries(tree, right, 0, right, 1, right->len - 1);
+    act__btreeMoveKeys(tree, parent, idx, right, 0, 1);
+  } else {
+    act__btreeMoveKeys(tree, child, child->len, parent, idx, 1);
+    act__btreeMoveChildren(tree, child, child->len + 1, right, 0, 1);
+    act__btreeMoveKeys(tree, parent, idx, right, 0, 1);
+    act__btreeMoveKeys(tree, right, 0, right, 1, right->len - 1);
+    act__btreeMoveChildren(tree, right, 0, right, 1, right->len);
+  }
+  right->len--;
+  child->len++;
+}
+
+/// Gives the minimal child at @em idx of an internal node a spare key, by
+/// borrowing from or merging with a sibling, and returns the index of the
+/// child that now holds its range.
+static size_t act__btreeFixChild(const act_BTree *tree,
+                                 act__BTreeNode *parent, size_t idx) {
+  act__BTreeNode **children = act__btreeChildren(tree, parent);
+  if (idx > 0 && !act__btreeIsMinimal(tree, children[idx - 1])) {
+    act__btreeBorrowLeft(tree, parent, idx);
+    return idx;
+  }
+  if (idx < parent->len && !act__btreeIsMinimal(tree, children[idx + 1])) {
+    act__btreeBorrowRight(tree, parent, idx);
+    return idx;
+  }
+  if (idx < parent->len) {
+    act__btreeMergeChildren(tree, parent, idx);
+    return idx;
+  }
+  act__btreeMergeChildren(tree, parent, idx - 1);
+  return idx - 1;
+}
+
+act_BTree act_btreeNew(const act_Allocator *allocator, size_t key_size,
+                       size_t value_size, act_SortCompareFn compare,
+                       int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_ALLOCATOR;
+    return (act_BTree){0};
+  }
+  if (key_size == 0) {
+    *error_code = ACT_BTREE_ERROR_INVALID_KEY_SIZE;
+    return (act_BTree){0};
+  }
+  if (compare == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_COMPARATOR;
+    return (act_BTree){0};
+  }
+
+  // Both kinds of node get the same size, so they can share a pool
+  size_t leaf_capacity = act__btreeCapacity(key_size, value_size, 0);
+  size_t internal_capacity =
+      act__btreeCapacity(key_size, sizeof(void *), sizeof(void *));
+  size_t leaf_bytes =
+      act__btreeNodeBytes(key_size, value_size, leaf_capacity, 0);
+  size_t internal_bytes = act__btreeNodeBytes(
+      key_size, sizeof(void *), internal_capacity, sizeof(void *));
+  size_t node_size =
+      act__btreeRoundUp(leaf_bytes > internal_bytes ? leaf_bytes
+                                                    : internal_bytes,
+                        ACT__BTREE_CACHE_LINE);
+
+  size_t keys_end = ACT__BTREE_KEYS_OFFSET;
+  return (act_BTree){
+      ._allocator = allocator,
+      ._key_size = key_size,
+      ._value_size = value_size,
+      ._compare = compare,
+      ._leaf_capacity = leaf_capacity,
+      ._internal_capacity = internal_capacity,
+      ._values_offset = keys_end + act__btreeRoundUp(leaf_capacity * key_size,
+                                                     ACT__BTREE_ALIGN),
+      ._children_offset =
+          keys_end +
+          act__btreeRoundUp(internal_capacity * key_size, ACT__BTREE_ALIGN),
+      ._node_size = node_size,
+  };
+}
+
+void act_btreeFree(act_BTree *tree, int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (tree == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_TREE;
+    return;
+  }
+
+  if (tree->_root != NULL) {
+    act__btreeFreeNode(tree, tree->_root);
+  }
+  *tree = (act_BTree){0};
+}
+
+size_t act_btreeLen(const act_BTree *tree) { return tree->_len; }
+
+size_t act_btreeNodeSize(const act_BTree *tree) { return tree->_node_size; }
+
+bool act_btreeInsert(act_BTree *tree, const void *key, const void *value,
+                     int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (tree == NULL || tree->_allocator == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_TREE;
+    return false;
+  }
+  if (key == NULL || (value == NULL && tree->_value_size != 0)) {
+    *error_code = ACT_BTREE_ERROR_NULL_KEY;
+    return false;
+  }
+
+  if (tree->_root == NULL) {
+    tree->_root = act__btreeNewNode(tree, true);
+    if (tree->_root == NULL) {
+      *error_code = ACT_BTREE_ERROR_ALLOCATION_FAILED;
+      return false;
+    }
+  }
+
+  // Full nodes are split on the way down, so a split never has to climb
+  // back up the tree
+  if (act__btreeIsFull(tree, tree->_root)) {
+    act__BTreeNode *root = act__btreeNewNode(tree, false);
+    if (root == NULL) {
+      *error_code = ACT_BTREE_ERROR_ALLOCATION_FAILED;
+      return false;
+    }
+    act__btreeChildren(tree, root)[0] = tree->_root;
+    if (!act__btreeSplitChild(tree, root, 0)) {
+      tree->_allocator->free(root);
+      *error_code = ACT_BTREE_ERROR_ALLOCATION_FAILED;
+      return false;
+    }
+    tree->_root = root;
+  }
+
+  act__BTreeNode *node = tree->_root;
+  while (!node->leaf) {
+    size_t idx = act__btreeSearch(tree, node, key, true);
+    if (act__btreeIsFull(tree, act__btreeChildren(tree, node)[idx])) {
+      if (!act__btreeSplitChild(tree, node, idx)) {
+        *error_code = ACT_BTREE_ERROR_ALLOCATION_FAILED;
+        return false;
+      }
+      if (tree->_compare(key, act__btreeKeyAt(tree, node, idx)) >= 0) {
+        idx++;
+      }
+    }
+    node = act__btreeChildren(tree, node)[idx];
+  }
+
+  size_t idx = act__btreeSearch(tree, node, key, false);
+  if (idx < node->len &&
+      tree->_compare(act__btreeKeyAt(tree, node, idx), key) == 0) {
+    if (tree->_value_size != 0) {
+      memcpy(act__btreeValueAt(tree, node, idx), value, tree->_value_size);
+    }
+    return false;
+  }
+
+  act__btreeMoveEntries(tree, node, idx + 1, node, idx, node->len - idx);
+  memcpy(act__btreeKeyAt(tree, node, idx), key, tree->_key_size);
+  if (tree->_value_size != 0) {
+    memcpy(act__btreeValueAt(tree, node, idx), value, tree->_value_size);
+  }
+  node->len++;
+  tree->_len++;
+
+  return true;
+}
+
+void *act_btreeGet(const act_BTree *tree, const void *key, int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (tree == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_TREE;
+    return NULL;
+  }
+  if (key == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_KEY;
+    return NULL;
+  }
+
+  act__BTreeNode *leaf = act__btreeFindLeaf(tree, key);
+  if (leaf != NULL) {
+    size_t idx = act__btreeSearch(tree, leaf, key, false);
+    if (idx < leaf->len &&
+        tree->_compare(act__btreeKeyAt(tree, leaf, idx), key) == 0) {
+      return act__btreeValueAt(tree, leaf, idx);
+    }
+  }
+
+  *error_code = ACT_BTREE_ERROR_NOT_FOUND;
+  return NULL;
+}
+
+bool act_btreeContains(const act_BTree *tree, const void *key) {
+  int error_code = ACT_BTREE_ERROR_SUCCESS;
+  return act_btreeGet(tree, key, &error_code) != NULL;
+}
+
+bool act_btreeRemove(act_BTree *tree, const void *key, void *value,
+                     int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (tree == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_TREE;
+    return false;
+  }
+  if (key == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_KEY;
+    return false;
+  }
+  if (tree->_root == NULL) {
+    *error_code = ACT_BTREE_ERROR_NOT_FOUND;
+    return false;
+  }
+
+  // Minimal nodes are refilled on the way down, so a removal never has to
+  // climb back up the tree
+  act__BTreeNode *node = tree->_root;
+  while (!node->leaf) {
+    size_t idx = act__btreeSearch(tree, node, key, true);
+    if (act__btreeIsMinimal(tree, act__btreeChildren(tree, node)[idx])) {
+      idx = act__btreeFixChild(tree, node, idx);
+    }
+    act__BTreeNode *child = act__btreeChildren(tree, node)[idx];
+
+    // A root merged down to a single child is replaced by it
+    if (node == tree->_root && node->len == 0) {
+      tree->_root = child;
+      tree->_allocator->free(node);
+    }
+    node = child;
+  }
+
+  size_t idx = act__btreeSearch(tree, node, key, false);
+  if (idx == node->len ||
+      tree->_compare(act__btreeKeyAt(tree, node, idx), key) != 0) {
+    *error_code = ACT_BTREE_ERROR_NOT_FOUND;
+    return false;
+  }
+
+  if (value != NULL) {
+    memcpy(value, act__btreeValueAt(tree, node, idx), tree->_value_size);
+  }
+  act__btreeMoveEntries(tree, node, idx, node, idx + 1, node->len - idx - 1);
+  node->len--;
+  tree->_len--;
+
+  if (tree->_len == 0) {
+    tree->_allocator->free(tree->_root);
+    tree->_root = NULL;
+  }
+
+  return true;
+}
+
+act_BTreeIter act_btreeRange(const act_BTree *tree, const void *low,
+                             const void *high, int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (tree == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_TREE;
+    return (act_BTreeIter){0};
+  }
+
+  act_BTreeIter iter = {._tree = tree, ._stop = high, ._reverse = false};
+  if (low != NULL) {
+    iter._leaf = act__btreeFindLeaf(tree, low);
+    if (iter._leaf != NULL) {
+      iter._idx = act__btreeSearch(tree, iter._leaf, low, false);
+    }
+    return iter;
+  }
+
+  const act__BTreeNode *node = tree->_root;
+  while (node != NULL && !node->leaf) {
+    node = act__btreeChildren(tree, node)[0];
+  }
+  iter._leaf = node;
+  return iter;
+}
+
+act_BTreeIter act_btreeRangeReverse(const act_BTree *tree, const void *low,
+                                    const void *high, int *error_code) {
+  *error_code = ACT_BTREE_ERROR_SUCCESS;
+
+  if (tree == NULL) {
+    *error_code = ACT_BTREE_ERROR_NULL_TREE;
+    return (act_BTreeIter){0};
+  }
+
+  // The index of a reverse iterator is one past its next entry
+  act_BTreeIter iter = {._tree = tree, ._stop = low, ._reverse = true};
+  if (high != NULL) {
+    iter._leaf = act__btreeFindLeaf(tree, high);
+    if (iter._leaf != NULL) {
+      iter._idx = act__btreeSearch(tree, iter._leaf, high, false);
+    }
+    return iter;
+  }
+
+  const act__BTreeNode *node = tree->_root;
+  while (node != NULL && !node->leaf) {
+    node = act__btreeChildren(tree, node)[node->len];
+  }
+  iter._leaf = node;
+  iter._idx = node != NULL ? node->len : 0;
+  return iter;
+}
+
+bool act_btreeIterNext(act_BTreeIter *iter, const void **key, void **value) {
+  const act_BTree *tree = iter->_tree;
+  if (tree == NULL) {
+    return false;
+  }
+
+  size_t idx = 0;
+  if (iter->_reverse) {
+    while (iter->_leaf != NULL && iter->_idx == 0) {
+      iter->_leaf = iter->_leaf->prev;
+      iter->_idx = iter->_leaf != NULL ? iter->_leaf->len : 0;
+    }
+    if (iter->_leaf == NULL) {
+      return false;
+    }
+    idx = iter->_idx - 1;
+  } else {
+    while (iter->_leaf != NULL && iter->_idx == iter->_leaf->len) {
+      iter->_leaf = iter->_leaf->next;
+      iter->_idx = 0;
+    }
+    if (iter->_leaf == NULL) {
+      return false;
+    }
+    idx = iter->_idx;
+  }
+
+  const char *next_key = act__btreeKeyAt(tree, iter->_leaf, idx);
+  if (iter->_stop != NULL) {
+    int cmp = tree->_compare(next_key, iter->_stop);
+    if (iter->_reverse ? cmp < 0 : cmp >= 0) {
+      iter->_leaf = NULL;
+      return false;
+    }
+  }
+
+  iter->_idx = iter->_reverse ? idx : idx + 1;
+  if (key != NULL) {
+    *key = next_key;
+  }
+  if (value != NULL) {
+    *value = act__btreeValueAt(tree, iter->_leaf, idx);
+  }
+  return true;
+}
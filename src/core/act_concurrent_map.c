@@ -0,0 +1,757 @@
+#include "act_concurrent_map.h"
+#include <sched.h>
+#include <string.h>
+
+/// The number of buckets allocated for the first insertion into a shard.
+static const size_t CONCURRENT_MAP_MIN_BUCKETS = 16;
+
+/// The number of retired nodes and tables after which a writer reclaims its
+/// shard.
+static const size_t CONCURRENT_MAP_RECLAIM_THRESHOLD = 64;
+
+/// An entry of the map; its key and value are never modified once published,
+/// and its link only changes when the shard grows.
+typedef struct act__ConcurrentNode {
+  /// The next node in the bucket's chain.
+  _Atomic(struct act__ConcurrentNode *) next;
+
+  /// The next node in the shard's retired list.
+  struct act__ConcurrentNode *retired_next;
+
+  /// The epoch the node was unlinked in.
+  uint64_t retire_epoch;
+
+  /// The hash of the key.
+  uint64_t hash;
+
+  /// The length of the key.
+  size_t key_len;
+
+  /// The number of bytes allocated for the node.
+  size_t size;
+
+  /// The key, followed by the value.
+  char data[];
+} act__ConcurrentNode;
+
+/// The buckets of a shard; replaced (not resized) when the shard grows.
+typedef struct act__ConcurrentTable {
+  /// The next table in the shard's retired list.
+  struct act__ConcurrentTable *retired_next;
+
+  /// The epoch the table was replaced in.
+  uint64_t retire_epoch;
+
+  /// The number of buckets (a power of two).
+  size_t num_buckets;
+
+  /// The heads of the bucket chains.
+  _Atomic(act__ConcurrentNode *) buckets[];
+} act__ConcurrentTable;
+
+struct act__ConcurrentShard {
+  /// The lock taken by writers.
+  pthread_mutex_t lock;
+
+  /// The current table (**NULL** until the first insertion).
+  _Atomic(act__ConcurrentTable *) table;
+
+  /// Odd while the shard grows, and incremented again once it is done.
+  _Atomic size_t seq;
+
+  /// The number of entries.
+  _Atomic size_t len;
+
+  /// The nodes unlinked by writers.
+  act__ConcurrentNode *retired_nodes;
+
+  /// The tables replaced by writers.
+  act__ConcurrentTable *retired_tables;
+
+  /// The number of retired nodes and tables.
+  size_t num_retired;
+
+  /// Keeps the locks of neighbouring shards on separate cache lines.
+  char pad[64];
+};
+
+struct act_ConcurrentMapReader {
+  /// The epoch the reader's current lookup started in (zero between lookups).
+  _Atomic uint64_t epoch;
+
+  /// Whether the record belongs to a registered reader.
+  atomic_bool in_use;
+
+  /// The next record of the map.
+  struct act_ConcurrentMapReader *next;
+
+  /// Keeps the epochs of different readers on separate cache lines.
+  char pad[64];
+};
+
+/// Returns the number of bytes allocated for a table.
+static size_t act__concurrentTableSize(size_t num_buckets) {
+  return sizeof(act__ConcurrentTable) +
+         num_buckets * sizeof(_Atomic(act__ConcurrentNode *));
+}
+
+/// Returns the shard a hash belongs to (using bits the buckets do not use).
+static inline act__ConcurrentShard *
+act__concurrentMapShard(const act_ConcurrentMap *map, uint64_t hash) {
+  return &map->_shards[(size_t)(hash >> 40) & (map->_num_shards - 1)];
+}
+
+/// Checks if a node holds the given key.
+static inline bool act__concurrentNodeMatches(const act__ConcurrentNode *node,
+                                              act_StringView key,
+                                              uint64_t hash) {
+  return node->hash == hash && node->key_len == key.len &&
+         memcmp(node->data, key.data, key.len) == 0;
+}
+
+/// Allocates a node for the given entry.
+static act__ConcurrentNode *
+act__concurrentNodeNew(const act_ConcurrentMap *map, act_StringView key,
+                       uint64_t hash, const void *value) {
+  size_t size = sizeof(act__ConcurrentNode) + key.len + map->_value_size;
+  act__ConcurrentNode *node = (*map->_allocator->alloc)(size, sizeof(char));
+  if (node == NULL) {
+    return NULL;
+  }
+
+  atomic_init(&node->next, NULL);
+  node->retired_next = NULL;
+  node->retire_epoch = 0;
+  node->hash = hash;
+  node->key_len = key.len;
+  node->size = size;
+  if (key.len != 0) {
+    memcpy(node->data, key.data, key.len);
+  }
+  if (map->_value_size != 0) {
+    memcpy(node->data + key.len, value, map->_value_size);
+  }
+
+  return node;
+}
+
+/// Marks the start of a lookup by @a reader.
+static inline void act__concurrentReaderEnter(const act_ConcurrentMap *map,
+                                              act_ConcurrentMapReader *reader) {
+  // An exchange continues the release sequence of the previous exit, so a
+  // reclamation that reads this epoch still sees that lookup as done
+  uint64_t epoch = atomic_load_explicit(&map->_epoch, memory_order_relaxed);
+  atomic_exchange_explicit(&reader->epoch, epoch, memory_order_relaxed);
+
+  // Pairs with the fence of act__concurrentMapRetireEpoch: either the writer
+  // sees this epoch, or this reader sees the memory already unlinked
+  atomic_thread_fence(memory_order_seq_cst);
+}
+
+/// Marks the end of a lookup by @a reader.
+static inline void act__concurrentReaderExit(act_ConcurrentMapReader *reader) {
+  atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+}
+
+/// Returns the epoch to tag memory unlinked just before with; no lookup that
+/// started after this epoch can reach it.
+static inline uint64_t
+act__concurrentMapRetireEpoch(const act_ConcurrentMap *map) {
+  atomic_thread_fence(memory_order_seq_cst);
+  return atomic_load_explicit(&map->_epoch, memory_order_relaxed);
+}
+
+/// Returns the epoch of the oldest lookup in progress (**UINT64_MAX** if
+/// there is none); memory retired before it can be freed.
+static uint64_t act__concurrentMapOldestReader(const act_ConcurrentMap *map) {
+  atomic_thread_fence(memory_order_seq_cst);
+
+  uint64_t oldest = UINT64_MAX;
+  act_ConcurrentMapReader *reader =
+      atomic_load_explicit(&map->_readers, memory_order_acquire);
+  for (; reader != NULL; reader = reader->next) {
+    uint64_t epoch = atomic_load_explicit(&reader->epoch, memory_order_acquire);
+    if (epoch != 0 && epoch < oldest) {
+      oldest = epoch;
+    }
+  }
+
+  return oldest;
+}
+
+/// Adds a node to the shard's retired list; the shard must be locked.
+static inline void act__concurrentShardRetireNode(const act_ConcurrentMap *map,
+                                                  act__ConcurrentShard *shard,
+                                                  act__ConcurrentNode *node) {
+  node->retire_epoch = act__concurrentMapRetireEpoch(map);
+  node->retired_next = shard->retired_nodes;
+  shard->retired_nodes = node;
+  shard->num_retired++;
+}
+
+/// Replaces the shard's table with one twice as large, relinking its nodes
+/// into it.
+///
+/// Readers still traversing the old chains may be sent down the wrong chain,
+/// but every node they reach stays valid and the chains stay acyclic (a
+/// relinked node only links to nodes relinked before it), so they only risk
+/// missing a key; they then see the odd sequence number and try again.
+static void act__concurrentShardGrow(const act_ConcurrentMap *map,
+                                     act__ConcurrentShard *shard,
+                                     int *error_code) {
+  act__ConcurrentTable *old =
+      atomic_load_explicit(&shard->table, memory_order_relaxed);
+  size_t num_buckets =
+      old == NULL ? CONCURRENT_MAP_MIN_BUCKETS : old->num_buckets * 2;
+
+  act__ConcurrentTable *table = (*map->_allocator->alloc)(
+      act__concurrentTableSize(num_buckets), sizeof(char));
+  if (table == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+  table->retired_next = NULL;
+  table->retire_epoch = 0;
+  table->num_buckets = num_buckets;
+  for (size_t i = 0; i < num_buckets; i++) {
+    atomic_init(&table->buckets[i], NULL);
+  }
+
+  if (old == NULL) {
+    atomic_store_explicit(&shard->table, table, memory_order_release);
+    return;
+  }
+
+  size_t seq = atomic_load_explicit(&shard->seq, memory_order_relaxed);
+  atomic_store_explicit(&shard->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+
+  for (size_t i = 0; i < old->num_buckets; i++) {
+    act__ConcurrentNode *node =
+        atomic_load_explicit(&old->buckets[i], memory_order_relaxed);
+    while (node != NULL) {
+      act__ConcurrentNode *next =
+          atomic_load_explicit(&node->next, memory_order_relaxed);
+      _Atomic(act__ConcurrentNode *) *bucket =
+          &table->buckets[node->hash & (num_buckets - 1)];
+      atomic_store_explicit(&node->next,
+                            atomic_load_explicit(bucket, memory_order_relaxed),
+                            memory_order_relaxed);
+      atomic_store_explicit(bucket, node, memory_order_relaxed);
+      node = next;
+    }
+  }
+
+  atomic_store_explicit(&shard->table, table, memory_order_release);
+  atomic_store_explicit(&shard->seq, seq + 2, memory_order_release);
+
+  // Readers may still be traversing the old buckets
+  old->retire_epoch = act__concurrentMapRetireEpoch(map);
+  old->retired_next = shard->retired_tables;
+  shard->retired_tables = old;
+  shard->num_retired++;
+}
+
+/// Frees a list of nodes and tables, returning the bytes freed.
+static size_t act__concurrentShardFreeRetired(const act_ConcurrentMap *map,
+                                              act__ConcurrentNode *nodes,
+                                              act__ConcurrentTable *tables) {
+  size_t freed = 0;
+  while (nodes != NULL) {
+    act__ConcurrentNode *next = nodes->retired_next;
+    freed += nodes->size;
+    (*map->_allocator->free)(nodes);
+    nodes = next;
+  }
+  while (tables != NULL) {
+    act__ConcurrentTable *next = tables->retired_next;
+    freed += act__concurrentTableSize(tables->num_buckets);
+    (*map->_allocator->free)(tables);
+    tables = next;
+  }
+
+  return freed;
+}
+
+/// Frees the memory retired in a shard before the oldest lookup in progress
+/// started, returning the bytes freed; the rest stays retired.
+static size_t act__concurrentShardReclaim(act_ConcurrentMap *map,
+                                          act__ConcurrentShard *shard) {
+  // Detach the lists under the lock, and sort them outside of it
+  pthread_mutex_lock(&shard->lock);
+  act__ConcurrentNode *nodes = shard->retired_nodes;
+  act__ConcurrentTable *tables = shard->retired_tables;
+  shard->retired_nodes = NULL;
+  shard->retired_tables = NULL;
+  shard->num_retired = 0;
+  pthread_mutex_unlock(&shard->lock);
+  if (nodes == NULL && tables == NULL) {
+    return 0;
+  }
+
+  // Lookups starting from now on cannot reach anything detached above
+  atomic_fetch_add_explicit(&map->_epoch, 1, memory_order_relaxed);
+  uint64_t oldest = act__concurrentMapOldestReader(map);
+
+  act__ConcurrentNode *free_nodes = NULL;
+  act__ConcurrentNode *kept_nodes = NULL;
+  act__ConcurrentNode *kept_nodes_tail = NULL;
+  size_t num_kept = 0;
+  while (nodes != NULL) {
+    act__ConcurrentNode *next = nodes->retired_next;
+    if (nodes->retire_epoch < oldest) {
+      nodes->retired_next = free_nodes;
+      free_nodes = nodes;
+    } else {
+      nodes->retired_next = kept_nodes;
+      kept_nodes = nodes;
+      kept_nodes_tail = kept_nodes_tail == NULL ? nodes : kept_nodes_tail;
+      num_kept++;
+    }
+    nodes = next;
+  }
+
+  act__ConcurrentTable *free_tables = NULL;
+  act__ConcurrentTable *kept_tables = NULL;
+  act__ConcurrentTable *kept_tables_tail = NULL;
+  while (tables != NULL) {
+    act__ConcurrentTable *next = tables->retired_next;
+    if (tables->retire_epoch < oldest) {
+      tables->retired_next = free_tables;
+      free_tables = tables;
+    } else {
+      tables->retired_next = kept_tables;
+      kept_tables = tables;
+      kept_tables_tail = kept_tables_tail == NULL ? tables : kept_tables_tail;
+      num_kept++;
+    }
+    tables = next;
+  }
+
+  // Give back what may still be in use, for a later reclamation
+  if (num_kept != 0) {
+    pthread_mutex_lock(&shard->lock);
+    if (kept_nodes != NULL) {
+      kept_nodes_tail->retired_next = shard->retired_nodes;
+      shard->retired_nodes = kept_nodes;
+    }
+    if (kept_tables != NULL) {
+      kept_tables_tail->retired_next = shard->retired_tables;
+      shard->retired_tables = kept_tables;
+    }
+    shard->num_retired += num_kept;
+    pthread_mutex_unlock(&shard->lock);
+  }
+
+  return act__concurrentShardFreeRetired(map, free_nodes, free_tables);
+}
+
+act_ConcurrentMap act_concurrentMapNew(const act_Allocator *allocator,
+                                       size_t value_size, size_t num_shards,
+                                       int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_ALLOCATOR;
+    return (act_ConcurrentMap){0};
+  }
+
+  size_t shards_pow2 = 1;
+  while (shards_pow2 < num_shards) {
+    shards_pow2 *= 2;
+  }
+
+  act__ConcurrentShard *shards =
+      (*allocator->alloc)(shards_pow2, sizeof(*shards));
+  if (shards == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_ALLOCATION_FAILED;
+    return (act_ConcurrentMap){0};
+  }
+
+  for (size_t i = 0; i < shards_pow2; i++) {
+    if (pthread_mutex_init(&shards[i].lock, NULL) != 0) {
+      for (size_t j = 0; j < i; j++) {
+        pthread_mutex_destroy(&shards[j].lock);
+      }
+      (*allocator->free)(shards);
+      *error_code = ACT_CONCURRENT_MAP_ERROR_LOCK_FAILED;
+      return (act_ConcurrentMap){0};
+    }
+    atomic_init(&shards[i].table, NULL);
+    atomic_init(&shards[i].seq, 0);
+    atomic_init(&shards[i].len, 0);
+    shards[i].retired_nodes = NULL;
+    shards[i].retired_tables = NULL;
+    shards[i].num_retired = 0;
+  }
+
+  act_ConcurrentMap map = {
+      ._allocator = allocator,
+      ._value_size = value_size,
+      ._shards = shards,
+      ._num_shards = shards_pow2,
+  };
+  atomic_init(&map._epoch, 1);
+  atomic_init(&map._readers, NULL);
+
+  return map;
+}
+
+void act_concurrentMapFree(act_ConcurrentMap *map, int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return;
+  }
+  if (map->_shards == NULL) {
+    return;
+  }
+
+  for (size_t i = 0; i < map->_num_shards; i++) {
+    act__ConcurrentShard *shard = &map->_shards[i];
+
+    // Nothing can be reading, so the live entries go with the retired ones
+    act__ConcurrentTable *table =
+        atomic_load_explicit(&shard->table, memory_order_relaxed);
+    if (table != NULL) {
+      for (size_t b = 0; b < table->num_buckets; b++) {
+        act__ConcurrentNode *node =
+            atomic_load_explicit(&table->buckets[b], memory_order_relaxed);
+        while (node != NULL) {
+          act__ConcurrentNode *next =
+              atomic_load_explicit(&node->next, memory_order_relaxed);
+          node->retired_next = shard->retired_nodes;
+          shard->retired_nodes = node;
+          node = next;
+        }
+      }
+      table->retired_next = shard->retired_tables;
+      shard->retired_tables = table;
+    }
+
+    act__concurrentShardFreeRetired(map, shard->retired_nodes,
+                                    shard->retired_tables);
+    pthread_mutex_destroy(&shard->lock);
+  }
+  (*map->_allocator->free)(map->_shards);
+
+  act_ConcurrentMapReader *reader =
+      atomic_load_explicit(&map->_readers, memory_order_acquire);
+  while (reader != NULL) {
+    act_ConcurrentMapReader *next = reader->next;
+    (*map->_allocator->free)(reader);
+    reader = next;
+  }
+
+  *map = (act_ConcurrentMap){0};
+}
+
+size_t act_concurrentMapLen(const act_ConcurrentMap *map) {
+  size_t len = 0;
+  for (size_t i = 0; i < map->_num_shards; i++) {
+    len += atomic_load_explicit(&map->_shards[i].len, memory_order_relaxed);
+  }
+
+  return len;
+}
+
+act_ConcurrentMapReader *act_concurrentMapRegisterReader(act_ConcurrentMap *map,
+                                                         int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL || map->_shards == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return NULL;
+  }
+
+  // Reuse the record of a reader that unregistered
+  act_ConcurrentMapReader *reader =
+      atomic_load_explicit(&map->_readers, memory_order_acquire);
+  for (; reader != NULL; reader = reader->next) {
+    bool in_use = false;
+    if (!atomic_load_explicit(&reader->in_use, memory_order_relaxed) &&
+        atomic_compare_exchange_strong_explicit(&reader->in_use, &in_use, true,
+                                                memory_order_acquire,
+                                                memory_order_relaxed)) {
+      return reader;
+    }
+  }
+
+  reader = (*map->_allocator->alloc)(1, sizeof(*reader));
+  if (reader == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+  atomic_init(&reader->epoch, 0);
+  atomic_init(&reader->in_use, true);
+
+  // Records are only ever pushed, so a plain CAS loop is enough
+  reader->next = atomic_load_explicit(&map->_readers, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&map->_readers, &reader->next,
+                                                reader, memory_order_release,
+                                                memory_order_relaxed)) {
+  }
+
+  return reader;
+}
+
+void act_concurrentMapUnregisterReader(act_ConcurrentMap *map,
+                                       act_ConcurrentMapReader *reader,
+                                       int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return;
+  }
+  if (reader == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_READER;
+    return;
+  }
+
+  atomic_store_explicit(&reader->in_use, false, memory_order_release);
+}
+
+bool act_concurrentMapInsert(act_ConcurrentMap *map, act_StringView key,
+                             const void *value, int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if ((key.data == NULL && key.len != 0) ||
+      (value == NULL && map->_value_size != 0)) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  uint64_t hash = act_stringViewHash(key);
+  act__ConcurrentShard *shard = act__concurrentMapShard(map, hash);
+
+  // Allocate before locking, to keep the critical section short
+  act__ConcurrentNode *node = act__concurrentNodeNew(map, key, hash, value);
+  if (node == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_ALLOCATION_FAILED;
+    return false;
+  }
+
+  pthread_mutex_lock(&shard->lock);
+
+  act__ConcurrentTable *table =
+      atomic_load_explicit(&shard->table, memory_order_relaxed);
+  size_t len = atomic_load_explicit(&shard->len, memory_order_relaxed);
+  if (table == NULL || len + 1 > table->num_buckets) {
+    act__concurrentShardGrow(map, shard, error_code);
+    if (table == NULL && *error_code != ACT_CONCURRENT_MAP_ERROR_SUCCESS) {
+      pthread_mutex_unlock(&shard->lock);
+      (*map->_allocator->free)(node);
+      return false;
+    }
+
+    // A failed grow leaves a (longer-chained) table that still works
+    *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+    table = atomic_load_explicit(&shard->table, memory_order_relaxed);
+  }
+
+  // Replace an existing entry by swapping the pointer to it
+  bool inserted = true;
+  _Atomic(act__ConcurrentNode *) *link =
+      &table->buckets[hash & (table->num_buckets - 1)];
+  act__ConcurrentNode *head = atomic_load_explicit(link, memory_order_relaxed);
+  for (act__ConcurrentNode *cur = head; cur != NULL;) {
+    _Atomic(act__ConcurrentNode *) *next = &cur->next;
+    if (act__concurrentNodeMatches(cur, key, hash)) {
+      atomic_store_explicit(
+          &node->next, atomic_load_explicit(next, memory_order_relaxed),
+          memory_order_relaxed);
+      atomic_store_explicit(link, node, memory_order_release);
+      act__concurrentShardRetireNode(map, shard, cur);
+      inserted = false;
+      break;
+    }
+    link = next;
+    cur = atomic_load_explicit(next, memory_order_relaxed);
+  }
+
+  // Publish the new entry at the head of its chain
+  if (inserted) {
+    _Atomic(act__ConcurrentNode *) *bucket =
+        &table->buckets[hash & (table->num_buckets - 1)];
+    atomic_store_explicit(&node->next, head, memory_order_relaxed);
+    atomic_store_explicit(bucket, node, memory_order_release);
+    atomic_store_explicit(&shard->len, len + 1, memory_order_relaxed);
+  }
+
+  bool reclaim = shard->num_retired >= CONCURRENT_MAP_RECLAIM_THRESHOLD;
+  pthread_mutex_unlock(&shard->lock);
+
+  if (reclaim) {
+    act__concurrentShardReclaim(map, shard);
+  }
+  return inserted;
+}
+
+/// Looks up @a key (whose hash is @a hash) without locking.
+static bool act__concurrentMapGet(const act_ConcurrentMap *map,
+                                  act_ConcurrentMapReader *reader,
+                                  act_StringView key, uint64_t hash,
+                                  void *value, int *error_code) {
+  act__ConcurrentShard *shard = act__concurrentMapShard(map, hash);
+  act__concurrentReaderEnter(map, reader);
+
+  const act__ConcurrentNode *found = NULL;
+  for (;;) {
+    size_t seq = atomic_load_explicit(&shard->seq, memory_order_acquire);
+    act__ConcurrentTable *table =
+        atomic_load_explicit(&shard->table, memory_order_acquire);
+    if (table != NULL) {
+      act__ConcurrentNode *node = atomic_load_explicit(
+          &table->buckets[hash & (table->num_buckets - 1)],
+          memory_order_acquire);
+      while (node != NULL && !act__concurrentNodeMatches(node, key, hash)) {
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+      }
+      found = node;
+    }
+    if (found != NULL) {
+      break;
+    }
+
+    // A miss only counts if the shard did not grow meanwhile
+    atomic_thread_fence(memory_order_acquire);
+    if (seq % 2 == 0 &&
+        atomic_load_explicit(&shard->seq, memory_order_relaxed) == seq) {
+      break;
+    }
+    sched_yield();
+  }
+
+  if (found != NULL && value != NULL && map->_value_size != 0) {
+    memcpy(value, found->data + found->key_len, map->_value_size);
+  }
+  act__concurrentReaderExit(reader);
+
+  if (found == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NOT_FOUND;
+    return false;
+  }
+  return true;
+}
+
+bool act_concurrentMapGet(const act_ConcurrentMap *map,
+                          act_ConcurrentMapReader *reader, act_StringView key,
+                          void *value, int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (reader == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_READER;
+    return false;
+  }
+  if (key.data == NULL && key.len != 0) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  return act__concurrentMapGet(map, reader, key, act_stringViewHash(key),
+                               value, error_code);
+}
+
+bool act_concurrentMapGetString(const act_ConcurrentMap *map,
+                                act_ConcurrentMapReader *reader,
+                                act_String *key, void *value, int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (reader == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_READER;
+    return false;
+  }
+  if (key == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  return act__concurrentMapGet(map, reader, act_stringAsView(*key),
+                               act_stringHash(key), value, error_code);
+}
+
+bool act_concurrentMapRemove(act_ConcurrentMap *map, act_StringView key,
+                             void *value, int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (key.data == NULL && key.len != 0) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  uint64_t hash = act_stringViewHash(key);
+  act__ConcurrentShard *shard = act__concurrentMapShard(map, hash);
+
+  pthread_mutex_lock(&shard->lock);
+
+  bool removed = false;
+  act__ConcurrentTable *table =
+      atomic_load_explicit(&shard->table, memory_order_relaxed);
+  if (table != NULL) {
+    _Atomic(act__ConcurrentNode *) *link =
+        &table->buckets[hash & (table->num_buckets - 1)];
+    act__ConcurrentNode *cur = atomic_load_explicit(link, memory_order_relaxed);
+    while (cur != NULL) {
+      act__ConcurrentNode *next =
+          atomic_load_explicit(&cur->next, memory_order_relaxed);
+      if (act__concurrentNodeMatches(cur, key, hash)) {
+        // Readers on the node still see a valid chain through its next link
+        atomic_store_explicit(link, next, memory_order_release);
+        if (value != NULL && map->_value_size != 0) {
+          memcpy(value, cur->data + cur->key_len, map->_value_size);
+        }
+        act__concurrentShardRetireNode(map, shard, cur);
+        atomic_fetch_sub_explicit(&shard->len, 1, memory_order_relaxed);
+        removed = true;
+        break;
+      }
+      link = &cur->next;
+      cur = next;
+    }
+  }
+
+  bool reclaim = shard->num_retired >= CONCURRENT_MAP_RECLAIM_THRESHOLD;
+  pthread_mutex_unlock(&shard->lock);
+
+  if (reclaim) {
+    act__concurrentShardReclaim(map, shard);
+  }
+  if (!removed) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NOT_FOUND;
+  }
+  return removed;
+}
+
+size_t act_concurrentMapReclaim(act_ConcurrentMap *map, int *error_code) {
+  *error_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_CONCURRENT_MAP_ERROR_NULL_MAP;
+    return 0;
+  }
+
+  size_t freed = 0;
+  for (size_t i = 0; i < map->_num_shards; i++) {
+    freed += act__concurrentShardReclaim(map, &map->_shards[i]);
+  }
+
+  return freed;
+}
@@ -0,0 +1,260 @@
+#ifndef ACT_CONCURRENT_MAP_H
+#define ACT_CONCURRENT_MAP_H
+
+#include "act_allocator.h"
+#include "act_hash.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_concurrent_map.h
+///
+/// This header defines a hash map with string keys that can be used from many
+/// threads at once.
+///
+/// The map is split into shards by hash, and writers only lock the shard they
+/// modify. Readers never lock: every entry is a node in a chain of atomic
+/// pointers whose key and value never change, and writers publish changes by
+/// swapping single pointers (RCU-style), so a reader always sees either the
+/// old or the new state. Growing a shard relinks its nodes into a larger
+/// table; a lookup that misses while that happens tries again.
+///
+/// Memory unlinked by writers cannot be freed while readers might still be
+/// traversing it, so it is retired instead, and freed after a grace period
+/// (epoch-based reclamation). Every thread that reads the map registers an
+/// #act_ConcurrentMapReader, which announces the epoch each lookup started
+/// in; retired memory is only freed once every lookup in progress started
+/// after it was unlinked. Writers reclaim their shard's retired memory as it
+/// builds up, and #act_concurrentMapReclaim reclaims the whole map, at any
+/// time.
+
+/// The default number of shards of an #act_ConcurrentMap.
+#define ACT_CONCURRENT_MAP_DEFAULT_SHARDS 64
+
+/// @brief A shard of an #act_ConcurrentMap.
+///
+/// This type is private; its definition is only visible to the map
+/// implementation.
+typedef struct act__ConcurrentShard act__ConcurrentShard;
+
+/// @brief A thread registered to read an #act_ConcurrentMap.
+///
+/// This type is private; its definition is only visible to the map
+/// implementation.
+///
+/// @sa #act_concurrentMapRegisterReader
+typedef struct act_ConcurrentMapReader act_ConcurrentMapReader;
+
+/// @brief **[PRIVATE]** A sharded hash map with lock-free reads.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_concurrentMapInsert, #act_concurrentMapGet
+typedef struct act_ConcurrentMap {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The size of a value.
+  size_t _value_size;
+
+  /// @internal The shards.
+  act__ConcurrentShard *_shards;
+
+  /// @internal The number of shards (a power of two).
+  size_t _num_shards;
+
+  /// @internal The current epoch, advanced by every reclamation.
+  _Atomic uint64_t _epoch;
+
+  /// @internal The readers registered with the map (never unlinked).
+  _Atomic(act_ConcurrentMapReader *) _readers;
+  /// @endcond
+} act_ConcurrentMap;
+
+/// @brief The possible error values.
+typedef enum act_ConcurrentMapError {
+  /// Successful operation.
+  ACT_CONCURRENT_MAP_ERROR_SUCCESS = 0x0,
+
+  /// The given map was **NULL**.
+  ACT_CONCURRENT_MAP_ERROR_NULL_MAP,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_CONCURRENT_MAP_ERROR_NULL_ALLOCATOR,
+
+  /// The given key or value was **NULL**.
+  ACT_CONCURRENT_MAP_ERROR_NULL_KEY,
+
+  /// The given reader was **NULL**.
+  ACT_CONCURRENT_MAP_ERROR_NULL_READER,
+
+  /// A failure during allocation.
+  ACT_CONCURRENT_MAP_ERROR_ALLOCATION_FAILED,
+
+  /// A failure initializing a lock.
+  ACT_CONCURRENT_MAP_ERROR_LOCK_FAILED,
+
+  /// The key is not in the map.
+  ACT_CONCURRENT_MAP_ERROR_NOT_FOUND,
+} act_ConcurrentMapError;
+
+/// @brief Creates a new #act_ConcurrentMap.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations; it must be thread-safe.
+/// @param[in]  value_size  The size of a value (may be zero for a set).
+/// @param[in]  num_shards  The number of shards (rounded up to a power of
+///                         two); more shards let more writers run at once.
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation.
+///
+/// @return A new, empty map.
+///
+/// @note This function allocates the shards.
+///
+/// @sa #act_concurrentMapFree
+act_ConcurrentMap act_concurrentMapNew(const act_Allocator *allocator,
+                                       size_t value_size, size_t num_shards,
+                                       int *error_code);
+
+/// @brief Frees all memory allocated by the #act_ConcurrentMap, including its
+/// readers.
+///
+/// No other thread may be using the map.
+///
+/// @param[in]  map         The map to free.
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation.
+void act_concurrentMapFree(act_ConcurrentMap *map, int *error_code);
+
+/// @brief Returns the number of entries in the #act_ConcurrentMap.
+///
+/// The result is only a snapshot if other threads are writing.
+///
+/// @param map The map to get the length of.
+///
+/// @return The number of entries.
+size_t act_concurrentMapLen(const act_ConcurrentMap *map);
+
+/// @brief Registers the calling thread as a reader of the #act_ConcurrentMap.
+///
+/// Every thread that looks keys up needs its own reader; a reader must not be
+/// used by two threads at once. Registering and unregistering are cheap, as
+/// the records of unregistered readers are reused.
+///
+/// @param[in]  map         The map to read.
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation.
+///
+/// @return The reader, or **NULL** on error.
+///
+/// @note This function @em possibly allocates a reader record, which lives
+/// until #act_concurrentMapFree.
+///
+/// @sa #act_concurrentMapUnregisterReader, #act_concurrentMapGet
+act_ConcurrentMapReader *act_concurrentMapRegisterReader(act_ConcurrentMap *map,
+                                                         int *error_code);
+
+/// @brief Unregisters a reader of the #act_ConcurrentMap, once its thread is
+/// done reading.
+///
+/// @param[in]  map         The map that was read.
+/// @param[in]  reader      The reader to unregister.
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation.
+///
+/// @sa #act_concurrentMapRegisterReader
+void act_concurrentMapUnregisterReader(act_ConcurrentMap *map,
+                                       act_ConcurrentMapReader *reader,
+                                       int *error_code);
+
+/// @brief Inserts a key and value into the #act_ConcurrentMap, replacing the
+/// value if the key already exists.
+///
+/// Only the key's shard is locked.
+///
+/// @param[in]  map         The map to insert into.
+/// @param[in]  key         The key, copied into the map.
+/// @param[in]  value       The value (of the map's value size) to copy in.
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation.
+///
+/// @return **true** if the key was new, **false** if its value was replaced.
+///
+/// @note This function allocates a new entry (the replaced entry is retired),
+/// @em possibly allocates memory if the shard grows, and @em possibly frees
+/// retired memory.
+bool act_concurrentMapInsert(act_ConcurrentMap *map, act_StringView key,
+                             const void *value, int *error_code);
+
+/// @brief Looks up the value of a key in the #act_ConcurrentMap, without
+/// taking any lock.
+///
+/// @param[in]  map         The map to search.
+/// @param[in]  reader      The calling thread's reader.
+/// @param[in]  key         The key to look for.
+/// @param[out] value       Where to copy the value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation; #ACT_CONCURRENT_MAP_ERROR_NOT_FOUND if
+///                         the key is not in the map.
+///
+/// @return **true** if the key was found, **false** otherwise.
+bool act_concurrentMapGet(const act_ConcurrentMap *map,
+                          act_ConcurrentMapReader *reader, act_StringView key,
+                          void *value, int *error_code);
+
+/// @brief Looks up the value of an #act_String key in the #act_ConcurrentMap,
+/// using (and caching) the key's hash.
+///
+/// @param[in]  map         The map to search.
+/// @param[in]  reader      The calling thread's reader.
+/// @param[in]  key         The key to look for.
+/// @param[out] value       Where to copy the value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation; #ACT_CONCURRENT_MAP_ERROR_NOT_FOUND if
+///                         the key is not in the map.
+///
+/// @return **true** if the key was found, **false** otherwise.
+///
+/// @sa #act_stringHash
+bool act_concurrentMapGetString(const act_ConcurrentMap *map,
+                                act_ConcurrentMapReader *reader,
+                                act_String *key, void *value, int *error_code);
+
+/// @brief Removes a key (and its value) from the #act_ConcurrentMap.
+///
+/// @param[in]  map         The map to remove from.
+/// @param[in]  key         The key to remove.
+/// @param[out] value       Where to copy the removed value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation; #ACT_CONCURRENT_MAP_ERROR_NOT_FOUND if
+///                         the key is not in the map.
+///
+/// @return **true** if the key was removed, **false** if it was not found.
+///
+/// @note The removed entry is retired, and freed once no reader can still be
+/// using it; this function @em possibly frees retired memory.
+bool act_concurrentMapRemove(act_ConcurrentMap *map, act_StringView key,
+                             void *value, int *error_code);
+
+/// @brief Frees the memory retired by writers that no reader can still be
+/// using.
+///
+/// This may be called at any time, from any thread. Memory retired while a
+/// lookup was in progress is kept until that lookup is done, and freed by a
+/// later reclamation.
+///
+/// @param[in]  map         The map to reclaim memory from.
+/// @param[out] error_code  The error code (#act_ConcurrentMapError) of the
+///                         operation.
+///
+/// @return The number of bytes freed.
+size_t act_concurrentMapReclaim(act_ConcurrentMap *map, int *error_code);
+
+#endif /* !ACT_CONCURRENT_MAP_H */
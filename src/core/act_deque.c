@@ -0,0 +1,291 @@
+#include "act_deque.h"
+#include <string.h>
+
+/// Returns a pointer to the element in @em slot of the buffer.
+static inline char *act__dequeSlotAt(const act_Deque *deque, size_t slot) {
+  return (char *)deque->_buffer + slot * deque->_data_size;
+}
+
+/// Returns the slot of the element at @em idx from the front.
+static inline size_t act__dequeSlot(const act_Deque *deque, size_t idx) {
+  return (deque->_head + idx) & (deque->_capacity - 1);
+}
+
+/// Copies @em count elements into the ring, starting at @em slot and
+/// wrapping around the end of the buffer.
+static void act__dequeCopyIn(act_Deque *deque, size_t slot, const char *src,
+                             size_t count) {
+  size_t until_end = deque->_capacity - slot;
+  size_t first = count < until_end ? count : until_end;
+  memcpy(act__dequeSlotAt(deque, slot), src, first * deque->_data_size);
+  memcpy(deque->_buffer, src + first * deque->_data_size,
+         (count - first) * deque->_data_size);
+}
+
+/// Copies @em count elements out of the ring, starting at @em slot and
+/// wrapping around the end of the buffer.
+static void act__dequeCopyOut(const act_Deque *deque, size_t slot, char *dst,
+                              size_t count) {
+  size_t until_end = deque->_capacity - slot;
+  size_t first = count < until_end ? count : until_end;
+  memcpy(dst, act__dequeSlotAt(deque, slot), first * deque->_data_size);
+  memcpy(dst + first * deque->_data_size, deque->_buffer,
+         (count - first) * deque->_data_size);
+}
+
+/// Grows the buffer to hold at least @em min_capacity elements, unwrapping
+/// the elements to the start of the new buffer.
+static bool act__dequeGrow(act_Deque *deque, size_t min_capacity) {
+  size_t capacity =
+      deque->_capacity == 0 ? ACT_DEQUE_MIN_CAPACITY : deque->_capacity * 2;
+  while (capacity < min_capacity) {
+    capacity *= 2;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *buffer = act_vectorWithCapacity(
+      deque->_allocator, deque->_data_size, capacity, &vec_err);
+  if (buffer == NULL || vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    return false;
+  }
+
+  if (deque->_buffer != NULL) {
+    act__dequeCopyOut(deque, deque->_head, buffer, deque->_len);
+    act_vectorFree(deque->_buffer, &vec_err);
+  }
+  deque->_buffer = buffer;
+  deque->_capacity = capacity;
+  deque->_head = 0;
+
+  return true;
+}
+
+act_Deque act_dequeNew(const act_Allocator *allocator, size_t data_size,
+                       int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_ALLOCATOR;
+    return (act_Deque){0};
+  }
+  if (data_size == 0) {
+    *error_code = ACT_DEQUE_ERROR_INVALID_DATA_SIZE;
+    return (act_Deque){0};
+  }
+
+  return (act_Deque){._allocator = allocator, ._data_size = data_size};
+}
+
+void act_dequeFree(act_Deque *deque, int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return;
+  }
+
+  if (deque->_buffer != NULL) {
+    int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+    act_vectorFree(deque->_buffer, &vec_err);
+  }
+  *deque = (act_Deque){0};
+}
+
+size_t act_dequeLen(const act_Deque *deque) { return deque->_len; }
+
+size_t act_dequeCapacity(const act_Deque *deque) { return deque->_capacity; }
+
+void act_dequeReserve(act_Deque *deque, size_t additional, int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL || deque->_allocator == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return;
+  }
+
+  if (deque->_len + additional > deque->_capacity &&
+      !act__dequeGrow(deque, deque->_len + additional)) {
+    *error_code = ACT_DEQUE_ERROR_ALLOCATION_FAILED;
+  }
+}
+
+void act_dequePushBack(act_Deque *deque, const void *element,
+                       int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL || deque->_allocator == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return;
+  }
+  if (element == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_ELEMENT;
+    return;
+  }
+
+  if (deque->_len == deque->_capacity &&
+      !act__dequeGrow(deque, deque->_len + 1)) {
+    *error_code = ACT_DEQUE_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  memcpy(act__dequeSlotAt(deque, act__dequeSlot(deque, deque->_len)), element,
+         deque->_data_size);
+  deque->_len++;
+}
+
+void act_dequePushFront(act_Deque *deque, const void *element,
+                        int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL || deque->_allocator == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return;
+  }
+  if (element == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_ELEMENT;
+    return;
+  }
+
+  if (deque->_len == deque->_capacity &&
+      !act__dequeGrow(deque, deque->_len + 1)) {
+    *error_code = ACT_DEQUE_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  deque->_head = (deque->_head - 1) & (deque->_capacity - 1);
+  memcpy(act__dequeSlotAt(deque, deque->_head), element, deque->_data_size);
+  deque->_len++;
+}
+
+bool act_dequePopBack(act_Deque *deque, void *element, int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return false;
+  }
+  if (deque->_len == 0) {
+    *error_code = ACT_DEQUE_ERROR_EMPTY;
+    return false;
+  }
+
+  deque->_len--;
+  if (element != NULL) {
+    memcpy(element,
+           act__dequeSlotAt(deque, act__dequeSlot(deque, deque->_len)),
+           deque->_data_size);
+  }
+
+  return true;
+}
+
+bool act_dequePopFront(act_Deque *deque, void *element, int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return false;
+  }
+  if (deque->_len == 0) {
+    *error_code = ACT_DEQUE_ERROR_EMPTY;
+    return false;
+  }
+
+  if (element != NULL) {
+    memcpy(element, act__dequeSlotAt(deque, deque->_head), deque->_data_size);
+  }
+  deque->_head = (deque->_head + 1) & (deque->_capacity - 1);
+  deque->_len--;
+
+  return true;
+}
+
+void *act_dequeAt(const act_Deque *deque, size_t idx, int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return NULL;
+  }
+  if (idx >= deque->_len) {
+    *error_code = ACT_DEQUE_ERROR_OUT_OF_BOUNDS;
+    return NULL;
+  }
+
+  return act__dequeSlotAt(deque, act__dequeSlot(deque, idx));
+}
+
+void act_dequePushBackMany(act_Deque *deque, const void *elements,
+                           size_t count, int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL || deque->_allocator == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return;
+  }
+  if (elements == NULL && count != 0) {
+    *error_code = ACT_DEQUE_ERROR_NULL_ELEMENT;
+    return;
+  }
+  if (count == 0) {
+    return;
+  }
+
+  if (deque->_len + count > deque->_capacity &&
+      !act__dequeGrow(deque, deque->_len + count)) {
+    *error_code = ACT_DEQUE_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  act__dequeCopyIn(deque, act__dequeSlot(deque, deque->_len), elements,
+                   count);
+  deque->_len += count;
+}
+
+size_t act_dequePopFrontMany(act_Deque *deque, void *elements, size_t max,
+                             int *error_code) {
+  *error_code = ACT_DEQUE_ERROR_SUCCESS;
+
+  if (deque == NULL) {
+    *error_code = ACT_DEQUE_ERROR_NULL_DEQUE;
+    return 0;
+  }
+
+  size_t count = max < deque->_len ? max : deque->_len;
+  if (count == 0) {
+    return 0;
+  }
+
+  if (elements != NULL) {
+    act__dequeCopyOut(deque, deque->_head, elements, count);
+  }
+  deque->_head = (deque->_head + count) & (deque->_capacity - 1);
+  deque->_len -= count;
+
+  return count;
+}
+
+void act_dequeSpans(const act_Deque *deque, act_DequeSpan *first,
+                    act_DequeSpan *second) {
+  if (deque->_len == 0) {
+    *first = (act_DequeSpan){.data = deque->_buffer, .len = 0};
+    *second = *first;
+    return;
+  }
+
+  size_t until_end = deque->_capacity - deque->_head;
+  size_t first_len = deque->_len < until_end ? deque->_len : until_end;
+  *first = (act_DequeSpan){
+      .data = act__dequeSlotAt(deque, deque->_head),
+      .len = first_len,
+  };
+  *second = (act_DequeSpan){
+      .data = deque->_buffer,
+      .len = deque->_len - first_len,
+  };
+}
+
+void act_dequeClear(act_Deque *deque) {
+  deque->_head = 0;
+  deque->_len = 0;
+}
@@ -0,0 +1,266 @@
+#ifndef ACT_DEQUE_H
+#define ACT_DEQUE_H
+
+#include "act_allocator.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_deque.h
+///
+/// This header defines a double-ended queue, stored as a ring buffer in the
+/// capacity of an #act_Vector.
+///
+/// Pushing and popping at either end take O(1) time and never move the other
+/// elements. The capacity is a power of two, so wrapping around is a mask
+/// instead of a division; when it is full the buffer doubles, and the
+/// elements are copied to the start of the new buffer in order.
+///
+/// The elements are stored in at most two contiguous spans (see
+/// #act_dequeSpans), so they can be copied out in bulk with two
+/// **@em memcpy** calls.
+
+/// The capacity of an #act_Deque after its first push.
+#define ACT_DEQUE_MIN_CAPACITY 16
+
+/// @brief **[PRIVATE]** A double-ended queue in a ring buffer.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_dequePushBack, #act_dequePopFront, #act_dequeSpans
+typedef struct act_Deque {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The buffer (**NULL** until the first push); only its capacity
+  /// is used.
+  act_Vector *_buffer;
+
+  /// @internal The number of elements the buffer holds (zero, or a power of
+  /// two).
+  size_t _capacity;
+
+  /// @internal The slot of the first element.
+  size_t _head;
+
+  /// @internal The number of elements.
+  size_t _len;
+
+  /// @internal The size of an element.
+  size_t _data_size;
+  /// @endcond
+} act_Deque;
+
+/// @brief A contiguous run of the elements of an #act_Deque.
+///
+/// @sa #act_dequeSpans
+typedef struct act_DequeSpan {
+  /// The first element of the run.
+  void *data;
+
+  /// The number of elements in the run.
+  size_t len;
+} act_DequeSpan;
+
+/// @brief The possible error values.
+typedef enum act_DequeError {
+  /// Successful operation.
+  ACT_DEQUE_ERROR_SUCCESS = 0x0,
+
+  /// The given deque was **NULL**.
+  ACT_DEQUE_ERROR_NULL_DEQUE,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_DEQUE_ERROR_NULL_ALLOCATOR,
+
+  /// The given element (or output) was **NULL**.
+  ACT_DEQUE_ERROR_NULL_ELEMENT,
+
+  /// A failure during allocation.
+  ACT_DEQUE_ERROR_ALLOCATION_FAILED,
+
+  /// The deque was empty.
+  ACT_DEQUE_ERROR_EMPTY,
+
+  /// The index was past the end of the deque.
+  ACT_DEQUE_ERROR_OUT_OF_BOUNDS,
+
+  /// The data size was zero.
+  ACT_DEQUE_ERROR_INVALID_DATA_SIZE,
+} act_DequeError;
+
+/// @brief Creates a new, empty #act_Deque.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  data_size   The size of an element.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @return A new, empty deque.
+///
+/// @note This function does not allocate any memory until the first push.
+///
+/// @sa #act_dequeFree, #ACT_DEQUE_NEW
+act_Deque act_dequeNew(const act_Allocator *allocator, size_t data_size,
+                       int *error_code);
+
+/// @brief Frees all memory allocated by the #act_Deque.
+///
+/// @param[in]  deque       The deque to free.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+void act_dequeFree(act_Deque *deque, int *error_code);
+
+/// @brief Returns the number of elements in the #act_Deque.
+///
+/// @param deque The deque to get the length of.
+///
+/// @return The number of elements.
+size_t act_dequeLen(const act_Deque *deque);
+
+/// @brief Returns the number of elements the #act_Deque can hold before it
+/// grows.
+///
+/// @param deque The deque to get the capacity of.
+///
+/// @return The capacity (zero, or a power of two).
+size_t act_dequeCapacity(const act_Deque *deque);
+
+/// @brief Ensures the #act_Deque has room for @em additional more elements.
+///
+/// @param[in]  deque       The deque to reserve space in.
+/// @param[in]  additional  The number of elements to make room for, past the
+///                         current length.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates a new buffer (and frees the old
+/// one) if the capacity is too small.
+void act_dequeReserve(act_Deque *deque, size_t additional, int *error_code);
+
+/// @brief Copies an element onto the back of the #act_Deque.
+///
+/// @param[in]  deque       The deque to push to.
+/// @param[in]  element     The element (of the deque's data size) to copy in.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the deque is full.
+///
+/// @sa #act_dequePopFront, #act_dequePushBackMany
+void act_dequePushBack(act_Deque *deque, const void *element, int *error_code);
+
+/// @brief Copies an element onto the front of the #act_Deque.
+///
+/// @param[in]  deque       The deque to push to.
+/// @param[in]  element     The element (of the deque's data size) to copy in.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the deque is full.
+///
+/// @sa #act_dequePopBack
+void act_dequePushFront(act_Deque *deque, const void *element,
+                        int *error_code);
+
+/// @brief Removes the element at the back of the #act_Deque.
+///
+/// @param[in]  deque       The deque to pop from.
+/// @param[out] element     Where to copy the element (may be **NULL**).
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation; #ACT_DEQUE_ERROR_EMPTY if the deque was
+///                         empty.
+///
+/// @return **true** if an element was removed, **false** if the deque was
+/// empty.
+bool act_dequePopBack(act_Deque *deque, void *element, int *error_code);
+
+/// @brief Removes the element at the front of the #act_Deque.
+///
+/// @param[in]  deque       The deque to pop from.
+/// @param[out] element     Where to copy the element (may be **NULL**).
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation; #ACT_DEQUE_ERROR_EMPTY if the deque was
+///                         empty.
+///
+/// @return **true** if an element was removed, **false** if the deque was
+/// empty.
+bool act_dequePopFront(act_Deque *deque, void *element, int *error_code);
+
+/// @brief Returns the element at @em idx of the #act_Deque, counting from the
+/// front.
+///
+/// @param[in]  deque       The deque to index.
+/// @param[in]  idx         The index of the element.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @return A pointer to the element, valid until the deque is next modified,
+/// or **NULL** if @em idx is out of bounds.
+void *act_dequeAt(const act_Deque *deque, size_t idx, int *error_code);
+
+/// @brief Copies @em count elements onto the back of the #act_Deque, in
+/// order.
+///
+/// @param[in]  deque       The deque to push to.
+/// @param[in]  elements    The elements to copy in.
+/// @param[in]  count       The number of elements.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory, at most once.
+void act_dequePushBackMany(act_Deque *deque, const void *elements,
+                           size_t count, int *error_code);
+
+/// @brief Removes up to @em max elements from the front of the #act_Deque,
+/// copying them out in order.
+///
+/// @param[in]  deque       The deque to pop from.
+/// @param[out] elements    Where to copy the elements (may be **NULL**, to
+///                         discard them).
+/// @param[in]  max         The max number of elements to remove.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @return The number of elements removed.
+size_t act_dequePopFrontMany(act_Deque *deque, void *elements, size_t max,
+                             int *error_code);
+
+/// @brief Returns the elements of the #act_Deque as two contiguous spans, in
+/// order: the elements of @em first are followed by those of @em second.
+///
+/// The second span is empty unless the elements wrap around the end of the
+/// buffer. The spans are valid until the deque is next modified.
+///
+/// @param[in]  deque   The deque to get the elements of.
+/// @param[out] first   The span of the front elements.
+/// @param[out] second  The span of the rest of the elements.
+void act_dequeSpans(const act_Deque *deque, act_DequeSpan *first,
+                    act_DequeSpan *second);
+
+/// @brief Removes all elements of the #act_Deque, keeping its capacity.
+///
+/// @param deque The deque to clear.
+void act_dequeClear(act_Deque *deque);
+
+/// @brief Create a new #act_Deque that stores elements of type @em T.
+///
+/// This macro calls #act_dequeNew with the size of @em T.
+///
+/// @param[in]  T           The type of the elements.
+/// @param[in]  allocator   The #act_Allocator used for internal allocations.
+/// @param[out] error_code  The error code (#act_DequeError) of the
+///                         operation.
+///
+/// @return A new, empty deque.
+///
+/// @sa #act_dequeFree
+#define ACT_DEQUE_NEW(T, allocator, error_code)                                \
+  act_dequeNew(allocator, sizeof(T), error_code)
+
+#endif /* !ACT_DEQUE_H */
@@ -0,0 +1,381 @@
+#include "act_flat_map.h"
+#include <string.h>
+
+/// The alignment of the keys and values in a sorted copy of a batch, so the
+/// comparator can read the keys in place.
+#define ACT__FLAT_MAP_RECORD_ALIGN 16
+
+/// Returns a pointer to the key at @em idx.
+static inline char *act__flatMapKeyAt(const act_FlatMap *map, size_t idx) {
+  return (char *)map->_keys + idx * map->_key_size;
+}
+
+/// Returns a pointer to the value at @em idx.
+static inline char *act__flatMapValueAt(const act_FlatMap *map, size_t idx) {
+  return (char *)map->_values + idx * map->_value_size;
+}
+
+/// Rebuilds the index over the keys, if the map is looked up with one.
+///
+/// The entries are already changed when this runs, so a failed rebuild is
+/// not an error: lookups fall back to binary searches without an index, until
+/// the next change rebuilds it.
+static void act__flatMapReindex(act_FlatMap *map) {
+  if (map->_lookup != ACT_FLAT_MAP_LOOKUP_EYTZINGER) {
+    return;
+  }
+
+  int sorted_err = ACT_SORTED_ERROR_SUCCESS;
+  act_eytzingerIndexFree(&map->_index, &sorted_err);
+  map->_index = act_eytzingerIndexNew(map->_keys, map->_compare, &sorted_err);
+  if (sorted_err != ACT_SORTED_ERROR_SUCCESS) {
+    map->_index = (act_EytzingerIndex){0};
+  }
+}
+
+/// Returns the index of the first key not less than @em key, and whether it
+/// is equal to it.
+static size_t act__flatMapFind(const act_FlatMap *map, const void *key,
+                               bool *found) {
+  int sorted_err = ACT_SORTED_ERROR_SUCCESS;
+  if (map->_index._data != NULL) {
+    const void *element =
+        act_eytzingerIndexLowerBound(&map->_index, key, &sorted_err);
+    if (element == NULL) {
+      *found = false;
+      return act_flatMapLen(map);
+    }
+    *found = map->_compare(element, key) == 0;
+    return act_eytzingerIndexRank(&map->_index, element, &sorted_err);
+  }
+
+  size_t idx = 0;
+  *found =
+      act_vectorBinarySearch(map->_keys, key, map->_compare, &idx, &sorted_err);
+  return idx;
+}
+
+act_FlatMap act_flatMapNew(const act_Allocator *allocator, size_t key_size,
+                           size_t value_size, act_SortCompareFn compare,
+                           act_FlatMapLookup lookup, int *error_code) {
+  *error_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_ALLOCATOR;
+    return (act_FlatMap){0};
+  }
+  if (key_size == 0) {
+    *error_code = ACT_FLAT_MAP_ERROR_INVALID_KEY_SIZE;
+    return (act_FlatMap){0};
+  }
+  if (compare == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_COMPARATOR;
+    return (act_FlatMap){0};
+  }
+  if (lookup != ACT_FLAT_MAP_LOOKUP_BINARY &&
+      lookup != ACT_FLAT_MAP_LOOKUP_EYTZINGER) {
+    *error_code = ACT_FLAT_MAP_ERROR_INVALID_LOOKUP;
+    return (act_FlatMap){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *keys = act_vectorNew(allocator, key_size, &vec_err);
+  act_Vector *values = act_vectorNew(allocator, value_size, &vec_err);
+  if (keys == NULL || values == NULL) {
+    if (keys != NULL) {
+      act_vectorFree(keys, &vec_err);
+    }
+    *error_code = ACT_FLAT_MAP_ERROR_ALLOCATION_FAILED;
+    return (act_FlatMap){0};
+  }
+
+  act_FlatMap map = {
+      ._allocator = allocator,
+      ._keys = keys,
+      ._values = values,
+      ._key_size = key_size,
+      ._value_size = value_size,
+      ._compare = compare,
+      ._lookup = lookup,
+  };
+  act__flatMapReindex(&map);
+
+  return map;
+}
+
+void act_flatMapFree(act_FlatMap *map, int *error_code) {
+  *error_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_MAP;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (map->_keys != NULL) {
+    act_vectorFree(map->_keys, &vec_err);
+    act_vectorFree(map->_values, &vec_err);
+  }
+  int sorted_err = ACT_SORTED_ERROR_SUCCESS;
+  act_eytzingerIndexFree(&map->_index, &sorted_err);
+
+  *map = (act_FlatMap){0};
+}
+
+size_t act_flatMapLen(const act_FlatMap *map) {
+  if (map->_keys == NULL) {
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  return act_vectorLen(map->_keys, &vec_err);
+}
+
+bool act_flatMapInsert(act_FlatMap *map, const void *key, const void *value,
+                       int *error_code) {
+  *error_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL || map->_keys == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (key == NULL || (value == NULL && map->_value_size != 0)) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  bool found = false;
+  size_t idx = act__flatMapFind(map, key, &found);
+  if (found) {
+    if (map->_value_size != 0) {
+      memcpy(act__flatMapValueAt(map, idx), value, map->_value_size);
+    }
+    return false;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *keys = act_vectorReserve(map->_keys, 1, &vec_err);
+  if (keys == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_ALLOCATION_FAILED;
+    return false;
+  }
+  map->_keys = keys;
+  act_Vector *values = act_vectorReserve(map->_values, 1, &vec_err);
+  if (values == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_ALLOCATION_FAILED;
+    return false;
+  }
+  map->_values = values;
+
+  // Shift the entries after the key up by one
+  size_t len = act_flatMapLen(map);
+  memmove(act__flatMapKeyAt(map, idx + 1), act__flatMapKeyAt(map, idx),
+          (len - idx) * map->_key_size);
+  memmove(act__flatMapValueAt(map, idx + 1), act__flatMapValueAt(map, idx),
+          (len - idx) * map->_value_size);
+  memcpy(act__flatMapKeyAt(map, idx), key, map->_key_size);
+  if (map->_value_size != 0) {
+    memcpy(act__flatMapValueAt(map, idx), value, map->_value_size);
+  }
+  act__vectorSetLen(map->_keys, len + 1, &vec_err);
+  act__vectorSetLen(map->_values, len + 1, &vec_err);
+
+  act__flatMapReindex(map);
+  return true;
+}
+
+size_t act_flatMapInsertBatch(act_FlatMap *map, const act_Vector *keys,
+                              const act_Vector *values, int *error_code) {
+  *error_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL || map->_keys == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_MAP;
+    return 0;
+  }
+  if (keys == NULL || (values == NULL && map->_value_size != 0)) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_KEY;
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t key_size = map->_key_size;
+  const size_t value_size = map->_value_size;
+  size_t batch_len = act_vectorLen(keys, &vec_err);
+  if (act_vectorDataSize(keys, &vec_err) != key_size ||
+      (values != NULL &&
+       (act_vectorDataSize(values, &vec_err) != value_size ||
+        act_vectorLen(values, &vec_err) != batch_len))) {
+    *error_code = ACT_FLAT_MAP_ERROR_INVALID_BATCH;
+    return 0;
+  }
+  if (batch_len == 0) {
+    return 0;
+  }
+
+  // Sort a copy of the batch as (key, value) records, keeping the order of
+  // equal keys so the last one can win
+  const size_t align = ACT__FLAT_MAP_RECORD_ALIGN;
+  const size_t value_offset = (key_size + align - 1) / align * align;
+  const size_t record_size =
+      (value_offset + value_size + align - 1) / align * align;
+  act_Vector *records = act_vectorWithCapacity(map->_allocator, record_size,
+                                                batch_len, &vec_err);
+  if (records == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_ALLOCATION_FAILED;
+    return 0;
+  }
+  for (size_t i = 0; i < batch_len; i++) {
+    char *record = (char *)records + i * record_size;
+    memcpy(record, (const char *)keys + i * key_size, key_size);
+    if (value_size != 0) {
+      memcpy(record + value_offset, (const char *)values + i * value_size,
+             value_size);
+    }
+  }
+  act__vectorSetLen(records, batch_len, &vec_err);
+
+  int sort_err = ACT_SORT_ERROR_SUCCESS;
+  act_vectorSortStable(records, map->_compare, &sort_err);
+
+  size_t len = act_flatMapLen(map);
+  act_Vector *new_keys = act_vectorWithCapacity(map->_allocator, key_size,
+                                                len + batch_len, &vec_err);
+  act_Vector *new_values = act_vectorWithCapacity(
+      map->_allocator, value_size, len + batch_len, &vec_err);
+  if (sort_err != ACT_SORT_ERROR_SUCCESS || new_keys == NULL ||
+      new_values == NULL) {
+    if (new_keys != NULL) {
+      act_vectorFree(new_keys, &vec_err);
+    }
+    if (new_values != NULL) {
+      act_vectorFree(new_values, &vec_err);
+    }
+    act_vectorFree(records, &vec_err);
+    *error_code = ACT_FLAT_MAP_ERROR_ALLOCATION_FAILED;
+    return 0;
+  }
+
+  // Merge the entries and the batch in a single pass
+  act_SortCompareFn compare = map->_compare;
+  char *out_key = (char *)new_keys;
+  char *out_value = (char *)new_values;
+  size_t added = 0;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < len || j < batch_len) {
+    // Negative to take the next entry, positive to take the next record of
+    // the batch, and zero if their keys are equal
+    const char *record = (const char *)records + j * record_size;
+    int order = 1;
+    if (j == batch_len) {
+      order = -1;
+    } else if (i < len) {
+      order = compare(act__flatMapKeyAt(map, i), record);
+    }
+
+    if (order < 0) {
+      memcpy(out_key, act__flatMapKeyAt(map, i), key_size);
+      memcpy(out_value, act__flatMapValueAt(map, i), value_size);
+      i++;
+    } else {
+      // Skip to the last of a run of equal keys in the batch
+      while (j + 1 < batch_len &&
+             compare(record, record + record_size) == 0) {
+        record += record_size;
+        j++;
+      }
+      memcpy(out_key, record, key_size);
+      memcpy(out_value, record + value_offset, value_size);
+      added += order > 0;
+      i += order == 0;
+      j++;
+    }
+    out_key += key_size;
+    out_value += value_size;
+  }
+
+  size_t new_len = (size_t)(out_key - (char *)new_keys) / key_size;
+  act__vectorSetLen(new_keys, new_len, &vec_err);
+  act__vectorSetLen(new_values, new_len, &vec_err);
+  act_vectorFree(map->_keys, &vec_err);
+  act_vectorFree(map->_values, &vec_err);
+  act_vectorFree(records, &vec_err);
+  map->_keys = new_keys;
+  map->_values = new_values;
+
+  act__flatMapReindex(map);
+  return added;
+}
+
+void *act_flatMapGet(const act_FlatMap *map, const void *key,
+                     int *error_code) {
+  *error_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL || map->_keys == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_MAP;
+    return NULL;
+  }
+  if (key == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_KEY;
+    return NULL;
+  }
+
+  bool found = false;
+  size_t idx = act__flatMapFind(map, key, &found);
+  if (!found) {
+    *error_code = ACT_FLAT_MAP_ERROR_NOT_FOUND;
+    return NULL;
+  }
+  return act__flatMapValueAt(map, idx);
+}
+
+bool act_flatMapContains(const act_FlatMap *map, const void *key) {
+  int err = ACT_FLAT_MAP_ERROR_SUCCESS;
+  act_flatMapGet(map, key, &err);
+  return err == ACT_FLAT_MAP_ERROR_SUCCESS;
+}
+
+bool act_flatMapRemove(act_FlatMap *map, const void *key, void *value,
+                       int *error_code) {
+  *error_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  if (map == NULL || map->_keys == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (key == NULL) {
+    *error_code = ACT_FLAT_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  bool found = false;
+  size_t idx = act__flatMapFind(map, key, &found);
+  if (!found) {
+    *error_code = ACT_FLAT_MAP_ERROR_NOT_FOUND;
+    return false;
+  }
+  if (value != NULL) {
+    memcpy(value, act__flatMapValueAt(map, idx), map->_value_size);
+  }
+
+  // Shift the entries after the key down by one
+  size_t len = act_flatMapLen(map);
+  memmove(act__flatMapKeyAt(map, idx), act__flatMapKeyAt(map, idx + 1),
+          (len - idx - 1) * map->_key_size);
+  memmove(act__flatMapValueAt(map, idx), act__flatMapValueAt(map, idx + 1),
+          (len - idx - 1) * map->_value_size);
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act__vectorSetLen(map->_keys, len - 1, &vec_err);
+  act__vectorSetLen(map->_values, len - 1, &vec_err);
+
+  act__flatMapReindex(map);
+  return true;
+}
+
+const act_Vector *act_flatMapKeys(const act_FlatMap *map) {
+  return map->_keys;
+}
+
+act_Vector *act_flatMapValues(const act_FlatMap *map) {
+  return map->_values;
+}
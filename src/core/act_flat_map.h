@@ -0,0 +1,258 @@
+#ifndef ACT_FLAT_MAP_H
+#define ACT_FLAT_MAP_H
+
+#include "act_allocator.h"
+#include "act_sort.h"
+#include "act_sorted.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_flat_map.h
+///
+/// This header defines a map stored as two parallel #act_Vector, of keys in
+/// sorted order and of their values, with generic key and value sizes.
+///
+/// A flat map has no per-entry overhead besides the key and value, and
+/// iterating over it is a walk over two arrays, in key order. Lookups are
+/// binary searches; inserting or removing a single entry moves every entry
+/// after it, so maps that change are best filled by
+/// #act_flatMapInsertBatch, which sorts the batch and merges it with the
+/// existing entries in a single pass.
+///
+/// For read-mostly maps, lookups can instead go through an
+/// #act_EytzingerIndex over the keys, which is rebuilt after every change. If
+/// a rebuild runs out of memory, the change still succeeds and lookups fall
+/// back to binary searches until the next change.
+
+/// @brief How an #act_FlatMap looks up keys.
+typedef enum act_FlatMapLookup {
+  /// A branchless binary search over the sorted keys.
+  ACT_FLAT_MAP_LOOKUP_BINARY,
+
+  /// A search of an #act_EytzingerIndex over the keys, at the cost of a copy
+  /// of the keys.
+  ACT_FLAT_MAP_LOOKUP_EYTZINGER,
+} act_FlatMapLookup;
+
+/// @brief **[PRIVATE]** A sorted map stored in parallel vectors.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_flatMapInsertBatch, #act_flatMapGet, #act_flatMapKeys
+typedef struct act_FlatMap {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The keys, in sorted order.
+  act_Vector *_keys;
+
+  /// @internal The values, in the order of their keys.
+  act_Vector *_values;
+
+  /// @internal The size of a key.
+  size_t _key_size;
+
+  /// @internal The size of a value.
+  size_t _value_size;
+
+  /// @internal The comparator that orders the keys.
+  act_SortCompareFn _compare;
+
+  /// @internal How keys are looked up.
+  act_FlatMapLookup _lookup;
+
+  /// @internal The index over the keys (empty unless looked up with one, or
+  /// if it couldn't be built).
+  act_EytzingerIndex _index;
+  /// @endcond
+} act_FlatMap;
+
+/// @brief The possible error values.
+typedef enum act_FlatMapError {
+  /// Successful operation.
+  ACT_FLAT_MAP_ERROR_SUCCESS = 0x0,
+
+  /// The given map was **NULL**.
+  ACT_FLAT_MAP_ERROR_NULL_MAP,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_FLAT_MAP_ERROR_NULL_ALLOCATOR,
+
+  /// The given key, value or batch was **NULL**.
+  ACT_FLAT_MAP_ERROR_NULL_KEY,
+
+  /// The given comparator was **NULL**.
+  ACT_FLAT_MAP_ERROR_NULL_COMPARATOR,
+
+  /// A failure during allocation.
+  ACT_FLAT_MAP_ERROR_ALLOCATION_FAILED,
+
+  /// The key is not in the map.
+  ACT_FLAT_MAP_ERROR_NOT_FOUND,
+
+  /// The key size was zero.
+  ACT_FLAT_MAP_ERROR_INVALID_KEY_SIZE,
+
+  /// The lookup was not one of #act_FlatMapLookup.
+  ACT_FLAT_MAP_ERROR_INVALID_LOOKUP,
+
+  /// The batch's vectors have different lengths, or elements of the wrong
+  /// size.
+  ACT_FLAT_MAP_ERROR_INVALID_BATCH,
+} act_FlatMapError;
+
+/// @brief Creates a new, empty #act_FlatMap.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  key_size    The size of a key.
+/// @param[in]  value_size  The size of a value (may be zero for a set).
+/// @param[in]  compare     The comparator that orders the keys.
+/// @param[in]  lookup      How keys are looked up.
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation.
+///
+/// @return A new, empty map.
+///
+/// @note This function allocates the (empty) key and value vectors.
+///
+/// @sa #act_flatMapFree, #ACT_FLAT_MAP_NEW
+act_FlatMap act_flatMapNew(const act_Allocator *allocator, size_t key_size,
+                           size_t value_size, act_SortCompareFn compare,
+                           act_FlatMapLookup lookup, int *error_code);
+
+/// @brief Frees all memory allocated by the #act_FlatMap.
+///
+/// @param[in]  map         The map to free.
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation.
+void act_flatMapFree(act_FlatMap *map, int *error_code);
+
+/// @brief Returns the number of entries in the #act_FlatMap.
+///
+/// @param map The map to get the length of.
+///
+/// @return The number of entries.
+size_t act_flatMapLen(const act_FlatMap *map);
+
+/// @brief Inserts a key and value into the #act_FlatMap, overwriting the
+/// value if the key already exists, in O(n).
+///
+/// @param[in]  map         The map to insert into.
+/// @param[in]  key         The key (of the map's key size) to copy in.
+/// @param[in]  value       The value (of the map's value size) to copy in.
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation.
+///
+/// @return **true** if the key was new, **false** if its value was replaced.
+///
+/// @note This function @em possibly allocates memory if the map grows, and
+/// rebuilds the index if the map has one.
+///
+/// @sa #act_flatMapInsertBatch
+bool act_flatMapInsert(act_FlatMap *map, const void *key, const void *value,
+                       int *error_code);
+
+/// @brief Inserts a batch of keys and values into the #act_FlatMap,
+/// overwriting the values of keys that already exist, in
+/// O(n + m log m).
+///
+/// The batch is sorted, then merged with the entries of the map in a single
+/// pass. If a key is in the batch more than once, its last value wins.
+///
+/// @param[in]  map         The map to insert into.
+/// @param[in]  keys        The keys to insert.
+/// @param[in]  values      The values of the keys, in the same order (may be
+///                         **NULL** if the map's value size is zero).
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation.
+///
+/// @return The number of keys that were new.
+///
+/// @note This function allocates a sorted copy of the batch, and new key and
+/// value vectors with room for the entries of both; it rebuilds the index if
+/// the map has one.
+size_t act_flatMapInsertBatch(act_FlatMap *map, const act_Vector *keys,
+                              const act_Vector *values, int *error_code);
+
+/// @brief Looks up the value of a key in the #act_FlatMap, in O(log n).
+///
+/// @param[in]  map         The map to search.
+/// @param[in]  key         The key to look for.
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation; #ACT_FLAT_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return A pointer to the value, valid until the map is next modified, or
+/// **NULL** if the key is not in the map.
+void *act_flatMapGet(const act_FlatMap *map, const void *key,
+                     int *error_code);
+
+/// @brief Checks if the #act_FlatMap contains the given key.
+///
+/// @param map The map to search.
+/// @param key The key to look for.
+///
+/// @return **true** if the key is in the map, **false** otherwise.
+bool act_flatMapContains(const act_FlatMap *map, const void *key);
+
+/// @brief Removes a key (and its value) from the #act_FlatMap, in O(n).
+///
+/// @param[in]  map         The map to remove from.
+/// @param[in]  key         The key to remove.
+/// @param[out] value       Where to copy the removed value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation; #ACT_FLAT_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return **true** if the key was removed, **false** if it was not found.
+///
+/// @note This function rebuilds the index if the map has one.
+bool act_flatMapRemove(act_FlatMap *map, const void *key, void *value,
+                       int *error_code);
+
+/// @brief Returns the keys of the #act_FlatMap, in sorted order.
+///
+/// @param map The map to get the keys of.
+///
+/// @return The vector of keys, valid until the map is next modified.
+///
+/// @sa #act_flatMapValues
+const act_Vector *act_flatMapKeys(const act_FlatMap *map);
+
+/// @brief Returns the values of the #act_FlatMap, in the order of their keys.
+///
+/// The values may be changed in place.
+///
+/// @param map The map to get the values of.
+///
+/// @return The vector of values, valid until the map is next modified.
+///
+/// @sa #act_flatMapKeys
+act_Vector *act_flatMapValues(const act_FlatMap *map);
+
+/// @brief Create a new #act_FlatMap with keys of type @em K and values of type
+/// @em V.
+///
+/// This macro calls #act_flatMapNew with the sizes of @em K and @em V.
+///
+/// @param[in]  K           The type of the keys.
+/// @param[in]  V           The type of the values.
+/// @param[in]  compare     The comparator that orders the keys.
+/// @param[in]  lookup      How keys are looked up.
+/// @param[in]  allocator   The #act_Allocator used for internal allocations.
+/// @param[out] error_code  The error code (#act_FlatMapError) of the
+///                         operation.
+///
+/// @return A new, empty map.
+///
+/// @sa #act_flatMapFree
+#define ACT_FLAT_MAP_NEW(K, V, compare, lookup, allocator, error_code)         \
+  act_flatMapNew(allocator, sizeof(K), sizeof(V), compare, lookup, error_code)
+
+#endif /* !ACT_FLAT_MAP_H */
@@ -0,0 +1,123 @@
+#include "act_hash.h"
+#include <string.h>
+
+/// The secret constants of the hash (the default wyhash secret).
+static const uint64_t HASH_SECRET[4] = {
+    0x2d358dccaa6c78a5ULL,
+    0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL,
+    0x4d5a2da51de1aa47ULL,
+};
+
+/// Computes the full 128-bit product of @a a and @a b, returning the low half
+/// in @a a and the high half in @a b.
+static inline void act__hashMultiply(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t product = (__uint128_t)*a * *b;
+  *a = (uint64_t)product;
+  *b = (uint64_t)(product >> 64);
+#else
+  uint64_t a_hi = *a >> 32;
+  uint64_t a_lo = (uint32_t)*a;
+  uint64_t b_hi = *b >> 32;
+  uint64_t b_lo = (uint32_t)*b;
+  uint64_t hh = a_hi * b_hi;
+  uint64_t hl = a_hi * b_lo;
+  uint64_t lh = a_lo * b_hi;
+  uint64_t ll = a_lo * b_lo;
+  uint64_t mid = (ll >> 32) + (uint32_t)hl + (uint32_t)lh;
+  *a = (mid << 32) | (uint32_t)ll;
+  *b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif
+}
+
+/// Multiplies @a a and @a b and folds the 128-bit product into 64 bits.
+static inline uint64_t act__hashMix(uint64_t a, uint64_t b) {
+  act__hashMultiply(&a, &b);
+  return a ^ b;
+}
+
+/// Reads 8 little-endian bytes.
+static inline uint64_t act__hashRead8(const uint8_t *p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+/// Reads 4 little-endian bytes.
+static inline uint64_t act__hashRead4(const uint8_t *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap32(value);
+#endif
+  return value;
+}
+
+uint64_t act_hashBytes(const void *data, size_t len, uint64_t seed) {
+  const uint8_t *p = data;
+  seed ^= act__hashMix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+
+  uint64_t a = 0;
+  uint64_t b = 0;
+  if (len <= 16) {
+    // Two (possibly overlapping) reads from each end cover every byte
+    if (len >= 4) {
+      size_t offset = (len >> 3) << 2;
+      a = (act__hashRead4(p) << 32) | act__hashRead4(p + offset);
+      b = (act__hashRead4(p + len - 4) << 32) |
+          act__hashRead4(p + len - 4 - offset);
+    } else if (len > 0) {
+      a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+    }
+  } else {
+    size_t remaining = len;
+
+    // Three independent lanes keep the multipliers busy on long inputs
+    if (remaining >= 48) {
+      uint64_t seed1 = seed;
+      uint64_t seed2 = seed;
+      do {
+        seed = act__hashMix(act__hashRead8(p) ^ HASH_SECRET[1],
+                            act__hashRead8(p + 8) ^ seed);
+        seed1 = act__hashMix(act__hashRead8(p + 16) ^ HASH_SECRET[2],
+                             act__hashRead8(p + 24) ^ seed1);
+        seed2 = act__hashMix(act__hashRead8(p + 32) ^ HASH_SECRET[3],
+                             act__hashRead8(p + 40) ^ seed2);
+        p += 48;
+        remaining -= 48;
+      } while (remaining >= 48);
+      seed ^= seed1 ^ seed2;
+    }
+
+    while (remaining > 16) {
+      seed = act__hashMix(act__hashRead8(p) ^ HASH_SECRET[1],
+                          act__hashRead8(p + 8) ^ seed);
+      p += 16;
+      remaining -= 16;
+    }
+
+    // The last 16 bytes (overlapping the previous block if needed)
+    a = act__hashRead8(p + remaining - 16);
+    b = act__hashRead8(p + remaining - 8);
+  }
+
+  a ^= HASH_SECRET[1];
+  b ^= seed;
+  act__hashMultiply(&a, &b);
+  return act__hashMix(a ^ HASH_SECRET[0] ^ len, b ^ HASH_SECRET[1]);
+}
+
+uint64_t act_hashU64(uint64_t value, uint64_t seed) {
+  uint64_t a = value ^ HASH_SECRET[0];
+  uint64_t b = seed ^ HASH_SECRET[1];
+  act__hashMultiply(&a, &b);
+  return act__hashMix(a ^ HASH_SECRET[0], b ^ HASH_SECRET[1]);
+}
+
+uint64_t act_hashCombine(uint64_t hash1, uint64_t hash2) {
+  return act_hashU64(hash2, hash1);
+}
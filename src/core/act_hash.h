@@ -0,0 +1,50 @@
+#ifndef ACT_HASH_H
+#define ACT_HASH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_hash.h
+///
+/// This header defines fast, non-cryptographic hash functions for building
+/// hash tables.
+///
+/// The byte hash follows the construction of wyhash (final version 4): inputs
+/// are consumed 48 bytes at a time through three independent 64x64 -> 128-bit
+/// multiply-and-fold lanes, and short inputs take a branch-light path with
+/// overlapping reads. The hashes are @em not suitable for cryptographic use,
+/// and should be seeded with a random value where an attacker controls the
+/// keys.
+
+/// The seed used by the hash functions that do not take one.
+#define ACT_HASH_DEFAULT_SEED 0
+
+/// @brief Hashes the given bytes.
+///
+/// @param data The bytes to hash (may be **NULL** if @a len is zero).
+/// @param len  The number of bytes to hash.
+/// @param seed The seed of the hash; different seeds give independent hashes.
+///
+/// @return The 64-bit hash of @a data.
+uint64_t act_hashBytes(const void *data, size_t len, uint64_t seed);
+
+/// @brief Hashes the given 64-bit integer.
+///
+/// This is much cheaper than hashing the integer's bytes with
+/// #act_hashBytes, but every input bit still affects every output bit.
+///
+/// @param value  The integer to hash.
+/// @param seed   The seed of the hash.
+///
+/// @return The 64-bit hash of @a value.
+uint64_t act_hashU64(uint64_t value, uint64_t seed);
+
+/// @brief Combines two hashes into one (e.g. to hash a composite key).
+///
+/// @param hash1  The first hash.
+/// @param hash2  The second hash.
+///
+/// @return A hash depending on both hashes (and their order).
+uint64_t act_hashCombine(uint64_t hash1, uint64_t hash2);
+
+#endif /* !ACT_HASH_H */
@@ -0,0 +1,621 @@
+#include "act_hash_map.h"
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/// The number of control bytes scanned at a time.
+#define HASH_MAP_GROUP_WIDTH 16
+
+/// The control byte of an empty slot (full slots have the high bit clear).
+static const uint8_t HASH_MAP_EMPTY = 0x80;
+
+/// The number of slots allocated for the first insertion.
+static const size_t HASH_MAP_MIN_CAPACITY = HASH_MAP_GROUP_WIDTH;
+
+/// Returns the slot a hash starts probing from.
+static inline size_t act__hashMapHome(const act_HashMap *map, uint64_t hash) {
+  return (size_t)(hash >> 7) & (map->_capacity - 1);
+}
+
+/// Returns the control byte stored for a hash.
+static inline uint8_t act__hashMapTag(uint64_t hash) {
+  return (uint8_t)(hash & 0x7F);
+}
+
+/// Returns the number of trailing zero bits of a non-zero mask.
+static inline unsigned act__hashMapTrailingZeros(uint32_t mask) {
+  return (unsigned)__builtin_ctz(mask);
+}
+
+/// Compares a group of control bytes against @a tag, returning a bitmask of
+/// the matching slots in @a match, and of the empty slots in @a empty.
+static inline void act__hashMapScanGroup(const uint8_t *ctrl, uint8_t tag,
+                                         uint32_t *match, uint32_t *empty) {
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  *match = (uint32_t)_mm_movemask_epi8(
+      _mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+  *empty = (uint32_t)_mm_movemask_epi8(group);
+#else
+  *match = 0;
+  *empty = 0;
+  for (uint32_t i = 0; i < HASH_MAP_GROUP_WIDTH; i++) {
+    *match |= (uint32_t)(ctrl[i] == tag) << i;
+    *empty |= (uint32_t)(ctrl[i] >> 7) << i;
+  }
+#endif
+}
+
+/// Sets the control byte of a slot, keeping the mirrored group in sync.
+static inline void act__hashMapSetCtrl(act_HashMap *map, size_t slot,
+                                       uint8_t ctrl) {
+  map->_ctrl[slot] = ctrl;
+  if (slot < HASH_MAP_GROUP_WIDTH - 1) {
+    map->_ctrl[map->_capacity + slot] = ctrl;
+  }
+}
+
+/// Returns a pointer to the key of a slot.
+static inline char *act__hashMapKeyAt(const act_HashMap *map, size_t slot) {
+  return map->_keys + slot * map->_key_size;
+}
+
+/// Returns a pointer to the value of a slot.
+static inline char *act__hashMapValueAt(const act_HashMap *map, size_t slot) {
+  return map->_values + slot * map->_value_size;
+}
+
+/// Returns the contents of a slot's key.
+static inline act_StringView act__hashMapKeyView(const act_HashMap *map,
+                                                 size_t slot) {
+  const char *key = act__hashMapKeyAt(map, slot);
+  if (map->_string_keys) {
+    return act_stringAsView(*(const act_String *)key);
+  }
+  return (act_StringView){.data = key, .len = map->_key_size};
+}
+
+/// Returns the hash of a slot's key (cached for string keys).
+static uint64_t act__hashMapSlotHash(const act_HashMap *map, size_t slot) {
+  char *key = act__hashMapKeyAt(map, slot);
+  if (map->_string_keys) {
+    return act_stringHash((act_String *)key);
+  }
+  return act_hashBytes(key, map->_key_size, ACT_HASH_DEFAULT_SEED);
+}
+
+/// Finds the slot holding @a key, returning `SIZE_MAX` if there is none; the
+/// empty slot where it would be inserted is returned in @a insert_slot.
+static size_t act__hashMapFind(const act_HashMap *map, act_StringView key,
+                               uint64_t hash, size_t *insert_slot) {
+  size_t mask = map->_capacity - 1;
+  uint8_t tag = act__hashMapTag(hash);
+  size_t pos = act__hashMapHome(map, hash);
+
+  // The load factor is below one, so every probe ends at an empty slot
+  for (;;) {
+    uint32_t match;
+    uint32_t empty;
+    act__hashMapScanGroup(map->_ctrl + pos, tag, &match, &empty);
+
+    // Linear probing never skips an empty slot, so only check the matches
+    // before the first one
+    if (empty != 0) {
+      match &= (empty & (0u - empty)) - 1;
+    }
+    while (match != 0) {
+      size_t slot = (pos + act__hashMapTrailingZeros(match)) & mask;
+      act_StringView slot_key = act__hashMapKeyView(map, slot);
+      if (slot_key.len == key.len &&
+          memcmp(slot_key.data, key.data, key.len) == 0) {
+        return slot;
+      }
+      match &= match - 1;
+    }
+
+    if (empty != 0) {
+      *insert_slot = (pos + act__hashMapTrailingZeros(empty)) & mask;
+      return SIZE_MAX;
+    }
+    pos = (pos + HASH_MAP_GROUP_WIDTH) & mask;
+  }
+}
+
+/// Returns the first empty slot in the probe sequence of @a hash.
+static size_t act__hashMapFindEmpty(const act_HashMap *map, uint64_t hash) {
+  size_t mask = map->_capacity - 1;
+  size_t pos = act__hashMapHome(map, hash);
+  for (;;) {
+    uint32_t match;
+    uint32_t empty;
+    act__hashMapScanGroup(map->_ctrl + pos, HASH_MAP_EMPTY, &match, &empty);
+    if (empty != 0) {
+      return (pos + act__hashMapTrailingZeros(empty)) & mask;
+    }
+    pos = (pos + HASH_MAP_GROUP_WIDTH) & mask;
+  }
+}
+
+/// Returns the maximum number of entries for the given number of slots.
+static size_t act__hashMapMaxLen(size_t capacity, float max_load_factor) {
+  size_t max_len = (size_t)((double)capacity * (double)max_load_factor);
+  return max_len < capacity ? max_len : capacity - 1;
+}
+
+/// Moves all entries into a new table with @a capacity slots.
+static void act__hashMapRehash(act_HashMap *map, size_t capacity,
+                               int *error_code) {
+  // One allocation: the control bytes, then the keys, then the values, with
+  // the arrays kept 16-byte aligned
+  size_t ctrl_size = capacity + HASH_MAP_GROUP_WIDTH;
+  size_t keys_size = (capacity * map->_key_size + 15) & ~(size_t)15;
+  size_t values_size = capacity * map->_value_size;
+  char *data = (*map->_allocator->alloc)(ctrl_size + keys_size + values_size,
+                                         sizeof(char));
+  if (data == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+  memset(data, HASH_MAP_EMPTY, ctrl_size);
+
+  act_HashMap old = *map;
+  map->_ctrl = (uint8_t *)data;
+  map->_keys = data + ctrl_size;
+  map->_values = data + ctrl_size + keys_size;
+  map->_capacity = capacity;
+
+  // Every key is unique, so entries are placed without comparing keys
+  for (size_t slot = 0; slot < old._capacity; slot++) {
+    if (old._ctrl[slot] & HASH_MAP_EMPTY) {
+      continue;
+    }
+
+    uint64_t hash = act__hashMapSlotHash(&old, slot);
+    size_t new_slot = act__hashMapFindEmpty(map, hash);
+    act__hashMapSetCtrl(map, new_slot, act__hashMapTag(hash));
+    memcpy(act__hashMapKeyAt(map, new_slot), act__hashMapKeyAt(&old, slot),
+           map->_key_size);
+    if (map->_value_size != 0) {
+      memcpy(act__hashMapValueAt(map, new_slot),
+             act__hashMapValueAt(&old, slot), map->_value_size);
+    }
+  }
+
+  if (old._ctrl != NULL) {
+    (*map->_allocator->free)(old._ctrl);
+  }
+}
+
+/// Grows the map (if needed) so that @a len entries fit.
+static void act__hashMapEnsureFits(act_HashMap *map, size_t len,
+                                   int *error_code) {
+  if (map->_capacity != 0 &&
+      len <= act__hashMapMaxLen(map->_capacity, map->_max_load_factor)) {
+    return;
+  }
+
+  size_t capacity =
+      map->_capacity == 0 ? HASH_MAP_MIN_CAPACITY : map->_capacity * 2;
+  while (len > act__hashMapMaxLen(capacity, map->_max_load_factor)) {
+    capacity *= 2;
+  }
+
+  act__hashMapRehash(map, capacity, error_code);
+}
+
+/// Removes the entry in @a slot, shifting the entries after it back so that
+/// no tombstone is needed.
+static void act__hashMapRemoveSlot(act_HashMap *map, size_t slot) {
+  size_t mask = map->_capacity - 1;
+  size_t hole = slot;
+  size_t next = slot;
+  for (;;) {
+    next = (next + 1) & mask;
+    if (map->_ctrl[next] & HASH_MAP_EMPTY) {
+      break;
+    }
+
+    // An entry can fill the hole only if its home is not after the hole
+    // (cyclically), or lookups starting at its home would miss it
+    size_t home = act__hashMapHome(map, act__hashMapSlotHash(map, next));
+    bool home_in_range = hole <= next ? (hole < home && home <= next)
+                                      : (hole < home || home <= next);
+    if (home_in_range) {
+      continue;
+    }
+
+    act__hashMapSetCtrl(map, hole, map->_ctrl[next]);
+    memcpy(act__hashMapKeyAt(map, hole), act__hashMapKeyAt(map, next),
+           map->_key_size);
+    if (map->_value_size != 0) {
+      memcpy(act__hashMapValueAt(map, hole), act__hashMapValueAt(map, next),
+             map->_value_size);
+    }
+    hole = next;
+  }
+
+  act__hashMapSetCtrl(map, hole, HASH_MAP_EMPTY);
+  map->_len--;
+}
+
+/// Inserts or updates the entry of @a key, whose hash is @a hash.
+static bool act__hashMapInsert(act_HashMap *map, act_StringView key,
+                               uint64_t hash, const void *value,
+                               int *error_code) {
+  size_t insert_slot = 0;
+  if (map->_capacity != 0) {
+    size_t slot = act__hashMapFind(map, key, hash, &insert_slot);
+    if (slot != SIZE_MAX) {
+      if (map->_value_size != 0) {
+        memcpy(act__hashMapValueAt(map, slot), value, map->_value_size);
+      }
+      return false;
+    }
+  }
+
+  // Growing moves every entry, so the insertion slot is found again
+  if (map->_capacity == 0 ||
+      map->_len + 1 > act__hashMapMaxLen(map->_capacity,
+                                         map->_max_load_factor)) {
+    act__hashMapEnsureFits(map, map->_len + 1, error_code);
+    if (*error_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+      return false;
+    }
+    insert_slot = act__hashMapFindEmpty(map, hash);
+  }
+
+  char *slot_key = act__hashMapKeyAt(map, insert_slot);
+  if (map->_string_keys) {
+    int str_err = ACT_STRING_ERROR_SUCCESS;
+    act_String owned = act_stringFromView(map->_allocator, key, &str_err);
+    if (str_err != ACT_STRING_ERROR_SUCCESS) {
+      *error_code = ACT_HASH_MAP_ERROR_ALLOCATION_FAILED;
+      return false;
+    }
+    // Seed the key's hash cache, so growing never re-hashes it
+    owned._hash = hash;
+    owned._has_hash = true;
+    memcpy(slot_key, &owned, sizeof(owned));
+  } else {
+    memcpy(slot_key, key.data, map->_key_size);
+  }
+  if (map->_value_size != 0) {
+    memcpy(act__hashMapValueAt(map, insert_slot), value, map->_value_size);
+  }
+  act__hashMapSetCtrl(map, insert_slot, act__hashMapTag(hash));
+  map->_len++;
+
+  return true;
+}
+
+/// Returns the value of @a key, whose hash is @a hash.
+static void *act__hashMapGet(const act_HashMap *map, act_StringView key,
+                             uint64_t hash, int *error_code) {
+  size_t insert_slot = 0;
+  size_t slot = map->_len == 0
+                    ? SIZE_MAX
+                    : act__hashMapFind(map, key, hash, &insert_slot);
+  if (slot == SIZE_MAX) {
+    *error_code = ACT_HASH_MAP_ERROR_NOT_FOUND;
+    return NULL;
+  }
+
+  return act__hashMapValueAt(map, slot);
+}
+
+/// Removes the entry of @a key, whose hash is @a hash.
+static bool act__hashMapRemove(act_HashMap *map, act_StringView key,
+                               uint64_t hash, void *value, int *error_code) {
+  size_t insert_slot = 0;
+  size_t slot = map->_len == 0
+                    ? SIZE_MAX
+                    : act__hashMapFind(map, key, hash, &insert_slot);
+  if (slot == SIZE_MAX) {
+    *error_code = ACT_HASH_MAP_ERROR_NOT_FOUND;
+    return false;
+  }
+
+  if (value != NULL && map->_value_size != 0) {
+    memcpy(value, act__hashMapValueAt(map, slot), map->_value_size);
+  }
+  if (map->_string_keys) {
+    int str_err = ACT_STRING_ERROR_SUCCESS;
+    act_stringFree((act_String *)act__hashMapKeyAt(map, slot), &str_err);
+  }
+  act__hashMapRemoveSlot(map, slot);
+
+  return true;
+}
+
+act_HashMap act_hashMapNew(const act_Allocator *allocator, size_t key_size,
+                           size_t value_size, int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_ALLOCATOR;
+    return (act_HashMap){0};
+  }
+  if (key_size == 0) {
+    *error_code = ACT_HASH_MAP_ERROR_INVALID_KEY_SIZE;
+    return (act_HashMap){0};
+  }
+
+  return (act_HashMap){
+      ._allocator = allocator,
+      ._key_size = key_size,
+      ._value_size = value_size,
+      ._string_keys = false,
+      ._max_load_factor = ACT_HASH_MAP_DEFAULT_MAX_LOAD_FACTOR,
+  };
+}
+
+act_HashMap act_hashMapNewStringKeys(const act_Allocator *allocator,
+                                     size_t value_size, int *error_code) {
+  act_HashMap map =
+      act_hashMapNew(allocator, sizeof(act_String), value_size, error_code);
+  map._string_keys = true;
+  return map;
+}
+
+void act_hashMapFree(act_HashMap *map, int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return;
+  }
+
+  act_hashMapClear(map, error_code);
+  if (map->_ctrl != NULL) {
+    (*map->_allocator->free)(map->_ctrl);
+  }
+
+  *map = (act_HashMap){0};
+}
+
+size_t act_hashMapLen(const act_HashMap *map) { return map->_len; }
+
+size_t act_hashMapCapacity(const act_HashMap *map) { return map->_capacity; }
+
+float act_hashMapLoadFactor(const act_HashMap *map) {
+  if (map->_capacity == 0) {
+    return 0.0f;
+  }
+  return (float)map->_len / (float)map->_capacity;
+}
+
+float act_hashMapMaxLoadFactor(const act_HashMap *map) {
+  return map->_max_load_factor;
+}
+
+void act_hashMapSetMaxLoadFactor(act_HashMap *map, float max_load_factor,
+                                 int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return;
+  }
+  if (!(max_load_factor > 0.0f && max_load_factor < 1.0f)) {
+    *error_code = ACT_HASH_MAP_ERROR_INVALID_LOAD_FACTOR;
+    return;
+  }
+
+  map->_max_load_factor = max_load_factor;
+  if (map->_capacity != 0) {
+    act__hashMapEnsureFits(map, map->_len, error_code);
+  }
+}
+
+void act_hashMapReserve(act_HashMap *map, size_t capacity, int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return;
+  }
+  if (capacity == 0) {
+    return;
+  }
+
+  act__hashMapEnsureFits(map, capacity, error_code);
+}
+
+void act_hashMapClear(act_HashMap *map, int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return;
+  }
+  if (map->_capacity == 0) {
+    return;
+  }
+
+  if (map->_string_keys) {
+    int str_err = ACT_STRING_ERROR_SUCCESS;
+    for (size_t slot = 0; slot < map->_capacity; slot++) {
+      if (!(map->_ctrl[slot] & HASH_MAP_EMPTY)) {
+        act_stringFree((act_String *)act__hashMapKeyAt(map, slot), &str_err);
+      }
+    }
+  }
+
+  memset(map->_ctrl, HASH_MAP_EMPTY, map->_capacity + HASH_MAP_GROUP_WIDTH);
+  map->_len = 0;
+}
+
+bool act_hashMapInsert(act_HashMap *map, const void *key, const void *value,
+                       int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (key == NULL || (value == NULL && map->_value_size != 0)) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+  if (map->_string_keys) {
+    *error_code = ACT_HASH_MAP_ERROR_WRONG_KEY_KIND;
+    return false;
+  }
+
+  act_StringView view = {.data = key, .len = map->_key_size};
+  return act__hashMapInsert(
+      map, view, act_hashBytes(key, map->_key_size, ACT_HASH_DEFAULT_SEED),
+      value, error_code);
+}
+
+void *act_hashMapGet(const act_HashMap *map, const void *key,
+                     int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return NULL;
+  }
+  if (key == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_KEY;
+    return NULL;
+  }
+  if (map->_string_keys) {
+    *error_code = ACT_HASH_MAP_ERROR_WRONG_KEY_KIND;
+    return NULL;
+  }
+
+  act_StringView view = {.data = key, .len = map->_key_size};
+  return act__hashMapGet(
+      map, view, act_hashBytes(key, map->_key_size, ACT_HASH_DEFAULT_SEED),
+      error_code);
+}
+
+bool act_hashMapContains(const act_HashMap *map, const void *key) {
+  int err = ACT_HASH_MAP_ERROR_SUCCESS;
+  act_hashMapGet(map, key, &err);
+  return err == ACT_HASH_MAP_ERROR_SUCCESS;
+}
+
+bool act_hashMapRemove(act_HashMap *map, const void *key, void *value,
+                       int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (key == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+  if (map->_string_keys) {
+    *error_code = ACT_HASH_MAP_ERROR_WRONG_KEY_KIND;
+    return false;
+  }
+
+  act_StringView view = {.data = key, .len = map->_key_size};
+  return act__hashMapRemove(
+      map, view, act_hashBytes(key, map->_key_size, ACT_HASH_DEFAULT_SEED),
+      value, error_code);
+}
+
+/// Checks the arguments of the string-key functions.
+static bool act__hashMapCheckStrArgs(const act_HashMap *map,
+                                     act_StringView key, int *error_code) {
+  *error_code = ACT_HASH_MAP_ERROR_SUCCESS;
+
+  if (map == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_MAP;
+    return false;
+  }
+  if (key.data == NULL && key.len != 0) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+  if (!map->_string_keys) {
+    *error_code = ACT_HASH_MAP_ERROR_WRONG_KEY_KIND;
+    return false;
+  }
+
+  return true;
+}
+
+bool act_hashMapInsertStr(act_HashMap *map, act_StringView key,
+                          const void *value, int *error_code) {
+  if (!act__hashMapCheckStrArgs(map, key, error_code)) {
+    return false;
+  }
+  if (value == NULL && map->_value_size != 0) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_KEY;
+    return false;
+  }
+
+  return act__hashMapInsert(map, key, act_stringViewHash(key), value,
+                            error_code);
+}
+
+void *act_hashMapGetStr(const act_HashMap *map, act_StringView key,
+                        int *error_code) {
+  if (!act__hashMapCheckStrArgs(map, key, error_code)) {
+    return NULL;
+  }
+
+  return act__hashMapGet(map, key, act_stringViewHash(key), error_code);
+}
+
+void *act_hashMapGetString(const act_HashMap *map, act_String *key,
+                           int *error_code) {
+  if (key == NULL) {
+    *error_code = ACT_HASH_MAP_ERROR_NULL_KEY;
+    return NULL;
+  }
+
+  act_StringView view = act_stringAsView(*key);
+  if (!act__hashMapCheckStrArgs(map, view, error_code)) {
+    return NULL;
+  }
+
+  return act__hashMapGet(map, view, act_stringHash(key), error_code);
+}
+
+bool act_hashMapRemoveStr(act_HashMap *map, act_StringView key, void *value,
+                          int *error_code) {
+  if (!act__hashMapCheckStrArgs(map, key, error_code)) {
+    return false;
+  }
+
+  return act__hashMapRemove(map, key, act_stringViewHash(key), value,
+                            error_code);
+}
+
+act_HashMapIter act_hashMapIter(const act_HashMap *map) {
+  return (act_HashMapIter){._map = map, ._slot = 0};
+}
+
+bool act_hashMapIterNext(act_HashMapIter *iter, const void **key,
+                         void **value) {
+  const act_HashMap *map = iter->_map;
+  if (map == NULL) {
+    return false;
+  }
+
+  while (iter->_slot < map->_capacity) {
+    size_t slot = iter->_slot++;
+    if (map->_ctrl[slot] & HASH_MAP_EMPTY) {
+      continue;
+    }
+
+    if (key != NULL) {
+      *key = act__hashMapKeyAt(map, slot);
+    }
+    if (value != NULL) {
+      *value = act__hashMapValueAt(map, slot);
+    }
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,381 @@
+#ifndef ACT_HASH_MAP_H
+#define ACT_HASH_MAP_H
+
+#include "act_allocator.h"
+#include "act_hash.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_hash_map.h
+///
+/// This header defines an open-addressing hash map with generic key and value
+/// sizes.
+///
+/// Every slot has a one byte control word: either empty, or the low 7 bits of
+/// the key's hash. Lookups compare 16 control bytes at a time (with SSE2 where
+/// available), so only the slots whose control byte matches have their keys
+/// compared. Collisions are resolved by linear probing, and removal shifts the
+/// following entries back instead of leaving tombstones, so lookups never
+/// slow down after many removals.
+
+/// The default maximum load factor of an #act_HashMap.
+#define ACT_HASH_MAP_DEFAULT_MAX_LOAD_FACTOR 0.875f
+
+/// @brief **[PRIVATE]** An open-addressing hash map.
+///
+/// Keys are either compared and hashed byte-wise (see #act_hashMapNew), or are
+/// owned #act_String keys compared by contents (see
+/// #act_hashMapNewStringKeys).
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_hashMapInsert, #act_hashMapGet, #act_hashMapRemove
+typedef struct act_HashMap {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The size of a key.
+  size_t _key_size;
+
+  /// @internal The size of a value.
+  size_t _value_size;
+
+  /// @internal Whether the keys are owned #act_String.
+  bool _string_keys;
+
+  /// @internal The control bytes (with the first group mirrored at the end).
+  uint8_t *_ctrl;
+
+  /// @internal The keys, indexed by slot.
+  char *_keys;
+
+  /// @internal The values, indexed by slot.
+  char *_values;
+
+  /// @internal The number of slots (zero, or a power of two of at least 16).
+  size_t _capacity;
+
+  /// @internal The number of entries.
+  size_t _len;
+
+  /// @internal The maximum ratio of entries to slots before growing.
+  float _max_load_factor;
+  /// @endcond
+} act_HashMap;
+
+/// @brief **[PRIVATE]** An iterator over the entries of an #act_HashMap.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use #act_hashMapIterNext instead.
+///
+/// @sa #act_hashMapIter
+typedef struct act_HashMapIter {
+  /// @cond
+  /// @internal The map being iterated over.
+  const act_HashMap *_map;
+
+  /// @internal The next slot to visit.
+  size_t _slot;
+  /// @endcond
+} act_HashMapIter;
+
+/// @brief The possible error values.
+typedef enum act_HashMapError {
+  /// Successful operation.
+  ACT_HASH_MAP_ERROR_SUCCESS = 0x0,
+
+  /// The given map was **NULL**.
+  ACT_HASH_MAP_ERROR_NULL_MAP,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_HASH_MAP_ERROR_NULL_ALLOCATOR,
+
+  /// The given key or value was **NULL**.
+  ACT_HASH_MAP_ERROR_NULL_KEY,
+
+  /// A failure during allocation.
+  ACT_HASH_MAP_ERROR_ALLOCATION_FAILED,
+
+  /// The key is not in the map.
+  ACT_HASH_MAP_ERROR_NOT_FOUND,
+
+  /// The key size was zero.
+  ACT_HASH_MAP_ERROR_INVALID_KEY_SIZE,
+
+  /// The load factor was not between zero and one (exclusive).
+  ACT_HASH_MAP_ERROR_INVALID_LOAD_FACTOR,
+
+  /// A string-key function was used on a byte-key map, or vice versa.
+  ACT_HASH_MAP_ERROR_WRONG_KEY_KIND,
+} act_HashMapError;
+
+/// @brief Creates a new #act_HashMap with byte-wise compared keys.
+///
+/// Keys are hashed and compared as raw bytes, so struct keys must not contain
+/// uninitialized padding.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  key_size    The size of a key.
+/// @param[in]  value_size  The size of a value (may be zero for a set).
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+///
+/// @return A new, empty map.
+///
+/// @note This function does not allocate any memory until the first insert.
+///
+/// @sa #act_hashMapFree, #ACT_HASH_MAP_NEW
+act_HashMap act_hashMapNew(const act_Allocator *allocator, size_t key_size,
+                           size_t value_size, int *error_code);
+
+/// @brief Creates a new #act_HashMap with owned #act_String keys.
+///
+/// Keys are copied into the map (with the map's allocator) on insertion and
+/// freed on removal. They are compared by contents, and their cached hash
+/// (#act_stringHash) is reused when the map grows.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  value_size  The size of a value (may be zero for a set).
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+///
+/// @return A new, empty map.
+///
+/// @sa #act_hashMapFree, #act_hashMapInsertStr, #act_hashMapGetStr
+act_HashMap act_hashMapNewStringKeys(const act_Allocator *allocator,
+                                     size_t value_size, int *error_code);
+
+/// @brief Frees all memory allocated by the #act_HashMap (including owned
+/// string keys).
+///
+/// @param[in]  map         The map to free.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+void act_hashMapFree(act_HashMap *map, int *error_code);
+
+/// @brief Returns the number of entries in the #act_HashMap.
+///
+/// @param map The map to get the length of.
+///
+/// @return The number of entries.
+size_t act_hashMapLen(const act_HashMap *map);
+
+/// @brief Returns the number of slots allocated by the #act_HashMap.
+///
+/// @param map The map to get the capacity of.
+///
+/// @return The number of slots.
+size_t act_hashMapCapacity(const act_HashMap *map);
+
+/// @brief Returns the current load factor (entries per slot) of the
+/// #act_HashMap.
+///
+/// @param map The map to get the load factor of.
+///
+/// @return The load factor (zero for a map without slots).
+float act_hashMapLoadFactor(const act_HashMap *map);
+
+/// @brief Returns the maximum load factor of the #act_HashMap, above which it
+/// grows.
+///
+/// @param map The map to get the maximum load factor of.
+///
+/// @return The maximum load factor.
+float act_hashMapMaxLoadFactor(const act_HashMap *map);
+
+/// @brief Sets the maximum load factor of the #act_HashMap.
+///
+/// Lower values trade memory for shorter probe sequences. The map grows
+/// immediately if it is already above the new maximum.
+///
+/// @param[in]  map             The map to update.
+/// @param[in]  max_load_factor The new maximum (between zero and one,
+///                             exclusive).
+/// @param[out] error_code      The error code (#act_HashMapError) of the
+///                             operation.
+///
+/// @note This function @em possibly allocates memory if the map grows.
+void act_hashMapSetMaxLoadFactor(act_HashMap *map, float max_load_factor,
+                                 int *error_code);
+
+/// @brief Makes room for at least @a capacity entries in total, so that
+/// inserting them will not trigger a rehash.
+///
+/// @param[in]  map         The map to reserve space in.
+/// @param[in]  capacity    The number of entries to make room for.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory.
+void act_hashMapReserve(act_HashMap *map, size_t capacity, int *error_code);
+
+/// @brief Removes all entries from the #act_HashMap, keeping its slots.
+///
+/// @param[in]  map         The map to clear.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+void act_hashMapClear(act_HashMap *map, int *error_code);
+
+/// @brief Inserts a key and value into the #act_HashMap, overwriting the
+/// value if the key already exists.
+///
+/// @param[in]  map         The map to insert into.
+/// @param[in]  key         The key (of the map's key size) to copy in.
+/// @param[in]  value       The value (of the map's value size) to copy in.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+///
+/// @return **true** if the key was new, **false** if its value was replaced.
+///
+/// @note This function @em possibly allocates memory if the map grows.
+bool act_hashMapInsert(act_HashMap *map, const void *key, const void *value,
+                       int *error_code);
+
+/// @brief Looks up the value of a key in the #act_HashMap.
+///
+/// @param[in]  map         The map to search.
+/// @param[in]  key         The key to look for.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation; #ACT_HASH_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return A pointer to the value, valid until the map is next modified, or
+/// **NULL** if the key is not in the map.
+void *act_hashMapGet(const act_HashMap *map, const void *key,
+                     int *error_code);
+
+/// @brief Checks if the #act_HashMap contains the given key.
+///
+/// @param map The map to search.
+/// @param key The key to look for.
+///
+/// @return **true** if the key is in the map, **false** otherwise.
+bool act_hashMapContains(const act_HashMap *map, const void *key);
+
+/// @brief Removes a key (and its value) from the #act_HashMap.
+///
+/// @param[in]  map         The map to remove from.
+/// @param[in]  key         The key to remove.
+/// @param[out] value       Where to copy the removed value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation; #ACT_HASH_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return **true** if the key was removed, **false** if it was not found.
+bool act_hashMapRemove(act_HashMap *map, const void *key, void *value,
+                       int *error_code);
+
+/// @brief Inserts a string key and value into a string-key #act_HashMap,
+/// overwriting the value if the key already exists.
+///
+/// @param[in]  map         The map to insert into.
+/// @param[in]  key         The key, copied into the map if it is new.
+/// @param[in]  value       The value (of the map's value size) to copy in.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+///
+/// @return **true** if the key was new, **false** if its value was replaced.
+///
+/// @note This function allocates a copy of new keys, and @em possibly
+/// allocates memory if the map grows.
+///
+/// @sa #act_hashMapNewStringKeys
+bool act_hashMapInsertStr(act_HashMap *map, act_StringView key,
+                          const void *value, int *error_code);
+
+/// @brief Looks up the value of a string key in a string-key #act_HashMap.
+///
+/// @param[in]  map         The map to search.
+/// @param[in]  key         The key to look for.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation; #ACT_HASH_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return A pointer to the value, valid until the map is next modified, or
+/// **NULL** if the key is not in the map.
+///
+/// @sa #act_hashMapGetString
+void *act_hashMapGetStr(const act_HashMap *map, act_StringView key,
+                        int *error_code);
+
+/// @brief Looks up the value of an #act_String key in a string-key
+/// #act_HashMap, using (and caching) the key's hash.
+///
+/// Repeated lookups with the same string only hash it once.
+///
+/// @param[in]  map         The map to search.
+/// @param[in]  key         The key to look for.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation; #ACT_HASH_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return A pointer to the value, valid until the map is next modified, or
+/// **NULL** if the key is not in the map.
+///
+/// @sa #act_stringHash
+void *act_hashMapGetString(const act_HashMap *map, act_String *key,
+                           int *error_code);
+
+/// @brief Removes a string key (and its value) from a string-key
+/// #act_HashMap, freeing the map's copy of the key.
+///
+/// @param[in]  map         The map to remove from.
+/// @param[in]  key         The key to remove.
+/// @param[out] value       Where to copy the removed value (may be **NULL**).
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation; #ACT_HASH_MAP_ERROR_NOT_FOUND if the
+///                         key is not in the map.
+///
+/// @return **true** if the key was removed, **false** if it was not found.
+bool act_hashMapRemoveStr(act_HashMap *map, act_StringView key, void *value,
+                          int *error_code);
+
+/// @brief Creates an iterator over the entries of the #act_HashMap, in
+/// unspecified order.
+///
+/// The iterator is invalidated by any modification of the map.
+///
+/// @param map The map to iterate over.
+///
+/// @return An iterator positioned before the first entry.
+///
+/// @sa #act_hashMapIterNext
+act_HashMapIter act_hashMapIter(const act_HashMap *map);
+
+/// @brief Advances the iterator to the next entry.
+///
+/// @param[in]  iter  The iterator to advance.
+/// @param[out] key   The key of the next entry (an #act_String for string-key
+///                   maps); may be **NULL**.
+/// @param[out] value The value of the next entry; may be **NULL**.
+///
+/// @return **true** if an entry was returned, **false** once all entries have
+/// been visited.
+bool act_hashMapIterNext(act_HashMapIter *iter, const void **key,
+                         void **value);
+
+/// @brief Create a new #act_HashMap with keys of type @em K and values of type
+/// @em V.
+///
+/// This macro calls #act_hashMapNew with the sizes of @em K and @em V.
+///
+/// @param[in]  K           The type of the keys.
+/// @param[in]  V           The type of the values.
+/// @param[in]  allocator   The #act_Allocator used for internal allocations.
+/// @param[out] error_code  The error code (#act_HashMapError) of the
+///                         operation.
+///
+/// @return A new, empty map.
+///
+/// @sa #act_hashMapFree
+#define ACT_HASH_MAP_NEW(K, V, allocator, error_code)                          \
+  act_hashMapNew(allocator, sizeof(K), sizeof(V), error_code)
+
+#endif /* !ACT_HASH_MAP_H */
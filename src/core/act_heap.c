@@ -0,0 +1,430 @@
+#include "act_heap.h"
+#include <string.h>
+
+/// Returns a pointer to the element at @em idx.
+static inline char *act__heapAt(const act_Heap *heap, size_t idx) {
+  return (char *)heap->_data + idx * heap->_data_size;
+}
+
+/// Moves the value in the scratch space down from the hole at @em idx, until
+/// none of its children are smaller, and stores it there.
+static void act__heapSiftDown(act_Heap *heap, size_t idx, size_t len) {
+  const size_t size = heap->_data_size;
+  const size_t arity = heap->_arity;
+  act_HeapCompareFn compare = heap->_compare;
+
+  for (;;) {
+    size_t first = idx * arity + 1;
+    if (first >= len) {
+      break;
+    }
+
+    // Find the smallest child
+    size_t last = first + arity < len ? first + arity : len;
+    size_t best = first;
+    for (size_t child = first + 1; child < last; child++) {
+      if (compare(act__heapAt(heap, child), act__heapAt(heap, best)) < 0) {
+        best = child;
+      }
+    }
+
+    if (compare(act__heapAt(heap, best), heap->_scratch) >= 0) {
+      break;
+    }
+    memcpy(act__heapAt(heap, idx), act__heapAt(heap, best), size);
+    idx = best;
+  }
+
+  memcpy(act__heapAt(heap, idx), heap->_scratch, size);
+}
+
+/// Moves the value in the scratch space up from the hole at @em idx, until
+/// its parent is not larger, and stores it there.
+static void act__heapSiftUp(act_Heap *heap, size_t idx) {
+  const size_t size = heap->_data_size;
+
+  while (idx > 0) {
+    size_t parent = (idx - 1) / heap->_arity;
+    if (heap->_compare(heap->_scratch, act__heapAt(heap, parent)) >= 0) {
+      break;
+    }
+    memcpy(act__heapAt(heap, idx), act__heapAt(heap, parent), size);
+    idx = parent;
+  }
+
+  memcpy(act__heapAt(heap, idx), heap->_scratch, size);
+}
+
+/// Restores the heap property of all elements, bottom-up (Floyd's method).
+static void act__heapHeapify(act_Heap *heap) {
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(heap->_data, &vec_err);
+  if (len < 2) {
+    return;
+  }
+
+  for (size_t idx = (len - 2) / heap->_arity + 1; idx-- > 0;) {
+    memcpy(heap->_scratch, act__heapAt(heap, idx), heap->_data_size);
+    act__heapSiftDown(heap, idx, len);
+  }
+}
+
+/// Checks the arguments shared by the heap constructors.
+static bool act__heapCheckArgs(act_HeapCompareFn compare, act_HeapArity arity,
+                               int *error_code) {
+  if (compare == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_COMPARATOR;
+    return false;
+  }
+  if (arity != ACT_HEAP_ARITY_BINARY && arity != ACT_HEAP_ARITY_QUATERNARY) {
+    *error_code = ACT_HEAP_ERROR_INVALID_ARITY;
+    return false;
+  }
+  return true;
+}
+
+act_Heap act_heapNew(const act_Allocator *allocator, size_t data_size,
+                     act_HeapCompareFn compare, act_HeapArity arity,
+                     int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_ALLOCATOR;
+    return (act_Heap){0};
+  }
+  if (data_size == 0) {
+    *error_code = ACT_HEAP_ERROR_INVALID_DATA_SIZE;
+    return (act_Heap){0};
+  }
+  if (!act__heapCheckArgs(compare, arity, error_code)) {
+    return (act_Heap){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *data = act_vectorNew(allocator, data_size, &vec_err);
+  void *scratch = (*allocator->alloc)(1, data_size);
+  if (data == NULL || scratch == NULL) {
+    if (data != NULL) {
+      act_vectorFree(data, &vec_err);
+    }
+    *error_code = ACT_HEAP_ERROR_ALLOCATION_FAILED;
+    return (act_Heap){0};
+  }
+
+  return (act_Heap){
+      ._data = data,
+      ._data_size = data_size,
+      ._compare = compare,
+      ._arity = arity,
+      ._scratch = scratch,
+  };
+}
+
+act_Heap act_heapFromVector(act_Vector *vec, act_HeapCompareFn compare,
+                            act_HeapArity arity, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_VECTOR;
+    return (act_Heap){0};
+  }
+  if (!act__heapCheckArgs(compare, arity, error_code)) {
+    return (act_Heap){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t data_size = act_vectorDataSize(vec, &vec_err);
+  if (data_size == 0) {
+    *error_code = ACT_HEAP_ERROR_INVALID_DATA_SIZE;
+    return (act_Heap){0};
+  }
+
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  void *scratch = (*allocator->alloc)(1, data_size);
+  if (scratch == NULL) {
+    *error_code = ACT_HEAP_ERROR_ALLOCATION_FAILED;
+    return (act_Heap){0};
+  }
+
+  act_Heap heap = {
+      ._data = vec,
+      ._data_size = data_size,
+      ._compare = compare,
+      ._arity = arity,
+      ._scratch = scratch,
+  };
+  act__heapHeapify(&heap);
+
+  return heap;
+}
+
+void act_heapFree(act_Heap *heap, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (heap->_data != NULL) {
+    const act_Allocator *allocator = act_vectorAllocator(heap->_data, &vec_err);
+    (*allocator->free)(heap->_scratch);
+    act_vectorFree(heap->_data, &vec_err);
+  }
+
+  *heap = (act_Heap){0};
+}
+
+size_t act_heapLen(const act_Heap *heap) {
+  if (heap->_data == NULL) {
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  return act_vectorLen(heap->_data, &vec_err);
+}
+
+void act_heapPush(act_Heap *heap, const void *value, int *error_code) {
+  act_heapExtend(heap, value, 1, error_code);
+}
+
+void act_heapExtend(act_Heap *heap, const void *values, size_t count,
+                    int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL || heap->_data == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return;
+  }
+  if (values == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_VALUE;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *data = act_vectorReserve(heap->_data, count, &vec_err);
+  if (data == NULL) {
+    *error_code = ACT_HEAP_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+  heap->_data = data;
+
+  size_t len = act_vectorLen(data, &vec_err);
+  act__vectorSetLen(data, len + count, &vec_err);
+
+  // Rebuilding is O(n + count), sifting each value up is O(count * log n)
+  if (count > len) {
+    memcpy(act__heapAt(heap, len), values, count * heap->_data_size);
+    act__heapHeapify(heap);
+    return;
+  }
+
+  const char *value = values;
+  for (size_t i = 0; i < count; i++) {
+    memcpy(heap->_scratch, value, heap->_data_size);
+    act__heapSiftUp(heap, len + i);
+    value += heap->_data_size;
+  }
+}
+
+const void *act_heapTop(const act_Heap *heap, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return NULL;
+  }
+  if (act_heapLen(heap) == 0) {
+    *error_code = ACT_HEAP_ERROR_EMPTY;
+    return NULL;
+  }
+
+  return heap->_data;
+}
+
+bool act_heapPop(act_Heap *heap, void *value, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return false;
+  }
+  size_t len = act_heapLen(heap);
+  if (len == 0) {
+    *error_code = ACT_HEAP_ERROR_EMPTY;
+    return false;
+  }
+
+  if (value != NULL) {
+    memcpy(value, heap->_data, heap->_data_size);
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act__vectorSetLen(heap->_data, --len, &vec_err);
+  if (len > 0) {
+    memcpy(heap->_scratch, act__heapAt(heap, len), heap->_data_size);
+    act__heapSiftDown(heap, 0, len);
+  }
+
+  return true;
+}
+
+bool act_heapReplaceTop(act_Heap *heap, const void *value, void *top,
+                        int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return false;
+  }
+  if (value == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_VALUE;
+    return false;
+  }
+  size_t len = act_heapLen(heap);
+  if (len == 0) {
+    *error_code = ACT_HEAP_ERROR_EMPTY;
+    return false;
+  }
+
+  // Copy the value first, in case it aliases top
+  memcpy(heap->_scratch, value, heap->_data_size);
+  if (top != NULL) {
+    memcpy(top, heap->_data, heap->_data_size);
+  }
+  act__heapSiftDown(heap, 0, len);
+
+  return true;
+}
+
+void act_heapClear(act_Heap *heap, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL || heap->_data == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act__vectorSetLen(heap->_data, 0, &vec_err);
+}
+
+act_Vector *act_heapIntoVector(act_Heap *heap, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (heap == NULL || heap->_data == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *data = heap->_data;
+  const act_Allocator *allocator = act_vectorAllocator(data, &vec_err);
+  (*allocator->free)(heap->_scratch);
+
+  *heap = (act_Heap){0};
+
+  return data;
+}
+
+act_TopK act_topKNew(const act_Allocator *allocator, size_t data_size,
+                     size_t k, act_HeapCompareFn compare, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (k == 0) {
+    *error_code = ACT_HEAP_ERROR_INVALID_K;
+    return (act_TopK){0};
+  }
+
+  act_Heap heap = act_heapNew(allocator, data_size, compare,
+                              ACT_HEAP_ARITY_QUATERNARY, error_code);
+  if (*error_code != ACT_HEAP_ERROR_SUCCESS) {
+    return (act_TopK){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act_Vector *data = act_vectorReserve(heap._data, k, &vec_err);
+  if (data == NULL) {
+    act_heapFree(&heap, error_code);
+    *error_code = ACT_HEAP_ERROR_ALLOCATION_FAILED;
+    return (act_TopK){0};
+  }
+  heap._data = data;
+
+  return (act_TopK){._heap = heap, ._k = k};
+}
+
+void act_topKFree(act_TopK *top_k, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (top_k == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return;
+  }
+
+  act_heapFree(&top_k->_heap, error_code);
+  *top_k = (act_TopK){0};
+}
+
+size_t act_topKLen(const act_TopK *top_k) {
+  return act_heapLen(&top_k->_heap);
+}
+
+bool act_topKPush(act_TopK *top_k, const void *value, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (top_k == NULL || top_k->_heap._data == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return false;
+  }
+  if (value == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_VALUE;
+    return false;
+  }
+
+  act_Heap *heap = &top_k->_heap;
+  if (act_heapLen(heap) < top_k->_k) {
+    act_heapPush(heap, value, error_code);
+    return *error_code == ACT_HEAP_ERROR_SUCCESS;
+  }
+
+  // Only elements greater than the least kept one get in
+  if (heap->_compare(value, heap->_data) <= 0) {
+    return false;
+  }
+  return act_heapReplaceTop(heap, value, NULL, error_code);
+}
+
+const void *act_topKThreshold(const act_TopK *top_k, int *error_code) {
+  if (top_k == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return NULL;
+  }
+
+  return act_heapTop(&top_k->_heap, error_code);
+}
+
+act_Vector *act_topKIntoSortedVector(act_TopK *top_k, int *error_code) {
+  *error_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (top_k == NULL || top_k->_heap._data == NULL) {
+    *error_code = ACT_HEAP_ERROR_NULL_HEAP;
+    return NULL;
+  }
+
+  // Heapsort in place: the least element moves to the end of the heap, which
+  // then shrinks past it
+  act_Heap *heap = &top_k->_heap;
+  size_t len = act_heapLen(heap);
+  for (size_t end = len; end-- > 1;) {
+    memcpy(heap->_scratch, act__heapAt(heap, end), heap->_data_size);
+    memcpy(act__heapAt(heap, end), heap->_data, heap->_data_size);
+    act__heapSiftDown(heap, 0, end);
+  }
+
+  act_Vector *data = act_heapIntoVector(heap, error_code);
+  *top_k = (act_TopK){0};
+
+  return data;
+}
@@ -0,0 +1,355 @@
+#ifndef ACT_HEAP_H
+#define ACT_HEAP_H
+
+#include "act_allocator.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_heap.h
+///
+/// This header defines a priority queue (an implicit d-ary heap) with a
+/// generic element size, stored in an #act_Vector.
+///
+/// The order is given by a comparator with the same contract as the one taken
+/// by **@em qsort**, and the top of the heap is the smallest element; a
+/// comparator with its result negated gives a max-heap.
+///
+/// A heap can be binary, or 4-ary: a 4-ary heap is half as deep, and the four
+/// children of a node are adjacent in memory, so large heaps of small
+/// elements take fewer cache misses per push and pop.
+///
+/// An #act_TopK is a heap bounded to the @em k greatest elements seen so far:
+/// its top is the least of them, so each new element is only compared against
+/// the top, and replaces it if greater.
+
+/// @brief The comparator used to order the elements of an #act_Heap.
+///
+/// @param a The first element.
+/// @param b The second element.
+///
+/// @return A negative value if @em a should be closer to the top than @em b,
+/// a positive value if it should be further, and zero if they are equivalent.
+typedef int (*act_HeapCompareFn)(const void *a, const void *b);
+
+/// @brief The number of children of each node of an #act_Heap.
+typedef enum act_HeapArity {
+  /// A binary heap.
+  ACT_HEAP_ARITY_BINARY = 2,
+
+  /// A 4-ary heap.
+  ACT_HEAP_ARITY_QUATERNARY = 4,
+} act_HeapArity;
+
+/// @brief **[PRIVATE]** A priority queue.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_heapPush, #act_heapPop, #act_heapTop
+typedef struct act_Heap {
+  /// @cond
+  /// @internal The elements, in heap order.
+  act_Vector *_data;
+
+  /// @internal The size of an element.
+  size_t _data_size;
+
+  /// @internal The comparator that orders the elements.
+  act_HeapCompareFn _compare;
+
+  /// @internal The number of children of each node.
+  size_t _arity;
+
+  /// @internal Space for one element, used while sifting.
+  void *_scratch;
+  /// @endcond
+} act_Heap;
+
+/// @brief **[PRIVATE]** Keeps the @em k greatest of a stream of elements.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_topKPush, #act_topKIntoSortedVector
+typedef struct act_TopK {
+  /// @cond
+  /// @internal The kept elements, least on top.
+  act_Heap _heap;
+
+  /// @internal The maximum number of elements kept.
+  size_t _k;
+  /// @endcond
+} act_TopK;
+
+/// @brief The possible error values.
+typedef enum act_HeapError {
+  /// Successful operation.
+  ACT_HEAP_ERROR_SUCCESS = 0x0,
+
+  /// The given heap was **NULL**.
+  ACT_HEAP_ERROR_NULL_HEAP,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_HEAP_ERROR_NULL_ALLOCATOR,
+
+  /// The given vector was **NULL**.
+  ACT_HEAP_ERROR_NULL_VECTOR,
+
+  /// The given comparator was **NULL**.
+  ACT_HEAP_ERROR_NULL_COMPARATOR,
+
+  /// The given value pointer was **NULL**.
+  ACT_HEAP_ERROR_NULL_VALUE,
+
+  /// A failure during allocation.
+  ACT_HEAP_ERROR_ALLOCATION_FAILED,
+
+  /// The heap is empty.
+  ACT_HEAP_ERROR_EMPTY,
+
+  /// The element size was zero.
+  ACT_HEAP_ERROR_INVALID_DATA_SIZE,
+
+  /// The arity was not one of #act_HeapArity.
+  ACT_HEAP_ERROR_INVALID_ARITY,
+
+  /// The number of elements to keep was zero.
+  ACT_HEAP_ERROR_INVALID_K,
+} act_HeapError;
+
+/// @brief Creates a new, empty #act_Heap.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  data_size   The size of an element.
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[in]  arity       The number of children of each node.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return A new, empty heap.
+///
+/// @note This function allocates an empty #act_Vector and space for one
+/// element.
+///
+/// @sa #act_heapFree, #ACT_HEAP_NEW
+act_Heap act_heapNew(const act_Allocator *allocator, size_t data_size,
+                     act_HeapCompareFn compare, act_HeapArity arity,
+                     int *error_code);
+
+/// @brief Creates an #act_Heap from the elements of an #act_Vector, in O(n).
+///
+/// The heap takes ownership of the vector (which must not be used or freed
+/// afterwards), and reorders its elements in place instead of pushing them one
+/// at a time.
+///
+/// @param[in]  vec         The vector to build the heap from.
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[in]  arity       The number of children of each node.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return A heap of the elements of @em vec.
+///
+/// @note This function allocates space for one element, with the vector's
+/// allocator.
+///
+/// @sa #act_heapIntoVector
+act_Heap act_heapFromVector(act_Vector *vec, act_HeapCompareFn compare,
+                            act_HeapArity arity, int *error_code);
+
+/// @brief Frees all memory allocated by the #act_Heap.
+///
+/// @param[in]  heap        The heap to free.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+void act_heapFree(act_Heap *heap, int *error_code);
+
+/// @brief Returns the number of elements in the #act_Heap.
+///
+/// @param heap The heap to get the length of.
+///
+/// @return The number of elements.
+size_t act_heapLen(const act_Heap *heap);
+
+/// @brief Pushes a copy of a value onto the #act_Heap, in O(log n).
+///
+/// @param[in]  heap        The heap to push onto.
+/// @param[in]  value       The value (of the heap's element size) to copy in.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the underlying vector
+/// grows.
+void act_heapPush(act_Heap *heap, const void *value, int *error_code);
+
+/// @brief Pushes copies of many values onto the #act_Heap.
+///
+/// When the new values outnumber the elements already in the heap, the whole
+/// heap is rebuilt in O(n) instead of sifting each value up.
+///
+/// @param[in]  heap        The heap to push onto.
+/// @param[in]  values      The values (of the heap's element size) to copy in.
+/// @param[in]  count       The number of values.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @note This function @em possibly allocates memory if the underlying vector
+/// grows (at most once).
+void act_heapExtend(act_Heap *heap, const void *values, size_t count,
+                    int *error_code);
+
+/// @brief Returns the top (smallest) element of the #act_Heap.
+///
+/// @param[in]  heap        The heap to peek at.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation; #ACT_HEAP_ERROR_EMPTY if the heap is
+///                         empty.
+///
+/// @return A pointer to the top element (valid until the heap is modified),
+/// or **NULL** if the heap is empty.
+const void *act_heapTop(const act_Heap *heap, int *error_code);
+
+/// @brief Removes the top (smallest) element of the #act_Heap, in O(log n).
+///
+/// @param[in]  heap        The heap to pop from.
+/// @param[out] value       Where to copy the removed element (may be
+///                         **NULL**).
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation; #ACT_HEAP_ERROR_EMPTY if the heap is
+///                         empty.
+///
+/// @return **true** if an element was removed, **false** if the heap was
+/// empty.
+bool act_heapPop(act_Heap *heap, void *value, int *error_code);
+
+/// @brief Replaces the top element of the #act_Heap with a new value.
+///
+/// This is a pop followed by a push, but only sifts once.
+///
+/// @param[in]  heap        The heap to modify.
+/// @param[in]  value       The value (of the heap's element size) to copy in.
+/// @param[out] top         Where to copy the replaced element (may be
+///                         **NULL**, or alias @em value).
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation; #ACT_HEAP_ERROR_EMPTY if the heap is
+///                         empty.
+///
+/// @return **true** if the top was replaced, **false** if the heap was empty
+/// (and nothing was pushed).
+bool act_heapReplaceTop(act_Heap *heap, const void *value, void *top,
+                        int *error_code);
+
+/// @brief Removes all elements from the #act_Heap, keeping its memory.
+///
+/// @param[in]  heap        The heap to clear.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+void act_heapClear(act_Heap *heap, int *error_code);
+
+/// @brief Converts the #act_Heap back into its underlying #act_Vector.
+///
+/// The elements are in heap order (not sorted). The heap is left empty and
+/// only needs to be freed.
+///
+/// @param[in]  heap        The heap to convert.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return The vector of elements, owned by the caller.
+///
+/// @sa #act_heapFromVector
+act_Vector *act_heapIntoVector(act_Heap *heap, int *error_code);
+
+/// @brief Creates a new, empty #act_TopK.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  data_size   The size of an element.
+/// @param[in]  k           The number of elements to keep.
+/// @param[in]  compare     The comparator that orders the elements; the
+///                         greatest elements are kept.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return A new, empty top-k.
+///
+/// @note This function allocates space for @em k + 1 elements.
+///
+/// @sa #act_topKFree
+act_TopK act_topKNew(const act_Allocator *allocator, size_t data_size,
+                     size_t k, act_HeapCompareFn compare, int *error_code);
+
+/// @brief Frees all memory allocated by the #act_TopK.
+///
+/// @param[in]  top_k       The top-k to free.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+void act_topKFree(act_TopK *top_k, int *error_code);
+
+/// @brief Returns the number of elements kept by the #act_TopK (at most
+/// @em k).
+///
+/// @param top_k The top-k to get the length of.
+///
+/// @return The number of elements kept.
+size_t act_topKLen(const act_TopK *top_k);
+
+/// @brief Offers an element to the #act_TopK, in O(log k) if it's kept and
+/// O(1) otherwise.
+///
+/// @param[in]  top_k       The top-k to offer the element to.
+/// @param[in]  value       The value (of the top-k's element size) to copy
+///                         in if kept.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return **true** if the element is now among the kept elements.
+bool act_topKPush(act_TopK *top_k, const void *value, int *error_code);
+
+/// @brief Returns the least of the elements kept by the #act_TopK.
+///
+/// Once @em k elements have been offered, this is the k-th greatest element
+/// seen (e.g. the 99th percentile, with @em k set to 1% of the stream).
+///
+/// @param[in]  top_k       The top-k to peek at.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation; #ACT_HEAP_ERROR_EMPTY if nothing has
+///                         been kept.
+///
+/// @return A pointer to the least kept element (valid until the next push),
+/// or **NULL** if nothing has been kept.
+const void *act_topKThreshold(const act_TopK *top_k, int *error_code);
+
+/// @brief Converts the #act_TopK into an #act_Vector of the kept elements,
+/// greatest first, in O(k log k).
+///
+/// The top-k is left empty and only needs to be freed.
+///
+/// @param[in]  top_k       The top-k to convert.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return The vector of kept elements, owned by the caller.
+act_Vector *act_topKIntoSortedVector(act_TopK *top_k, int *error_code);
+
+/// @brief Creates a new #act_Heap that stores elements of type @em T.
+///
+/// @param[in]  T           The type of the elements stored in the heap.
+/// @param[in]  compare     The comparator that orders the elements.
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[out] error_code  The error code (#act_HeapError) of the
+///                         operation.
+///
+/// @return A new, empty binary heap.
+///
+/// @sa #act_heapNew
+#define ACT_HEAP_NEW(T, compare, allocator, error_code)                        \
+  act_heapNew(allocator, sizeof(T), compare, ACT_HEAP_ARITY_BINARY,            \
+              error_code)
+
+#endif /* !ACT_HEAP_H */
@@ -0,0 +1,386 @@
+#include "act_iter.h"
+#include <string.h>
+
+/// Yields the next element of a vector, or byte of a string.
+static const void *act__iterSourceNext(act_Iter *iter) {
+  if (iter->_pos >= iter->_len) {
+    return NULL;
+  }
+  return iter->_data + iter->_pos++ * iter->_data_size;
+}
+
+/// Yields the next codepoint of a string.
+static const void *act__iterCodepointsNext(act_Iter *iter) {
+  uint32_t codepoint;
+  if (!act_stringCodepointIterNext(&iter->_codepoints, &codepoint)) {
+    return NULL;
+  }
+  memcpy(iter->_element, &codepoint, sizeof(codepoint));
+  return iter->_element;
+}
+
+/// Yields the next token of a string; the position is past the end of the
+/// string once the last token has been yielded.
+static const void *act__iterSplitNext(act_Iter *iter) {
+  if (iter->_pos > iter->_len) {
+    return NULL;
+  }
+
+  const char *start = iter->_data != NULL ? iter->_data + iter->_pos : NULL;
+  const char *end = iter->_pos < iter->_len
+                        ? memchr(start, iter->_delimiter,
+                                 iter->_len - iter->_pos)
+                        : NULL;
+  size_t len = end != NULL ? (size_t)(end - start) : iter->_len - iter->_pos;
+
+  act_StringView token = {.data = start, .len = len};
+  memcpy(iter->_element, &token, sizeof(token));
+  iter->_pos += len + 1;
+  return iter->_element;
+}
+
+/// Yields the result of the map function on the next element of the source.
+static const void *act__iterMapNext(act_Iter *iter) {
+  const void *element = act_iterNext(iter->_source);
+  if (element == NULL) {
+    return NULL;
+  }
+  iter->_map(element, iter->_element, iter->_arg);
+  return iter->_element;
+}
+
+/// Yields the next element of the source that satisfies the predicate.
+static const void *act__iterFilterNext(act_Iter *iter) {
+  const void *element;
+  while ((element = act_iterNext(iter->_source)) != NULL) {
+    if (iter->_predicate(element, iter->_arg)) {
+      return element;
+    }
+  }
+  return NULL;
+}
+
+/// Yields the next element of the source, while there are some left to take.
+static const void *act__iterTakeNext(act_Iter *iter) {
+  if (iter->_len == 0) {
+    return NULL;
+  }
+  iter->_len--;
+  return act_iterNext(iter->_source);
+}
+
+/// Yields the next elements of both sources, side by side.
+static const void *act__iterZipNext(act_Iter *iter) {
+  const void *first = act_iterNext(iter->_source);
+  if (first == NULL) {
+    return NULL;
+  }
+  const void *second = act_iterNext(iter->_other);
+  if (second == NULL) {
+    return NULL;
+  }
+
+  size_t first_size = iter->_source->_data_size;
+  memcpy(iter->_element, first, first_size);
+  memcpy(iter->_element + first_size, second, iter->_other->_data_size);
+  return iter->_element;
+}
+
+/// Yields the next run of a vector or string source, pointing into it.
+static const void *act__iterChunkSpanNext(act_Iter *iter) {
+  act_Iter *source = iter->_source;
+  if (source->_pos >= source->_len) {
+    return NULL;
+  }
+
+  size_t left = source->_len - source->_pos;
+  act_IterChunk chunk = {
+      .data = source->_data + source->_pos * source->_data_size,
+      .len = left < iter->_chunk_len ? left : iter->_chunk_len,
+  };
+  source->_pos += chunk.len;
+  memcpy(iter->_element, &chunk, sizeof(chunk));
+  return iter->_element;
+}
+
+/// Yields the next run of the source, gathered into the buffer.
+static const void *act__iterChunkGatherNext(act_Iter *iter) {
+  const size_t size = iter->_source->_data_size;
+  size_t len = 0;
+  const void *element;
+  while (len < iter->_chunk_len &&
+         (element = act_iterNext(iter->_source)) != NULL) {
+    memcpy(iter->_buffer + len * size, element, size);
+    len++;
+  }
+  if (len == 0) {
+    return NULL;
+  }
+
+  act_IterChunk chunk = {.data = iter->_buffer, .len = len};
+  memcpy(iter->_element, &chunk, sizeof(chunk));
+  return iter->_element;
+}
+
+/// Checks that an adapter's source was created successfully.
+static bool act__iterCheckSource(const act_Iter *source, int *error_code) {
+  *error_code = ACT_ITER_ERROR_SUCCESS;
+
+  if (source == NULL || source->_next == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_ITER;
+    return false;
+  }
+  return true;
+}
+
+act_Iter act_iterFromVector(const act_Vector *vec, int *error_code) {
+  *error_code = ACT_ITER_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_VECTOR;
+    return (act_Iter){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  return (act_Iter){
+      ._next = act__iterSourceNext,
+      ._data = vec,
+      ._len = act_vectorLen(vec, &vec_err),
+      ._data_size = act_vectorDataSize(vec, &vec_err),
+  };
+}
+
+act_Iter act_iterFromView(act_StringView view) {
+  return (act_Iter){
+      ._next = act__iterSourceNext,
+      ._data = view.data,
+      ._len = view.len,
+      ._data_size = sizeof(char),
+  };
+}
+
+act_Iter act_iterCodepoints(act_StringView view) {
+  return (act_Iter){
+      ._next = act__iterCodepointsNext,
+      ._data_size = sizeof(uint32_t),
+      ._codepoints = act_stringViewCodepointIter(view),
+  };
+}
+
+act_Iter act_iterSplit(act_StringView view, char delimiter) {
+  return (act_Iter){
+      ._next = act__iterSplitNext,
+      ._data = view.data,
+      ._len = view.len,
+      ._data_size = sizeof(act_StringView),
+      ._delimiter = delimiter,
+  };
+}
+
+act_Iter act_iterMap(act_Iter *source, size_t out_data_size, act_IterMapFn fn,
+                     void *arg, int *error_code) {
+  if (!act__iterCheckSource(source, error_code)) {
+    return (act_Iter){0};
+  }
+  if (fn == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_FUNCTION;
+    return (act_Iter){0};
+  }
+  if (out_data_size == 0 || out_data_size > ACT_ITER_MAX_DATA_SIZE) {
+    *error_code = ACT_ITER_ERROR_INVALID_DATA_SIZE;
+    return (act_Iter){0};
+  }
+
+  return (act_Iter){
+      ._next = act__iterMapNext,
+      ._source = source,
+      ._data_size = out_data_size,
+      ._map = fn,
+      ._arg = arg,
+  };
+}
+
+act_Iter act_iterFilter(act_Iter *source, act_IterPredicateFn predicate,
+                        void *arg, int *error_code) {
+  if (!act__iterCheckSource(source, error_code)) {
+    return (act_Iter){0};
+  }
+  if (predicate == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_FUNCTION;
+    return (act_Iter){0};
+  }
+
+  return (act_Iter){
+      ._next = act__iterFilterNext,
+      ._source = source,
+      ._data_size = source->_data_size,
+      ._predicate = predicate,
+      ._arg = arg,
+  };
+}
+
+act_Iter act_iterTake(act_Iter *source, size_t count, int *error_code) {
+  if (!act__iterCheckSource(source, error_code)) {
+    return (act_Iter){0};
+  }
+
+  return (act_Iter){
+      ._next = act__iterTakeNext,
+      ._source = source,
+      ._len = count,
+      ._data_size = source->_data_size,
+  };
+}
+
+act_Iter act_iterZip(act_Iter *first, act_Iter *second, int *error_code) {
+  if (!act__iterCheckSource(first, error_code) ||
+      !act__iterCheckSource(second, error_code)) {
+    return (act_Iter){0};
+  }
+
+  size_t data_size = first->_data_size + second->_data_size;
+  if (data_size > ACT_ITER_MAX_DATA_SIZE) {
+    *error_code = ACT_ITER_ERROR_INVALID_DATA_SIZE;
+    return (act_Iter){0};
+  }
+
+  return (act_Iter){
+      ._next = act__iterZipNext,
+      ._source = first,
+      ._other = second,
+      ._data_size = data_size,
+  };
+}
+
+act_Iter act_iterChunk(act_Iter *source, size_t chunk_len,
+                       const act_Allocator *allocator, int *error_code) {
+  if (!act__iterCheckSource(source, error_code)) {
+    return (act_Iter){0};
+  }
+  if (allocator == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_ALLOCATOR;
+    return (act_Iter){0};
+  }
+  if (chunk_len == 0) {
+    *error_code = ACT_ITER_ERROR_INVALID_LEN;
+    return (act_Iter){0};
+  }
+
+  act_Iter chunk = {
+      ._next = act__iterChunkSpanNext,
+      ._source = source,
+      ._data_size = sizeof(act_IterChunk),
+      ._allocator = allocator,
+      ._chunk_len = chunk_len,
+  };
+
+  // Runs of contiguous sources are spans of them; others need a buffer
+  if (source->_next != act__iterSourceNext) {
+    chunk._next = act__iterChunkGatherNext;
+    chunk._buffer = (*allocator->alloc)(chunk_len, source->_data_size);
+    if (chunk._buffer == NULL) {
+      *error_code = ACT_ITER_ERROR_ALLOCATION_FAILED;
+      return (act_Iter){0};
+    }
+  }
+
+  return chunk;
+}
+
+void act_iterFree(act_Iter *iter, int *error_code) {
+  *error_code = ACT_ITER_ERROR_SUCCESS;
+
+  if (iter == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_ITER;
+    return;
+  }
+
+  if (iter->_buffer != NULL) {
+    (*iter->_allocator->free)(iter->_buffer);
+  }
+  *iter = (act_Iter){0};
+}
+
+size_t act_iterDataSize(const act_Iter *iter) { return iter->_data_size; }
+
+const void *act_iterNext(act_Iter *iter) {
+  return iter->_next != NULL ? iter->_next(iter) : NULL;
+}
+
+act_Vector *act_iterCollect(act_Iter *iter, const act_Allocator *allocator,
+                            int *error_code) {
+  if (!act__iterCheckSource(iter, error_code)) {
+    return NULL;
+  }
+  if (allocator == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_ALLOCATOR;
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t size = iter->_data_size;
+  act_Vector *vec = act_vectorNew(allocator, size, &vec_err);
+  if (vec == NULL) {
+    *error_code = ACT_ITER_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+
+  size_t len = 0;
+  size_t capacity = 0;
+  const void *element;
+  while ((element = act_iterNext(iter)) != NULL) {
+    if (len == capacity) {
+      act_Vector *grown = act_vectorReserve(vec, 1, &vec_err);
+      if (grown == NULL) {
+        act_vectorFree(vec, &vec_err);
+        *error_code = ACT_ITER_ERROR_ALLOCATION_FAILED;
+        return NULL;
+      }
+      vec = grown;
+      capacity = act_vectorCapacity(vec, &vec_err);
+    }
+    memcpy((char *)vec + len * size, element, size);
+    act__vectorSetLen(vec, ++len, &vec_err);
+  }
+
+  return vec;
+}
+
+void act_iterReduce(act_Iter *iter, void *acc, act_IterCombineFn combine,
+                    void *arg, int *error_code) {
+  if (!act__iterCheckSource(iter, error_code)) {
+    return;
+  }
+  if (acc == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_ELEMENT;
+    return;
+  }
+  if (combine == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_FUNCTION;
+    return;
+  }
+
+  const void *element;
+  while ((element = act_iterNext(iter)) != NULL) {
+    combine(acc, element, arg);
+  }
+}
+
+size_t act_iterForEach(act_Iter *iter, act_IterForEachFn fn, void *arg,
+                       int *error_code) {
+  if (!act__iterCheckSource(iter, error_code)) {
+    return 0;
+  }
+  if (fn == NULL) {
+    *error_code = ACT_ITER_ERROR_NULL_FUNCTION;
+    return 0;
+  }
+
+  size_t count = 0;
+  const void *element;
+  while ((element = act_iterNext(iter)) != NULL) {
+    fn(element, arg);
+    count++;
+  }
+  return count;
+}
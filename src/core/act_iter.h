@@ -0,0 +1,348 @@
+#ifndef ACT_ITER_H
+#define ACT_ITER_H
+
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_iter.h
+///
+/// This header defines lazy iterators over the elements of an #act_Vector or
+/// the bytes, codepoints or tokens of a string, and adapters that chain them
+/// into pipelines (map, filter, take, zip, chunk) that run in a single pass.
+///
+/// Nothing runs until a sink (#act_iterCollect, #act_iterReduce,
+/// #act_iterForEach, or #act_iterNext) pulls elements from the last iterator,
+/// which pulls them from the one before it, and so on: each element goes
+/// through the whole pipeline before the next is read, so no intermediate
+/// vector is ever allocated, and the elements stay in cache between steps.
+///
+/// Iterators yield pointers to their elements, which stay valid until the
+/// next element is pulled. Sources over vectors and strings, filters and
+/// takes yield pointers into the source without copying the elements; maps
+/// and zips write their elements into a small buffer in the iterator; chunks
+/// of a vector or string are spans of the source, and other chunks are
+/// gathered into a buffer allocated by the chunk.
+///
+/// An adapter keeps a pointer to the iterators it pulls from, which must
+/// outlive it (e.g. all the stages of a pipeline are local variables of the
+/// same function). A pipeline is consumed once.
+
+/// The max size of the elements of maps and zips.
+#define ACT_ITER_MAX_DATA_SIZE 64
+
+/// @brief Computes the element of a map for an element of its source.
+///
+/// @param element The element of the source.
+/// @param out     Where to write the element of the map.
+/// @param arg     The argument given to #act_iterMap.
+typedef void (*act_IterMapFn)(const void *element, void *out, void *arg);
+
+/// @brief Returns whether a filter should keep an element.
+///
+/// @param element The element.
+/// @param arg     The argument given to #act_iterFilter.
+///
+/// @return **true** if the element is kept, **false** otherwise.
+typedef bool (*act_IterPredicateFn)(const void *element, void *arg);
+
+/// @brief Combines an element into an accumulator (e.g. adds it).
+///
+/// @param acc     The accumulator.
+/// @param element The element to combine into the accumulator.
+/// @param arg     The argument given to #act_iterReduce.
+typedef void (*act_IterCombineFn)(void *acc, const void *element, void *arg);
+
+/// @brief Consumes an element.
+///
+/// @param element The element.
+/// @param arg     The argument given to #act_iterForEach.
+typedef void (*act_IterForEachFn)(const void *element, void *arg);
+
+/// @brief A run of consecutive elements, yielded by #act_iterChunk.
+typedef struct act_IterChunk {
+  /// The first element of the run.
+  const void *data;
+
+  /// The number of elements in the run.
+  size_t len;
+} act_IterChunk;
+
+typedef struct act_Iter act_Iter;
+
+/// @brief Advances an iterator.
+///
+/// This type is private; it is only called by the iterator implementation.
+typedef const void *(*act__IterNextFn)(act_Iter *iter);
+
+/// @brief **[PRIVATE]** A lazy iterator, or a stage of a pipeline.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_iterNext, #act_iterCollect
+struct act_Iter {
+  /// @cond
+  /// @internal Yields the next element (**NULL** at the end).
+  act__IterNextFn _next;
+
+  /// @internal The iterator the adapter pulls from.
+  act_Iter *_source;
+
+  /// @internal The second iterator of a zip.
+  act_Iter *_other;
+
+  /// @internal The elements of a vector or string source.
+  const char *_data;
+
+  /// @internal The number of elements of a source, or left to take.
+  size_t _len;
+
+  /// @internal The index of the next element of a source.
+  size_t _pos;
+
+  /// @internal The size of the yielded elements.
+  size_t _data_size;
+
+  /// @internal The function of a map.
+  act_IterMapFn _map;
+
+  /// @internal The predicate of a filter.
+  act_IterPredicateFn _predicate;
+
+  /// @internal The argument of the map or filter function.
+  void *_arg;
+
+  /// @internal The delimiter of a string split.
+  char _delimiter;
+
+  /// @internal The state of a codepoint source.
+  act_StringCodepointIter _codepoints;
+
+  /// @internal The allocator of the buffer of a chunk.
+  const act_Allocator *_allocator;
+
+  /// @internal The elements of a chunk gathered from its source.
+  char *_buffer;
+
+  /// @internal The max number of elements in a chunk.
+  size_t _chunk_len;
+
+  /// @internal The last element yielded by a map, zip, chunk, split or
+  /// codepoint source.
+  alignas(max_align_t) char _element[ACT_ITER_MAX_DATA_SIZE];
+  /// @endcond
+};
+
+/// @brief The possible error values.
+typedef enum act_IterError {
+  /// Successful operation.
+  ACT_ITER_ERROR_SUCCESS = 0x0,
+
+  /// The given iterator was **NULL**, or was not created successfully.
+  ACT_ITER_ERROR_NULL_ITER,
+
+  /// The given vector was **NULL**.
+  ACT_ITER_ERROR_NULL_VECTOR,
+
+  /// The given function was **NULL**.
+  ACT_ITER_ERROR_NULL_FUNCTION,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_ITER_ERROR_NULL_ALLOCATOR,
+
+  /// The given accumulator was **NULL**.
+  ACT_ITER_ERROR_NULL_ELEMENT,
+
+  /// A failure during allocation.
+  ACT_ITER_ERROR_ALLOCATION_FAILED,
+
+  /// The data size was zero, or larger than #ACT_ITER_MAX_DATA_SIZE.
+  ACT_ITER_ERROR_INVALID_DATA_SIZE,
+
+  /// The chunk length was zero.
+  ACT_ITER_ERROR_INVALID_LEN,
+} act_IterError;
+
+/// @brief Creates an iterator over the elements of an #act_Vector.
+///
+/// The vector must not be changed while the iterator is used.
+///
+/// @param[in]  vec         The vector to iterate over.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+///
+/// @return An iterator yielding pointers to the elements of @em vec.
+act_Iter act_iterFromVector(const act_Vector *vec, int *error_code);
+
+/// @brief Creates an iterator over the bytes (as **char**) of an
+/// #act_StringView.
+///
+/// @param view The view to iterate over.
+///
+/// @return An iterator yielding pointers to the bytes of @em view.
+act_Iter act_iterFromView(act_StringView view);
+
+/// @brief Creates an iterator over the UTF-8 codepoints (as **uint32_t**) of
+/// an #act_StringView.
+///
+/// Invalid sequences are decoded as in #act_stringCodepointIterNext.
+///
+/// @param view The view to iterate over.
+///
+/// @return An iterator yielding the codepoints of @em view.
+act_Iter act_iterCodepoints(act_StringView view);
+
+/// @brief Creates an iterator over the tokens (as #act_StringView) of an
+/// #act_StringView, split at every occurrence of a delimiter.
+///
+/// The tokens are the same as those of #act_stringViewSplitAll, without
+/// allocating them all up front.
+///
+/// @param view      The view to split.
+/// @param delimiter The character to split at.
+///
+/// @return An iterator yielding views of the tokens of @em view.
+act_Iter act_iterSplit(act_StringView view, char delimiter);
+
+/// @brief Creates an iterator over the results of a function on the elements
+/// of another iterator.
+///
+/// @param[in]  source         The iterator to map.
+/// @param[in]  out_data_size  The size of the results (at most
+///                            #ACT_ITER_MAX_DATA_SIZE).
+/// @param[in]  fn             The function computing each result.
+/// @param[in]  arg            The argument given to @em fn.
+/// @param[out] error_code     The error code (#act_IterError) of the
+///                            operation.
+///
+/// @return An iterator yielding the results of @em fn.
+act_Iter act_iterMap(act_Iter *source, size_t out_data_size, act_IterMapFn fn,
+                     void *arg, int *error_code);
+
+/// @brief Creates an iterator over the elements of another iterator that
+/// satisfy a predicate.
+///
+/// @param[in]  source      The iterator to filter.
+/// @param[in]  predicate   The predicate of the elements to keep.
+/// @param[in]  arg         The argument given to @em predicate.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+///
+/// @return An iterator yielding the kept elements.
+act_Iter act_iterFilter(act_Iter *source, act_IterPredicateFn predicate,
+                        void *arg, int *error_code);
+
+/// @brief Creates an iterator over the first elements of another iterator.
+///
+/// Once @em count elements have been yielded, the source is not pulled from
+/// again.
+///
+/// @param[in]  source      The iterator to take from.
+/// @param[in]  count       The max number of elements to yield.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+///
+/// @return An iterator yielding at most @em count elements.
+act_Iter act_iterTake(act_Iter *source, size_t count, int *error_code);
+
+/// @brief Creates an iterator over pairs of elements from two iterators, until
+/// either ends.
+///
+/// Each element is the bytes of the element of @em first, followed by those of
+/// the element of @em second (e.g. a struct of the two, if no padding goes
+/// between them).
+///
+/// @param[in]  first       The iterator of the first halves.
+/// @param[in]  second      The iterator of the second halves.
+/// @param[out] error_code  The error code (#act_IterError) of the operation;
+///                         #ACT_ITER_ERROR_INVALID_DATA_SIZE if the pairs are
+///                         larger than #ACT_ITER_MAX_DATA_SIZE.
+///
+/// @return An iterator yielding the pairs.
+act_Iter act_iterZip(act_Iter *first, act_Iter *second, int *error_code);
+
+/// @brief Creates an iterator over runs (as #act_IterChunk) of consecutive
+/// elements of another iterator.
+///
+/// Every run has @em chunk_len elements, but the last, which may be shorter.
+/// Runs of a vector or string source point into it; others are gathered into
+/// a buffer, which is reused for every run.
+///
+/// @param[in]  source      The iterator to cut into runs.
+/// @param[in]  chunk_len   The number of elements in a run.
+/// @param[in]  allocator   The allocator of the buffer.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+///
+/// @return An iterator yielding the runs.
+///
+/// @note This function allocates space for @em chunk_len elements, unless
+/// the source is a vector or string.
+///
+/// @sa #act_iterFree
+act_Iter act_iterChunk(act_Iter *source, size_t chunk_len,
+                       const act_Allocator *allocator, int *error_code);
+
+/// @brief Frees the memory allocated by an iterator (only chunks allocate).
+///
+/// @param[in]  iter        The iterator to free.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+void act_iterFree(act_Iter *iter, int *error_code);
+
+/// @brief Returns the size of the elements of an iterator.
+///
+/// @param iter The iterator.
+///
+/// @return The size of the elements.
+size_t act_iterDataSize(const act_Iter *iter);
+
+/// @brief Advances an iterator.
+///
+/// @param[in]  iter  The iterator to advance.
+///
+/// @return A pointer to the next element, valid until the next call, or
+/// **NULL** once the iterator has ended.
+const void *act_iterNext(act_Iter *iter);
+
+/// @brief Copies the remaining elements of an iterator into a new
+/// #act_Vector.
+///
+/// @param[in]  iter        The iterator to consume.
+/// @param[in]  allocator   The allocator of the vector.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+///
+/// @return A new vector of the elements, or **NULL** on error.
+///
+/// @note This function allocates the vector, which grows geometrically.
+act_Vector *act_iterCollect(act_Iter *iter, const act_Allocator *allocator,
+                            int *error_code);
+
+/// @brief Combines the remaining elements of an iterator, in order, into an
+/// accumulator.
+///
+/// @param[in]     iter        The iterator to consume.
+/// @param[in,out] acc         The accumulator, holding the initial value.
+/// @param[in]     combine     The function combining an element into the
+///                            accumulator.
+/// @param[in]     arg         The argument given to @em combine.
+/// @param[out]    error_code  The error code (#act_IterError) of the
+///                            operation.
+void act_iterReduce(act_Iter *iter, void *acc, act_IterCombineFn combine,
+                    void *arg, int *error_code);
+
+/// @brief Calls a function on every remaining element of an iterator, in
+/// order.
+///
+/// @param[in]  iter        The iterator to consume.
+/// @param[in]  fn          The function to call.
+/// @param[in]  arg         The argument given to @em fn.
+/// @param[out] error_code  The error code (#act_IterError) of the operation.
+///
+/// @return The number of elements consumed.
+size_t act_iterForEach(act_Iter *iter, act_IterForEachFn fn, void *arg,
+                       int *error_code);
+
+#endif /* !ACT_ITER_H */
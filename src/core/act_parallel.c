@@ -0,0 +1,620 @@
+#include "act_parallel.h"
+#include <string.h>
+
+/// The smallest number of elements in a block; a multiple of 64, so the
+/// blocks of a filter own whole words of its bitmap.
+#define ACT__PARALLEL_MIN_BLOCK 4096
+
+/// The number of blocks per worker, so that workers that finish early can
+/// steal some.
+#define ACT__PARALLEL_BLOCKS_PER_THREAD 8
+
+typedef struct act__ParallelJob act__ParallelJob;
+
+/// Combines a block of elements, in order, into an accumulator.
+typedef void (*act__ParallelReduceFn)(const act__ParallelJob *job,
+                                      const char *elements, size_t len,
+                                      void *acc);
+
+/// Scans a block of elements in place, starting from an accumulator (and
+/// with space for an element in @em tmp).
+typedef void (*act__ParallelScanFn)(const act__ParallelJob *job,
+                                    char *elements, size_t len, void *acc,
+                                    void *tmp);
+
+/// The state shared by the blocks of an algorithm.
+struct act__ParallelJob {
+  /// The elements of the vector.
+  char *data;
+
+  /// The size of an element.
+  size_t data_size;
+
+  /// The number of elements.
+  size_t len;
+
+  /// The number of elements in a block (but the last).
+  size_t block_len;
+
+  /// The argument of the user's function.
+  void *arg;
+
+  /// The identity of the combining function.
+  const void *identity;
+
+  /// The combining function of reductions and scans.
+  act_ParallelCombineFn combine;
+
+  /// Reduces a block.
+  act__ParallelReduceFn reduce;
+
+  /// Scans a block.
+  act__ParallelScanFn scan;
+
+  /// Whether the scan includes each element in its own result.
+  bool inclusive;
+
+  /// Space for an element per block (and the running total), for scans.
+  char *scratch;
+
+  /// The function of maps.
+  act_ParallelMapFn map;
+
+  /// The predicate of filters.
+  act_ParallelPredicateFn predicate;
+
+  /// The elements of the output, for maps and filters.
+  char *out;
+
+  /// The size of an element of the output.
+  size_t out_data_size;
+
+  /// A bit per element, set for the elements kept by filters.
+  uint64_t *bitmap;
+};
+
+/// Returns the number of elements in a block, for a vector of @em len
+/// elements.
+static size_t act__parallelBlockLen(const act_ThreadPool *pool, size_t len) {
+  size_t blocks =
+      act_threadPoolNumThreads(pool) * ACT__PARALLEL_BLOCKS_PER_THREAD;
+  size_t block_len = (len + blocks - 1) / blocks;
+  block_len =
+      block_len < ACT__PARALLEL_MIN_BLOCK ? ACT__PARALLEL_MIN_BLOCK : block_len;
+  return (block_len + 63) & ~(size_t)63;
+}
+
+/// Returns the number of elements in block @em block of a job.
+static size_t act__parallelBlockSize(const act__ParallelJob *job,
+                                     size_t block) {
+  size_t first = block * job->block_len;
+  return job->len - first < job->block_len ? job->len - first
+                                           : job->block_len;
+}
+
+/// Checks the arguments common to all the algorithms.
+static bool act__parallelCheck(const act_ThreadPool *pool,
+                               const act_Vector *vec, bool has_fn,
+                               int *error_code) {
+  *error_code = ACT_PARALLEL_ERROR_SUCCESS;
+
+  if (pool == NULL || act_threadPoolNumThreads(pool) == 0) {
+    *error_code = ACT_PARALLEL_ERROR_NULL_POOL;
+    return false;
+  }
+  if (vec == NULL) {
+    *error_code = ACT_PARALLEL_ERROR_NULL_VECTOR;
+    return false;
+  }
+  if (!has_fn) {
+    *error_code = ACT_PARALLEL_ERROR_NULL_FUNCTION;
+    return false;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (act_vectorDataSize(vec, &vec_err) == 0) {
+    *error_code = ACT_PARALLEL_ERROR_INVALID_DATA_SIZE;
+    return false;
+  }
+
+  return true;
+}
+
+/// Reduces a block with the user's combining function.
+static void act__parallelReduceGeneric(const act__ParallelJob *job,
+                                       const char *elements, size_t len,
+                                       void *acc) {
+  for (size_t i = 0; i < len; i++) {
+    job->combine(acc, elements + i * job->data_size, job->arg);
+  }
+}
+
+/// Scans a block with the user's combining function.
+static void act__parallelScanGeneric(const act__ParallelJob *job,
+                                     char *elements, size_t len, void *acc,
+                                     void *tmp) {
+  const size_t size = job->data_size;
+  for (char *element = elements; element < elements + len * size;
+       element += size) {
+    if (job->inclusive) {
+      job->combine(acc, element, job->arg);
+      memcpy(element, acc, size);
+    } else {
+      memcpy(tmp, element, size);
+      memcpy(element, acc, size);
+      job->combine(acc, tmp, job->arg);
+    }
+  }
+}
+
+/// Defines the combining function and the block kernels of sums of elements
+/// of type @em T, with names ending in @em S. The reductions keep four
+/// independent sums, so that floating point additions can be vectorized
+/// without reordering them.
+#define ACT__PARALLEL_DEFINE_SUM(S, T)                                         \
+  static void act__parallelAdd##S(void *acc, const void *element, void *arg) { \
+    (void)arg;                                                                 \
+    *(T *)acc += *(const T *)element;                                          \
+  }                                                                            \
+                                                                               \
+  static void act__parallelReduceSum##S(const act__ParallelJob *job,           \
+                                        const char *elements, size_t len,      \
+                                        void *acc) {                           \
+    (void)job;                                                                 \
+    const T *values = (const T *)elements;                                     \
+    T lanes[4] = {0};                                                          \
+    size_t i = 0;                                                              \
+    for (; i + 4 <= len; i += 4) {                                             \
+      lanes[0] += values[i];                                                   \
+      lanes[1] += values[i + 1];                                               \
+      lanes[2] += values[i + 2];                                               \
+      lanes[3] += values[i + 3];                                               \
+    }                                                                          \
+    T sum = *(T *)acc + ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]));       \
+    for (; i < len; i++) {                                                     \
+      sum += values[i];                                                        \
+    }                                                                          \
+    *(T *)acc = sum;                                                           \
+  }                                                                            \
+                                                                               \
+  static void act__parallelScanSum##S(const act__ParallelJob *job,             \
+                                      char *elements, size_t len, void *acc,   \
+                                      void *tmp) {                             \
+    (void)tmp;                                                                 \
+    T *values = (T *)elements;                                                 \
+    T sum = *(T *)acc;                                                         \
+    if (job->inclusive) {                                                      \
+      for (size_t i = 0; i < len; i++) {                                       \
+        sum += values[i];                                                      \
+        values[i] = sum;                                                       \
+      }                                                                        \
+    } else {                                                                   \
+      for (size_t i = 0; i < len; i++) {                                       \
+        T value = values[i];                                                   \
+        values[i] = sum;                                                       \
+        sum += value;                                                          \
+      }                                                                        \
+    }                                                                          \
+    *(T *)acc = sum;                                                           \
+  }
+
+// Signed sums use the unsigned kernels, which wrap around on overflow
+ACT__PARALLEL_DEFINE_SUM(U64, uint64_t)
+ACT__PARALLEL_DEFINE_SUM(F64, double)
+
+/// Reduces the blocks of a job, one per partial result.
+static void act__parallelReduceBlocks(void *partials, size_t start,
+                                      size_t count, void *arg) {
+  const act__ParallelJob *job = arg;
+  char *partial = partials;
+  for (size_t block = start; block < start + count; block++) {
+    memcpy(partial, job->identity, job->data_size);
+    job->reduce(job, job->data + block * job->block_len * job->data_size,
+                act__parallelBlockSize(job, block), partial);
+    partial += job->data_size;
+  }
+}
+
+/// Scans the blocks of a job, each from the prefix before it.
+static void act__parallelScanBlocks(void *prefixes, size_t start,
+                                    size_t count, void *arg) {
+  const act__ParallelJob *job = arg;
+  char *prefix = prefixes;
+  for (size_t block = start; block < start + count; block++) {
+    job->scan(job, job->data + block * job->block_len * job->data_size,
+              act__parallelBlockSize(job, block), prefix,
+              job->scratch + block * job->data_size);
+    prefix += job->data_size;
+  }
+}
+
+/// Reduces the elements of a job into @em result; for scans (whose result
+/// may be **NULL**), then scans them in place.
+static void act__parallelRun(act_ThreadPool *pool, act__ParallelJob *job,
+                             void *result, int *error_code) {
+  const size_t size = job->data_size;
+  if (result != NULL) {
+    memcpy(result, job->identity, size);
+  }
+  if (job->len == 0) {
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const act_Allocator *allocator = act_vectorAllocator(job->data, &vec_err);
+  job->block_len = act__parallelBlockLen(pool, job->len);
+  size_t num_blocks = (job->len + job->block_len - 1) / job->block_len;
+
+  act_Vector *partials =
+      act_vectorWithCapacity(allocator, size, num_blocks, &vec_err);
+  if (partials == NULL) {
+    *error_code = ACT_PARALLEL_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+  act__vectorSetLen(partials, num_blocks, &vec_err);
+
+  if (job->scan != NULL) {
+    job->scratch = (*allocator->alloc)(num_blocks + 1, size);
+    if (job->scratch == NULL) {
+      act_vectorFree(partials, &vec_err);
+      *error_code = ACT_PARALLEL_ERROR_ALLOCATION_FAILED;
+      return;
+    }
+    if (result == NULL) {
+      result = job->scratch + num_blocks * size;
+      memcpy(result, job->identity, size);
+    }
+  }
+
+  int pool_err = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_parallelFor(pool, partials, 1, act__parallelReduceBlocks, job,
+                  &pool_err);
+
+  // Combine the blocks in order; for scans, each block's result is replaced
+  // with the prefix before it
+  char *partial = partials;
+  for (size_t block = 0; block < num_blocks; block++) {
+    if (job->scan != NULL) {
+      char *tmp = job->scratch + block * size;
+      memcpy(tmp, partial, size);
+      memcpy(partial, result, size);
+      job->combine(result, tmp, job->arg);
+    } else {
+      job->combine(result, partial, job->arg);
+    }
+    partial += size;
+  }
+
+  if (job->scan != NULL) {
+    act_parallelFor(pool, partials, 1, act__parallelScanBlocks, job,
+                    &pool_err);
+    (*allocator->free)(job->scratch);
+  }
+  act_vectorFree(partials, &vec_err);
+}
+
+/// Checks the arguments of a reduction or scan, and sets up its job.
+static bool act__parallelSetUp(act_ThreadPool *pool, const act_Vector *vec,
+                               size_t data_size, const void *identity,
+                               act_ParallelCombineFn combine, void *arg,
+                               act__ParallelJob *job, int *error_code) {
+  if (!act__parallelCheck(pool, vec, combine != NULL, error_code)) {
+    return false;
+  }
+  if (identity == NULL) {
+    *error_code = ACT_PARALLEL_ERROR_NULL_ELEMENT;
+    return false;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  if (data_size != 0 && size != data_size) {
+    *error_code = ACT_PARALLEL_ERROR_INVALID_DATA_SIZE;
+    return false;
+  }
+
+  *job = (act__ParallelJob){
+      .data = (char *)vec,
+      .data_size = size,
+      .len = act_vectorLen(vec, &vec_err),
+      .arg = arg,
+      .identity = identity,
+      .combine = combine,
+  };
+  return true;
+}
+
+/// Scans an #act_Vector in place with the given kernel.
+static void act__parallelScan(act_ThreadPool *pool, act_Vector *vec,
+                              size_t data_size, const void *identity,
+                              act_ParallelCombineFn combine, void *arg,
+                              act__ParallelReduceFn reduce,
+                              act__ParallelScanFn scan, bool inclusive,
+                              int *error_code) {
+  act__ParallelJob job;
+  if (!act__parallelSetUp(pool, vec, data_size, identity, combine, arg, &job,
+                          error_code)) {
+    return;
+  }
+  job.reduce = reduce;
+  job.scan = scan;
+  job.inclusive = inclusive;
+  act__parallelRun(pool, &job, NULL, error_code);
+}
+
+/// Sums an #act_Vector of 8 byte numbers with the given kernels.
+static void act__parallelSum(act_ThreadPool *pool, const act_Vector *vec,
+                             void *result, act_ParallelCombineFn combine,
+                             act__ParallelReduceFn reduce, int *error_code) {
+  const uint64_t zero = 0;
+  act__ParallelJob job;
+  if (!act__parallelSetUp(pool, vec, sizeof(zero), &zero, combine, NULL,
+                          &job, error_code)) {
+    return;
+  }
+  job.reduce = reduce;
+  act__parallelRun(pool, &job, result, error_code);
+}
+
+/// Maps a piece of the output of a map.
+static void act__parallelMapPiece(void *out, size_t start, size_t len,
+                                  void *arg) {
+  const act__ParallelJob *job = arg;
+  const char *in = job->data + start * job->data_size;
+  char *dst = out;
+  for (size_t i = 0; i < len; i++) {
+    job->map(in, dst, job->arg);
+    in += job->data_size;
+    dst += job->out_data_size;
+  }
+}
+
+/// Tests the elements of the blocks of a filter, setting their bits, and
+/// counts the kept elements of each block.
+static void act__parallelFlagBlocks(void *counts, size_t start, size_t count,
+                                    void *arg) {
+  const act__ParallelJob *job = arg;
+  size_t *block_counts = counts;
+  for (size_t block = start; block < start + count; block++) {
+    size_t first = block * job->block_len;
+    size_t len = act__parallelBlockSize(job, block);
+    const char *element = job->data + first * job->data_size;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < len; i += 64) {
+      size_t word_len = len - i < 64 ? len - i : 64;
+      uint64_t word = 0;
+      for (size_t bit = 0; bit < word_len; bit++) {
+        word |= (uint64_t)job->predicate(element, job->arg) << bit;
+        element += job->data_size;
+      }
+      job->bitmap[(first + i) / 64] = word;
+      kept += (size_t)__builtin_popcountll(word);
+    }
+    block_counts[block - start] = kept;
+  }
+}
+
+/// Copies the kept elements of the blocks of a filter to their offsets in
+/// the output.
+static void act__parallelCompactBlocks(void *offsets, size_t start,
+                                       size_t count, void *arg) {
+  const act__ParallelJob *job = arg;
+  const size_t *block_offsets = offsets;
+  for (size_t block = start; block < start + count; block++) {
+    size_t first = block * job->block_len;
+    size_t len = act__parallelBlockSize(job, block);
+    char *dst = job->out + block_offsets[block - start] * job->data_size;
+
+    for (size_t i = 0; i < len; i += 64) {
+      uint64_t word = job->bitmap[(first + i) / 64];
+      while (word != 0) {
+        size_t bit = (size_t)__builtin_ctzll(word);
+        memcpy(dst, job->data + (first + i + bit) * job->data_size,
+               job->data_size);
+        dst += job->data_size;
+        word &= word - 1;
+      }
+    }
+  }
+}
+
+act_Vector *act_parallelMap(act_ThreadPool *pool, const act_Vector *vec,
+                            size_t out_data_size, act_ParallelMapFn fn,
+                            void *arg, int *error_code) {
+  if (!act__parallelCheck(pool, vec, fn != NULL, error_code)) {
+    return NULL;
+  }
+  if (out_data_size == 0) {
+    *error_code = ACT_PARALLEL_ERROR_INVALID_DATA_SIZE;
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  act_Vector *out =
+      act_vectorWithCapacity(allocator, out_data_size, len, &vec_err);
+  if (out == NULL) {
+    *error_code = ACT_PARALLEL_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+  act__vectorSetLen(out, len, &vec_err);
+
+  act__ParallelJob job = {
+      .data = (char *)vec,
+      .data_size = act_vectorDataSize(vec, &vec_err),
+      .len = len,
+      .arg = arg,
+      .map = fn,
+      .out_data_size = out_data_size,
+  };
+
+  // Loop over the output, which is indexed like the input
+  int pool_err = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_parallelFor(pool, out, act__parallelBlockLen(pool, len),
+                  act__parallelMapPiece, &job, &pool_err);
+
+  return out;
+}
+
+act_Vector *act_parallelFilter(act_ThreadPool *pool, const act_Vector *vec,
+                               act_ParallelPredicateFn predicate, void *arg,
+                               int *error_code) {
+  if (!act__parallelCheck(pool, vec, predicate != NULL, error_code)) {
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  act__ParallelJob job = {
+      .data = (char *)vec,
+      .data_size = act_vectorDataSize(vec, &vec_err),
+      .len = act_vectorLen(vec, &vec_err),
+      .arg = arg,
+      .predicate = predicate,
+  };
+  job.block_len = act__parallelBlockLen(pool, job.len);
+  size_t num_blocks = (job.len + job.block_len - 1) / job.block_len;
+
+  act_Vector *counts =
+      act_vectorWithCapacity(allocator, sizeof(size_t), num_blocks, &vec_err);
+  job.bitmap = (*allocator->alloc)((job.len + 63) / 64 + 1, sizeof(uint64_t));
+  if (counts == NULL || job.bitmap == NULL) {
+    if (counts != NULL) {
+      act_vectorFree(counts, &vec_err);
+    }
+    if (job.bitmap != NULL) {
+      (*allocator->free)(job.bitmap);
+    }
+    *error_code = ACT_PARALLEL_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+  act__vectorSetLen(counts, num_blocks, &vec_err);
+
+  int pool_err = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_parallelFor(pool, counts, 1, act__parallelFlagBlocks, &job, &pool_err);
+
+  // The kept elements of each block go after those of the blocks before it
+  size_t *offsets = counts;
+  size_t total = 0;
+  for (size_t block = 0; block < num_blocks; block++) {
+    size_t kept = offsets[block];
+    offsets[block] = total;
+    total += kept;
+  }
+
+  act_Vector *out =
+      act_vectorWithCapacity(allocator, job.data_size, total, &vec_err);
+  if (out != NULL) {
+    act__vectorSetLen(out, total, &vec_err);
+    job.out = out;
+    act_parallelFor(pool, counts, 1, act__parallelCompactBlocks, &job,
+                    &pool_err);
+  } else {
+    *error_code = ACT_PARALLEL_ERROR_ALLOCATION_FAILED;
+  }
+
+  (*allocator->free)(job.bitmap);
+  act_vectorFree(counts, &vec_err);
+  return out;
+}
+
+void act_parallelReduce(act_ThreadPool *pool, const act_Vector *vec,
+                        const void *identity, void *result,
+                        act_ParallelCombineFn combine, void *arg,
+                        int *error_code) {
+  act__ParallelJob job;
+  if (!act__parallelSetUp(pool, vec, 0, identity, combine, arg, &job,
+                          error_code)) {
+    return;
+  }
+  if (result == NULL) {
+    *error_code = ACT_PARALLEL_ERROR_NULL_ELEMENT;
+    return;
+  }
+
+  job.reduce = act__parallelReduceGeneric;
+  act__parallelRun(pool, &job, result, error_code);
+}
+
+void act_parallelInclusiveScan(act_ThreadPool *pool, act_Vector *vec,
+                               const void *identity,
+                               act_ParallelCombineFn combine, void *arg,
+                               int *error_code) {
+  act__parallelScan(pool, vec, 0, identity, combine, arg,
+                    act__parallelReduceGeneric, act__parallelScanGeneric,
+                    true, error_code);
+}
+
+void act_parallelExclusiveScan(act_ThreadPool *pool, act_Vector *vec,
+                               const void *identity,
+                               act_ParallelCombineFn combine, void *arg,
+                               int *error_code) {
+  act__parallelScan(pool, vec, 0, identity, combine, arg,
+                    act__parallelReduceGeneric, act__parallelScanGeneric,
+                    false, error_code);
+}
+
+uint64_t act_parallelSumU64(act_ThreadPool *pool, const act_Vector *vec,
+                            int *error_code) {
+  uint64_t sum = 0;
+  act__parallelSum(pool, vec, &sum, act__parallelAddU64,
+                   act__parallelReduceSumU64, error_code);
+  return sum;
+}
+
+int64_t act_parallelSumI64(act_ThreadPool *pool, const act_Vector *vec,
+                           int *error_code) {
+  return (int64_t)act_parallelSumU64(pool, vec, error_code);
+}
+
+double act_parallelSumF64(act_ThreadPool *pool, const act_Vector *vec,
+                          int *error_code) {
+  double sum = 0;
+  act__parallelSum(pool, vec, &sum, act__parallelAddF64,
+                   act__parallelReduceSumF64, error_code);
+  return sum;
+}
+
+void act_parallelInclusiveScanU64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code) {
+  const uint64_t zero = 0;
+  act__parallelScan(pool, vec, sizeof(uint64_t), &zero, act__parallelAddU64,
+                    NULL, act__parallelReduceSumU64, act__parallelScanSumU64,
+                    true, error_code);
+}
+
+void act_parallelInclusiveScanI64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code) {
+  act_parallelInclusiveScanU64(pool, vec, error_code);
+}
+
+void act_parallelInclusiveScanF64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code) {
+  const double zero = 0;
+  act__parallelScan(pool, vec, sizeof(double), &zero, act__parallelAddF64,
+                    NULL, act__parallelReduceSumF64, act__parallelScanSumF64,
+                    true, error_code);
+}
+
+void act_parallelExclusiveScanU64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code) {
+  const uint64_t zero = 0;
+  act__parallelScan(pool, vec, sizeof(uint64_t), &zero, act__parallelAddU64,
+                    NULL, act__parallelReduceSumU64, act__parallelScanSumU64,
+                    false, error_code);
+}
+
+void act_parallelExclusiveScanI64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code) {
+  act_parallelExclusiveScanU64(pool, vec, error_code);
+}
+
+void act_parallelExclusiveScanF64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code) {
+  const double zero = 0;
+  act__parallelScan(pool, vec, sizeof(double), &zero, act__parallelAddF64,
+                    NULL, act__parallelReduceSumF64, act__parallelScanSumF64,
+                    false, error_code);
+}
@@ -0,0 +1,296 @@
+#ifndef ACT_PARALLEL_H
+#define ACT_PARALLEL_H
+
+#include "act_allocator.h"
+#include "act_thread_pool.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_parallel.h
+///
+/// This header defines data-parallel algorithms over the elements of an
+/// #act_Vector, run on an #act_ThreadPool: map, filter, reduce and prefix
+/// scans.
+///
+/// The vector is cut into blocks of consecutive elements, a few per worker.
+/// A reduction reduces every block in parallel, then combines the results of
+/// the blocks in order. A scan does the same, turns the results of the blocks
+/// into the prefix before each block, then scans every block in parallel
+/// starting from its prefix. A filter tests every element once, recording the
+/// results in a bitmap and counting them per block; the counts give the
+/// position of each block's elements in the output, so the blocks are copied
+/// out in parallel and the elements stay in order.
+///
+/// Combining functions must be associative, since the elements are grouped
+/// differently than in a serial loop, but need not be commutative:
+/// #act_parallelReduce and the scans that take a function always combine the
+/// elements in order. The grouping only depends on the length of the vector
+/// and the number of workers, so results (e.g. of floating point sums) are
+/// the same from run to run on the same pool.
+///
+/// The **uint64_t**, **int64_t** and **double** versions of the sum and the
+/// scans add the elements in tight loops, instead of calling a function for
+/// each element; the sums keep a few independent totals, so the compiler can
+/// vectorize them. Signed sums wrap around on overflow. The totals interleave
+/// the elements of a block, so the **double** sums (and the prefixes of the
+/// **double** scans) do not add the elements in order: they are reassociated,
+/// and may differ in the last bits from a serial loop's, though they are
+/// still the same from run to run on the same pool.
+
+/// @brief Computes the element of the output of #act_parallelMap for an
+/// element of the input.
+///
+/// @param element The element of the input.
+/// @param out     Where to write the element of the output.
+/// @param arg     The argument given to #act_parallelMap.
+typedef void (*act_ParallelMapFn)(const void *element, void *out, void *arg);
+
+/// @brief Returns whether #act_parallelFilter should keep an element.
+///
+/// @param element The element.
+/// @param arg     The argument given to #act_parallelFilter.
+///
+/// @return **true** if the element is kept, **false** otherwise.
+typedef bool (*act_ParallelPredicateFn)(const void *element, void *arg);
+
+/// @brief Combines an element into an accumulator (e.g. adds it), for
+/// reductions and scans; must be associative.
+///
+/// @param acc     The accumulator, which holds the combination of the elements
+///                before @em element.
+/// @param element The element to combine into the accumulator.
+/// @param arg     The argument given to the reduction or scan.
+typedef void (*act_ParallelCombineFn)(void *acc, const void *element,
+                                      void *arg);
+
+/// @brief The possible error values.
+typedef enum act_ParallelError {
+  /// Successful operation.
+  ACT_PARALLEL_ERROR_SUCCESS = 0x0,
+
+  /// The given pool was **NULL** or already freed.
+  ACT_PARALLEL_ERROR_NULL_POOL,
+
+  /// The given vector was **NULL**.
+  ACT_PARALLEL_ERROR_NULL_VECTOR,
+
+  /// The given function was **NULL**.
+  ACT_PARALLEL_ERROR_NULL_FUNCTION,
+
+  /// The given identity or result was **NULL**.
+  ACT_PARALLEL_ERROR_NULL_ELEMENT,
+
+  /// A failure during allocation.
+  ACT_PARALLEL_ERROR_ALLOCATION_FAILED,
+
+  /// The data size was zero, or doesn't match the type of the function.
+  ACT_PARALLEL_ERROR_INVALID_DATA_SIZE,
+} act_ParallelError;
+
+/// @brief Maps every element of an #act_Vector into a new vector, in
+/// parallel.
+///
+/// @param[in]  pool           The pool to run on.
+/// @param[in]  vec            The vector to map.
+/// @param[in]  out_data_size  The data size of the new vector.
+/// @param[in]  fn             The function computing each new element.
+/// @param[in]  arg            The argument given to @em fn.
+/// @param[out] error_code     The error code (#act_ParallelError) of the
+///                            operation.
+///
+/// @return The new vector, of the same length, using the allocator of
+/// @em vec.
+///
+/// @note This function allocates the new vector.
+act_Vector *act_parallelMap(act_ThreadPool *pool, const act_Vector *vec,
+                            size_t out_data_size, act_ParallelMapFn fn,
+                            void *arg, int *error_code);
+
+/// @brief Copies the elements of an #act_Vector that satisfy a predicate into
+/// a new vector, in order, in parallel.
+///
+/// The predicate is called exactly once for each element.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to filter.
+/// @param[in]  predicate   The predicate of the elements to keep.
+/// @param[in]  arg         The argument given to @em predicate.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @return The new vector, using the allocator of @em vec.
+///
+/// @note This function allocates the new vector (with no spare capacity),
+/// a bit per element, and a count per block.
+act_Vector *act_parallelFilter(act_ThreadPool *pool, const act_Vector *vec,
+                               act_ParallelPredicateFn predicate, void *arg,
+                               int *error_code);
+
+/// @brief Combines all the elements of an #act_Vector, in order, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to reduce.
+/// @param[in]  identity    The identity of @em combine (e.g. zero for sums),
+///                         of the vector's data size.
+/// @param[out] result      Where to write the combination of the elements (the
+///                         identity, if the vector is empty).
+/// @param[in]  combine     The associative function combining the elements.
+/// @param[in]  arg         The argument given to @em combine.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @note This function allocates a result per block.
+void act_parallelReduce(act_ThreadPool *pool, const act_Vector *vec,
+                        const void *identity, void *result,
+                        act_ParallelCombineFn combine, void *arg,
+                        int *error_code);
+
+/// @brief Replaces every element of an #act_Vector with the combination of
+/// itself and the elements before it, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[in]  identity    The identity of @em combine, of the vector's data
+///                         size.
+/// @param[in]  combine     The associative function combining the elements.
+/// @param[in]  arg         The argument given to @em combine.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @note This function allocates two elements per block, and one more.
+///
+/// @sa #act_parallelExclusiveScan
+void act_parallelInclusiveScan(act_ThreadPool *pool, act_Vector *vec,
+                               const void *identity,
+                               act_ParallelCombineFn combine, void *arg,
+                               int *error_code);
+
+/// @brief Replaces every element of an #act_Vector with the combination of
+/// the elements before it (the identity, for the first), in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[in]  identity    The identity of @em combine, of the vector's data
+///                         size.
+/// @param[in]  combine     The associative function combining the elements.
+/// @param[in]  arg         The argument given to @em combine.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @note This function allocates two elements per block, and one more.
+///
+/// @sa #act_parallelInclusiveScan
+void act_parallelExclusiveScan(act_ThreadPool *pool, act_Vector *vec,
+                               const void *identity,
+                               act_ParallelCombineFn combine, void *arg,
+                               int *error_code);
+
+/// @brief Returns the sum of an #act_Vector of **uint64_t**, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to sum.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @return The sum, modulo 2^64.
+uint64_t act_parallelSumU64(act_ThreadPool *pool, const act_Vector *vec,
+                            int *error_code);
+
+/// @brief Returns the sum of an #act_Vector of **int64_t**, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to sum.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @return The sum, wrapped around on overflow.
+int64_t act_parallelSumI64(act_ThreadPool *pool, const act_Vector *vec,
+                           int *error_code);
+
+/// @brief Returns the sum of an #act_Vector of **double**, in parallel.
+///
+/// The additions are reassociated (grouped by block, and spread over a few
+/// interleaved totals within a block), so the sum may differ in the last bits
+/// from a serial loop's.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to sum.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+///
+/// @return The sum.
+double act_parallelSumF64(act_ThreadPool *pool, const act_Vector *vec,
+                          int *error_code);
+
+/// @brief Replaces every element of an #act_Vector of **uint64_t** with the
+/// sum of itself and the elements before it, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+void act_parallelInclusiveScanU64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code);
+
+/// @brief Replaces every element of an #act_Vector of **int64_t** with the
+/// sum of itself and the elements before it, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+void act_parallelInclusiveScanI64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code);
+
+/// @brief Replaces every element of an #act_Vector of **double** with the
+/// sum of itself and the elements before it, in parallel.
+///
+/// The prefix of each block comes from reassociated sums (see
+/// #act_parallelSumF64), so the results may differ in the last bits from a
+/// serial loop's.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+void act_parallelInclusiveScanF64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code);
+
+/// @brief Replaces every element of an #act_Vector of **uint64_t** with the
+/// sum of the elements before it, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+void act_parallelExclusiveScanU64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code);
+
+/// @brief Replaces every element of an #act_Vector of **int64_t** with the
+/// sum of the elements before it, in parallel.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+void act_parallelExclusiveScanI64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code);
+
+/// @brief Replaces every element of an #act_Vector of **double** with the
+/// sum of the elements before it, in parallel.
+///
+/// The prefix of each block comes from reassociated sums (see
+/// #act_parallelSumF64), so the results may differ in the last bits from a
+/// serial loop's.
+///
+/// @param[in]  pool        The pool to run on.
+/// @param[in]  vec         The vector to scan in place.
+/// @param[out] error_code  The error code (#act_ParallelError) of the
+///                         operation.
+void act_parallelExclusiveScanF64(act_ThreadPool *pool, act_Vector *vec,
+                                  int *error_code);
+
+#endif /* !ACT_PARALLEL_H */
@@ -0,0 +1,502 @@
+#include "act_queue.h"
+#include <string.h>
+
+/// The size of a cache line.
+#define ACT__QUEUE_CACHE_LINE 64
+
+struct act__QueueIndices {
+  /// Keeps the indices off the cache lines of neighbouring allocations.
+  char pad0[ACT__QUEUE_CACHE_LINE];
+
+  /// The position of the next push.
+  _Atomic size_t tail;
+
+  /// The consumer's index, as last read by the (single) producer.
+  size_t cached_head;
+
+  /// Keeps the producers' and consumers' indices on separate cache lines.
+  char pad1[ACT__QUEUE_CACHE_LINE];
+
+  /// The position of the next pop.
+  _Atomic size_t head;
+
+  /// The producer's index, as last read by the (single) consumer.
+  size_t cached_tail;
+
+  /// Keeps the indices off the cache lines of neighbouring allocations.
+  char pad2[ACT__QUEUE_CACHE_LINE];
+};
+
+/// Rounds a capacity up to a power of two (of at least @em min), or returns
+/// zero if it is too large.
+static size_t act__queueCapacity(size_t capacity, size_t min) {
+  if (capacity > SIZE_MAX / 2 + 1) {
+    return 0;
+  }
+
+  size_t pow2 = min;
+  while (pow2 < capacity) {
+    pow2 *= 2;
+  }
+  return pow2;
+}
+
+/// Makes the indices of a new queue.
+static act__QueueIndices *act__queueNewIndices(const act_Allocator *allocator) {
+  act__QueueIndices *indices = allocator->alloc(1, sizeof(*indices));
+  if (indices != NULL) {
+    atomic_init(&indices->tail, 0);
+    atomic_init(&indices->head, 0);
+    indices->cached_head = 0;
+    indices->cached_tail = 0;
+  }
+  return indices;
+}
+
+/// Returns a pointer to the element of an SPSC queue at @em pos.
+static inline char *act__spscQueueAt(const act_SpscQueue *queue, size_t pos) {
+  return queue->_buffer + (pos & queue->_mask) * queue->_data_size;
+}
+
+/// Copies @em count elements into an SPSC queue from @em pos, wrapping around
+/// the end of the ring.
+static void act__spscQueueCopyIn(act_SpscQueue *queue, size_t pos,
+                                 const char *src, size_t count) {
+  size_t until_end = queue->_mask + 1 - (pos & queue->_mask);
+  size_t first = count < until_end ? count : until_end;
+  memcpy(act__spscQueueAt(queue, pos), src, first * queue->_data_size);
+  memcpy(queue->_buffer, src + first * queue->_data_size,
+         (count - first) * queue->_data_size);
+}
+
+/// Copies @em count elements out of an SPSC queue from @em pos, wrapping
+/// around the end of the ring.
+static void act__spscQueueCopyOut(const act_SpscQueue *queue, size_t pos,
+                                  char *dst, size_t count) {
+  size_t until_end = queue->_mask + 1 - (pos & queue->_mask);
+  size_t first = count < until_end ? count : until_end;
+  memcpy(dst, act__spscQueueAt(queue, pos), first * queue->_data_size);
+  memcpy(dst + first * queue->_data_size, queue->_buffer,
+         (count - first) * queue->_data_size);
+}
+
+/// Returns the sequence number of the slot of an MPMC queue at @em pos.
+static inline _Atomic size_t *act__mpmcQueueSeq(const act_MpmcQueue *queue,
+                                                size_t pos) {
+  return (_Atomic size_t *)(queue->_slots +
+                            (pos & queue->_mask) * queue->_stride);
+}
+
+/// Returns the element of the slot of an MPMC queue at @em pos.
+static inline char *act__mpmcQueueAt(const act_MpmcQueue *queue,
+                                     size_t pos) {
+  return (char *)act__mpmcQueueSeq(queue, pos) + sizeof(_Atomic size_t);
+}
+
+act_SpscQueue act_spscQueueNew(const act_Allocator *allocator,
+                               size_t data_size, size_t capacity,
+                               int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ALLOCATOR;
+    return (act_SpscQueue){0};
+  }
+  if (data_size == 0) {
+    *error_code = ACT_QUEUE_ERROR_INVALID_DATA_SIZE;
+    return (act_SpscQueue){0};
+  }
+  size_t slots = act__queueCapacity(capacity, 1);
+  if (capacity == 0 || slots == 0) {
+    *error_code = ACT_QUEUE_ERROR_INVALID_CAPACITY;
+    return (act_SpscQueue){0};
+  }
+
+  act__QueueIndices *indices = act__queueNewIndices(allocator);
+  char *buffer = allocator->alloc(slots, data_size);
+  if (indices == NULL || buffer == NULL) {
+    if (indices != NULL) {
+      allocator->free(indices);
+    }
+    if (buffer != NULL) {
+      allocator->free(buffer);
+    }
+    *error_code = ACT_QUEUE_ERROR_ALLOCATION_FAILED;
+    return (act_SpscQueue){0};
+  }
+
+  return (act_SpscQueue){
+      ._allocator = allocator,
+      ._indices = indices,
+      ._buffer = buffer,
+      ._mask = slots - 1,
+      ._data_size = data_size,
+  };
+}
+
+void act_spscQueueFree(act_SpscQueue *queue, int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return;
+  }
+
+  if (queue->_indices != NULL) {
+    queue->_allocator->free(queue->_indices);
+    queue->_allocator->free(queue->_buffer);
+  }
+  *queue = (act_SpscQueue){0};
+}
+
+size_t act_spscQueueCapacity(const act_SpscQueue *queue) {
+  return queue->_indices == NULL ? 0 : queue->_mask + 1;
+}
+
+size_t act_spscQueueLen(const act_SpscQueue *queue) {
+  if (queue->_indices == NULL) {
+    return 0;
+  }
+
+  size_t head =
+      atomic_load_explicit(&queue->_indices->head, memory_order_acquire);
+  size_t tail =
+      atomic_load_explicit(&queue->_indices->tail, memory_order_acquire);
+  return tail - head;
+}
+
+bool act_spscQueuePush(act_SpscQueue *queue, const void *element,
+                       int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL || queue->_indices == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return false;
+  }
+  if (element == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ELEMENT;
+    return false;
+  }
+
+  act__QueueIndices *indices = queue->_indices;
+  size_t tail = atomic_load_explicit(&indices->tail, memory_order_relaxed);
+  if (tail - indices->cached_head > queue->_mask) {
+    indices->cached_head =
+        atomic_load_explicit(&indices->head, memory_order_acquire);
+    if (tail - indices->cached_head > queue->_mask) {
+      *error_code = ACT_QUEUE_ERROR_FULL;
+      return false;
+    }
+  }
+
+  memcpy(act__spscQueueAt(queue, tail), element, queue->_data_size);
+  atomic_store_explicit(&indices->tail, tail + 1, memory_order_release);
+
+  return true;
+}
+
+bool act_spscQueuePop(act_SpscQueue *queue, void *element, int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL || queue->_indices == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return false;
+  }
+  if (element == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ELEMENT;
+    return false;
+  }
+
+  act__QueueIndices *indices = queue->_indices;
+  size_t head = atomic_load_explicit(&indices->head, memory_order_relaxed);
+  if (head == indices->cached_tail) {
+    indices->cached_tail =
+        atomic_load_explicit(&indices->tail, memory_order_acquire);
+    if (head == indices->cached_tail) {
+      *error_code = ACT_QUEUE_ERROR_EMPTY;
+      return false;
+    }
+  }
+
+  memcpy(element, act__spscQueueAt(queue, head), queue->_data_size);
+  atomic_store_explicit(&indices->head, head + 1, memory_order_release);
+
+  return true;
+}
+
+size_t act_spscQueuePushMany(act_SpscQueue *queue, const void *elements,
+                             size_t count, int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL || queue->_indices == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return 0;
+  }
+  if (elements == NULL && count != 0) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ELEMENT;
+    return 0;
+  }
+
+  act__QueueIndices *indices = queue->_indices;
+  size_t tail = atomic_load_explicit(&indices->tail, memory_order_relaxed);
+  size_t free_slots = queue->_mask + 1 - (tail - indices->cached_head);
+  if (free_slots < count) {
+    indices->cached_head =
+        atomic_load_explicit(&indices->head, memory_order_acquire);
+    free_slots = queue->_mask + 1 - (tail - indices->cached_head);
+  }
+
+  size_t pushed = count < free_slots ? count : free_slots;
+  if (pushed < count) {
+    *error_code = ACT_QUEUE_ERROR_FULL;
+  }
+  if (pushed == 0) {
+    return 0;
+  }
+
+  act__spscQueueCopyIn(queue, tail, elements, pushed);
+  atomic_store_explicit(&indices->tail, tail + pushed, memory_order_release);
+
+  return pushed;
+}
+
+size_t act_spscQueuePopMany(act_SpscQueue *queue, void *elements, size_t max,
+                            int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL || queue->_indices == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return 0;
+  }
+  if (elements == NULL && max != 0) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ELEMENT;
+    return 0;
+  }
+  if (max == 0) {
+    return 0;
+  }
+
+  act__QueueIndices *indices = queue->_indices;
+  size_t head = atomic_load_explicit(&indices->head, memory_order_relaxed);
+  size_t ready = indices->cached_tail - head;
+  if (ready < max) {
+    indices->cached_tail =
+        atomic_load_explicit(&indices->tail, memory_order_acquire);
+    ready = indices->cached_tail - head;
+  }
+
+  size_t popped = max < ready ? max : ready;
+  if (popped == 0) {
+    *error_code = ACT_QUEUE_ERROR_EMPTY;
+    return 0;
+  }
+
+  act__spscQueueCopyOut(queue, head, elements, popped);
+  atomic_store_explicit(&indices->head, head + popped, memory_order_release);
+
+  return popped;
+}
+
+act_MpmcQueue act_mpmcQueueNew(const act_Allocator *allocator,
+                               size_t data_size, size_t capacity,
+                               int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ALLOCATOR;
+    return (act_MpmcQueue){0};
+  }
+  if (data_size == 0) {
+    *error_code = ACT_QUEUE_ERROR_INVALID_DATA_SIZE;
+    return (act_MpmcQueue){0};
+  }
+  size_t slots = act__queueCapacity(capacity, 2);
+  if (capacity == 0 || slots == 0) {
+    *error_code = ACT_QUEUE_ERROR_INVALID_CAPACITY;
+    return (act_MpmcQueue){0};
+  }
+
+  // Every slot starts with its sequence number, aligned for the atomic
+  const size_t align = _Alignof(_Atomic size_t);
+  size_t stride =
+      (sizeof(_Atomic size_t) + data_size + align - 1) / align * align;
+
+  act__QueueIndices *indices = act__queueNewIndices(allocator);
+  char *slots_data = allocator->alloc(slots, stride);
+  if (indices == NULL || slots_data == NULL) {
+    if (indices != NULL) {
+      allocator->free(indices);
+    }
+    if (slots_data != NULL) {
+      allocator->free(slots_data);
+    }
+    *error_code = ACT_QUEUE_ERROR_ALLOCATION_FAILED;
+    return (act_MpmcQueue){0};
+  }
+
+  act_MpmcQueue queue = {
+      ._allocator = allocator,
+      ._indices = indices,
+      ._slots = slots_data,
+      ._mask = slots - 1,
+      ._data_size = data_size,
+      ._stride = stride,
+  };
+
+  // A slot is ready to be pushed to at the position equal to its sequence
+  // number, and popped from at the one after
+  for (size_t i = 0; i < slots; i++) {
+    atomic_init(act__mpmcQueueSeq(&queue, i), i);
+  }
+
+  return queue;
+}
+
+void act_mpmcQueueFree(act_MpmcQueue *queue, int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return;
+  }
+
+  if (queue->_indices != NULL) {
+    queue->_allocator->free(queue->_indices);
+    queue->_allocator->free(queue->_slots);
+  }
+  *queue = (act_MpmcQueue){0};
+}
+
+size_t act_mpmcQueueCapacity(const act_MpmcQueue *queue) {
+  return queue->_indices == NULL ? 0 : queue->_mask + 1;
+}
+
+size_t act_mpmcQueueLen(const act_MpmcQueue *queue) {
+  if (queue->_indices == NULL) {
+    return 0;
+  }
+
+  size_t head =
+      atomic_load_explicit(&queue->_indices->head, memory_order_acquire);
+  size_t tail =
+      atomic_load_explicit(&queue->_indices->tail, memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+/// Claims a run of up to @em max slots of an MPMC queue, all ready to be
+/// pushed to (or, if @em pop, popped from), and returns its length and start.
+static size_t act__mpmcQueueClaim(act_MpmcQueue *queue, size_t max, bool pop,
+                                  size_t *start) {
+  _Atomic size_t *index = pop ? &queue->_indices->head : &queue->_indices->tail;
+  size_t ready_offset = pop ? 1 : 0;
+
+  size_t pos = atomic_load_explicit(index, memory_order_relaxed);
+  for (;;) {
+    size_t seq = atomic_load_explicit(act__mpmcQueueSeq(queue, pos),
+                                      memory_order_acquire);
+    intptr_t diff = (intptr_t)seq - (intptr_t)(pos + ready_offset);
+
+    // The slot is a lap behind (the queue is full, or empty)
+    if (diff < 0) {
+      return 0;
+    }
+    // Another thread claimed the slot first
+    if (diff > 0) {
+      pos = atomic_load_explicit(index, memory_order_relaxed);
+      continue;
+    }
+
+    // The slots after it stay ready until the index moves past them
+    size_t count = 1;
+    while (count < max &&
+           atomic_load_explicit(act__mpmcQueueSeq(queue, pos + count),
+                                memory_order_acquire) ==
+               pos + count + ready_offset) {
+      count++;
+    }
+
+    if (atomic_compare_exchange_weak_explicit(index, &pos, pos + count,
+                                              memory_order_relaxed,
+                                              memory_order_relaxed)) {
+      *start = pos;
+      return count;
+    }
+  }
+}
+
+bool act_mpmcQueuePush(act_MpmcQueue *queue, const void *element,
+                       int *error_code) {
+  return act_mpmcQueuePushMany(queue, element, 1, error_code) == 1;
+}
+
+bool act_mpmcQueuePop(act_MpmcQueue *queue, void *element, int *error_code) {
+  return act_mpmcQueuePopMany(queue, element, 1, error_code) == 1;
+}
+
+size_t act_mpmcQueuePushMany(act_MpmcQueue *queue, const void *elements,
+                             size_t count, int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL || queue->_indices == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return 0;
+  }
+  if (elements == NULL && count != 0) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ELEMENT;
+    return 0;
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  size_t pos = 0;
+  size_t pushed = act__mpmcQueueClaim(queue, count, false, &pos);
+  if (pushed < count) {
+    *error_code = ACT_QUEUE_ERROR_FULL;
+  }
+
+  const char *src = elements;
+  for (size_t i = 0; i < pushed; i++) {
+    memcpy(act__mpmcQueueAt(queue, pos + i), src + i * queue->_data_size,
+           queue->_data_size);
+    atomic_store_explicit(act__mpmcQueueSeq(queue, pos + i), pos + i + 1,
+                          memory_order_release);
+  }
+
+  return pushed;
+}
+
+size_t act_mpmcQueuePopMany(act_MpmcQueue *queue, void *elements, size_t max,
+                            int *error_code) {
+  *error_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  if (queue == NULL || queue->_indices == NULL) {
+    *error_code = ACT_QUEUE_ERROR_NULL_QUEUE;
+    return 0;
+  }
+  if (elements == NULL && max != 0) {
+    *error_code = ACT_QUEUE_ERROR_NULL_ELEMENT;
+    return 0;
+  }
+  if (max == 0) {
+    return 0;
+  }
+
+  size_t pos = 0;
+  size_t popped = act__mpmcQueueClaim(queue, max, true, &pos);
+  if (popped == 0) {
+    *error_code = ACT_QUEUE_ERROR_EMPTY;
+    return 0;
+  }
+
+  // Emptied slots are ready to be pushed to in the next lap
+  char *dst = elements;
+  for (size_t i = 0; i < popped; i++) {
+    memcpy(dst + i * queue->_data_size, act__mpmcQueueAt(queue, pos + i),
+           queue->_data_size);
+    atomic_store_explicit(act__mpmcQueueSeq(queue, pos + i),
+                          pos + i + queue->_mask + 1, memory_order_release);
+  }
+
+  return popped;
+}
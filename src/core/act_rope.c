@@ -0,0 +1,508 @@
+#include "act_rope.h"
+
+/// The max number of characters stored in a single chunk.
+static const size_t ROPE_CHUNK_MAX = 1024;
+
+struct act__RopeNode {
+  /// The left subtree (**NULL** for chunks).
+  act__RopeNode *left;
+
+  /// The right subtree (**NULL** for chunks).
+  act__RopeNode *right;
+
+  /// The number of characters in this subtree.
+  size_t len;
+
+  /// The height of this subtree (1 for chunks).
+  size_t height;
+
+  /// The characters of the chunk (**NULL** for branches).
+  char *data;
+};
+
+static bool act__ropeIsChunk(const act__RopeNode *node) {
+  return node->data != NULL;
+}
+
+static size_t act__ropeHeight(const act__RopeNode *node) {
+  return node == NULL ? 0 : node->height;
+}
+
+static size_t act__ropeNodeLen(const act__RopeNode *node) {
+  return node == NULL ? 0 : node->len;
+}
+
+/// Recomputes the length and height of a branch from its children.
+static void act__ropeUpdate(act__RopeNode *node) {
+  size_t left_height = act__ropeHeight(node->left);
+  size_t right_height = act__ropeHeight(node->right);
+
+  node->len = act__ropeNodeLen(node->left) + act__ropeNodeLen(node->right);
+  node->height = 1 + (left_height > right_height ? left_height : right_height);
+}
+
+/// Creates a chunk holding a copy of @a data.
+static act__RopeNode *act__ropeChunk(const act_Allocator *allocator,
+                                     const char *data, size_t len,
+                                     int *error_code) {
+  act__RopeNode *node = (*allocator->alloc)(1, sizeof(*node));
+  char *copy = (*allocator->alloc)(len, sizeof(*copy));
+  if (node == NULL || copy == NULL) {
+    (*allocator->free)(node);
+    (*allocator->free)(copy);
+    *error_code = ACT_ROPE_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+  memcpy(copy, data, len);
+
+  node->data = copy;
+  node->len = len;
+  node->height = 1;
+
+  return node;
+}
+
+/// Creates a branch over the two given subtrees.
+static act__RopeNode *act__ropeBranch(const act_Allocator *allocator,
+                                      act__RopeNode *left,
+                                      act__RopeNode *right, int *error_code) {
+  act__RopeNode *node = (*allocator->alloc)(1, sizeof(*node));
+  if (node == NULL) {
+    *error_code = ACT_ROPE_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+
+  node->left = left;
+  node->right = right;
+  act__ropeUpdate(node);
+
+  return node;
+}
+
+static void act__ropeFreeNode(const act_Allocator *allocator,
+                              act__RopeNode *node) {
+  if (node == NULL) {
+    return;
+  }
+
+  act__ropeFreeNode(allocator, node->left);
+  act__ropeFreeNode(allocator, node->right);
+  (*allocator->free)(node->data);
+  (*allocator->free)(node);
+}
+
+static act__RopeNode *act__ropeRotateLeft(act__RopeNode *node) {
+  act__RopeNode *pivot = node->right;
+  node->right = pivot->left;
+  act__ropeUpdate(node);
+  pivot->left = node;
+  act__ropeUpdate(pivot);
+
+  return pivot;
+}
+
+static act__RopeNode *act__ropeRotateRight(act__RopeNode *node) {
+  act__RopeNode *pivot = node->left;
+  node->left = pivot->right;
+  act__ropeUpdate(node);
+  pivot->right = node;
+  act__ropeUpdate(pivot);
+
+  return pivot;
+}
+
+/// Restores the AVL invariant of a branch whose subtrees differ in height by
+/// at most two.
+static act__RopeNode *act__ropeRebalance(act__RopeNode *node) {
+  act__ropeUpdate(node);
+
+  size_t left_height = act__ropeHeight(node->left);
+  size_t right_height = act__ropeHeight(node->right);
+  if (left_height > right_height + 1) {
+    if (act__ropeHeight(node->left->left) <
+        act__ropeHeight(node->left->right)) {
+      node->left = act__ropeRotateLeft(node->left);
+    }
+    return act__ropeRotateRight(node);
+  }
+  if (right_height > left_height + 1) {
+    if (act__ropeHeight(node->right->right) <
+        act__ropeHeight(node->right->left)) {
+      node->right = act__ropeRotateRight(node->right);
+    }
+    return act__ropeRotateLeft(node);
+  }
+
+  return node;
+}
+
+/// Appends the contents of chunk @a right to chunk @a left, freeing @a right.
+static act__RopeNode *act__ropeMergeChunks(const act_Allocator *allocator,
+                                           act__RopeNode *left,
+                                           act__RopeNode *right,
+                                           int *error_code) {
+  char *data =
+      (*allocator->resize)(left->data, left->len + right->len, sizeof(*data));
+  if (data == NULL) {
+    *error_code = ACT_ROPE_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+  memcpy(data + left->len, right->data, right->len);
+
+  left->data = data;
+  left->len += right->len;
+  act__ropeFreeNode(allocator, right);
+
+  return left;
+}
+
+/// Joins two trees into a balanced tree holding @a left followed by
+/// @a right.
+///
+/// This takes time proportional to the difference in height of the trees.
+/// Small chunks are pushed down to, and merged with, the neighbouring chunk so
+/// that many small edits do not fragment the rope.
+static act__RopeNode *act__ropeJoin(const act_Allocator *allocator,
+                                    act__RopeNode *left, act__RopeNode *right,
+                                    int *error_code) {
+  if (left == NULL) {
+    return right;
+  }
+  if (right == NULL) {
+    return left;
+  }
+
+  bool left_chunk = act__ropeIsChunk(left);
+  bool right_chunk = act__ropeIsChunk(right);
+  if (left_chunk && right_chunk && left->len + right->len <= ROPE_CHUNK_MAX) {
+    return act__ropeMergeChunks(allocator, left, right, error_code);
+  }
+
+  size_t left_height = act__ropeHeight(left);
+  size_t right_height = act__ropeHeight(right);
+  bool small_right = right_chunk && right->len < ROPE_CHUNK_MAX;
+  bool small_left = left_chunk && left->len < ROPE_CHUNK_MAX;
+  if (left_height > right_height + 1 || (small_right && !left_chunk)) {
+    act__RopeNode *joined =
+        act__ropeJoin(allocator, left->right, right, error_code);
+    if (joined == NULL) {
+      return NULL;
+    }
+    left->right = joined;
+    return act__ropeRebalance(left);
+  }
+  if (right_height > left_height + 1 || (small_left && !right_chunk)) {
+    act__RopeNode *joined =
+        act__ropeJoin(allocator, left, right->left, error_code);
+    if (joined == NULL) {
+      return NULL;
+    }
+    right->left = joined;
+    return act__ropeRebalance(right);
+  }
+
+  return act__ropeBranch(allocator, left, right, error_code);
+}
+
+/// Splits a tree into the characters before @a idx and the rest.
+static void act__ropeSplit(const act_Allocator *allocator, act__RopeNode *node,
+                           size_t idx, act__RopeNode **left,
+                           act__RopeNode **right, int *error_code) {
+  if (idx == 0) {
+    *left = NULL;
+    *right = node;
+    return;
+  }
+  if (idx >= act__ropeNodeLen(node)) {
+    *left = node;
+    *right = NULL;
+    return;
+  }
+
+  // Keep the front of the chunk in place and copy out the back
+  if (act__ropeIsChunk(node)) {
+    *right = act__ropeChunk(allocator, node->data + idx, node->len - idx,
+                            error_code);
+    node->len = idx;
+    *left = node;
+    return;
+  }
+
+  act__RopeNode *node_left = node->left;
+  act__RopeNode *node_right = node->right;
+  size_t left_len = act__ropeNodeLen(node_left);
+  (*allocator->free)(node);
+
+  if (idx <= left_len) {
+    act__RopeNode *split_right = NULL;
+    act__ropeSplit(allocator, node_left, idx, left, &split_right, error_code);
+    *right = act__ropeJoin(allocator, split_right, node_right, error_code);
+  } else {
+    act__RopeNode *split_left = NULL;
+    act__ropeSplit(allocator, node_right, idx - left_len, &split_left, right,
+                   error_code);
+    *left = act__ropeJoin(allocator, node_left, split_left, error_code);
+  }
+}
+
+/// Builds a balanced tree of chunks from the given view.
+static act__RopeNode *act__ropeBuild(const act_Allocator *allocator,
+                                     act_StringView view, int *error_code) {
+  if (view.len == 0) {
+    return NULL;
+  }
+  if (view.len <= ROPE_CHUNK_MAX) {
+    return act__ropeChunk(allocator, view.data, view.len, error_code);
+  }
+
+  // Split on a chunk boundary so that all but the last chunk are full
+  size_t num_chunks = (view.len + ROPE_CHUNK_MAX - 1) / ROPE_CHUNK_MAX;
+  size_t mid = (num_chunks / 2) * ROPE_CHUNK_MAX;
+
+  act__RopeNode *left = act__ropeBuild(
+      allocator, (act_StringView){.data = view.data, .len = mid}, error_code);
+  act__RopeNode *right = act__ropeBuild(
+      allocator,
+      (act_StringView){.data = view.data + mid, .len = view.len - mid},
+      error_code);
+  if (left == NULL || right == NULL) {
+    act__ropeFreeNode(allocator, left);
+    act__ropeFreeNode(allocator, right);
+    return NULL;
+  }
+
+  return act__ropeBranch(allocator, left, right, error_code);
+}
+
+act_Rope act_ropeNew(const act_Allocator *allocator, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  ACT_ASSERT_OR(allocator != NULL, *error_code = ACT_ROPE_ERROR_NULL_ALLOCATOR);
+
+  return (act_Rope){
+      ._allocator = allocator,
+      ._root = NULL,
+  };
+}
+
+act_Rope act_ropeFromView(const act_Allocator *allocator, act_StringView view,
+                          int *error_code) {
+  act_Rope rope = act_ropeNew(allocator, error_code);
+  if (*error_code != ACT_ROPE_ERROR_SUCCESS) {
+    return rope;
+  }
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_ROPE_ERROR_NULL_STRING;
+    return rope;
+  }
+
+  rope._root = act__ropeBuild(allocator, view, error_code);
+
+  return rope;
+}
+
+act_Rope act_ropeFromString(const act_String *string, int *error_code) {
+  if (string == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_STRING;
+    return (act_Rope){0};
+  }
+
+  return act_ropeFromView(string->_allocator, act_stringAsView(*string),
+                          error_code);
+}
+
+void act_ropeFree(act_Rope *rope, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return;
+  }
+
+  if (rope->_root != NULL) {
+    act__ropeFreeNode(rope->_allocator, rope->_root);
+  }
+  rope->_root = NULL;
+}
+
+size_t act_ropeLen(const act_Rope *rope) {
+  return act__ropeNodeLen(rope->_root);
+}
+
+char act_ropeCharAt(const act_Rope *rope, size_t idx, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return '\0';
+  }
+  if (idx >= act_ropeLen(rope)) {
+    *error_code = ACT_ROPE_ERROR_INDEX_OUT_OF_BOUNDS;
+    return '\0';
+  }
+
+  const act__RopeNode *node = rope->_root;
+  while (!act__ropeIsChunk(node)) {
+    size_t left_len = act__ropeNodeLen(node->left);
+    if (idx < left_len) {
+      node = node->left;
+    } else {
+      idx -= left_len;
+      node = node->right;
+    }
+  }
+
+  return node->data[idx];
+}
+
+void act_ropeInsert(act_Rope *rope, size_t idx, act_StringView view,
+                    int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return;
+  }
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_ROPE_ERROR_NULL_STRING;
+    return;
+  }
+  if (idx > act_ropeLen(rope)) {
+    *error_code = ACT_ROPE_ERROR_INDEX_OUT_OF_BOUNDS;
+    return;
+  }
+  if (view.len == 0) {
+    return;
+  }
+
+  const act_Allocator *allocator = rope->_allocator;
+  act__RopeNode *middle = act__ropeBuild(allocator, view, error_code);
+  if (middle == NULL) {
+    return;
+  }
+
+  act__RopeNode *left = NULL;
+  act__RopeNode *right = NULL;
+  act__ropeSplit(allocator, rope->_root, idx, &left, &right, error_code);
+  left = act__ropeJoin(allocator, left, middle, error_code);
+  rope->_root = act__ropeJoin(allocator, left, right, error_code);
+}
+
+void act_ropeDelete(act_Rope *rope, size_t idx, size_t len, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return;
+  }
+  if (idx > act_ropeLen(rope) || len > act_ropeLen(rope) - idx) {
+    *error_code = ACT_ROPE_ERROR_INDEX_OUT_OF_BOUNDS;
+    return;
+  }
+  if (len == 0) {
+    return;
+  }
+
+  const act_Allocator *allocator = rope->_allocator;
+  act__RopeNode *left = NULL;
+  act__RopeNode *rest = NULL;
+  act__RopeNode *middle = NULL;
+  act__RopeNode *right = NULL;
+  act__ropeSplit(allocator, rope->_root, idx, &left, &rest, error_code);
+  act__ropeSplit(allocator, rest, len, &middle, &right, error_code);
+  act__ropeFreeNode(allocator, middle);
+  rope->_root = act__ropeJoin(allocator, left, right, error_code);
+}
+
+void act_ropeConcat(act_Rope *rope, act_Rope *other, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL || other == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return;
+  }
+
+  rope->_root =
+      act__ropeJoin(rope->_allocator, rope->_root, other->_root, error_code);
+  other->_root = NULL;
+}
+
+act_Rope act_ropeSplit(act_Rope *rope, size_t idx, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return (act_Rope){0};
+  }
+  if (idx > act_ropeLen(rope)) {
+    *error_code = ACT_ROPE_ERROR_INDEX_OUT_OF_BOUNDS;
+    return (act_Rope){0};
+  }
+
+  act_Rope back = {._allocator = rope->_allocator, ._root = NULL};
+  act__ropeSplit(rope->_allocator, rope->_root, idx, &rope->_root,
+                 &back._root, error_code);
+
+  return back;
+}
+
+act_String act_ropeToString(const act_Rope *rope, int *error_code) {
+  *error_code = ACT_ROPE_ERROR_SUCCESS;
+
+  if (rope == NULL) {
+    *error_code = ACT_ROPE_ERROR_NULL_ROPE;
+    return (act_String){0};
+  }
+
+  size_t len = act_ropeLen(rope);
+  char *data = (*rope->_allocator->alloc)(len + 1, sizeof(*data));
+  if (data == NULL) {
+    *error_code = ACT_ROPE_ERROR_ALLOCATION_FAILED;
+    return (act_String){0};
+  }
+
+  size_t offset = 0;
+  act_StringView chunk;
+  act_RopeChunkIter iter = act_ropeChunkIter(rope);
+  while (act_ropeChunkIterNext(&iter, &chunk)) {
+    memcpy(data + offset, chunk.data, chunk.len);
+    offset += chunk.len;
+  }
+  data[len] = '\0';
+
+  return (act_String){
+      ._allocator = rope->_allocator,
+      ._len = len,
+      ._capacity = len + 1,
+      ._data = data,
+  };
+}
+
+act_RopeChunkIter act_ropeChunkIter(const act_Rope *rope) {
+  act_RopeChunkIter iter = {._depth = 0};
+  if (rope != NULL && rope->_root != NULL) {
+    iter._stack[iter._depth++] = rope->_root;
+  }
+
+  return iter;
+}
+
+bool act_ropeChunkIterNext(act_RopeChunkIter *iter, act_StringView *chunk) {
+  while (iter->_depth != 0) {
+    const act__RopeNode *node = iter->_stack[--iter->_depth];
+    if (act__ropeIsChunk(node)) {
+      *chunk = (act_StringView){.data = node->data, .len = node->len};
+      return true;
+    }
+
+    // Visit the left subtree first
+    if (node->right != NULL) {
+      iter->_stack[iter->_depth++] = node->right;
+    }
+    if (node->left != NULL) {
+      iter->_stack[iter->_depth++] = node->left;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,231 @@
+#ifndef ACT_ROPE_H
+#define ACT_ROPE_H
+
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+/// @file act_rope.h
+///
+/// This header defines a rope: a balanced tree of string chunks for large,
+/// editable text.
+///
+/// Insertion, deletion, concatenation, and splitting take O(log n) time,
+/// instead of the O(n) shifting/copying needed for a contiguous #act_String.
+
+/// The max depth of a rope tree, which bounds the iterator's stack.
+#define ACT_ROPE_MAX_DEPTH 96
+
+/// @brief A node of the rope's tree (either a chunk or a branch).
+///
+/// This type is private; its definition is only visible to the rope
+/// implementation.
+typedef struct act__RopeNode act__RopeNode;
+
+/// @brief **[PRIVATE]** A balanced tree of string chunks.
+///
+/// @param allocator  An allocator for making internal allocations
+///                   #act_Allocator.
+/// @param root       The root of the tree (**NULL** if the rope is empty).
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_ropeLen, #act_ropeToString
+typedef struct act_Rope {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The root of the tree.
+  act__RopeNode *_root;
+  /// @endcond
+} act_Rope;
+
+/// @brief **[PRIVATE]** An iterator over the chunks of an #act_Rope, in
+/// order.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use #act_ropeChunkIterNext instead.
+///
+/// @sa #act_ropeChunkIter
+typedef struct act_RopeChunkIter {
+  /// @cond
+  /// @internal The nodes left to visit.
+  const act__RopeNode *_stack[ACT_ROPE_MAX_DEPTH];
+
+  /// @internal The number of nodes on the stack.
+  size_t _depth;
+  /// @endcond
+} act_RopeChunkIter;
+
+/// @brief The possible error values.
+typedef enum act_RopeError {
+  /// Successful operation.
+  ACT_ROPE_ERROR_SUCCESS = 0x0,
+
+  /// The given rope was **NULL**.
+  ACT_ROPE_ERROR_NULL_ROPE,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_ROPE_ERROR_NULL_ALLOCATOR,
+
+  /// The given string was **NULL**.
+  ACT_ROPE_ERROR_NULL_STRING,
+
+  /// A failure during allocation.
+  ACT_ROPE_ERROR_ALLOCATION_FAILED,
+
+  /// The index was out of bounds.
+  ACT_ROPE_ERROR_INDEX_OUT_OF_BOUNDS,
+} act_RopeError;
+
+/// @brief Creates a new, empty #act_Rope.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @return A new rope.
+///
+/// @note This function does not allocate any memory.
+///
+/// @sa #act_ropeFree
+act_Rope act_ropeNew(const act_Allocator *allocator, int *error_code);
+
+/// @brief Creates a new #act_Rope from the given view.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[in]  view        The text to copy into the rope.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @return A balanced rope holding a copy of @a view.
+///
+/// @sa #act_ropeFree
+act_Rope act_ropeFromView(const act_Allocator *allocator, act_StringView view,
+                          int *error_code);
+
+/// @brief Creates a new #act_Rope from the given #act_String, using the
+/// string's allocator.
+///
+/// @param[in]  string      The string to copy into the rope.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @return A balanced rope holding a copy of @a string.
+///
+/// @sa #act_ropeFree, #act_ropeToString
+act_Rope act_ropeFromString(const act_String *string, int *error_code);
+
+/// @brief Frees all memory allocated by the #act_Rope.
+///
+/// @param[in]  rope        The rope to free.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+void act_ropeFree(act_Rope *rope, int *error_code);
+
+/// @brief Returns the length of the #act_Rope.
+///
+/// @param rope The rope to get the length of.
+///
+/// @return The total number of characters in the rope.
+size_t act_ropeLen(const act_Rope *rope);
+
+/// @brief Returns the character at the given index of the #act_Rope.
+///
+/// @param[in]  rope        The rope to index.
+/// @param[in]  idx         The index of the character.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @return The character at @a idx.
+char act_ropeCharAt(const act_Rope *rope, size_t idx, int *error_code);
+
+/// @brief Inserts a copy of the given view into the #act_Rope at the given
+/// index, in O(log n) time.
+///
+/// @param[in]  rope        The rope to insert into.
+/// @param[in]  idx         The index to insert at (at most the length).
+/// @param[in]  view        The text to insert.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @note This function allocates chunks for the inserted text.
+void act_ropeInsert(act_Rope *rope, size_t idx, act_StringView view,
+                    int *error_code);
+
+/// @brief Deletes a range of characters from the #act_Rope, in O(log n)
+/// time.
+///
+/// @param[in]  rope        The rope to delete from.
+/// @param[in]  idx         The index of the first character to delete.
+/// @param[in]  len         The number of characters to delete.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+void act_ropeDelete(act_Rope *rope, size_t idx, size_t len, int *error_code);
+
+/// @brief Appends @a other to the end of @a rope, in O(log n) time.
+///
+/// No text is copied; the chunks of @a other are moved into @a rope, and
+/// @a other is left empty.
+///
+/// @param[in]  rope        The rope to append to.
+/// @param[in]  other       The rope to append (emptied by this function).
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+void act_ropeConcat(act_Rope *rope, act_Rope *other, int *error_code);
+
+/// @brief Splits the #act_Rope at the given index, in O(log n) time.
+///
+/// @a rope keeps the characters before @a idx, and the rest are moved into
+/// the returned rope.
+///
+/// @param[in]  rope        The rope to split.
+/// @param[in]  idx         The index to split at (at most the length).
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @return A rope holding the characters from @a idx onwards.
+///
+/// @sa #act_ropeFree
+act_Rope act_ropeSplit(act_Rope *rope, size_t idx, int *error_code);
+
+/// @brief Materializes the #act_Rope into a new #act_String.
+///
+/// @param[in]  rope        The rope to convert.
+/// @param[out] error_code  The error code (#act_RopeError) of the
+///                         operation.
+///
+/// @return A heap allocated string with the rope's contents.
+///
+/// @note This function allocates ```act_ropeLen(rope) + 1``` bytes.
+///
+/// @sa #act_stringFree
+act_String act_ropeToString(const act_Rope *rope, int *error_code);
+
+/// @brief Creates an iterator over the chunks of the #act_Rope.
+///
+/// The iterator is invalidated by any modification of the rope.
+///
+/// @param rope The rope to iterate over.
+///
+/// @return An iterator positioned before the first chunk.
+///
+/// @sa #act_ropeChunkIterNext
+act_RopeChunkIter act_ropeChunkIter(const act_Rope *rope);
+
+/// @brief Advances the iterator to the next chunk.
+///
+/// @param[in]  iter  The iterator to advance.
+/// @param[out] chunk The next chunk, if there is one.
+///
+/// @return **true** if a chunk was returned, **false** once all chunks have
+/// been visited.
+bool act_ropeChunkIterNext(act_RopeChunkIter *iter, act_StringView *chunk);
+
+#endif /* !ACT_ROPE_H */
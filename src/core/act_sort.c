@@ -0,0 +1,1531 @@
+#include "act_sort.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+/// Forces inlining, so the element size is a constant in specialized sorts.
+#define ACT__SORT_INLINE static inline __attribute__((always_inline))
+
+/// Ranges smaller than this are insertion sorted.
+#define ACT__SORT_INSERTION_THRESHOLD 24
+
+/// Ranges larger than this use a pseudomedian of nine as the pivot.
+#define ACT__SORT_NINTHER_THRESHOLD 128
+
+/// The number of moves allowed when finishing an almost sorted range.
+#define ACT__SORT_PARTIAL_INSERTION_LIMIT 8
+
+/// The length of the runs that the stable sort starts merging from.
+#define ACT__SORT_STABLE_RUN 16
+
+/// The largest element that is kept in a scratch space on the stack.
+#define ACT__SORT_STACK_ELEM_SIZE 64
+
+/// The smallest number of elements worth sorting on another thread.
+#define ACT__SORT_MIN_PER_THREAD 4096
+
+/// The maximum depth of the explicit stack of the unstable sort.
+#define ACT__SORT_STACK_DEPTH 64
+
+/// Returns whether @em a comes strictly before @em b.
+ACT__SORT_INLINE bool act__sortLess(act_SortCompareFn compare, const char *a,
+                                    const char *b) {
+  return compare(a, b) < 0;
+}
+
+/// Swaps two elements, in 16 byte pieces.
+ACT__SORT_INLINE void act__sortSwap(char *a, char *b, size_t size) {
+  char tmp[16];
+  while (size >= sizeof(tmp)) {
+    memcpy(tmp, a, sizeof(tmp));
+    memcpy(a, b, sizeof(tmp));
+    memcpy(b, tmp, sizeof(tmp));
+    a += sizeof(tmp);
+    b += sizeof(tmp);
+    size -= sizeof(tmp);
+  }
+  if (size > 0) {
+    memcpy(tmp, a, size);
+    memcpy(a, b, size);
+    memcpy(b, tmp, size);
+  }
+}
+
+/// Swaps two elements if they are out of order.
+ACT__SORT_INLINE void act__sortSort2(char *a, char *b, size_t size,
+                                     act_SortCompareFn compare) {
+  if (act__sortLess(compare, b, a)) {
+    act__sortSwap(a, b, size);
+  }
+}
+
+/// Sorts three elements.
+ACT__SORT_INLINE void act__sortSort3(char *a, char *b, char *c, size_t size,
+                                     act_SortCompareFn compare) {
+  act__sortSort2(a, b, size, compare);
+  act__sortSort2(b, c, size, compare);
+  act__sortSort2(a, b, size, compare);
+}
+
+/// Insertion sorts [begin, end). When @em guarded is false, the element
+/// before @em begin must not be greater than any element in the range.
+ACT__SORT_INLINE void act__sortInsertion(char *begin, char *end, size_t size,
+                                         act_SortCompareFn compare, char *tmp,
+                                         bool guarded) {
+  if (begin == end) {
+    return;
+  }
+
+  for (char *cur = begin + size; cur < end; cur += size) {
+    char *sift = cur;
+    char *sift_1 = cur - size;
+    if (!act__sortLess(compare, sift, sift_1)) {
+      continue;
+    }
+
+    memcpy(tmp, sift, size);
+    do {
+      memcpy(sift, sift_1, size);
+      sift -= size;
+    } while ((!guarded || sift != begin) &&
+             act__sortLess(compare, tmp, (sift_1 -= size)));
+    memcpy(sift, tmp, size);
+  }
+}
+
+/// Insertion sorts [begin, end), giving up (and returning **false**) once more
+/// than a few elements had to be moved.
+ACT__SORT_INLINE bool act__sortPartialInsertion(char *begin, char *end,
+                                                size_t size,
+                                                act_SortCompareFn compare,
+                                                char *tmp) {
+  if (begin == end) {
+    return true;
+  }
+
+  size_t moved = 0;
+  for (char *cur = begin + size; cur < end; cur += size) {
+    char *sift = cur;
+    char *sift_1 = cur - size;
+    if (!act__sortLess(compare, sift, sift_1)) {
+      continue;
+    }
+
+    memcpy(tmp, sift, size);
+    do {
+      memcpy(sift, sift_1, size);
+      sift -= size;
+    } while (sift != begin && act__sortLess(compare, tmp, (sift_1 -= size)));
+    memcpy(sift, tmp, size);
+
+    moved += (size_t)(cur - sift) / size;
+    if (moved > ACT__SORT_PARTIAL_INSERTION_LIMIT) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// Heapsorts @em len elements starting at @em base.
+ACT__SORT_INLINE void act__sortHeapsort(char *base, size_t len, size_t size,
+                                        act_SortCompareFn compare, char *tmp) {
+  for (size_t end = len, start = len / 2; end > 1;) {
+    size_t idx;
+    if (start > 0) {
+      // Building the heap
+      idx = --start;
+      memcpy(tmp, base + idx * size, size);
+    } else {
+      // Moving the largest element to the end
+      end--;
+      memcpy(tmp, base + end * size, size);
+      memcpy(base + end * size, base, size);
+      idx = 0;
+    }
+
+    for (;;) {
+      size_t child = 2 * idx + 1;
+      if (child >= end) {
+        break;
+      }
+      if (child + 1 < end && act__sortLess(compare, base + child * size,
+                                           base + (child + 1) * size)) {
+        child++;
+      }
+      if (!act__sortLess(compare, tmp, base + child * size)) {
+        break;
+      }
+      memcpy(base + idx * size, base + child * size, size);
+      idx = child;
+    }
+    memcpy(base + idx * size, tmp, size);
+  }
+}
+
+/// Partitions [begin, end) around the pivot at @em begin, putting equal
+/// elements on the right. Returns the pivot's final position, and whether the
+/// range was already partitioned.
+ACT__SORT_INLINE char *act__sortPartitionRight(char *begin, char *end,
+                                               size_t size,
+                                               act_SortCompareFn compare,
+                                               char *pivot,
+                                               bool *already_partitioned) {
+  memcpy(pivot, begin, size);
+  char *first = begin;
+  char *last = end;
+
+  // The median of three guarantees an element not less than the pivot to
+  // the right, so the first scan needs no bounds check.
+  while (act__sortLess(compare, (first += size), pivot)) {
+  }
+  if (first - size == begin) {
+    while (first < last && !act__sortLess(compare, (last -= size), pivot)) {
+    }
+  } else {
+    while (!act__sortLess(compare, (last -= size), pivot)) {
+    }
+  }
+
+  *already_partitioned = first >= last;
+  while (first < last) {
+    act__sortSwap(first, last, size);
+    while (act__sortLess(compare, (first += size), pivot)) {
+    }
+    while (!act__sortLess(compare, (last -= size), pivot)) {
+    }
+  }
+
+  char *pivot_pos = first - size;
+  memcpy(begin, pivot_pos, size);
+  memcpy(pivot_pos, pivot, size);
+  return pivot_pos;
+}
+
+/// Partitions [begin, end) around the pivot at @em begin, putting equal
+/// elements on the left. Returns the pivot's final position.
+ACT__SORT_INLINE char *act__sortPartitionLeft(char *begin, char *end,
+                                              size_t size,
+                                              act_SortCompareFn compare,
+                                              char *pivot) {
+  memcpy(pivot, begin, size);
+  char *first = begin;
+  char *last = end;
+
+  while (act__sortLess(compare, pivot, (last -= size))) {
+  }
+  if (last + size == end) {
+    while (first < last && !act__sortLess(compare, pivot, (first += size))) {
+    }
+  } else {
+    while (!act__sortLess(compare, pivot, (first += size))) {
+    }
+  }
+
+  while (first < last) {
+    act__sortSwap(first, last, size);
+    while (act__sortLess(compare, pivot, (last -= size))) {
+    }
+    while (!act__sortLess(compare, pivot, (first += size))) {
+    }
+  }
+
+  memcpy(begin, last, size);
+  memcpy(last, pivot, size);
+  return last;
+}
+
+/// Breaks up patterns in a range that partitioned badly, by swapping a few
+/// elements around its quartiles.
+ACT__SORT_INLINE void act__sortShuffle(char *begin, char *end, size_t len,
+                                       size_t size) {
+  size_t q = len / 4;
+  act__sortSwap(begin, begin + q * size, size);
+  act__sortSwap(end - size, end - q * size, size);
+  if (len > ACT__SORT_NINTHER_THRESHOLD) {
+    act__sortSwap(begin + size, begin + (q + 1) * size, size);
+    act__sortSwap(begin + 2 * size, begin + (q + 2) * size, size);
+    act__sortSwap(end - 2 * size, end - (q + 1) * size, size);
+    act__sortSwap(end - 3 * size, end - (q + 2) * size, size);
+  }
+}
+
+/// A range still to be sorted by #act__sortPdq.
+typedef struct act__SortRange {
+  char *begin;
+  char *end;
+  int bad_allowed;
+  bool leftmost;
+} act__SortRange;
+
+/// Sorts @em len elements starting at @em base with pattern-defeating
+/// quicksort. The larger side of every partition is pushed onto an explicit
+/// stack, so the stack never holds more than log2(len) ranges.
+ACT__SORT_INLINE void act__sortPdq(char *base, size_t len, size_t size,
+                                   act_SortCompareFn compare, char *tmp) {
+  if (len < 2) {
+    return;
+  }
+
+  act__SortRange stack[ACT__SORT_STACK_DEPTH];
+  size_t top = 0;
+  stack[top++] = (act__SortRange){
+      .begin = base,
+      .end = base + len * size,
+      .bad_allowed = 63 - __builtin_clzll((unsigned long long)len),
+      .leftmost = true,
+  };
+
+  while (top > 0) {
+    act__SortRange range = stack[--top];
+    char *begin = range.begin;
+    char *end = range.end;
+
+    for (;;) {
+      size_t n = (size_t)(end - begin) / size;
+      if (n < ACT__SORT_INSERTION_THRESHOLD) {
+        act__sortInsertion(begin, end, size, compare, tmp, range.leftmost);
+        break;
+      }
+
+      // Choose the pivot, and move it to begin
+      char *mid = begin + (n / 2) * size;
+      if (n > ACT__SORT_NINTHER_THRESHOLD) {
+        act__sortSort3(begin, mid, end - size, size, compare);
+        act__sortSort3(begin + size, mid - size, end - 2 * size, size,
+                       compare);
+        act__sortSort3(begin + 2 * size, mid + size, end - 3 * size, size,
+                       compare);
+        act__sortSort3(mid - size, mid, mid + size, size, compare);
+        act__sortSwap(begin, mid, size);
+      } else {
+        act__sortSort3(mid, begin, end - size, size, compare);
+      }
+
+      // If the pivot equals the element before the range (a previous pivot),
+      // everything equal to it is already in place.
+      if (!range.leftmost && !act__sortLess(compare, begin - size, begin)) {
+        begin = act__sortPartitionLeft(begin, end, size, compare, tmp) + size;
+        continue;
+      }
+
+      bool already_partitioned = false;
+      char *pivot = act__sortPartitionRight(begin, end, size, compare, tmp,
+                                            &already_partitioned);
+      size_t l_len = (size_t)(pivot - begin) / size;
+      size_t r_len = n - l_len - 1;
+
+      if (l_len < n / 8 || r_len < n / 8) {
+        if (--range.bad_allowed == 0) {
+          act__sortHeapsort(begin, n, size, compare, tmp);
+          break;
+        }
+        if (l_len >= ACT__SORT_INSERTION_THRESHOLD) {
+          act__sortShuffle(begin, pivot, l_len, size);
+        }
+        if (r_len >= ACT__SORT_INSERTION_THRESHOLD) {
+          act__sortShuffle(pivot + size, end, r_len, size);
+        }
+      } else if (already_partitioned &&
+                 act__sortPartialInsertion(begin, pivot, size, compare,
+                                           tmp) &&
+                 act__sortPartialInsertion(pivot + size, end, size, compare,
+                                           tmp)) {
+        break;
+      }
+
+      // Defer the larger side, and keep sorting the smaller one
+      if (l_len < r_len) {
+        stack[top++] = (act__SortRange){pivot + size, end, range.bad_allowed,
+                                        false};
+        end = pivot;
+      } else {
+        stack[top++] = (act__SortRange){begin, pivot, range.bad_allowed,
+                                        range.leftmost};
+        begin = pivot + size;
+        range.leftmost = false;
+      }
+    }
+  }
+}
+
+/// Merges the sorted ranges @em a and @em b into @em out, taking from @em a
+/// first when elements are equivalent.
+ACT__SORT_INLINE void act__sortMerge(const char *a, size_t a_len,
+                                     const char *b, size_t b_len, char *out,
+                                     size_t size, act_SortCompareFn compare) {
+  // Already in order: nothing to interleave
+  if (a_len == 0 || b_len == 0 ||
+      !act__sortLess(compare, b, a + (a_len - 1) * size)) {
+    memcpy(out, a, a_len * size);
+    memcpy(out + a_len * size, b, b_len * size);
+    return;
+  }
+
+  const char *a_end = a + a_len * size;
+  const char *b_end = b + b_len * size;
+  while (a < a_end && b < b_end) {
+    if (act__sortLess(compare, b, a)) {
+      memcpy(out, b, size);
+      b += size;
+    } else {
+      memcpy(out, a, size);
+      a += size;
+    }
+    out += size;
+  }
+  memcpy(out, a, (size_t)(a_end - a));
+  out += a_end - a;
+  memcpy(out, b, (size_t)(b_end - b));
+}
+
+/// Sorts @em len elements starting at @em base with a bottom-up merge sort,
+/// using @em buf (as large as the range) to merge into.
+ACT__SORT_INLINE void act__sortMergeSort(char *base, size_t len, size_t size,
+                                         act_SortCompareFn compare, char *buf,
+                                         char *tmp) {
+  for (size_t lo = 0; lo < len; lo += ACT__SORT_STABLE_RUN) {
+    size_t hi = lo + ACT__SORT_STABLE_RUN < len ? lo + ACT__SORT_STABLE_RUN
+                                                : len;
+    act__sortInsertion(base + lo * size, base + hi * size, size, compare, tmp,
+                       true);
+  }
+
+  char *src = base;
+  char *dst = buf;
+  for (size_t width = ACT__SORT_STABLE_RUN; width < len; width *= 2) {
+    for (size_t lo = 0; lo < len; lo += 2 * width) {
+      size_t mid = lo + width < len ? lo + width : len;
+      size_t hi = mid + width < len ? mid + width : len;
+      act__sortMerge(src + lo * size, mid - lo, src + mid * size, hi - mid,
+                     dst + lo * size, size, compare);
+    }
+    char *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != base) {
+    memcpy(base, src, len * size);
+  }
+}
+
+/// Sorts a slice with the element size known at compile time in common cases.
+/// @em buf is only used (and must be as large as the slice) when @em stable.
+static void act__sortSlice(char *base, size_t len, size_t size,
+                           act_SortCompareFn compare, bool stable, char *buf,
+                           char *tmp) {
+  if (stable) {
+    switch (size) {
+    case 4:
+      act__sortMergeSort(base, len, 4, compare, buf, tmp);
+      break;
+    case 8:
+      act__sortMergeSort(base, len, 8, compare, buf, tmp);
+      break;
+    case 16:
+      act__sortMergeSort(base, len, 16, compare, buf, tmp);
+      break;
+    default:
+      act__sortMergeSort(base, len, size, compare, buf, tmp);
+      break;
+    }
+    return;
+  }
+
+  switch (size) {
+  case 4:
+    act__sortPdq(base, len, 4, compare, tmp);
+    break;
+  case 8:
+    act__sortPdq(base, len, 8, compare, tmp);
+    break;
+  case 16:
+    act__sortPdq(base, len, 16, compare, tmp);
+    break;
+  default:
+    act__sortPdq(base, len, size, compare, tmp);
+    break;
+  }
+}
+
+/// Sorts a slice, providing the scratch space for one element.
+static bool act__sortSliceWithScratch(const act_Allocator *allocator,
+                                      char *base, size_t len, size_t size,
+                                      act_SortCompareFn compare, bool stable,
+                                      char *buf) {
+  _Alignas(16) char stack_tmp[ACT__SORT_STACK_ELEM_SIZE];
+  char *tmp = stack_tmp;
+  if (size > sizeof(stack_tmp)) {
+    tmp = (*allocator->alloc)(1, size);
+    if (tmp == NULL) {
+      return false;
+    }
+  }
+
+  act__sortSlice(base, len, size, compare, stable, buf, tmp);
+
+  if (tmp != stack_tmp) {
+    (*allocator->free)(tmp);
+  }
+  return true;
+}
+
+/// Returns how many elements of @em a are among the first @em k elements of
+/// the stable merge of @em a and @em b.
+static size_t act__sortCoRank(size_t k, const char *a, size_t a_len,
+                              const char *b, size_t b_len, size_t size,
+                              act_SortCompareFn compare) {
+  size_t lo = k > b_len ? k - b_len : 0;
+  size_t hi = k < a_len ? k : a_len;
+  while (lo < hi) {
+    size_t i = lo + (hi - lo) / 2;
+    size_t j = k - i;
+    // a[i] belongs to the first k elements unless b[j - 1] comes before it
+    if (j > 0 && !act__sortLess(compare, b + (j - 1) * size, a + i * size)) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+/// A piece of a merge of two runs, done by a single thread.
+typedef struct act__SortMergeTask {
+  const char *a;
+  size_t a_len;
+  const char *b;
+  size_t b_len;
+  char *out;
+  size_t k_begin;
+  size_t k_end;
+} act__SortMergeTask;
+
+/// The state shared by the threads of a parallel sort.
+typedef struct act__SortShared {
+  const act_Allocator *allocator;
+  char *base;
+  char *buf;
+  size_t len;
+  size_t size;
+  act_SortCompareFn compare;
+  bool stable;
+
+  /// Sorts a run in place instead of the comparison sort (may be **NULL**).
+  void (*sort_run)(char *base, size_t len);
+
+  /// The boundaries of the sorted runs (num_runs + 1 of them).
+  size_t *bounds;
+  size_t num_runs;
+
+  act__SortMergeTask *tasks;
+  size_t num_tasks;
+
+  size_t num_threads;
+  _Atomic bool failed;
+} act__SortShared;
+
+/// A thread of a parallel sort.
+typedef struct act__SortWorker {
+  act__SortShared *shared;
+  size_t idx;
+  void (*work)(act__SortShared *shared, size_t idx);
+} act__SortWorker;
+
+/// Sorts the runs assigned to a thread.
+static void act__sortRunsWork(act__SortShared *shared, size_t idx) {
+  for (size_t run = idx; run < shared->num_runs; run += shared->num_threads) {
+    size_t lo = shared->bounds[run];
+    size_t hi = shared->bounds[run + 1];
+    if (shared->sort_run != NULL) {
+      shared->sort_run(shared->base + lo * shared->size, hi - lo);
+      continue;
+    }
+
+    bool ok = act__sortSliceWithScratch(
+        shared->allocator, shared->base + lo * shared->size, hi - lo,
+        shared->size, shared->compare, shared->stable,
+        shared->buf + lo * shared->size);
+    if (!ok) {
+      shared->failed = true;
+    }
+  }
+}
+
+/// Does the merge tasks assigned to a thread.
+static void act__sortMergeWork(act__SortShared *shared, size_t idx) {
+  const size_t size = shared->size;
+  for (size_t t = idx; t < shared->num_tasks; t += shared->num_threads) {
+    const act__SortMergeTask *task = &shared->tasks[t];
+    size_t i0 = act__sortCoRank(task->k_begin, task->a, task->a_len, task->b,
+                                task->b_len, size, shared->compare);
+    size_t i1 = act__sortCoRank(task->k_end, task->a, task->a_len, task->b,
+                                task->b_len, size, shared->compare);
+    size_t j0 = task->k_begin - i0;
+    size_t j1 = task->k_end - i1;
+    act__sortMerge(task->a + i0 * size, i1 - i0, task->b + j0 * size,
+                   j1 - j0, task->out + task->k_begin * size, size,
+                   shared->compare);
+  }
+}
+
+/// The entry point of the threads of a parallel sort.
+static void *act__sortWorkerMain(void *arg) {
+  act__SortWorker *worker = arg;
+  worker->work(worker->shared, worker->idx);
+  return NULL;
+}
+
+/// Runs @em work on all threads; work of threads that can't be started is
+/// done on the calling thread.
+static void act__sortRunParallel(act__SortShared *shared,
+                                 void (*work)(act__SortShared *, size_t),
+                                 act__SortWorker *workers, pthread_t *threads,
+                                 bool *started) {
+  for (size_t i = 1; i < shared->num_threads; i++) {
+    workers[i] = (act__SortWorker){shared, i, work};
+    started[i] = pthread_create(&threads[i], NULL, act__sortWorkerMain,
+                                &workers[i]) == 0;
+  }
+
+  work(shared, 0);
+
+  for (size_t i = 1; i < shared->num_threads; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    } else {
+      work(shared, i);
+    }
+  }
+}
+
+/// Plans one round of merging adjacent pairs of runs from @em src into
+/// @em dst, splitting the merges into pieces of about equal size.
+static void act__sortPlanMerges(act__SortShared *shared, const char *src,
+                                char *dst) {
+  const size_t size = shared->size;
+  const size_t piece = (shared->len + shared->num_threads - 1) /
+                       shared->num_threads;
+
+  shared->num_tasks = 0;
+  size_t num_runs = 0;
+  for (size_t run = 0; run < shared->num_runs; run += 2) {
+    size_t lo = shared->bounds[run];
+    size_t mid = shared->bounds[run + 1];
+    size_t hi = run + 2 <= shared->num_runs ? shared->bounds[run + 2] : mid;
+
+    for (size_t k = 0; k < hi - lo; k += piece) {
+      shared->tasks[shared->num_tasks++] = (act__SortMergeTask){
+          .a = src + lo * size,
+          .a_len = mid - lo,
+          .b = src + mid * size,
+          .b_len = hi - mid,
+          .out = dst + lo * size,
+          .k_begin = k,
+          .k_end = k + piece < hi - lo ? k + piece : hi - lo,
+      };
+    }
+
+    shared->bounds[num_runs++] = lo;
+  }
+  shared->bounds[num_runs] = shared->len;
+  shared->num_runs = num_runs;
+}
+
+/// Sorts with many threads: sorts one run per thread, then merges pairs of
+/// runs until one is left.
+static bool act__sortParallel(act__SortShared *shared) {
+  const act_Allocator *allocator = shared->allocator;
+  const size_t num_threads = shared->num_threads;
+
+  act__SortWorker *workers = (*allocator->alloc)(num_threads, sizeof(*workers));
+  pthread_t *threads = (*allocator->alloc)(num_threads, sizeof(*threads));
+  bool *started = (*allocator->alloc)(num_threads, sizeof(*started));
+  size_t *bounds = (*allocator->alloc)(num_threads + 1, sizeof(*bounds));
+  act__SortMergeTask *tasks =
+      (*allocator->alloc)(2 * num_threads, sizeof(*tasks));
+  bool ok = workers != NULL && threads != NULL && started != NULL &&
+            bounds != NULL && tasks != NULL;
+
+  if (ok) {
+    for (size_t i = 0; i <= num_threads; i++) {
+      bounds[i] = shared->len * i / num_threads;
+    }
+    shared->bounds = bounds;
+    shared->num_runs = num_threads;
+    shared->tasks = tasks;
+
+    act__sortRunParallel(shared, act__sortRunsWork, workers, threads,
+                         started);
+    ok = !shared->failed;
+  }
+
+  char *src = shared->base;
+  char *dst = shared->buf;
+  while (ok && shared->num_runs > 1) {
+    act__sortPlanMerges(shared, src, dst);
+    act__sortRunParallel(shared, act__sortMergeWork, workers, threads,
+                         started);
+    char *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  // Copy the result back with a last "merge" of a single run
+  if (ok && src != shared->base) {
+    shared->num_runs = 1;
+    act__sortPlanMerges(shared, src, shared->base);
+    act__sortRunParallel(shared, act__sortMergeWork, workers, threads,
+                         started);
+  }
+
+  if (workers != NULL) {
+    (*allocator->free)(workers);
+  }
+  if (threads != NULL) {
+    (*allocator->free)(threads);
+  }
+  if (started != NULL) {
+    (*allocator->free)(started);
+  }
+  if (bounds != NULL) {
+    (*allocator->free)(bounds);
+  }
+  if (tasks != NULL) {
+    (*allocator->free)(tasks);
+  }
+
+  return ok;
+}
+
+/// Returns the number of threads to sort @em len elements with, when
+/// @em num_threads were requested (zero for one per online CPU).
+static size_t act__sortNumThreads(size_t len, size_t num_threads) {
+  if (num_threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    num_threads = cpus > 0 ? (size_t)cpus : 1;
+  }
+  if (num_threads > len / ACT__SORT_MIN_PER_THREAD) {
+    num_threads = len / ACT__SORT_MIN_PER_THREAD;
+  }
+  return num_threads > 0 ? num_threads : 1;
+}
+
+/// Sorts the vector, with a merge buffer when stable or parallel.
+static void act__sortVector(act_Vector *vec, act_SortCompareFn compare,
+                            bool stable, size_t num_threads,
+                            int *error_code) {
+  *error_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_VECTOR;
+    return;
+  }
+  if (compare == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_COMPARATOR;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  if (len < 2 || size == 0) {
+    return;
+  }
+
+  num_threads = act__sortNumThreads(len, num_threads);
+
+  // The unstable sequential sort works in place
+  if (!stable && num_threads == 1) {
+    if (!act__sortSliceWithScratch(allocator, vec, len, size, compare, false,
+                                   NULL)) {
+      *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+    }
+    return;
+  }
+
+  char *buf = (*allocator->alloc)(len, size);
+  if (buf == NULL) {
+    *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  bool ok = true;
+  if (num_threads == 1) {
+    ok = act__sortSliceWithScratch(allocator, vec, len, size, compare, true,
+                                   buf);
+  } else {
+    act__SortShared shared = {
+        .allocator = allocator,
+        .base = vec,
+        .buf = buf,
+        .len = len,
+        .size = size,
+        .compare = compare,
+        .stable = stable,
+        .num_threads = num_threads,
+    };
+    ok = act__sortParallel(&shared);
+  }
+  if (!ok) {
+    *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+  }
+
+  (*allocator->free)(buf);
+}
+
+void act_vectorSort(act_Vector *vec, act_SortCompareFn compare,
+                    int *error_code) {
+  act__sortVector(vec, compare, false, 1, error_code);
+}
+
+void act_vectorSortStable(act_Vector *vec, act_SortCompareFn compare,
+                          int *error_code) {
+  act__sortVector(vec, compare, true, 1, error_code);
+}
+
+void act_vectorSortParallel(act_Vector *vec, act_SortCompareFn compare,
+                            size_t num_threads, int *error_code) {
+  act__sortVector(vec, compare, false, num_threads, error_code);
+}
+
+void act_vectorSortStableParallel(act_Vector *vec, act_SortCompareFn compare,
+                                  size_t num_threads, int *error_code) {
+  act__sortVector(vec, compare, true, num_threads, error_code);
+}
+
+/// Moves the element that would be at @em nth (a pointer into [base, base +
+/// len)) in sorted order there, with no greater element before it and no
+/// smaller element after it (introselect).
+///
+/// This follows #act__sortPdq, but only continues into the side of each
+/// partition that holds @em nth.
+ACT__SORT_INLINE void act__sortSelect(char *base, size_t len, char *nth,
+                                      size_t size, act_SortCompareFn compare,
+                                      char *tmp) {
+  char *begin = base;
+  char *end = base + len * size;
+  int bad_allowed = 63 - __builtin_clzll((unsigned long long)len);
+  bool leftmost = true;
+
+  for (;;) {
+    size_t n = (size_t)(end - begin) / size;
+    if (n < ACT__SORT_INSERTION_THRESHOLD) {
+      act__sortInsertion(begin, end, size, compare, tmp, leftmost);
+      return;
+    }
+
+    char *mid = begin + (n / 2) * size;
+    if (n > ACT__SORT_NINTHER_THRESHOLD) {
+      act__sortSort3(begin, mid, end - size, size, compare);
+      act__sortSort3(begin + size, mid - size, end - 2 * size, size, compare);
+      act__sortSort3(begin + 2 * size, mid + size, end - 3 * size, size,
+                     compare);
+      act__sortSort3(mid - size, mid, mid + size, size, compare);
+      act__sortSwap(begin, mid, size);
+    } else {
+      act__sortSort3(mid, begin, end - size, size, compare);
+    }
+
+    // Everything up to the returned position equals the previous pivot
+    if (!leftmost && !act__sortLess(compare, begin - size, begin)) {
+      char *last_equal =
+          act__sortPartitionLeft(begin, end, size, compare, tmp);
+      if (nth <= last_equal) {
+        return;
+      }
+      begin = last_equal + size;
+      continue;
+    }
+
+    bool already_partitioned = false;
+    char *pivot = act__sortPartitionRight(begin, end, size, compare, tmp,
+                                          &already_partitioned);
+    if (pivot == nth) {
+      return;
+    }
+
+    size_t l_len = (size_t)(pivot - begin) / size;
+    size_t r_len = n - l_len - 1;
+    if (l_len < n / 8 || r_len < n / 8) {
+      if (--bad_allowed == 0) {
+        act__sortHeapsort(begin, n, size, compare, tmp);
+        return;
+      }
+      if (l_len >= ACT__SORT_INSERTION_THRESHOLD) {
+        act__sortShuffle(begin, pivot, l_len, size);
+      }
+      if (r_len >= ACT__SORT_INSERTION_THRESHOLD) {
+        act__sortShuffle(pivot + size, end, r_len, size);
+      }
+    }
+
+    if (nth < pivot) {
+      end = pivot;
+    } else {
+      begin = pivot + size;
+      leftmost = false;
+    }
+  }
+}
+
+/// Selects the @em nth element with the element size known at compile time in
+/// common cases.
+static void act__sortSelectSlice(char *base, size_t len, size_t nth,
+                                 size_t size, act_SortCompareFn compare,
+                                 char *tmp) {
+  switch (size) {
+  case 4:
+    act__sortSelect(base, len, base + nth * 4, 4, compare, tmp);
+    break;
+  case 8:
+    act__sortSelect(base, len, base + nth * 8, 8, compare, tmp);
+    break;
+  case 16:
+    act__sortSelect(base, len, base + nth * 16, 16, compare, tmp);
+    break;
+  default:
+    act__sortSelect(base, len, base + nth * size, size, compare, tmp);
+    break;
+  }
+}
+
+/// Sorts the first @em k elements of the vector (in sorted order), by
+/// selecting the k-th and sorting those before it.
+static void act__sortPartial(act_Vector *vec, size_t k, bool only_nth,
+                             act_SortCompareFn compare, int *error_code) {
+  *error_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_VECTOR;
+    return;
+  }
+  if (compare == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_COMPARATOR;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  if (only_nth && k >= len) {
+    *error_code = ACT_SORT_ERROR_INDEX_OUT_OF_BOUNDS;
+    return;
+  }
+  if (k > len) {
+    k = len;
+  }
+  if ((!only_nth && k == 0) || size == 0) {
+    return;
+  }
+
+  _Alignas(16) char stack_tmp[ACT__SORT_STACK_ELEM_SIZE];
+  char *tmp = stack_tmp;
+  if (size > sizeof(stack_tmp)) {
+    tmp = (*allocator->alloc)(1, size);
+    if (tmp == NULL) {
+      *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+      return;
+    }
+  }
+
+  if (only_nth || k < len) {
+    act__sortSelectSlice(vec, len, only_nth ? k : k - 1, size, compare, tmp);
+  }
+  if (!only_nth) {
+    act__sortSlice(vec, k < len ? k - 1 : k, size, compare, false, NULL, tmp);
+  }
+
+  if (tmp != stack_tmp) {
+    (*allocator->free)(tmp);
+  }
+}
+
+void act_vectorNthElement(act_Vector *vec, size_t nth,
+                          act_SortCompareFn compare, int *error_code) {
+  act__sortPartial(vec, nth, true, compare, error_code);
+}
+
+void act_vectorPartialSort(act_Vector *vec, size_t k,
+                           act_SortCompareFn compare, int *error_code) {
+  act__sortPartial(vec, k, false, compare, error_code);
+}
+
+/// Vectors shorter than this are sorted by comparison instead of radix sorted.
+#define ACT__SORT_RADIX_MIN_LEN 256
+
+/// A key and the index of the element it was extracted from.
+typedef struct act__SortKeyIdx {
+  uint64_t key;
+  size_t idx;
+} act__SortKeyIdx;
+
+static int act__sortCompareU32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int act__sortCompareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int act__sortCompareKeyIdx(const void *a, const void *b) {
+  const act__SortKeyIdx *x = a;
+  const act__SortKeyIdx *y = b;
+  if (x->key != y->key) {
+    return (x->key > y->key) - (x->key < y->key);
+  }
+  return (x->idx > y->idx) - (x->idx < y->idx);
+}
+
+/// Returns the key of an element of width @em width (4, 8, or a key-index
+/// pair).
+ACT__SORT_INLINE uint64_t act__sortRadixKey(const char *elem, size_t width) {
+  if (width == sizeof(uint32_t)) {
+    uint32_t key;
+    memcpy(&key, elem, sizeof(key));
+    return key;
+  }
+  uint64_t key;
+  memcpy(&key, elem, sizeof(key));
+  return key;
+}
+
+/// LSD radix sorts @em len elements of @em width bytes, whose key (of
+/// @em key_bytes bytes) is at their start, using @em buf as large as them.
+ACT__SORT_INLINE void act__sortRadix(char *data, char *buf, size_t len,
+                                     size_t width, size_t key_bytes) {
+  size_t counts[sizeof(uint64_t)][256];
+  memset(counts, 0, key_bytes * sizeof(*counts));
+
+  // One histogram pass for all digits
+  for (size_t i = 0; i < len; i++) {
+    uint64_t key = act__sortRadixKey(data + i * width, width);
+    for (size_t d = 0; d < key_bytes; d++) {
+      counts[d][(key >> (8 * d)) & 0xFF]++;
+    }
+  }
+
+  char *src = data;
+  char *dst = buf;
+  for (size_t d = 0; d < key_bytes; d++) {
+    size_t *count = counts[d];
+    const size_t shift = 8 * d;
+
+    // Every key has the same digit: the order doesn't change
+    if (count[(act__sortRadixKey(src, width) >> shift) & 0xFF] == len) {
+      continue;
+    }
+
+    size_t offset = 0;
+    for (size_t digit = 0; digit < 256; digit++) {
+      size_t n = count[digit];
+      count[digit] = offset;
+      offset += n;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+      const char *elem = src + i * width;
+      size_t digit = (act__sortRadixKey(elem, width) >> shift) & 0xFF;
+      memcpy(dst + count[digit]++ * width, elem, width);
+    }
+
+    char *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != data) {
+    memcpy(data, src, len * width);
+  }
+}
+
+/// Checks the arguments of a radix sort, and returns the number of elements
+/// to sort (zero if there is nothing to do).
+static size_t act__sortRadixCheck(act_Vector *vec, size_t data_size,
+                                  const act_Allocator **scratch_allocator,
+                                  int *error_code) {
+  *error_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_VECTOR;
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (data_size != 0 && act_vectorDataSize(vec, &vec_err) != data_size) {
+    *error_code = ACT_SORT_ERROR_INVALID_DATA_SIZE;
+    return 0;
+  }
+  if (*scratch_allocator == NULL) {
+    *scratch_allocator = act_vectorAllocator(vec, &vec_err);
+  }
+
+  size_t len = act_vectorLen(vec, &vec_err);
+  return len < 2 ? 0 : len;
+}
+
+/// Radix sorts a vector of unsigned integers of @em width bytes.
+static void act__sortRadixUnsigned(act_Vector *vec, size_t width,
+                                   const act_Allocator *scratch_allocator,
+                                   int *error_code) {
+  size_t len =
+      act__sortRadixCheck(vec, width, &scratch_allocator, error_code);
+  if (len == 0) {
+    return;
+  }
+
+  if (len < ACT__SORT_RADIX_MIN_LEN) {
+    _Alignas(16) char tmp[sizeof(uint64_t)];
+    if (width == sizeof(uint32_t)) {
+      act__sortPdq(vec, len, sizeof(uint32_t), act__sortCompareU32, tmp);
+    } else {
+      act__sortPdq(vec, len, sizeof(uint64_t), act__sortCompareU64, tmp);
+    }
+    return;
+  }
+
+  char *buf = (*scratch_allocator->alloc)(len, width);
+  if (buf == NULL) {
+    *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  if (width == sizeof(uint32_t)) {
+    act__sortRadix(vec, buf, len, sizeof(uint32_t), sizeof(uint32_t));
+  } else {
+    act__sortRadix(vec, buf, len, sizeof(uint64_t), sizeof(uint64_t));
+  }
+
+  (*scratch_allocator->free)(buf);
+}
+
+void act_vectorRadixSortU32(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code) {
+  act__sortRadixUnsigned(vec, sizeof(uint32_t), scratch_allocator,
+                         error_code);
+}
+
+void act_vectorRadixSortU64(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code) {
+  act__sortRadixUnsigned(vec, sizeof(uint64_t), scratch_allocator,
+                         error_code);
+}
+
+void act_vectorRadixSortI64(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code) {
+  size_t len = act__sortRadixCheck(vec, sizeof(int64_t), &scratch_allocator,
+                                   error_code);
+
+  // Flipping the sign bit orders the two's complement values as unsigned
+  uint64_t *values = vec;
+  for (size_t i = 0; i < len; i++) {
+    values[i] ^= UINT64_C(1) << 63;
+  }
+
+  act__sortRadixUnsigned(vec, sizeof(uint64_t), scratch_allocator,
+                         error_code);
+
+  for (size_t i = 0; i < len; i++) {
+    values[i] ^= UINT64_C(1) << 63;
+  }
+}
+
+void act_vectorRadixSortF64(act_Vector *vec,
+                            const act_Allocator *scratch_allocator,
+                            int *error_code) {
+  size_t len = act__sortRadixCheck(vec, sizeof(double), &scratch_allocator,
+                                   error_code);
+
+  // Flipping every bit of negative values (and the sign bit of the others)
+  // orders the IEEE 754 bit patterns as unsigned
+  uint64_t *values = vec;
+  for (size_t i = 0; i < len; i++) {
+    uint64_t mask = (uint64_t)((int64_t)values[i] >> 63) | UINT64_C(1) << 63;
+    values[i] ^= mask;
+  }
+
+  act__sortRadixUnsigned(vec, sizeof(uint64_t), scratch_allocator,
+                         error_code);
+
+  for (size_t i = 0; i < len; i++) {
+    uint64_t mask = (uint64_t)((int64_t)~values[i] >> 63) | UINT64_C(1) << 63;
+    values[i] ^= mask;
+  }
+}
+
+void act_vectorRadixSortByKey(act_Vector *vec, act_SortKeyFn key,
+                              const act_Allocator *scratch_allocator,
+                              int *error_code) {
+  size_t len = act__sortRadixCheck(vec, 0, &scratch_allocator, error_code);
+  if (*error_code != ACT_SORT_ERROR_SUCCESS) {
+    return;
+  }
+  if (key == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_KEY_FN;
+    return;
+  }
+  if (len == 0) {
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t size = act_vectorDataSize(vec, &vec_err);
+
+  act__SortKeyIdx *pairs = (*scratch_allocator->alloc)(2 * len, sizeof(*pairs));
+  char *elems = (*scratch_allocator->alloc)(len, size);
+  if (pairs == NULL || elems == NULL) {
+    if (pairs != NULL) {
+      (*scratch_allocator->free)(pairs);
+    }
+    if (elems != NULL) {
+      (*scratch_allocator->free)(elems);
+    }
+    *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  char *base = vec;
+  for (size_t i = 0; i < len; i++) {
+    pairs[i] = (act__SortKeyIdx){.key = key(base + i * size), .idx = i};
+  }
+
+  // Ties are broken by index, so small inputs are stable too
+  if (len < ACT__SORT_RADIX_MIN_LEN) {
+    _Alignas(16) char tmp[sizeof(*pairs)];
+    act__sortPdq((char *)pairs, len, sizeof(*pairs), act__sortCompareKeyIdx,
+                 tmp);
+  } else {
+    act__sortRadix((char *)pairs, (char *)(pairs + len), len, sizeof(*pairs),
+                   sizeof(uint64_t));
+  }
+
+  // Gather the elements in order, then copy them back
+  for (size_t i = 0; i < len; i++) {
+    memcpy(elems + i * size, base + pairs[i].idx * size, size);
+  }
+  memcpy(base, elems, len * size);
+
+  (*scratch_allocator->free)(pairs);
+  (*scratch_allocator->free)(elems);
+}
+
+/// Groups of strings smaller than this are insertion sorted.
+#define ACT__SORT_STRING_INSERTION_THRESHOLD 16
+
+/// The number of string bytes cached in an entry.
+#define ACT__SORT_STRING_CACHE_BYTES 7
+
+/// A string being sorted.
+typedef struct act__SortStringEntry {
+  /// The next cached bytes of the string (big-endian, zero padded) in the
+  /// high bytes, and the number of bytes left (capped at 8) in the low byte.
+  uint64_t cache;
+
+  /// The whole string.
+  act_StringView view;
+
+  /// The index of the string in the vector.
+  size_t idx;
+} act__SortStringEntry;
+
+/// A group of strings still to be sorted by #act__sortStringsMultikey, which
+/// share their first @em depth bytes.
+typedef struct act__SortStringRange {
+  act__SortStringEntry *begin;
+  size_t len;
+  size_t depth;
+  int bad_allowed;
+} act__SortStringRange;
+
+/// Returns the cache of the string's bytes from @em depth.
+///
+/// Comparing caches as integers compares the cached bytes lexicographically,
+/// and a string that ends within the cached bytes comes before any longer
+/// string with the same bytes. Equal caches with a low byte below 8 mean
+/// equal strings.
+ACT__SORT_INLINE uint64_t act__sortStringCache(act_StringView view,
+                                               size_t depth) {
+  const unsigned char *bytes = (const unsigned char *)view.data + depth;
+  size_t rem = view.len - depth;
+
+  uint64_t cache = 0;
+  if (rem >= sizeof(cache)) {
+    memcpy(&cache, bytes, sizeof(cache));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    cache = __builtin_bswap64(cache);
+#endif
+    return (cache & ~UINT64_C(0xFF)) | sizeof(cache);
+  }
+
+  for (size_t i = 0; i < rem; i++) {
+    cache |= (uint64_t)bytes[i] << (56 - 8 * i);
+  }
+  return cache | rem;
+}
+
+/// Returns whether a string comes before another, when both share their first
+/// @em depth bytes and their caches are from @em depth.
+ACT__SORT_INLINE bool act__sortStringLess(const act__SortStringEntry *a,
+                                          const act__SortStringEntry *b,
+                                          size_t depth) {
+  if (a->cache != b->cache) {
+    return a->cache < b->cache;
+  }
+  if ((a->cache & 0xFF) < 8) {
+    return false;
+  }
+
+  size_t skip = depth + ACT__SORT_STRING_CACHE_BYTES;
+  act_StringView a_rest = {a->view.data + skip, a->view.len - skip};
+  act_StringView b_rest = {b->view.data + skip, b->view.len - skip};
+  return act_stringViewLexCompare(a_rest, b_rest) < 0;
+}
+
+/// Compares two entries by their whole strings.
+static int act__sortCompareStringEntry(const void *a, const void *b) {
+  const act__SortStringEntry *x = a;
+  const act__SortStringEntry *y = b;
+  return act_stringViewLexCompare(x->view, y->view);
+}
+
+/// Insertion sorts a small group of strings that share their first
+/// @em depth bytes.
+static void act__sortStringsInsertion(act__SortStringEntry *entries,
+                                      size_t len, size_t depth) {
+  for (size_t i = 1; i < len; i++) {
+    act__SortStringEntry tmp = entries[i];
+    size_t j = i;
+    while (j > 0 && act__sortStringLess(&tmp, &entries[j - 1], depth)) {
+      entries[j] = entries[j - 1];
+      j--;
+    }
+    entries[j] = tmp;
+  }
+}
+
+/// Returns the median of three caches.
+static uint64_t act__sortStringMedian(uint64_t a, uint64_t b, uint64_t c) {
+  if (a < b) {
+    return b < c ? b : (a < c ? c : a);
+  }
+  return a < c ? a : (b < c ? c : b);
+}
+
+/// Sorts strings with multikey quicksort: a three-way quicksort on the cached
+/// bytes, which moves on to the next bytes (without comparing the shared
+/// prefix again) only for the strings equal to the pivot.
+///
+/// Like #act__sortPdq, too many unbalanced partitions fall back to a
+/// comparison sort, and the larger groups are pushed onto an explicit stack.
+static void act__sortStringsMultikey(act__SortStringEntry *entries,
+                                     size_t len) {
+  if (len < 2) {
+    return;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    entries[i].cache = act__sortStringCache(entries[i].view, 0);
+  }
+
+  act__SortStringRange stack[3 * ACT__SORT_STACK_DEPTH];
+  size_t top = 0;
+  stack[top++] = (act__SortStringRange){
+      .begin = entries,
+      .len = len,
+      .depth = 0,
+      .bad_allowed = 2 * (64 - __builtin_clzll((unsigned long long)len)),
+  };
+
+  while (top > 0) {
+    act__SortStringRange range = stack[--top];
+
+    for (;;) {
+      act__SortStringEntry *e = range.begin;
+      size_t n = range.len;
+      if (n < ACT__SORT_STRING_INSERTION_THRESHOLD) {
+        act__sortStringsInsertion(e, n, range.depth);
+        break;
+      }
+      if (range.bad_allowed == 0) {
+        _Alignas(16) char tmp[sizeof(act__SortStringEntry)];
+        act__sortPdq((char *)e, n, sizeof(*e), act__sortCompareStringEntry,
+                     tmp);
+        break;
+      }
+
+      uint64_t pivot =
+          act__sortStringMedian(e[0].cache, e[n / 2].cache, e[n - 1].cache);
+
+      // Three-way partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) >
+      size_t lt = 0;
+      size_t gt = n;
+      for (size_t i = 0; i < gt;) {
+        act__SortStringEntry tmp = e[i];
+        if (tmp.cache < pivot) {
+          e[i++] = e[lt];
+          e[lt++] = tmp;
+        } else if (tmp.cache > pivot) {
+          e[i] = e[--gt];
+          e[gt] = tmp;
+        } else {
+          i++;
+        }
+      }
+
+      // Strings equal to the pivot move on to their next bytes, unless they
+      // ended within the cached bytes (and so are all equal)
+      act__SortStringRange parts[3];
+      size_t num_parts = 0;
+      if ((pivot & 0xFF) == 8 && gt - lt > 1) {
+        size_t depth = range.depth + ACT__SORT_STRING_CACHE_BYTES;
+        for (size_t i = lt; i < gt; i++) {
+          e[i].cache = act__sortStringCache(e[i].view, depth);
+        }
+        parts[num_parts++] =
+            (act__SortStringRange){e + lt, gt - lt, depth, range.bad_allowed};
+      }
+
+      // Only splits with no large group of equal keys count as unbalanced
+      int bad_allowed = range.bad_allowed;
+      if (lt > n / 8 * 7 || n - gt > n / 8 * 7) {
+        bad_allowed--;
+      }
+      if (lt > 1) {
+        parts[num_parts++] =
+            (act__SortStringRange){e, lt, range.depth, bad_allowed};
+      }
+      if (n - gt > 1) {
+        parts[num_parts++] =
+            (act__SortStringRange){e + gt, n - gt, range.depth, bad_allowed};
+      }
+      if (num_parts == 0) {
+        break;
+      }
+
+      // Defer the larger groups, and keep sorting the smallest one
+      size_t smallest = 0;
+      for (size_t i = 1; i < num_parts; i++) {
+        if (parts[i].len < parts[smallest].len) {
+          smallest = i;
+        }
+      }
+      for (size_t i = 0; i < num_parts; i++) {
+        if (i != smallest) {
+          stack[top++] = parts[i];
+        }
+      }
+      range = parts[smallest];
+    }
+  }
+}
+
+/// Sorts a run of entries of a parallel string sort.
+static void act__sortStringRun(char *base, size_t len) {
+  act__sortStringsMultikey((act__SortStringEntry *)base, len);
+}
+
+/// Sorts a vector of #act_String (or of #act_StringView, if @em views).
+static void act__sortStringVector(act_Vector *vec, bool views,
+                                  size_t num_threads, int *error_code) {
+  *error_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_SORT_ERROR_NULL_VECTOR;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t size = views ? sizeof(act_StringView) : sizeof(act_String);
+  if (act_vectorDataSize(vec, &vec_err) != size) {
+    *error_code = ACT_SORT_ERROR_INVALID_DATA_SIZE;
+    return;
+  }
+  size_t len = act_vectorLen(vec, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  if (len < 2) {
+    return;
+  }
+
+  num_threads = act__sortNumThreads(len, num_threads);
+
+  // The strings are sorted as entries, then moved into place
+  act__SortStringEntry *entries = (*allocator->alloc)(len, sizeof(*entries));
+  char *buf = (*allocator->alloc)(len, size > sizeof(*entries)
+                                           ? size
+                                           : sizeof(*entries));
+  if (entries == NULL || buf == NULL) {
+    if (entries != NULL) {
+      (*allocator->free)(entries);
+    }
+    if (buf != NULL) {
+      (*allocator->free)(buf);
+    }
+    *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  for (size_t i = 0; i < len; i++) {
+    entries[i].view = views ? ((const act_StringView *)vec)[i]
+                            : act_stringAsView(((const act_String *)vec)[i]);
+    entries[i].idx = i;
+  }
+
+  bool ok = true;
+  if (num_threads == 1) {
+    act__sortStringsMultikey(entries, len);
+  } else {
+    act__SortShared shared = {
+        .allocator = allocator,
+        .base = (char *)entries,
+        .buf = buf,
+        .len = len,
+        .size = sizeof(*entries),
+        .compare = act__sortCompareStringEntry,
+        .sort_run = act__sortStringRun,
+        .num_threads = num_threads,
+    };
+    ok = act__sortParallel(&shared);
+  }
+
+  if (ok) {
+    // The merge buffer is reused to move the elements
+    char *base = vec;
+    for (size_t i = 0; i < len; i++) {
+      memcpy(buf + i * size, base + entries[i].idx * size, size);
+    }
+    memcpy(base, buf, len * size);
+  } else {
+    *error_code = ACT_SORT_ERROR_ALLOCATION_FAILED;
+  }
+
+  (*allocator->free)(entries);
+  (*allocator->free)(buf);
+}
+
+void act_vectorSortStrings(act_Vector *vec, int *error_code) {
+  act__sortStringVector(vec, false, 1, error_code);
+}
+
+void act_vectorSortStringViews(act_Vector *vec, int *error_code) {
+  act__sortStringVector(vec, true, 1, error_code);
+}
+
+void act_vectorSortStringsParallel(act_Vector *vec, size_t num_threads,
+                                   int *error_code) {
+  act__sortStringVector(vec, false, num_threads, error_code);
+}
+
+void act_vectorSortStringViewsParallel(act_Vector *vec, size_t num_threads,
+                                       int *error_code) {
+  act__sortStringVector(vec, true, num_threads, error_code);
+}
@@ -0,0 +1,930 @@
+#include "act_sorted.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ACT__SORTED_X86
+#include <immintrin.h>
+#endif
+
+/// The size of a cache line.
+#define ACT__SORTED_CACHE_LINE 64
+
+/// Prefetches the cache line at @em offset bytes from @em base, which may be
+/// past the end of the array (prefetches never fault).
+#define ACT__SORTED_PREFETCH(base, offset)                                     \
+  __builtin_prefetch((const void *)((uintptr_t)(base) + (offset)))
+
+/// Returns the number of elements before the first one for which
+/// @em compare(element, key) is not below @em limit: with a limit of 0 that's
+/// the lower bound, and with a limit of 1 the upper bound.
+static size_t act__sortedBound(const char *base, size_t len, size_t size,
+                               const void *key, act_SortCompareFn compare,
+                               int limit) {
+  if (len == 0) {
+    return 0;
+  }
+
+  // The bound is always in [first, first + len]
+  const char *first = base;
+  while (len > 1) {
+    size_t half = len / 2;
+    size_t next_half = (len - half) / 2;
+    ACT__SORTED_PREFETCH(first, next_half * size);
+    ACT__SORTED_PREFETCH(first, (half + next_half) * size);
+
+    // Arithmetic rather than a ternary, so the compiler doesn't branch
+    size_t below = compare(first + half * size, key) < limit;
+    first += below * half * size;
+    len -= half;
+  }
+
+  size_t below = compare(first, key) < limit;
+  return (size_t)(first - base) / size + below;
+}
+
+/// Checks the arguments shared by the searches on vectors.
+static bool act__sortedCheckArgs(const act_Vector *vec, const void *key,
+                                 act_SortCompareFn compare, int *error_code) {
+  if (vec == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_VECTOR;
+    return false;
+  }
+  if (key == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_KEY;
+    return false;
+  }
+  if (compare == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_COMPARATOR;
+    return false;
+  }
+  return true;
+}
+
+size_t act_vectorLowerBound(const act_Vector *vec, const void *key,
+                            act_SortCompareFn compare, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (!act__sortedCheckArgs(vec, key, compare, error_code)) {
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  return act__sortedBound(vec, len, size, key, compare, 0);
+}
+
+size_t act_vectorUpperBound(const act_Vector *vec, const void *key,
+                            act_SortCompareFn compare, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (!act__sortedCheckArgs(vec, key, compare, error_code)) {
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  return act__sortedBound(vec, len, size, key, compare, 1);
+}
+
+bool act_vectorBinarySearch(const act_Vector *vec, const void *key,
+                            act_SortCompareFn compare, size_t *index,
+                            int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (!act__sortedCheckArgs(vec, key, compare, error_code)) {
+    return false;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  size_t bound = act__sortedBound(vec, len, size, key, compare, 0);
+  if (index != NULL) {
+    *index = bound;
+  }
+
+  return bound < len && compare((const char *)vec + bound * size, key) == 0;
+}
+
+act_Vector *act_vectorMerge(const act_Vector *a, const act_Vector *b,
+                            act_SortCompareFn compare, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (a == NULL || b == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_VECTOR;
+    return NULL;
+  }
+  if (compare == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_COMPARATOR;
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t size = act_vectorDataSize(a, &vec_err);
+  if (act_vectorDataSize(b, &vec_err) != size) {
+    *error_code = ACT_SORTED_ERROR_INVALID_DATA_SIZE;
+    return NULL;
+  }
+
+  size_t a_len = act_vectorLen(a, &vec_err);
+  size_t b_len = act_vectorLen(b, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(a, &vec_err);
+  act_Vector *merged =
+      act_vectorWithCapacity(allocator, size, a_len + b_len, &vec_err);
+  if (merged == NULL) {
+    *error_code = ACT_SORTED_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+
+  const char *left = a;
+  const char *left_end = left + a_len * size;
+  const char *right = b;
+  const char *right_end = right + b_len * size;
+  char *out = merged;
+  while (left < left_end && right < right_end) {
+    // Take from the right only if strictly less, to keep the merge stable
+    if (compare(right, left) < 0) {
+      memcpy(out, right, size);
+      right += size;
+    } else {
+      memcpy(out, left, size);
+      left += size;
+    }
+    out += size;
+  }
+  memcpy(out, left, (size_t)(left_end - left));
+  out += left_end - left;
+  memcpy(out, right, (size_t)(right_end - right));
+
+  act__vectorSetLen(merged, a_len + b_len, &vec_err);
+
+  return merged;
+}
+
+/// Copies the sorted elements from @em src, starting at @em idx, into the
+/// subtree of @em dst rooted at node @em node (an in-order walk of the tree),
+/// and returns the index of the next element to copy.
+static size_t act__sortedFillEytzinger(char *dst, const char *src, size_t idx,
+                                       size_t node, size_t len, size_t size) {
+  if (node <= len) {
+    idx = act__sortedFillEytzinger(dst, src, idx, 2 * node, len, size);
+    memcpy(dst + node * size, src + idx * size, size);
+    idx++;
+    idx = act__sortedFillEytzinger(dst, src, idx, 2 * node + 1, len, size);
+  }
+  return idx;
+}
+
+act_EytzingerIndex act_eytzingerIndexNew(const act_Vector *vec,
+                                         act_SortCompareFn compare,
+                                         int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_VECTOR;
+    return (act_EytzingerIndex){0};
+  }
+  if (compare == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_COMPARATOR;
+    return (act_EytzingerIndex){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  size_t size = act_vectorDataSize(vec, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(vec, &vec_err);
+  if (size == 0) {
+    *error_code = ACT_SORTED_ERROR_INVALID_DATA_SIZE;
+    return (act_EytzingerIndex){0};
+  }
+
+  // Node 0 is unused, and the array is cache line aligned, so the 2^n
+  // descendants of a node n levels down share a line when 2^n elements fit
+  // in one
+  void *allocation =
+      (*allocator->alloc)(1, (len + 1) * size + ACT__SORTED_CACHE_LINE - 1);
+  if (allocation == NULL) {
+    *error_code = ACT_SORTED_ERROR_ALLOCATION_FAILED;
+    return (act_EytzingerIndex){0};
+  }
+  uintptr_t aligned = ((uintptr_t)allocation + ACT__SORTED_CACHE_LINE - 1) &
+                      ~(uintptr_t)(ACT__SORTED_CACHE_LINE - 1);
+  char *data = (char *)allocation + (aligned - (uintptr_t)allocation);
+  act__sortedFillEytzinger(data, vec, 0, 1, len, size);
+
+  size_t prefetch_levels = 1;
+  while (size << (prefetch_levels + 1) <= ACT__SORTED_CACHE_LINE) {
+    prefetch_levels++;
+  }
+
+  return (act_EytzingerIndex){
+      ._data = data,
+      ._allocation = allocation,
+      ._allocator = allocator,
+      ._len = len,
+      ._data_size = size,
+      ._compare = compare,
+      ._prefetch_levels = prefetch_levels,
+  };
+}
+
+void act_eytzingerIndexFree(act_EytzingerIndex *index, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (index == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_INDEX;
+    return;
+  }
+
+  if (index->_allocation != NULL) {
+    (*index->_allocator->free)(index->_allocation);
+  }
+  *index = (act_EytzingerIndex){0};
+}
+
+size_t act_eytzingerIndexLen(const act_EytzingerIndex *index) {
+  return index->_len;
+}
+
+/// Returns the node that a descent ending at @em node (past the leaves) last
+/// went left at: the lower bound, or 0 if the descent never went left.
+static inline size_t act__sortedEytzingerResult(size_t node) {
+  // The descent went right once per trailing one bit, so drop those and the
+  // last left turn
+  return node >> (__builtin_ctzll(~(unsigned long long)node) + 1);
+}
+
+/// Searches an Eytzinger index with any element type, comparing with its
+/// comparator.
+static const void *act__sortedEytzingerSearch(const act_EytzingerIndex *index,
+                                              const void *key) {
+  const char *data = index->_data;
+  const size_t len = index->_len;
+  const size_t size = index->_data_size;
+  const size_t levels = index->_prefetch_levels;
+  act_SortCompareFn compare = index->_compare;
+
+  size_t node = 1;
+  while (node <= len) {
+    ACT__SORTED_PREFETCH(data, (node << levels) * size);
+    node = 2 * node + (compare(data + node * size, key) < 0);
+  }
+
+  node = act__sortedEytzingerResult(node);
+  return node == 0 ? NULL : data + node * size;
+}
+
+/// Defines a function that searches an Eytzinger index of unsigned integers
+/// of type @em T, comparing them directly.
+#define ACT__SORTED_DEFINE_EYTZINGER_SEARCH(name, T)                           \
+  static const T *name(const act_EytzingerIndex *index, T key) {               \
+    const T *data = (const T *)index->_data;                                   \
+    const size_t len = index->_len;                                            \
+    const size_t levels = index->_prefetch_levels;                             \
+                                                                               \
+    size_t node = 1;                                                           \
+    while (node <= len) {                                                      \
+      ACT__SORTED_PREFETCH(data, (node << levels) * sizeof(T));                \
+      node = 2 * node + (data[node] < key);                                    \
+    }                                                                          \
+                                                                               \
+    node = act__sortedEytzingerResult(node);                                   \
+    return node == 0 ? NULL : data + node;                                     \
+  }
+
+ACT__SORTED_DEFINE_EYTZINGER_SEARCH(act__sortedEytzingerSearchU32, uint32_t)
+ACT__SORTED_DEFINE_EYTZINGER_SEARCH(act__sortedEytzingerSearchU64, uint64_t)
+
+const void *act_eytzingerIndexLowerBound(const act_EytzingerIndex *index,
+                                         const void *key, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (index == NULL || index->_data == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_INDEX;
+    return NULL;
+  }
+  if (key == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_KEY;
+    return NULL;
+  }
+
+  return act__sortedEytzingerSearch(index, key);
+}
+
+const void *act_eytzingerIndexFind(const act_EytzingerIndex *index,
+                                   const void *key, int *error_code) {
+  const void *found = act_eytzingerIndexLowerBound(index, key, error_code);
+  if (found == NULL || index->_compare(found, key) != 0) {
+    return NULL;
+  }
+  return found;
+}
+
+size_t act_eytzingerIndexRank(const act_EytzingerIndex *index,
+                              const void *element, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (index == NULL || index->_data == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_INDEX;
+    return 0;
+  }
+  uintptr_t offset = (uintptr_t)element - (uintptr_t)index->_data;
+  size_t node = offset / index->_data_size;
+  if (element == NULL || (uintptr_t)element < (uintptr_t)index->_data ||
+      offset % index->_data_size != 0 || node == 0 || node > index->_len) {
+    *error_code = ACT_SORTED_ERROR_INVALID_ELEMENT;
+    return 0;
+  }
+
+  // The in-order position the node would have in a perfect tree of the same
+  // height, less the empty slots of the last level that would come before it
+  size_t height = 64 - (size_t)__builtin_clzll(index->_len);
+  size_t depth = 63 - (size_t)__builtin_clzll(node);
+  size_t last_level = (size_t)1 << (height - 1);
+  size_t rank = ((2 * (node - ((size_t)1 << depth)) + 1)
+                 << (height - 1 - depth)) -
+                1;
+  size_t last_level_before = (rank + 1) / 2;
+  size_t last_level_len = index->_len - last_level + 1;
+  if (last_level_before > last_level_len) {
+    rank -= last_level_before - last_level_len;
+  }
+  return rank;
+}
+
+const uint32_t *
+act_eytzingerIndexLowerBoundU32(const act_EytzingerIndex *index, uint32_t key,
+                                int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (index == NULL || index->_data == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_INDEX;
+    return NULL;
+  }
+  if (index->_data_size != sizeof(uint32_t)) {
+    *error_code = ACT_SORTED_ERROR_INVALID_DATA_SIZE;
+    return NULL;
+  }
+
+  return act__sortedEytzingerSearchU32(index, key);
+}
+
+const uint64_t *
+act_eytzingerIndexLowerBoundU64(const act_EytzingerIndex *index, uint64_t key,
+                                int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (index == NULL || index->_data == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_INDEX;
+    return NULL;
+  }
+  if (index->_data_size != sizeof(uint64_t)) {
+    *error_code = ACT_SORTED_ERROR_INVALID_DATA_SIZE;
+    return NULL;
+  }
+
+  return act__sortedEytzingerSearchU64(index, key);
+}
+
+/// Gallop instead of merging when one vector is this many times longer than
+/// the other.
+#define ACT__SORTED_GALLOP_RATIO 32
+
+/// The number of elements the SIMD kernels may write past the end of their
+/// output (they store whole blocks, but only count the elements kept).
+#define ACT__SORTED_SIMD_SLACK 4
+
+/// Defines the scalar set operations on sorted arrays of unsigned integers of
+/// type @em T, with names ending in @em S. Each returns the number of
+/// elements written to @em out.
+#define ACT__SORTED_DEFINE_SET_OPS(S, T)                                       \
+  /* Returns the index of the first element from start on that is not less  \
+   * than key, by doubling the step until it's passed, then bisecting */      \
+  static size_t act__sortedGallop##S(const T *data, size_t start, size_t len, \
+                                     T key) {                                  \
+    if (start >= len || data[start] >= key) {                                  \
+      return start;                                                            \
+    }                                                                          \
+    size_t lo = start;                                                         \
+    size_t step = 1;                                                           \
+    while (lo + step < len && data[lo + step] < key) {                         \
+      lo += step;                                                              \
+      step *= 2;                                                               \
+    }                                                                          \
+    size_t hi = lo + step < len ? lo + step : len;                             \
+    while (hi - lo > 1) {                                                      \
+      size_t mid = lo + (hi - lo) / 2;                                         \
+      if (data[mid] < key) {                                                   \
+        lo = mid;                                                              \
+      } else {                                                                 \
+        hi = mid;                                                              \
+      }                                                                        \
+    }                                                                          \
+    return hi;                                                                 \
+  }                                                                            \
+                                                                               \
+  static size_t act__sortedIntersectScalar##S(const T *a, size_t a_len,        \
+                                              const T *b, size_t b_len,        \
+                                              T *out) {                        \
+    size_t i = 0;                                                              \
+    size_t j = 0;                                                              \
+    size_t count = 0;                                                          \
+    while (i < a_len && j < b_len) {                                           \
+      T x = a[i];                                                              \
+      T y = b[j];                                                              \
+      out[count] = x;                                                          \
+      count += x == y;                                                         \
+      i += x <= y;                                                             \
+      j += y <= x;                                                             \
+    }                                                                          \
+    return count;                                                              \
+  }                                                                            \
+                                                                               \
+  static size_t act__sortedIntersectGallop##S(const T *small,                  \
+                                              size_t small_len,                \
+                                              const T *large,                  \
+                                              size_t large_len, T *out) {      \
+    size_t j = 0;                                                              \
+    size_t count = 0;                                                          \
+    for (size_t i = 0; i < small_len; i++) {                                   \
+      j = act__sortedGallop##S(large, j, large_len, small[i]);                 \
+      if (j == large_len) {                                                    \
+        break;                                                                 \
+      }                                                                        \
+      if (large[j] == small[i]) {                                              \
+        out[count++] = small[i];                                               \
+        j++;                                                                   \
+      }                                                                        \
+    }                                                                          \
+    return count;                                                              \
+  }                                                                            \
+                                                                               \
+  /* Skips the elements of the first four of a whose bit is set in skip */    \
+  static size_t act__sortedDifferenceScalar##S(const T *a, size_t a_len,       \
+                                               const T *b, size_t b_len,       \
+                                               T *out, unsigned skip) {        \
+    size_t j = 0;                                                              \
+    size_t count = 0;                                                          \
+    for (size_t i = 0; i < a_len; i++) {                                       \
+      if (i < 4 && (skip >> i & 1) != 0) {                                     \
+        continue;                                                              \
+      }                                                                        \
+      T x = a[i];                                                              \
+      while (j < b_len && b[j] < x) {                                          \
+        j++;                                                                   \
+      }                                                                        \
+      out[count] = x;                                                          \
+      count += j == b_len || b[j] != x;                                        \
+    }                                                                          \
+    return count;                                                              \
+  }                                                                            \
+                                                                               \
+  static size_t act__sortedDifferenceGallop##S(const T *a, size_t a_len,       \
+                                               const T *b, size_t b_len,       \
+                                               T *out) {                       \
+    size_t count = 0;                                                          \
+    if (a_len < b_len) {                                                       \
+      /* Look each element of a up in b */                                     \
+      size_t j = 0;                                                            \
+      for (size_t i = 0; i < a_len; i++) {                                     \
+        j = act__sortedGallop##S(b, j, b_len, a[i]);                           \
+        out[count] = a[i];                                                     \
+        count += j == b_len || b[j] != a[i];                                   \
+      }                                                                        \
+      return count;                                                            \
+    }                                                                          \
+                                                                               \
+    /* Copy the runs of a between the elements of b */                         \
+    size_t i = 0;                                                              \
+    for (size_t j = 0; j < b_len && i < a_len; j++) {                          \
+      size_t run_end = act__sortedGallop##S(a, i, a_len, b[j]);                \
+      memcpy(out + count, a + i, (run_end - i) * sizeof(T));                   \
+      count += run_end - i;                                                    \
+      i = run_end + (run_end < a_len && a[run_end] == b[j]);                   \
+    }                                                                          \
+    memcpy(out + count, a + i, (a_len - i) * sizeof(T));                       \
+    return count + a_len - i;                                                  \
+  }                                                                            \
+                                                                               \
+  static size_t act__sortedUnion##S(const void *a_data, size_t a_len,          \
+                                    const void *b_data, size_t b_len,          \
+                                    void *out_data) {                          \
+    const T *a = a_data;                                                       \
+    const T *b = b_data;                                                       \
+    T *out = out_data;                                                         \
+    size_t i = 0;                                                              \
+    size_t j = 0;                                                              \
+    size_t count = 0;                                                          \
+    if (a_len > b_len * ACT__SORTED_GALLOP_RATIO ||                            \
+        b_len > a_len * ACT__SORTED_GALLOP_RATIO) {                            \
+      /* Copy the runs of the longer one between the elements of the other */ \
+      const T *small = a_len < b_len ? a : b;                                  \
+      const T *large = a_len < b_len ? b : a;                                  \
+      size_t small_len = a_len < b_len ? a_len : b_len;                        \
+      size_t large_len = a_len < b_len ? b_len : a_len;                        \
+      for (; i < small_len; i++) {                                             \
+        size_t run_end = act__sortedGallop##S(large, j, large_len, small[i]);  \
+        memcpy(out + count, large + j, (run_end - j) * sizeof(T));             \
+        count += run_end - j;                                                  \
+        j = run_end + (run_end < large_len && large[run_end] == small[i]);     \
+        out[count++] = small[i];                                               \
+      }                                                                        \
+      memcpy(out + count, large + j, (large_len - j) * sizeof(T));             \
+      return count + large_len - j;                                            \
+    }                                                                          \
+                                                                               \
+    while (i < a_len && j < b_len) {                                           \
+      T x = a[i];                                                              \
+      T y = b[j];                                                              \
+      out[count++] = x < y ? x : y;                                            \
+      i += x <= y;                                                             \
+      j += y <= x;                                                             \
+    }                                                                          \
+    memcpy(out + count, a + i, (a_len - i) * sizeof(T));                       \
+    count += a_len - i;                                                        \
+    memcpy(out + count, b + j, (b_len - j) * sizeof(T));                       \
+    return count + b_len - j;                                                  \
+  }
+
+ACT__SORTED_DEFINE_SET_OPS(U32, uint32_t)
+ACT__SORTED_DEFINE_SET_OPS(U64, uint64_t)
+
+#ifdef ACT__SORTED_X86
+/// For each mask of kept lanes, the bytes that move the kept 32-bit lanes of
+/// a block to its front (as little-endian words); later lanes are don't-care.
+static const uint32_t ACT__SORTED_COMPACT_U32[16][4]
+    __attribute__((aligned(16))) = {
+    {0, 0, 0, 0},
+    {0x03020100, 0, 0, 0},
+    {0x07060504, 0, 0, 0},
+    {0x03020100, 0x07060504, 0, 0},
+    {0x0B0A0908, 0, 0, 0},
+    {0x03020100, 0x0B0A0908, 0, 0},
+    {0x07060504, 0x0B0A0908, 0, 0},
+    {0x03020100, 0x07060504, 0x0B0A0908, 0},
+    {0x0F0E0D0C, 0, 0, 0},
+    {0x03020100, 0x0F0E0D0C, 0, 0},
+    {0x07060504, 0x0F0E0D0C, 0, 0},
+    {0x03020100, 0x07060504, 0x0F0E0D0C, 0},
+    {0x0B0A0908, 0x0F0E0D0C, 0, 0},
+    {0x03020100, 0x0B0A0908, 0x0F0E0D0C, 0},
+    {0x07060504, 0x0B0A0908, 0x0F0E0D0C, 0},
+    {0x03020100, 0x07060504, 0x0B0A0908, 0x0F0E0D0C},
+};
+
+/// For each mask of kept lanes, the 32-bit lanes that move the kept 64-bit
+/// lanes of a block to its front; later lanes are don't-care.
+static const int32_t ACT__SORTED_COMPACT_U64[16][8]
+    __attribute__((aligned(32))) = {
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 1, 0, 0, 0, 0, 0, 0},
+    {2, 3, 0, 0, 0, 0, 0, 0},
+    {0, 1, 2, 3, 0, 0, 0, 0},
+    {4, 5, 0, 0, 0, 0, 0, 0},
+    {0, 1, 4, 5, 0, 0, 0, 0},
+    {2, 3, 4, 5, 0, 0, 0, 0},
+    {0, 1, 2, 3, 4, 5, 0, 0},
+    {6, 7, 0, 0, 0, 0, 0, 0},
+    {0, 1, 6, 7, 0, 0, 0, 0},
+    {2, 3, 6, 7, 0, 0, 0, 0},
+    {0, 1, 2, 3, 6, 7, 0, 0},
+    {4, 5, 6, 7, 0, 0, 0, 0},
+    {0, 1, 4, 5, 6, 7, 0, 0},
+    {2, 3, 4, 5, 6, 7, 0, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+};
+
+/// Returns a mask of the lanes of @em a equal to some lane of @em b, by
+/// comparing @em a against every rotation of @em b.
+__attribute__((target("ssse3"))) static inline unsigned
+act__sortedMatchSsse3(__m128i a, __m128i b) {
+  __m128i eq = _mm_cmpeq_epi32(a, b);
+  b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1));
+  eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, b));
+  b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1));
+  eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, b));
+  b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1));
+  eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, b));
+  return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq));
+}
+
+/// Stores the lanes of @em block in @em keep at @em out, and returns how
+/// many there were.
+__attribute__((target("ssse3"))) static inline size_t
+act__sortedCompactSsse3(uint32_t *out, __m128i block, unsigned keep) {
+  __m128i shuffle =
+      _mm_load_si128((const __m128i *)ACT__SORTED_COMPACT_U32[keep]);
+  _mm_storeu_si128((__m128i *)out, _mm_shuffle_epi8(block, shuffle));
+  return (size_t)__builtin_popcount(keep);
+}
+
+/// Intersects blocks of four elements at a time: all 16 pairs are compared
+/// at once, and the block with the smaller last element is replaced.
+__attribute__((target("ssse3"))) static size_t
+act__sortedIntersectSsse3(const uint32_t *a, size_t a_len, const uint32_t *b,
+                          size_t b_len, uint32_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  while (i + 4 <= a_len && j + 4 <= b_len) {
+    __m128i a_block = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i b_block = _mm_loadu_si128((const __m128i *)(b + j));
+    unsigned match = act__sortedMatchSsse3(a_block, b_block);
+    count += act__sortedCompactSsse3(out + count, a_block, match);
+
+    uint32_t a_max = a[i + 3];
+    uint32_t b_max = b[j + 3];
+    i += (a_max <= b_max) * 4;
+    j += (b_max <= a_max) * 4;
+  }
+
+  return count + act__sortedIntersectScalarU32(a + i, a_len - i, b + j,
+                                               b_len - j, out + count);
+}
+
+/// Like #act__sortedIntersectSsse3, but the elements of a block of @em a
+/// that matched no block of @em b are kept once the block is replaced.
+__attribute__((target("ssse3"))) static size_t
+act__sortedDifferenceSsse3(const uint32_t *a, size_t a_len, const uint32_t *b,
+                           size_t b_len, uint32_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  unsigned matched = 0;
+  while (i + 4 <= a_len && j + 4 <= b_len) {
+    __m128i a_block = _mm_loadu_si128((const __m128i *)(a + i));
+    __m128i b_block = _mm_loadu_si128((const __m128i *)(b + j));
+    matched |= act__sortedMatchSsse3(a_block, b_block);
+
+    uint32_t a_max = a[i + 3];
+    uint32_t b_max = b[j + 3];
+    if (a_max <= b_max) {
+      count += act__sortedCompactSsse3(out + count, a_block, ~matched & 0xF);
+      matched = 0;
+      i += 4;
+    }
+    j += (b_max <= a_max) * 4;
+  }
+
+  return count + act__sortedDifferenceScalarU32(a + i, a_len - i, b + j,
+                                                b_len - j, out + count,
+                                                matched);
+}
+
+/// Returns a mask of the lanes of @em a equal to some lane of @em b, by
+/// comparing @em a against every rotation of @em b.
+__attribute__((target("avx2"))) static inline unsigned
+act__sortedMatchAvx2(__m256i a, __m256i b) {
+  __m256i eq = _mm256_cmpeq_epi64(a, b);
+  b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+  eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, b));
+  b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+  eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, b));
+  b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+  eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, b));
+  return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(eq));
+}
+
+/// Stores the lanes of @em block in @em keep at @em out, and returns how
+/// many there were.
+__attribute__((target("avx2"))) static inline size_t
+act__sortedCompactAvx2(uint64_t *out, __m256i block, unsigned keep) {
+  __m256i permute =
+      _mm256_load_si256((const __m256i *)ACT__SORTED_COMPACT_U64[keep]);
+  _mm256_storeu_si256((__m256i *)out,
+                      _mm256_permutevar8x32_epi32(block, permute));
+  return (size_t)__builtin_popcount(keep);
+}
+
+/// The 64-bit version of #act__sortedIntersectSsse3.
+__attribute__((target("avx2"))) static size_t
+act__sortedIntersectAvx2(const uint64_t *a, size_t a_len, const uint64_t *b,
+                         size_t b_len, uint64_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  while (i + 4 <= a_len && j + 4 <= b_len) {
+    __m256i a_block = _mm256_loadu_si256((const __m256i *)(a + i));
+    __m256i b_block = _mm256_loadu_si256((const __m256i *)(b + j));
+    unsigned match = act__sortedMatchAvx2(a_block, b_block);
+    count += act__sortedCompactAvx2(out + count, a_block, match);
+
+    uint64_t a_max = a[i + 3];
+    uint64_t b_max = b[j + 3];
+    i += (a_max <= b_max) * 4;
+    j += (b_max <= a_max) * 4;
+  }
+
+  return count + act__sortedIntersectScalarU64(a + i, a_len - i, b + j,
+                                               b_len - j, out + count);
+}
+
+/// The 64-bit version of #act__sortedDifferenceSsse3.
+__attribute__((target("avx2"))) static size_t
+act__sortedDifferenceAvx2(const uint64_t *a, size_t a_len, const uint64_t *b,
+                          size_t b_len, uint64_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  unsigned matched = 0;
+  while (i + 4 <= a_len && j + 4 <= b_len) {
+    __m256i a_block = _mm256_loadu_si256((const __m256i *)(a + i));
+    __m256i b_block = _mm256_loadu_si256((const __m256i *)(b + j));
+    matched |= act__sortedMatchAvx2(a_block, b_block);
+
+    uint64_t a_max = a[i + 3];
+    uint64_t b_max = b[j + 3];
+    if (a_max <= b_max) {
+      count += act__sortedCompactAvx2(out + count, a_block, ~matched & 0xF);
+      matched = 0;
+      i += 4;
+    }
+    j += (b_max <= a_max) * 4;
+  }
+
+  return count + act__sortedDifferenceScalarU64(a + i, a_len - i, b + j,
+                                                b_len - j, out + count,
+                                                matched);
+}
+#endif
+
+/// Returns whether one length is so much longer than the other that
+/// galloping through it beats merging.
+static inline bool act__sortedSkewed(size_t a_len, size_t b_len) {
+  return a_len > b_len * ACT__SORTED_GALLOP_RATIO ||
+         b_len > a_len * ACT__SORTED_GALLOP_RATIO;
+}
+
+static size_t act__sortedIntersectU32(const void *a_data, size_t a_len,
+                                      const void *b_data, size_t b_len,
+                                      void *out_data) {
+  const uint32_t *a = a_data;
+  const uint32_t *b = b_data;
+  uint32_t *out = out_data;
+  if (act__sortedSkewed(a_len, b_len)) {
+    return a_len < b_len
+               ? act__sortedIntersectGallopU32(a, a_len, b, b_len, out)
+               : act__sortedIntersectGallopU32(b, b_len, a, a_len, out);
+  }
+#ifdef ACT__SORTED_X86
+  if (__builtin_cpu_supports("ssse3")) {
+    return act__sortedIntersectSsse3(a, a_len, b, b_len, out);
+  }
+#endif
+  return act__sortedIntersectScalarU32(a, a_len, b, b_len, out);
+}
+
+static size_t act__sortedIntersectU64(const void *a_data, size_t a_len,
+                                      const void *b_data, size_t b_len,
+                                      void *out_data) {
+  const uint64_t *a = a_data;
+  const uint64_t *b = b_data;
+  uint64_t *out = out_data;
+  if (act__sortedSkewed(a_len, b_len)) {
+    return a_len < b_len
+               ? act__sortedIntersectGallopU64(a, a_len, b, b_len, out)
+               : act__sortedIntersectGallopU64(b, b_len, a, a_len, out);
+  }
+#ifdef ACT__SORTED_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return act__sortedIntersectAvx2(a, a_len, b, b_len, out);
+  }
+#endif
+  return act__sortedIntersectScalarU64(a, a_len, b, b_len, out);
+}
+
+static size_t act__sortedDifferenceU32(const void *a_data, size_t a_len,
+                                       const void *b_data, size_t b_len,
+                                       void *out_data) {
+  const uint32_t *a = a_data;
+  const uint32_t *b = b_data;
+  uint32_t *out = out_data;
+  if (act__sortedSkewed(a_len, b_len)) {
+    return act__sortedDifferenceGallopU32(a, a_len, b, b_len, out);
+  }
+#ifdef ACT__SORTED_X86
+  if (__builtin_cpu_supports("ssse3")) {
+    return act__sortedDifferenceSsse3(a, a_len, b, b_len, out);
+  }
+#endif
+  return act__sortedDifferenceScalarU32(a, a_len, b, b_len, out, 0);
+}
+
+static size_t act__sortedDifferenceU64(const void *a_data, size_t a_len,
+                                       const void *b_data, size_t b_len,
+                                       void *out_data) {
+  const uint64_t *a = a_data;
+  const uint64_t *b = b_data;
+  uint64_t *out = out_data;
+  if (act__sortedSkewed(a_len, b_len)) {
+    return act__sortedDifferenceGallopU64(a, a_len, b, b_len, out);
+  }
+#ifdef ACT__SORTED_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return act__sortedDifferenceAvx2(a, a_len, b, b_len, out);
+  }
+#endif
+  return act__sortedDifferenceScalarU64(a, a_len, b, b_len, out, 0);
+}
+
+/// A set operation on sorted arrays; returns the number of elements written
+/// to @em out.
+typedef size_t (*act__SortedSetOpFn)(const void *a, size_t a_len,
+                                     const void *b, size_t b_len, void *out);
+
+/// The kinds of set operations, which bound the length of their results
+/// differently.
+typedef enum act__SortedSetOpKind {
+  ACT__SORTED_INTERSECTION,
+  ACT__SORTED_UNION,
+  ACT__SORTED_DIFFERENCE,
+} act__SortedSetOpKind;
+
+/// Checks the vectors, makes room in @em dst for the most elements the
+/// operation can produce, and runs it.
+static act_Vector *act__sortedSetOp(act_Vector *dst, const act_Vector *a,
+                                    const act_Vector *b, size_t data_size,
+                                    act__SortedSetOpKind kind,
+                                    act__SortedSetOpFn op, int *error_code) {
+  *error_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (dst == NULL || a == NULL || b == NULL) {
+    *error_code = ACT_SORTED_ERROR_NULL_VECTOR;
+    return NULL;
+  }
+  if (dst == a || dst == b) {
+    *error_code = ACT_SORTED_ERROR_ALIASED_VECTOR;
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (act_vectorDataSize(dst, &vec_err) != data_size ||
+      act_vectorDataSize(a, &vec_err) != data_size ||
+      act_vectorDataSize(b, &vec_err) != data_size) {
+    *error_code = ACT_SORTED_ERROR_INVALID_DATA_SIZE;
+    return NULL;
+  }
+
+  size_t a_len = act_vectorLen(a, &vec_err);
+  size_t b_len = act_vectorLen(b, &vec_err);
+  size_t max_len = a_len;
+  if (kind == ACT__SORTED_INTERSECTION && b_len < a_len) {
+    max_len = b_len;
+  } else if (kind == ACT__SORTED_UNION) {
+    max_len = a_len + b_len;
+  }
+
+  // Reserved once, with the old elements dropped first so they aren't copied
+  act__vectorSetLen(dst, 0, &vec_err);
+  act_Vector *out =
+      act_vectorReserve(dst, max_len + ACT__SORTED_SIMD_SLACK, &vec_err);
+  if (out == NULL) {
+    *error_code = ACT_SORTED_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+
+  size_t len = op(a, a_len, b, b_len, out);
+  act__vectorSetLen(out, len, &vec_err);
+
+  return out;
+}
+
+act_Vector *act_vectorIntersectU32(act_Vector *dst, const act_Vector *a,
+                                   const act_Vector *b, int *error_code) {
+  return act__sortedSetOp(dst, a, b, sizeof(uint32_t),
+                          ACT__SORTED_INTERSECTION, act__sortedIntersectU32,
+                          error_code);
+}
+
+act_Vector *act_vectorIntersectU64(act_Vector *dst, const act_Vector *a,
+                                   const act_Vector *b, int *error_code) {
+  return act__sortedSetOp(dst, a, b, sizeof(uint64_t),
+                          ACT__SORTED_INTERSECTION, act__sortedIntersectU64,
+                          error_code);
+}
+
+act_Vector *act_vectorUnionU32(act_Vector *dst, const act_Vector *a,
+                               const act_Vector *b, int *error_code) {
+  return act__sortedSetOp(dst, a, b, sizeof(uint32_t), ACT__SORTED_UNION,
+                          act__sortedUnionU32, error_code);
+}
+
+act_Vector *act_vectorUnionU64(act_Vector *dst, const act_Vector *a,
+                               const act_Vector *b, int *error_code) {
+  return act__sortedSetOp(dst, a, b, sizeof(uint64_t), ACT__SORTED_UNION,
+                          act__sortedUnionU64, error_code);
+}
+
+act_Vector *act_vectorDifferenceU32(act_Vector *dst, const act_Vector *a,
+                                    const act_Vector *b, int *error_code) {
+  return act__sortedSetOp(dst, a, b, sizeof(uint32_t), ACT__SORTED_DIFFERENCE,
+                          act__sortedDifferenceU32, error_code);
+}
+
+act_Vector *act_vectorDifferenceU64(act_Vector *dst, const act_Vector *a,
+                                    const act_Vector *b, int *error_code) {
+  return act__sortedSetOp(dst, a, b, sizeof(uint64_t), ACT__SORTED_DIFFERENCE,
+                          act__sortedDifferenceU64, error_code);
+}
@@ -0,0 +1,423 @@
+#ifndef ACT_SORTED_H
+#define ACT_SORTED_H
+
+#include "act_allocator.h"
+#include "act_sort.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_sorted.h
+///
+/// This header defines functions on an #act_Vector whose elements are sorted
+/// by a comparator (e.g. by #act_vectorSort): binary searches, merges, and an
+/// index that is faster to search than the vector itself.
+///
+/// The binary searches are branchless: each step keeps one half of the range
+/// with a conditional move rather than a branch, since which half is kept is
+/// a coin flip the branch predictor gets wrong half the time. Both halves the
+/// next step might look at are prefetched.
+///
+/// An #act_EytzingerIndex stores the elements of a sorted vector in the order
+/// of a breadth-first walk of the binary search tree over them (the Eytzinger
+/// layout): the root, then its two children, then their four children, and so
+/// on. The children of node @em k are nodes @em 2k and @em 2k + 1, so the
+/// descendants of a node a few levels down share a cache line, which is
+/// prefetched while the levels in between are compared; and the top levels,
+/// which every search goes through, stay in cache.
+///
+/// Sorted vectors of **uint32_t** or **uint64_t** without duplicates can be
+/// used as sets, and intersected, united and subtracted into a destination
+/// vector, which is grown at most once. When one vector is much longer than
+/// the other, the longer one is galloped through (searched from the last
+/// position with steps that double, then bisected) rather than merged, and
+/// runs of it are copied whole. Otherwise intersections and differences
+/// compare blocks of four elements against four at a time with SIMD (SSSE3
+/// for **uint32_t**, AVX2 for **uint64_t**) when the CPU supports it.
+///
+/// Comparators are always called with an element of the vector first and the
+/// searched key second, so the key can be a partial element (e.g. just the
+/// key field of a record) if the comparator only reads that part of its
+/// second argument.
+
+/// @brief The possible error values.
+typedef enum act_SortedError {
+  /// Successful operation.
+  ACT_SORTED_ERROR_SUCCESS = 0x0,
+
+  /// The given vector was **NULL**.
+  ACT_SORTED_ERROR_NULL_VECTOR,
+
+  /// The given comparator was **NULL**.
+  ACT_SORTED_ERROR_NULL_COMPARATOR,
+
+  /// The given key was **NULL**.
+  ACT_SORTED_ERROR_NULL_KEY,
+
+  /// The given index was **NULL** or already freed.
+  ACT_SORTED_ERROR_NULL_INDEX,
+
+  /// A failure during allocation.
+  ACT_SORTED_ERROR_ALLOCATION_FAILED,
+
+  /// The data size doesn't match the type being searched, or the other
+  /// vector's data size.
+  ACT_SORTED_ERROR_INVALID_DATA_SIZE,
+
+  /// The destination vector was also one of the source vectors.
+  ACT_SORTED_ERROR_ALIASED_VECTOR,
+
+  /// The given element was not one of the index's elements.
+  ACT_SORTED_ERROR_INVALID_ELEMENT,
+} act_SortedError;
+
+/// @brief **[PRIVATE]** A read-only search index over the elements of a sorted
+/// #act_Vector, in Eytzinger order.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_eytzingerIndexNew, #act_eytzingerIndexLowerBound
+typedef struct act_EytzingerIndex {
+  /// @cond
+  /// @internal The elements in Eytzinger order, from index 1; cache line
+  /// aligned.
+  char *_data;
+
+  /// @internal The allocation that holds the elements.
+  void *_allocation;
+
+  /// @internal The allocator used for the elements.
+  const act_Allocator *_allocator;
+
+  /// @internal The number of elements.
+  size_t _len;
+
+  /// @internal The size of an element.
+  size_t _data_size;
+
+  /// @internal The comparator that orders the elements.
+  act_SortCompareFn _compare;
+
+  /// @internal The number of levels below the current node to prefetch.
+  size_t _prefetch_levels;
+  /// @endcond
+} act_EytzingerIndex;
+
+/// @brief Returns the index of the first element of the sorted #act_Vector
+/// that is not less than the key, in O(log n).
+///
+/// @param[in]  vec         The sorted vector to search.
+/// @param[in]  key         The key to search for.
+/// @param[in]  compare     The comparator the vector is sorted by.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The index of the first element not less than the key, or the
+/// length of the vector if there is none.
+///
+/// @sa #act_vectorUpperBound, #act_vectorBinarySearch
+size_t act_vectorLowerBound(const act_Vector *vec, const void *key,
+                            act_SortCompareFn compare, int *error_code);
+
+/// @brief Returns the index of the first element of the sorted #act_Vector
+/// that is greater than the key, in O(log n).
+///
+/// @param[in]  vec         The sorted vector to search.
+/// @param[in]  key         The key to search for.
+/// @param[in]  compare     The comparator the vector is sorted by.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The index of the first element greater than the key, or the length
+/// of the vector if there is none.
+///
+/// @sa #act_vectorLowerBound
+size_t act_vectorUpperBound(const act_Vector *vec, const void *key,
+                            act_SortCompareFn compare, int *error_code);
+
+/// @brief Checks if the sorted #act_Vector contains an element equivalent to
+/// the key, in O(log n).
+///
+/// @param[in]  vec         The sorted vector to search.
+/// @param[in]  key         The key to search for.
+/// @param[in]  compare     The comparator the vector is sorted by.
+/// @param[out] index       Set to the index of the first equivalent element
+///                         if found, or else to the index the key would be
+///                         inserted at to keep the vector sorted (may be
+///                         **NULL**).
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return **true** if an equivalent element was found.
+///
+/// @sa #act_vectorLowerBound
+bool act_vectorBinarySearch(const act_Vector *vec, const void *key,
+                            act_SortCompareFn compare, size_t *index,
+                            int *error_code);
+
+/// @brief Merges two sorted #act_Vector into a new sorted vector, in
+/// O(n + m).
+///
+/// Equivalent elements keep their order, and those of @em a come before
+/// those of @em b.
+///
+/// @param[in]  a           The first sorted vector.
+/// @param[in]  b           The second sorted vector, with the same data size.
+/// @param[in]  compare     The comparator both vectors are sorted by.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The merged vector, using the allocator of @em a.
+///
+/// @note This function allocates a vector with space for the elements of
+/// both vectors.
+act_Vector *act_vectorMerge(const act_Vector *a, const act_Vector *b,
+                            act_SortCompareFn compare, int *error_code);
+
+/// @brief Creates a new #act_EytzingerIndex over the elements of a sorted
+/// #act_Vector, in O(n).
+///
+/// The index holds a copy of the elements, so the vector may be freed or
+/// changed afterwards.
+///
+/// @param[in]  vec         The sorted vector to index.
+/// @param[in]  compare     The comparator the vector is sorted by.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return A new index.
+///
+/// @note This function allocates space for the elements of the vector (plus
+/// one, and a cache line), using the vector's allocator.
+///
+/// @sa #act_eytzingerIndexFree
+act_EytzingerIndex act_eytzingerIndexNew(const act_Vector *vec,
+                                         act_SortCompareFn compare,
+                                         int *error_code);
+
+/// @brief Frees all memory allocated by the #act_EytzingerIndex.
+///
+/// @param[in]  index       The index to free.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+void act_eytzingerIndexFree(act_EytzingerIndex *index, int *error_code);
+
+/// @brief Returns the number of elements in the #act_EytzingerIndex.
+///
+/// @param index The index to get the length of.
+///
+/// @return The number of elements.
+size_t act_eytzingerIndexLen(const act_EytzingerIndex *index);
+
+/// @brief Returns the first element in the #act_EytzingerIndex that is not
+/// less than the key, in O(log n).
+///
+/// @param[in]  index       The index to search.
+/// @param[in]  key         The key to search for.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return A pointer to the element (valid until the index is freed), or
+/// **NULL** if every element is less than the key.
+///
+/// @sa #act_eytzingerIndexFind
+const void *act_eytzingerIndexLowerBound(const act_EytzingerIndex *index,
+                                         const void *key, int *error_code);
+
+/// @brief Returns an element in the #act_EytzingerIndex equivalent to the
+/// key, in O(log n).
+///
+/// @param[in]  index       The index to search.
+/// @param[in]  key         The key to search for.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return A pointer to the first equivalent element (valid until the index
+/// is freed), or **NULL** if there is none.
+///
+/// @sa #act_eytzingerIndexLowerBound
+const void *act_eytzingerIndexFind(const act_EytzingerIndex *index,
+                                   const void *key, int *error_code);
+
+/// @brief Returns the position an element of the #act_EytzingerIndex had in
+/// the sorted vector the index was built from, in O(1).
+///
+/// @param[in]  index       The index the element belongs to.
+/// @param[in]  element     The element, as returned by a search of the index.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The index of the element in the sorted vector.
+size_t act_eytzingerIndexRank(const act_EytzingerIndex *index,
+                              const void *element, int *error_code);
+
+/// @brief Returns the first element in an #act_EytzingerIndex of
+/// **uint32_t** that is not less than the key, without calling the
+/// comparator.
+///
+/// The index must be sorted in ascending order.
+///
+/// @param[in]  index       The index to search.
+/// @param[in]  key         The key to search for.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return A pointer to the element (valid until the index is freed), or
+/// **NULL** if every element is less than the key.
+const uint32_t *
+act_eytzingerIndexLowerBoundU32(const act_EytzingerIndex *index, uint32_t key,
+                                int *error_code);
+
+/// @brief Returns the first element in an #act_EytzingerIndex of
+/// **uint64_t** that is not less than the key, without calling the
+/// comparator.
+///
+/// The index must be sorted in ascending order.
+///
+/// @param[in]  index       The index to search.
+/// @param[in]  key         The key to search for.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return A pointer to the element (valid until the index is freed), or
+/// **NULL** if every element is less than the key.
+const uint64_t *
+act_eytzingerIndexLowerBoundU64(const act_EytzingerIndex *index, uint64_t key,
+                                int *error_code);
+
+/// @brief Writes the intersection of two sets, stored as sorted #act_Vector of
+/// **uint32_t** without duplicates, to @em dst.
+///
+/// The result is the elements in both @em a and @em b, in order. The previous
+/// elements of @em dst are dropped.
+///
+/// @param[in]  dst         The destination vector of **uint32_t**.
+/// @param[in]  a           The first set.
+/// @param[in]  b           The second set.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) destination vector, or **NULL** if space
+/// couldn't be allocated for the result (in which case @em dst is left empty,
+/// and still owned by the caller); @em dst must not be used afterwards
+/// otherwise.
+///
+/// @note This function allocates memory at most once, if @em dst has no room
+/// for as many elements as the shorter of the two vectors (plus four).
+act_Vector *act_vectorIntersectU32(act_Vector *dst, const act_Vector *a,
+                                   const act_Vector *b, int *error_code);
+
+/// @brief Writes the intersection of two sets, stored as sorted #act_Vector of
+/// **uint64_t** without duplicates, to @em dst.
+///
+/// The result is the elements in both @em a and @em b, in order. The previous
+/// elements of @em dst are dropped.
+///
+/// @param[in]  dst         The destination vector of **uint64_t**.
+/// @param[in]  a           The first set.
+/// @param[in]  b           The second set.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) destination vector, or **NULL** if space
+/// couldn't be allocated for the result (in which case @em dst is left empty,
+/// and still owned by the caller); @em dst must not be used afterwards
+/// otherwise.
+///
+/// @note This function allocates memory at most once, if @em dst has no room
+/// for as many elements as the shorter of the two vectors (plus four).
+act_Vector *act_vectorIntersectU64(act_Vector *dst, const act_Vector *a,
+                                   const act_Vector *b, int *error_code);
+
+/// @brief Writes the union of two sets, stored as sorted #act_Vector of
+/// **uint32_t** without duplicates, to @em dst.
+///
+/// The result is the elements in @em a or @em b (or both), in order. The
+/// previous elements of @em dst are dropped.
+///
+/// @param[in]  dst         The destination vector of **uint32_t**.
+/// @param[in]  a           The first set.
+/// @param[in]  b           The second set.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) destination vector, or **NULL** if space
+/// couldn't be allocated for the result (in which case @em dst is left empty,
+/// and still owned by the caller); @em dst must not be used afterwards
+/// otherwise.
+///
+/// @note This function allocates memory at most once, if @em dst has no room
+/// for as many elements as both vectors (plus four).
+act_Vector *act_vectorUnionU32(act_Vector *dst, const act_Vector *a,
+                               const act_Vector *b, int *error_code);
+
+/// @brief Writes the union of two sets, stored as sorted #act_Vector of
+/// **uint64_t** without duplicates, to @em dst.
+///
+/// The result is the elements in @em a or @em b (or both), in order. The
+/// previous elements of @em dst are dropped.
+///
+/// @param[in]  dst         The destination vector of **uint64_t**.
+/// @param[in]  a           The first set.
+/// @param[in]  b           The second set.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) destination vector, or **NULL** if space
+/// couldn't be allocated for the result (in which case @em dst is left empty,
+/// and still owned by the caller); @em dst must not be used afterwards
+/// otherwise.
+///
+/// @note This function allocates memory at most once, if @em dst has no room
+/// for as many elements as both vectors (plus four).
+act_Vector *act_vectorUnionU64(act_Vector *dst, const act_Vector *a,
+                               const act_Vector *b, int *error_code);
+
+/// @brief Writes the difference of two sets, stored as sorted #act_Vector of
+/// **uint32_t** without duplicates, to @em dst.
+///
+/// The result is the elements in @em a that aren't in @em b, in order. The
+/// previous elements of @em dst are dropped.
+///
+/// @param[in]  dst         The destination vector of **uint32_t**.
+/// @param[in]  a           The first set.
+/// @param[in]  b           The second set.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) destination vector, or **NULL** if space
+/// couldn't be allocated for the result (in which case @em dst is left empty,
+/// and still owned by the caller); @em dst must not be used afterwards
+/// otherwise.
+///
+/// @note This function allocates memory at most once, if @em dst has no room
+/// for as many elements as @em a (plus four).
+act_Vector *act_vectorDifferenceU32(act_Vector *dst, const act_Vector *a,
+                                    const act_Vector *b, int *error_code);
+
+/// @brief Writes the difference of two sets, stored as sorted #act_Vector of
+/// **uint64_t** without duplicates, to @em dst.
+///
+/// The result is the elements in @em a that aren't in @em b, in order. The
+/// previous elements of @em dst are dropped.
+///
+/// @param[in]  dst         The destination vector of **uint64_t**.
+/// @param[in]  a           The first set.
+/// @param[in]  b           The second set.
+/// @param[out] error_code  The error code (#act_SortedError) of the
+///                         operation.
+///
+/// @return The (@em possibly moved) destination vector, or **NULL** if space
+/// couldn't be allocated for the result (in which case @em dst is left empty,
+/// and still owned by the caller); @em dst must not be used afterwards
+/// otherwise.
+///
+/// @note This function allocates memory at most once, if @em dst has no room
+/// for as many elements as @em a (plus four).
+act_Vector *act_vectorDifferenceU64(act_Vector *dst, const act_Vector *a,
+                                    const act_Vector *b, int *error_code);
+
+#endif /* !ACT_SORTED_H */
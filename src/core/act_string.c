@@ -1,9 +1,17 @@
 #include "act_string.h"
 #include <stdio.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define ACT__STRING_X86
+#include <immintrin.h>
+#endif
+
 /// The default capacity to add when resizing a @em #act_String.
 static const size_t STRING_RESIZE_CAP = 8;
 
+/// The minimum free space left in the gap when a gap buffer grows.
+static const size_t STRING_GAP_MIN = 64;
+
 act_String act_stringNew(const act_Allocator *allocator, int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
 
@@ -58,11 +66,55 @@ act_String act_stringFromCstr(const act_Allocator *allocator, const char *cstr,
   };
 }
 
+act_String act_stringFromView(const act_Allocator *allocator,
+                              act_StringView view, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_ALLOCATOR;
+    return (act_String){0};
+  }
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return (act_String){0};
+  }
+
+  char *data = (*allocator->alloc)(view.len + 1, sizeof(char));
+  if (data == NULL) {
+    *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+    return (act_String){0};
+  }
+  if (view.len != 0) {
+    memcpy(data, view.data, view.len);
+  }
+  data[view.len] = '\0';
+
+  return (act_String){
+      ._allocator = allocator,
+      ._len = view.len,
+      ._capacity = view.len + 1,
+      ._data = data,
+  };
+}
+
 void act_stringFree(act_String *string, int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
 
   ACT_ASSERT_OR(string != NULL, *error_code = ACT_STRING_ERROR_NULL_STRING);
 
+  // Shared buffers are only freed by the last reference
+  if (string->_meta != NULL) {
+    if (string->_meta->shared &&
+        atomic_fetch_sub_explicit(&string->_meta->refcount, 1,
+                                  memory_order_acq_rel) != 1) {
+      string->_data = NULL;
+      string->_meta = NULL;
+      return;
+    }
+    (*string->_allocator->free)(string->_meta);
+    string->_meta = NULL;
+  }
+
   (*string->_allocator->free)(string->_data);
 
   string = NULL;
@@ -72,7 +124,111 @@ size_t act_stringLen(act_String string) { return string._len; }
 
 size_t act_stringCapacity(act_String string) { return string._capacity; }
 
-const char *act_stringAsCstr(act_String string) { return string._data; }
+const char *act_stringAsCstr(act_String string) {
+  act__stringCompact(&string);
+  return string._data;
+}
+
+act_StringView act_stringAsView(act_String string) {
+  act__stringCompact(&string);
+  return (act_StringView){.data = string._data, .len = string._len};
+}
+
+act_StringView act_stringViewFromCstr(const char *cstr) {
+  if (cstr == NULL) {
+    return (act_StringView){.data = NULL, .len = 0};
+  }
+
+  return (act_StringView){.data = cstr, .len = strlen(cstr)};
+}
+
+/// Allocates bookkeeping for a buffer with a single reference and no gap.
+static act__StringMeta *act__stringMetaNew(const act_Allocator *allocator,
+                                           bool shared) {
+  act__StringMeta *meta = (*allocator->alloc)(1, sizeof(*meta));
+  if (meta == NULL) {
+    return NULL;
+  }
+
+  atomic_init(&meta->refcount, 1);
+  meta->shared = shared;
+  meta->gap_start = 0;
+  meta->gap_len = 0;
+
+  return meta;
+}
+
+void act__stringCompact(act_String *string) {
+  act__StringMeta *meta = string->_meta;
+  if (meta == NULL || meta->gap_len == 0) {
+    return;
+  }
+
+  // The text after the gap is followed by the null terminator
+  size_t tail_len = string->_len - meta->gap_start;
+  memmove(string->_data + meta->gap_start,
+          string->_data + meta->gap_start + meta->gap_len, tail_len + 1);
+  meta->gap_start = string->_len;
+  meta->gap_len = 0;
+}
+
+void act__stringMakeUnique(act_String *string, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+  string->_has_hash = false;
+
+  // Shared buffers never hold a gap, so this never needs to compact
+  act__StringMeta *meta = string->_meta;
+  if (meta == NULL || !meta->shared ||
+      atomic_load_explicit(&meta->refcount, memory_order_acquire) == 1) {
+    return;
+  }
+
+  // Give this string its own bookkeeping, so it stays in shared mode
+  act__StringMeta *unique_meta =
+      act__stringMetaNew(string->_allocator, /*shared=*/true);
+  if (unique_meta == NULL) {
+    *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  // An empty string is reallocated by its next push anyway
+  char *data = NULL;
+  if (string->_len != 0) {
+    size_t capacity = string->_capacity > string->_len + 1
+                          ? string->_capacity
+                          : string->_len + 1;
+    data = (*string->_allocator->alloc)(capacity, sizeof(*data));
+    if (data == NULL) {
+      (*string->_allocator->free)(unique_meta);
+      *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+      return;
+    }
+    memcpy(data, string->_data, string->_len);
+    data[string->_len] = '\0';
+    string->_capacity = capacity;
+  }
+
+  // Release the shared buffer; another reference may have freed it meanwhile
+  act_String released = *string;
+  int free_err = ACT_STRING_ERROR_SUCCESS;
+  act_stringFree(&released, &free_err);
+
+  string->_data = data;
+  string->_meta = unique_meta;
+}
+
+void act__stringDetach(act_String *string, int *error_code) {
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+  act__stringCompact(string);
+
+  if (string->_meta != NULL) {
+    (*string->_allocator->free)(string->_meta);
+    string->_meta = NULL;
+  }
+}
 
 act_String *act__stringResize(act_String *string, int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
@@ -94,6 +250,12 @@ act_String *act__stringResize(act_String *string, int *error_code) {
 act_String act_stringShrinkToFit(act_String string, int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
 
+  act__stringMakeUnique(&string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return string;
+  }
+  act__stringCompact(&string);
+
   // Only need to shrink if capacity is larger than length (plus null
   // terminator)
   if (string._capacity > string._len + 1) {
@@ -119,6 +281,12 @@ void act_stringPushChar(act_String *string, char c, int *error_code) {
 
   ACT_ASSERT_OR(string != NULL, *error_code = ACT_STRING_ERROR_NULL_STRING);
 
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+  act__stringCompact(string);
+
   // Allocate on first push
   if (string->_len == 0) {
     if (string->_capacity == 0) {
@@ -161,18 +329,24 @@ void act_stringPushCstr(act_String *string, const char *cstr, int *error_code) {
 
   ACT_ASSERT_OR(string != NULL, *error_code = ACT_STRING_ERROR_NULL_STRING);
 
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+  act__stringCompact(string);
+
   size_t cstr_len = strlen(cstr);
 
   // Allocate on first push
   if (string->_len == 0) {
-    char *data = (*string->_allocator->alloc)(cstr_len + 1, sizeof(char));
+    if (string->_capacity < cstr_len + 1) {
+      string->_capacity = cstr_len + 1;
+    }
+    char *data = (*string->_allocator->alloc)(string->_capacity, sizeof(char));
     ACT_ASSERT_OR(data != NULL,
                   *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED);
     data[cstr_len] = '\0';
 
-    if (string->_capacity == 0) {
-      string->_capacity = cstr_len + 1;
-    }
     string->_data = data;
   }
 
@@ -207,20 +381,183 @@ char act_stringPopChar(act_String *string, int *error_code) {
   ACT_ASSERT_OR(string->_data != NULL,
                 *error_code = ACT_STRING_ERROR_EMPTY_STRING);
 
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return null_term;
+  }
+  act__stringCompact(string);
+
   size_t len = string->_len;
 
   char retc = string->_data[len - 1];
 
   // Null terminate and decrement length
-  string->_data[string->_len--] = null_term;
+  string->_data[--string->_len] = null_term;
 
   return retc;
 }
 
+/// Moves the gap of the (unique) string to @a idx, growing it until it holds
+/// at least @a needed characters.
+static void act__stringMoveGap(act_String *string, size_t idx, size_t needed,
+                               int *error_code) {
+  if (string->_meta == NULL) {
+    string->_meta = act__stringMetaNew(string->_allocator, /*shared=*/false);
+    if (string->_meta == NULL) {
+      *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+      return;
+    }
+  }
+
+  act__StringMeta *meta = string->_meta;
+  char *data = string->_data;
+
+  // Slide the characters between the old and new edit points across the gap
+  if (meta->gap_len == 0) {
+    meta->gap_start = idx;
+  } else if (idx < meta->gap_start) {
+    memmove(data + idx + meta->gap_len, data + idx, meta->gap_start - idx);
+    meta->gap_start = idx;
+  } else if (idx > meta->gap_start) {
+    memmove(data + meta->gap_start, data + meta->gap_start + meta->gap_len,
+            idx - meta->gap_start);
+    meta->gap_start = idx;
+  }
+
+  if (meta->gap_len >= needed) {
+    return;
+  }
+
+  // Use any spare capacity first, and grow geometrically otherwise
+  size_t capacity = string->_capacity;
+  if (data == NULL || capacity < string->_len + needed + 1) {
+    size_t min_capacity = string->_len + needed + 1 + STRING_GAP_MIN;
+    capacity = 2 * capacity > min_capacity ? 2 * capacity : min_capacity;
+
+    if (data == NULL) {
+      data = (*string->_allocator->alloc)(capacity, sizeof(*data));
+      if (data != NULL) {
+        data[0] = '\0';
+      }
+    } else {
+      data = (*string->_allocator->resize)(data, capacity, sizeof(*data));
+    }
+    if (data == NULL) {
+      *error_code = ACT_STRING_ERROR_RESIZE_FAILED;
+      return;
+    }
+    string->_data = data;
+    string->_capacity = capacity;
+  }
+
+  // Move the text after the gap (and the null terminator) to the very end
+  size_t tail_len = string->_len - meta->gap_start + 1;
+  memmove(data + capacity - tail_len,
+          data + meta->gap_start + meta->gap_len, tail_len);
+  meta->gap_len = capacity - string->_len - 1;
+}
+
+/// Inserts @a len characters into the string at @a idx through its gap.
+static void act__stringInsert(act_String *string, size_t idx,
+                              const char *chars, size_t len,
+                              int *error_code) {
+  if (idx > string->_len) {
+    *error_code = ACT_STRING_ERROR_INDEX_OUT_OF_BOUNDS;
+    return;
+  }
+  if (len == 0) {
+    return;
+  }
+
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+
+  act__stringMoveGap(string, idx, len, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+
+  act__StringMeta *meta = string->_meta;
+  memcpy(string->_data + meta->gap_start, chars, len);
+  meta->gap_start += len;
+  meta->gap_len -= len;
+  string->_len += len;
+}
+
+void act_stringInsertCstrAtIdx(act_String *string, size_t idx,
+                               const char *cstr, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (string == NULL || cstr == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+
+  act__stringInsert(string, idx, cstr, strlen(cstr), error_code);
+}
+
+void act_stringInsertCharAtIdx(act_String *string, size_t idx, char c,
+                               int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (string == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+
+  act__stringInsert(string, idx, &c, 1, error_code);
+}
+
+void act_stringDeleteFromIdx(act_String *string, size_t idx, size_t len,
+                             int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (string == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+  if (idx > string->_len || len > string->_len - idx) {
+    *error_code = ACT_STRING_ERROR_INDEX_OUT_OF_BOUNDS;
+    return;
+  }
+  if (len == 0) {
+    return;
+  }
+
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+
+  act__stringMoveGap(string, idx, 0, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+
+  // The deleted characters directly follow the gap, so the gap absorbs them
+  string->_meta->gap_len += len;
+  string->_len -= len;
+}
+
+void act_stringCompact(act_String *string, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (string == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+
+  act__stringCompact(string);
+}
+
 size_t act_stringFindFirstIdxOfChar(act_String string, char find_char,
                                     int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
 
+  act__stringCompact(&string);
+
   ACT_ASSERT_OR(string._len != 0, *error_code = ACT_STRING_ERROR_EMPTY_STRING);
   ACT_ASSERT_OR(string._data != NULL,
                 *error_code = ACT_STRING_ERROR_EMPTY_STRING);
@@ -239,6 +576,8 @@ act_String *act_stringSplitAtIdx(act_String string, size_t idx,
                                  act_String splits[2], int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
 
+  act__stringCompact(&string);
+
   ACT_ASSERT_OR(string._len != 0, *error_code = ACT_STRING_ERROR_EMPTY_STRING);
   ACT_ASSERT_OR(string._data != 0, *error_code = ACT_STRING_ERROR_EMPTY_STRING);
   ACT_ASSERT_OR(idx < string._len,
@@ -271,6 +610,9 @@ act_String *act_stringSplitAtIdx(act_String string, size_t idx,
 
 act_StringComparison act_stringCompare(act_String str1, act_String str2,
                                        int *error_code) {
+  act__stringCompact(&str1);
+  act__stringCompact(&str2);
+
   ACT_ASSERT_OR(str1._data != NULL,
                 *error_code = ACT_STRING_ERROR_EMPTY_STRING);
   ACT_ASSERT_OR(str2._data != NULL,
@@ -299,6 +641,17 @@ act_String act_stringCopy(const act_String *string, int *error_code) {
   ACT_ASSERT_OR(string->_allocator != NULL,
                 *error_code = ACT_STRING_ERROR_NULL_ALLOCATOR);
 
+  // The gap lives in the buffer, so compacting a copy compacts the original
+  act_String source = *string;
+  act__stringCompact(&source);
+
+  // Shared buffers are copied by reference
+  if (string->_meta != NULL && string->_meta->shared) {
+    atomic_fetch_add_explicit(&string->_meta->refcount, 1,
+                              memory_order_relaxed);
+    return *string;
+  }
+
   act_String str_copy = {0};
 
   str_copy._allocator = string->_allocator;
@@ -322,6 +675,45 @@ act_String act_stringCopy(const act_String *string, int *error_code) {
   return str_copy;
 }
 
+act_String act_stringShare(act_String *string, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (string == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return (act_String){0};
+  }
+  if (string->_allocator == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_ALLOCATOR;
+    return (act_String){0};
+  }
+
+  // Shared buffers never hold a gap, since other references may read them
+  act__stringCompact(string);
+
+  // Switch to shared-buffer mode on the first share
+  if (string->_meta == NULL) {
+    string->_meta = act__stringMetaNew(string->_allocator, /*shared=*/true);
+    if (string->_meta == NULL) {
+      *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+      return (act_String){0};
+    }
+  }
+  string->_meta->shared = true;
+
+  atomic_fetch_add_explicit(&string->_meta->refcount, 1,
+                            memory_order_relaxed);
+
+  return *string;
+}
+
+size_t act_stringRefCount(act_String string) {
+  if (string._meta == NULL || !string._meta->shared) {
+    return 1;
+  }
+
+  return atomic_load_explicit(&string._meta->refcount, memory_order_acquire);
+}
+
 act_String act_stringConcat(const act_String *str1, const act_String *str2,
                             int *error_code) {
   *error_code = ACT_STRING_ERROR_SUCCESS;
@@ -331,6 +723,11 @@ act_String act_stringConcat(const act_String *str1, const act_String *str2,
   ACT_ASSERT_OR(str1->_allocator != NULL,
                 *error_code = ACT_STRING_ERROR_NULL_ALLOCATOR);
 
+  act_String source1 = *str1;
+  act_String source2 = *str2;
+  act__stringCompact(&source1);
+  act__stringCompact(&source2);
+
   act_String concat = {0};
 
   size_t combined_len = str1->_len + str2->_len;
@@ -358,3 +755,589 @@ act_String act_stringConcat(const act_String *str1, const act_String *str2,
 
   return concat;
 }
+
+act_String act_stringJoin(const ACT_VEC(act_String) strings,
+                          const char *separator, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (strings == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_VECTOR;
+    return (act_String){0};
+  }
+  if (separator == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return (act_String){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t num_strings = act_vectorLen(strings, &vec_err);
+  const act_Allocator *allocator = act_vectorAllocator(strings, &vec_err);
+  size_t sep_len = strlen(separator);
+
+  // Compute the final length first so only one allocation is needed
+  size_t joined_len = 0;
+  for (size_t i = 0; i < num_strings; i++) {
+    act_String source = strings[i];
+    act__stringCompact(&source);
+    joined_len += strings[i]._len;
+  }
+  if (num_strings > 1) {
+    joined_len += sep_len * (num_strings - 1);
+  }
+
+  char *joined = (*allocator->alloc)(joined_len + 1, sizeof(*joined));
+  if (joined == NULL) {
+    *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+    return (act_String){0};
+  }
+
+  size_t offset = 0;
+  for (size_t i = 0; i < num_strings; i++) {
+    if (i != 0 && sep_len != 0) {
+      memcpy(joined + offset, separator, sep_len);
+      offset += sep_len;
+    }
+    if (strings[i]._len != 0) {
+      memcpy(joined + offset, strings[i]._data, strings[i]._len);
+      offset += strings[i]._len;
+    }
+  }
+  joined[joined_len] = '\0';
+
+  return (act_String){
+      ._allocator = allocator,
+      ._len = joined_len,
+      ._capacity = joined_len + 1,
+      ._data = joined,
+  };
+}
+
+ACT_VEC(act_StringView)
+act_stringViewSplitAll(const act_Allocator *allocator, act_StringView view,
+                       char delimiter, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_ALLOCATOR;
+    return NULL;
+  }
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return NULL;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  // An empty view is a single empty token
+  if (view.len == 0) {
+    ACT_VEC(act_StringView)
+    tokens = ACT_VEC_WCAP(act_StringView, allocator, 1, &vec_err);
+    if (vec_err != ACT_VECTOR_ERROR_SUCCESS || tokens == NULL) {
+      *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+      return NULL;
+    }
+    ACT_VEC_PUSH(tokens, view, &vec_err);
+    return tokens;
+  }
+
+  const char *end = view.data + view.len;
+
+  // Count the tokens first so the vector is allocated exactly once
+  size_t num_tokens = 1;
+  for (const char *pos = view.data; pos < end; pos++) {
+    pos = memchr(pos, delimiter, (size_t)(end - pos));
+    if (pos == NULL) {
+      break;
+    }
+    num_tokens++;
+  }
+
+  ACT_VEC(act_StringView)
+  tokens = ACT_VEC_WCAP(act_StringView, allocator, num_tokens, &vec_err);
+  if (vec_err != ACT_VECTOR_ERROR_SUCCESS || tokens == NULL) {
+    *error_code = ACT_STRING_ERROR_ALLOCATION_FAILED;
+    return NULL;
+  }
+
+  const char *start = view.data;
+  for (size_t i = 0; i + 1 < num_tokens; i++) {
+    const char *pos = memchr(start, delimiter, (size_t)(end - start));
+    act_StringView token = {.data = start, .len = (size_t)(pos - start)};
+    ACT_VEC_PUSH(tokens, token, &vec_err);
+    start = pos + 1;
+  }
+  act_StringView last = {.data = start, .len = (size_t)(end - start)};
+  ACT_VEC_PUSH(tokens, last, &vec_err);
+
+  return tokens;
+}
+
+ACT_VEC(act_StringView)
+act_stringSplitAll(act_String string, char delimiter, int *error_code) {
+  return act_stringViewSplitAll(string._allocator, act_stringAsView(string),
+                                delimiter, error_code);
+}
+
+/// Marks an invalid sequence when decoding UTF-8.
+static const uint32_t UTF8_INVALID = UINT32_MAX;
+
+/// Decodes the UTF-8 sequence at the start of @a data.
+///
+/// Returns the number of bytes consumed; an invalid sequence is consumed up to
+/// (not including) the first byte that could not continue it, and decodes to
+/// #UTF8_INVALID.
+static size_t act__utf8Decode(const uint8_t *data, size_t len,
+                              uint32_t *codepoint) {
+  uint8_t lead = data[0];
+  if (lead < 0x80) {
+    *codepoint = lead;
+    return 1;
+  }
+
+  // The allowed range of the second byte depends on the lead (Unicode 3.9)
+  size_t num_bytes = 0;
+  uint32_t value = 0;
+  uint8_t lo = 0x80;
+  uint8_t hi = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    num_bytes = 2;
+    value = lead & 0x1F;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    num_bytes = 3;
+    value = lead & 0x0F;
+    lo = lead == 0xE0 ? 0xA0 : lo;
+    hi = lead == 0xED ? 0x9F : hi;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    num_bytes = 4;
+    value = lead & 0x07;
+    lo = lead == 0xF0 ? 0x90 : lo;
+    hi = lead == 0xF4 ? 0x8F : hi;
+  } else {
+    *codepoint = UTF8_INVALID;
+    return 1;
+  }
+
+  for (size_t i = 1; i < num_bytes; i++) {
+    if (i >= len || data[i] < lo || data[i] > hi) {
+      *codepoint = UTF8_INVALID;
+      return i;
+    }
+    value = (value << 6) | (data[i] & 0x3F);
+    lo = 0x80;
+    hi = 0xBF;
+  }
+
+  *codepoint = value;
+  return num_bytes;
+}
+
+/// Validates UTF-8 one sequence at a time, skipping ASCII a word at a time.
+static bool act__utf8ValidateScalar(const uint8_t *data, size_t len) {
+  const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+  size_t i = 0;
+  while (i < len) {
+    if (data[i] < 0x80) {
+      uint64_t word;
+      while (i + sizeof(word) <= len) {
+        memcpy(&word, data + i, sizeof(word));
+        if ((word & HIGH_BITS) != 0) {
+          break;
+        }
+        i += sizeof(word);
+      }
+      while (i < len && data[i] < 0x80) {
+        i++;
+      }
+      continue;
+    }
+
+    uint32_t codepoint;
+    i += act__utf8Decode(data + i, len - i, &codepoint);
+    if (codepoint == UTF8_INVALID) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#ifdef ACT__STRING_X86
+// The error classes of the lookup-table validator (Keiser & Lemire, "Validating
+// UTF-8 In Less Than One Instruction Per Byte"). Each table maps a nibble of
+// a byte pair to the classes it is compatible with; a pair is invalid when all
+// three lookups agree on a class.
+#define UTF8_TOO_SHORT (1 << 0)
+#define UTF8_TOO_LONG (1 << 1)
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE (1 << 3)
+#define UTF8_SURROGATE (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTS (1 << 7)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+/// Validates all complete 16-byte blocks of @a data, and returns the number
+/// of bytes checked (or `SIZE_MAX` if an error was found).
+__attribute__((target("ssse3"))) static size_t
+act__utf8ValidateSsse3(const uint8_t *data, size_t len) {
+  // Indexed by the high nibble of the first byte of a pair
+  const __m128i byte_1_high = _mm_setr_epi8(
+      UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+      UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+      (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS,
+      (char)UTF8_TWO_CONTS, UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT,
+      UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+      UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4);
+
+  // Indexed by the low nibble of the first byte of a pair
+  const __m128i byte_1_low = _mm_setr_epi8(
+      (char)(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4),
+      (char)(UTF8_CARRY | UTF8_OVERLONG_2), (char)UTF8_CARRY,
+      (char)UTF8_CARRY, (char)(UTF8_CARRY | UTF8_TOO_LARGE),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 |
+             UTF8_SURROGATE),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000));
+
+  // Indexed by the high nibble of the second byte of a pair
+  const __m128i byte_2_high = _mm_setr_epi8(
+      UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+      UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+      (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+             UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4),
+      (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+             UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+      (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+             UTF8_SURROGATE | UTF8_TOO_LARGE),
+      (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+             UTF8_SURROGATE | UTF8_TOO_LARGE),
+      UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+
+  // A block ending in these (or larger) bytes has an unfinished sequence
+  const __m128i incomplete_max =
+      _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                    (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  __m128i error = _mm_setzero_si128();
+  __m128i prev_input = _mm_setzero_si128();
+  __m128i prev_incomplete = _mm_setzero_si128();
+
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i input = _mm_loadu_si128((const __m128i *)(data + i));
+
+    // An ASCII block is only invalid if it cuts off the previous block
+    if (_mm_movemask_epi8(input) == 0) {
+      error = _mm_or_si128(error, prev_incomplete);
+      prev_incomplete = _mm_setzero_si128();
+      prev_input = input;
+      continue;
+    }
+
+    // Check every byte against the one before it
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i prev1_high = _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble_mask);
+    __m128i prev1_low = _mm_and_si128(prev1, nibble_mask);
+    __m128i input_high = _mm_and_si128(_mm_srli_epi16(input, 4), nibble_mask);
+    __m128i special = _mm_and_si128(
+        _mm_and_si128(_mm_shuffle_epi8(byte_1_high, prev1_high),
+                      _mm_shuffle_epi8(byte_1_low, prev1_low)),
+        _mm_shuffle_epi8(byte_2_high, input_high));
+
+    // The 3rd and 4th bytes of a sequence must be continuations, which is the
+    // only case where two continuations in a row are allowed
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    __m128i is_third = _mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80));
+    __m128i is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80));
+    __m128i must_be_cont = _mm_and_si128(_mm_or_si128(is_third, is_fourth),
+                                         _mm_set1_epi8((char)0x80));
+    error = _mm_or_si128(error, _mm_xor_si128(must_be_cont, special));
+
+    prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+    prev_input = input;
+  }
+
+  // Unfinished sequences at the end are left to the caller
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) !=
+      0xFFFF) {
+    return SIZE_MAX;
+  }
+  return i;
+}
+#endif
+
+/// Validates UTF-8, using SIMD when the CPU supports it.
+static bool act__utf8Validate(const uint8_t *data, size_t len) {
+  size_t start = 0;
+
+#ifdef ACT__STRING_X86
+  if (len >= 16 && __builtin_cpu_supports("ssse3")) {
+    size_t checked = act__utf8ValidateSsse3(data, len);
+    if (checked == SIZE_MAX) {
+      return false;
+    }
+
+    // Back up to the lead byte of a sequence cut off by the last block
+    start = checked;
+    for (size_t i = 1; i <= 3 && i <= checked; i++) {
+      uint8_t byte = data[checked - i];
+      if (byte >= 0xC0) {
+        start = checked - i;
+        break;
+      }
+      if (byte < 0x80) {
+        break;
+      }
+    }
+  }
+#endif
+
+  return act__utf8ValidateScalar(data + start, len - start);
+}
+
+bool act_stringViewValidateUtf8(act_StringView view, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return false;
+  }
+
+  if (!act__utf8Validate((const uint8_t *)view.data, view.len)) {
+    *error_code = ACT_STRING_ERROR_INVALID_UTF8;
+    return false;
+  }
+
+  return true;
+}
+
+bool act_stringValidateUtf8(act_String string, int *error_code) {
+  return act_stringViewValidateUtf8(act_stringAsView(string), error_code);
+}
+
+size_t act_stringViewCountCodepoints(act_StringView view) {
+  const uint8_t *data = (const uint8_t *)view.data;
+  size_t count = 0;
+  size_t i = 0;
+
+#ifdef __SSE2__
+  // Count the bytes that are not continuations (0x80-0xBF, i.e. < -64 as
+  // signed bytes), summing the per-lane counters before they overflow
+  const __m128i cont_max = _mm_set1_epi8(-65);
+  while (i + 16 <= view.len) {
+    size_t num_blocks = (view.len - i) / 16;
+    num_blocks = num_blocks > 255 ? 255 : num_blocks;
+
+    __m128i counts = _mm_setzero_si128();
+    for (size_t block = 0; block < num_blocks; block++, i += 16) {
+      __m128i input = _mm_loadu_si128((const __m128i *)(data + i));
+      counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(input, cont_max));
+    }
+
+    __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+    count += (size_t)_mm_cvtsi128_si32(sums) +
+             (size_t)_mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+  }
+#endif
+
+  for (; i < view.len; i++) {
+    count += (int8_t)data[i] > -65;
+  }
+
+  return count;
+}
+
+size_t act_stringCountCodepoints(act_String string) {
+  return act_stringViewCountCodepoints(act_stringAsView(string));
+}
+
+act_StringCodepointIter act_stringViewCodepointIter(act_StringView view) {
+  return (act_StringCodepointIter){
+      ._data = view.data,
+      ._len = view.data == NULL ? 0 : view.len,
+      ._pos = 0,
+  };
+}
+
+act_StringCodepointIter act_stringCodepointIter(act_String string) {
+  return act_stringViewCodepointIter(act_stringAsView(string));
+}
+
+bool act_stringCodepointIterNext(act_StringCodepointIter *iter,
+                                 uint32_t *codepoint) {
+  if (iter->_pos >= iter->_len) {
+    return false;
+  }
+
+  const uint8_t *data = (const uint8_t *)iter->_data + iter->_pos;
+  iter->_pos += act__utf8Decode(data, iter->_len - iter->_pos, codepoint);
+  if (*codepoint == UTF8_INVALID) {
+    *codepoint = ACT_STRING_REPLACEMENT_CHAR;
+  }
+
+  return true;
+}
+
+/// Flips the case of every byte of @a src in [@a first, @a last] (one of the
+/// ASCII letter ranges), writing the result to @a dst.
+static void act__stringConvertCase(const char *src, char *dst, size_t len,
+                                   char first, char last) {
+  size_t i = 0;
+
+#ifdef __SSE2__
+  // Bytes >= 0x80 are negative as signed bytes, so they are never in range
+  const __m128i below = _mm_set1_epi8((char)(first - 1));
+  const __m128i above = _mm_set1_epi8((char)(last + 1));
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  for (; i + 16 <= len; i += 16) {
+    __m128i input = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(input, below),
+                                     _mm_cmplt_epi8(input, above));
+    _mm_storeu_si128((__m128i *)(dst + i),
+                     _mm_xor_si128(input, _mm_and_si128(in_range, case_bit)));
+  }
+#endif
+
+  for (; i < len; i++) {
+    char c = src[i];
+    dst[i] = (c >= first && c <= last) ? (char)(c ^ 0x20) : c;
+  }
+}
+
+/// Converts the case of the string in place, cloning a shared buffer first.
+static void act__stringConvertCaseInPlace(act_String *string, char first,
+                                          char last, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if (string == NULL) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+  if (string->_len == 0) {
+    return;
+  }
+
+  act__stringMakeUnique(string, error_code);
+  if (*error_code != ACT_STRING_ERROR_SUCCESS) {
+    return;
+  }
+  act__stringCompact(string);
+
+  act__stringConvertCase(string->_data, string->_data, string->_len, first,
+                         last);
+}
+
+void act_stringToLower(act_String *string, int *error_code) {
+  act__stringConvertCaseInPlace(string, 'A', 'Z', error_code);
+}
+
+void act_stringToUpper(act_String *string, int *error_code) {
+  act__stringConvertCaseInPlace(string, 'a', 'z', error_code);
+}
+
+void act_stringViewToLower(act_StringView view, char *out, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if ((view.data == NULL || out == NULL) && view.len != 0) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+
+  act__stringConvertCase(view.data, out, view.len, 'A', 'Z');
+}
+
+void act_stringViewToUpper(act_StringView view, char *out, int *error_code) {
+  *error_code = ACT_STRING_ERROR_SUCCESS;
+
+  if ((view.data == NULL || out == NULL) && view.len != 0) {
+    *error_code = ACT_STRING_ERROR_NULL_STRING;
+    return;
+  }
+
+  act__stringConvertCase(view.data, out, view.len, 'a', 'z');
+}
+
+bool act_stringViewEqualsIgnoreCase(act_StringView view1,
+                                    act_StringView view2) {
+  if (view1.len != view2.len) {
+    return false;
+  }
+
+  size_t i = 0;
+
+#ifdef __SSE2__
+  // Fold both sides to lowercase and compare 16 bytes at a time
+  const __m128i below = _mm_set1_epi8('A' - 1);
+  const __m128i above = _mm_set1_epi8('Z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  for (; i + 16 <= view1.len; i += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(view1.data + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(view2.data + i));
+    a = _mm_or_si128(a, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(a, below),
+                                                    _mm_cmplt_epi8(a, above)),
+                                      case_bit));
+    b = _mm_or_si128(b, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(b, below),
+                                                    _mm_cmplt_epi8(b, above)),
+                                      case_bit));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF) {
+      return false;
+    }
+  }
+#endif
+
+  for (; i < view1.len; i++) {
+    char a = view1.data[i];
+    char b = view2.data[i];
+    a = (a >= 'A' && a <= 'Z') ? (char)(a | 0x20) : a;
+    b = (b >= 'A' && b <= 'Z') ? (char)(b | 0x20) : b;
+    if (a != b) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool act_stringEqualsIgnoreCase(act_String str1, act_String str2) {
+  return act_stringViewEqualsIgnoreCase(act_stringAsView(str1),
+                                        act_stringAsView(str2));
+}
+
+int act_stringViewLexCompare(act_StringView view1, act_StringView view2) {
+  size_t len = view1.len < view2.len ? view1.len : view2.len;
+  int cmp = len > 0 ? memcmp(view1.data, view2.data, len) : 0;
+  if (cmp != 0) {
+    return cmp;
+  }
+  return (view1.len > view2.len) - (view1.len < view2.len);
+}
+
+int act_stringLexCompare(act_String str1, act_String str2) {
+  return act_stringViewLexCompare(act_stringAsView(str1),
+                                  act_stringAsView(str2));
+}
+
+uint64_t act_stringViewHash(act_StringView view) {
+  return act_hashBytes(view.data, view.len, ACT_HASH_DEFAULT_SEED);
+}
+
+uint64_t act_stringHash(act_String *string) {
+  if (!string->_has_hash) {
+    string->_hash = act_stringViewHash(act_stringAsView(*string));
+    string->_has_hash = true;
+  }
+
+  return string->_hash;
+}
@@ -0,0 +1,337 @@
+#include "act_string_builder.h"
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/// The size of the blocks that small copied pieces are packed into.
+static const size_t STRING_BUILDER_BLOCK_SIZE = 4096;
+
+/// The max number of chunks handed to a single **@em writev** call.
+#define STRING_BUILDER_IOV_BATCH 64
+
+act_StringBuilder act_stringBuilderNew(const act_Allocator *allocator,
+                                       int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  act_StringBuilder builder = {0};
+  if (allocator == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_ALLOCATOR;
+    return builder;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  builder._allocator = allocator;
+  builder._chunks = ACT_VEC_NEW(act_StringView, allocator, &vec_err);
+  ACT_ASSERT_OR(vec_err == ACT_VECTOR_ERROR_SUCCESS,
+                *error_code = ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED);
+  builder._owned =
+      ACT_VEC_NEW(act__StringBuilderBuffer, allocator, &vec_err);
+  ACT_ASSERT_OR(vec_err == ACT_VECTOR_ERROR_SUCCESS,
+                *error_code = ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED);
+
+  return builder;
+}
+
+void act_stringBuilderFree(act_StringBuilder *builder, int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  if (builder == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_BUILDER;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (builder->_owned != NULL) {
+    size_t num_owned = act_vectorLen(builder->_owned, &vec_err);
+    for (size_t i = 0; i < num_owned; i++) {
+      act__StringBuilderBuffer owned = builder->_owned[i];
+      (*owned._allocator->free)(owned._data);
+    }
+    act_vectorFree(builder->_owned, &vec_err);
+  }
+  if (builder->_chunks != NULL) {
+    act_vectorFree(builder->_chunks, &vec_err);
+  }
+
+  *builder = (act_StringBuilder){0};
+}
+
+size_t act_stringBuilderLen(const act_StringBuilder *builder) {
+  return builder->_len;
+}
+
+size_t act_stringBuilderNumChunks(const act_StringBuilder *builder) {
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  return act_vectorLen(builder->_chunks, &vec_err);
+}
+
+/// Records a buffer that must be freed, with @a allocator, along with the
+/// builder.
+static void act__stringBuilderTakeOwnership(act_StringBuilder *builder,
+                                            char *buffer,
+                                            const act_Allocator *allocator,
+                                            int *error_code) {
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  act__StringBuilderBuffer owned = {._data = buffer, ._allocator = allocator};
+  ACT_VEC_PUSH(builder->_owned, owned, &vec_err);
+  ACT_ASSERT_OR(vec_err == ACT_VECTOR_ERROR_SUCCESS,
+                *error_code = ACT_STRING_BUILDER_ERROR_PUSH_FAILED);
+}
+
+void act_stringBuilderPushView(act_StringBuilder *builder, act_StringView view,
+                               int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  if (builder == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_BUILDER;
+    return;
+  }
+
+  // Empty chunks would only add iovecs and copies with no data
+  if (view.len == 0) {
+    return;
+  }
+  if (view.data == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_STRING;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  ACT_VEC_PUSH(builder->_chunks, view, &vec_err);
+  if (vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    *error_code = ACT_STRING_BUILDER_ERROR_PUSH_FAILED;
+    return;
+  }
+
+  builder->_len += view.len;
+}
+
+void act_stringBuilderPushCstr(act_StringBuilder *builder, const char *cstr,
+                               int *error_code) {
+  if (cstr == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_STRING;
+    return;
+  }
+
+  act_stringBuilderPushView(builder, act_stringViewFromCstr(cstr), error_code);
+}
+
+void act_stringBuilderPushString(act_StringBuilder *builder,
+                                 const act_String *string, int *error_code) {
+  if (string == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_STRING;
+    return;
+  }
+
+  act_stringBuilderPushView(builder, act_stringAsView(*string), error_code);
+}
+
+void act_stringBuilderPushOwnedString(act_StringBuilder *builder,
+                                      act_String string, int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  if (builder == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_BUILDER;
+    return;
+  }
+
+  // The builder needs sole ownership of the buffer it frees
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+  act__stringDetach(&string, &str_err);
+  if (str_err != ACT_STRING_ERROR_SUCCESS) {
+    *error_code = ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+
+  // Strings that never allocated have nothing to hand over
+  if (string._data == NULL) {
+    act_stringBuilderPushView(builder, act_stringAsView(string), error_code);
+    return;
+  }
+
+  // Record ownership first, so no chunk ever points into an unowned buffer
+  act__stringBuilderTakeOwnership(builder, string._data, string._allocator,
+                                  error_code);
+  if (*error_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+    (*string._allocator->free)(string._data);
+    return;
+  }
+
+  act_stringBuilderPushView(builder, act_stringAsView(string), error_code);
+  if (*error_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+    // The caller handed the buffer over, so it is freed here
+    int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+    act__StringBuilderBuffer owned;
+    ACT_VEC_POP(builder->_owned, &owned, &vec_err);
+    (*owned._allocator->free)(owned._data);
+  }
+}
+
+void act_stringBuilderPushCopy(act_StringBuilder *builder, act_StringView view,
+                               int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  if (builder == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_BUILDER;
+    return;
+  }
+  if (view.len == 0) {
+    return;
+  }
+  if (view.data == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_STRING;
+    return;
+  }
+
+  // Large pieces get their own buffer instead of wasting a block
+  if (view.len > STRING_BUILDER_BLOCK_SIZE / 2) {
+    char *piece = (*builder->_allocator->alloc)(view.len, sizeof(char));
+    if (piece == NULL) {
+      *error_code = ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED;
+      return;
+    }
+    memcpy(piece, view.data, view.len);
+
+    act__stringBuilderTakeOwnership(builder, piece, builder->_allocator,
+                                    error_code);
+    if (*error_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+      return;
+    }
+    act_stringBuilderPushView(
+        builder, (act_StringView){.data = piece, .len = view.len}, error_code);
+    return;
+  }
+
+  // Start a new block if the current one is full
+  if (builder->_scratch == NULL ||
+      builder->_scratch_cap - builder->_scratch_len < view.len) {
+    char *block = (*builder->_allocator->alloc)(STRING_BUILDER_BLOCK_SIZE,
+                                                sizeof(char));
+    if (block == NULL) {
+      *error_code = ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED;
+      return;
+    }
+
+    act__stringBuilderTakeOwnership(builder, block, builder->_allocator,
+                                    error_code);
+    if (*error_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+      return;
+    }
+    builder->_scratch = block;
+    builder->_scratch_len = 0;
+    builder->_scratch_cap = STRING_BUILDER_BLOCK_SIZE;
+  }
+
+  char *dst = builder->_scratch + builder->_scratch_len;
+  memcpy(dst, view.data, view.len);
+  builder->_scratch_len += view.len;
+
+  // Extend the last chunk if it ends exactly where this copy starts
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t num_chunks = act_vectorLen(builder->_chunks, &vec_err);
+  if (num_chunks != 0) {
+    act_StringView *last = &builder->_chunks[num_chunks - 1];
+    if (last->data + last->len == dst) {
+      last->len += view.len;
+      builder->_len += view.len;
+      return;
+    }
+  }
+
+  act_stringBuilderPushView(
+      builder, (act_StringView){.data = dst, .len = view.len}, error_code);
+}
+
+void act_stringBuilderPushChar(act_StringBuilder *builder, char c,
+                               int *error_code) {
+  act_stringBuilderPushCopy(builder, (act_StringView){.data = &c, .len = 1},
+                            error_code);
+}
+
+act_String act_stringBuilderBuild(const act_StringBuilder *builder,
+                                  int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  if (builder == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_BUILDER;
+    return (act_String){0};
+  }
+
+  // Allocate exactly once for the final string
+  char *data = (*builder->_allocator->alloc)(builder->_len + 1, sizeof(char));
+  if (data == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_ALLOCATION_FAILED;
+    return (act_String){0};
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t num_chunks = act_vectorLen(builder->_chunks, &vec_err);
+  size_t offset = 0;
+  for (size_t i = 0; i < num_chunks; i++) {
+    memcpy(data + offset, builder->_chunks[i].data, builder->_chunks[i].len);
+    offset += builder->_chunks[i].len;
+  }
+  data[offset] = '\0';
+
+  return (act_String){
+      ._allocator = builder->_allocator,
+      ._len = builder->_len,
+      ._capacity = builder->_len + 1,
+      ._data = data,
+  };
+}
+
+size_t act_stringBuilderWriteFd(const act_StringBuilder *builder, int fd,
+                                int *error_code) {
+  *error_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  if (builder == NULL) {
+    *error_code = ACT_STRING_BUILDER_ERROR_NULL_BUILDER;
+    return 0;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t num_chunks = act_vectorLen(builder->_chunks, &vec_err);
+
+  struct iovec iov[STRING_BUILDER_IOV_BATCH];
+  size_t written = 0;
+  size_t chunk_idx = 0;
+  size_t chunk_offset = 0; // Bytes of the current chunk already written
+  while (chunk_idx < num_chunks) {
+    // Fill the next batch, starting part way into a partially written chunk
+    int iov_len = 0;
+    for (size_t i = chunk_idx;
+         i < num_chunks && iov_len < STRING_BUILDER_IOV_BATCH; i++) {
+      size_t skip = (i == chunk_idx) ? chunk_offset : 0;
+      iov[iov_len].iov_base = (void *)(builder->_chunks[i].data + skip);
+      iov[iov_len].iov_len = builder->_chunks[i].len - skip;
+      iov_len++;
+    }
+
+    ssize_t status = writev(fd, iov, iov_len);
+    if (status < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      *error_code = ACT_STRING_BUILDER_ERROR_WRITE_FAILED;
+      return written;
+    }
+    written += (size_t)status;
+
+    // Advance past everything that was written
+    size_t remaining = (size_t)status;
+    while (chunk_idx < num_chunks && remaining > 0) {
+      size_t left_in_chunk = builder->_chunks[chunk_idx].len - chunk_offset;
+      if (remaining < left_in_chunk) {
+        chunk_offset += remaining;
+        remaining = 0;
+      } else {
+        remaining -= left_in_chunk;
+        chunk_idx++;
+        chunk_offset = 0;
+      }
+    }
+  }
+
+  return written;
+}
@@ -0,0 +1,289 @@
+#include "act_string_interner.h"
+
+/// The size of the arena blocks the canonical copies are stored in.
+static const size_t STRING_INTERNER_BLOCK_SIZE = 65536;
+
+/// The number of slots allocated for the first insertion.
+static const size_t STRING_INTERNER_INITIAL_SLOTS = 64;
+
+act_StringInterner act_stringInternerNew(const act_Allocator *allocator,
+                                         int *error_code) {
+  *error_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+
+  act_StringInterner interner = {0};
+  if (allocator == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_ALLOCATOR;
+    return interner;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  interner._allocator = allocator;
+  interner._entries = ACT_VEC_NEW(act_InternEntry, allocator, &vec_err);
+  ACT_ASSERT_OR(vec_err == ACT_VECTOR_ERROR_SUCCESS,
+                *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED);
+  interner._blocks = ACT_VEC_NEW(char *, allocator, &vec_err);
+  ACT_ASSERT_OR(vec_err == ACT_VECTOR_ERROR_SUCCESS,
+                *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED);
+
+  return interner;
+}
+
+void act_stringInternerFree(act_StringInterner *interner, int *error_code) {
+  *error_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+
+  if (interner == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_INTERNER;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  if (interner->_blocks != NULL) {
+    size_t num_blocks = act_vectorLen(interner->_blocks, &vec_err);
+    for (size_t i = 0; i < num_blocks; i++) {
+      (*interner->_allocator->free)(interner->_blocks[i]);
+    }
+    act_vectorFree(interner->_blocks, &vec_err);
+  }
+  if (interner->_entries != NULL) {
+    act_vectorFree(interner->_entries, &vec_err);
+  }
+  if (interner->_slots != NULL) {
+    (*interner->_allocator->free)(interner->_slots);
+  }
+
+  *interner = (act_StringInterner){0};
+}
+
+size_t act_stringInternerLen(const act_StringInterner *interner) {
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  return act_vectorLen(interner->_entries, &vec_err);
+}
+
+/// Returns the slot holding @a view, or the empty slot it would be stored in.
+static size_t act__stringInternerProbe(const act_StringInterner *interner,
+                                       act_StringView view, uint64_t hash) {
+  size_t mask = interner->_num_slots - 1;
+  size_t slot = (size_t)hash & mask;
+  while (interner->_slots[slot] != 0) {
+    const act_InternEntry *entry =
+        &interner->_entries[interner->_slots[slot] - 1];
+    if (entry->_hash == hash && entry->_len == view.len &&
+        memcmp(entry->_data, view.data, view.len) == 0) {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  return slot;
+}
+
+/// Doubles the number of slots and re-inserts every entry.
+static void act__stringInternerGrow(act_StringInterner *interner,
+                                    int *error_code) {
+  size_t num_slots = interner->_num_slots == 0
+                         ? STRING_INTERNER_INITIAL_SLOTS
+                         : interner->_num_slots * 2;
+
+  act_InternId *slots =
+      (*interner->_allocator->alloc)(num_slots, sizeof(*slots));
+  if (slots == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+  memset(slots, 0, num_slots * sizeof(*slots));
+
+  // Entries are unique, so they can be placed without comparing strings
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t num_entries = act_vectorLen(interner->_entries, &vec_err);
+  size_t mask = num_slots - 1;
+  for (size_t i = 0; i < num_entries; i++) {
+    size_t slot = (size_t)interner->_entries[i]._hash & mask;
+    while (slots[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    slots[slot] = (act_InternId)(i + 1);
+  }
+
+  if (interner->_slots != NULL) {
+    (*interner->_allocator->free)(interner->_slots);
+  }
+  interner->_slots = slots;
+  interner->_num_slots = num_slots;
+}
+
+/// Copies @a view (plus a null terminator) into the arena.
+static const char *act__stringInternerCopy(act_StringInterner *interner,
+                                           act_StringView view,
+                                           int *error_code) {
+  size_t size = view.len + 1;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  // Large strings get their own block, so the current block is kept
+  if (size > STRING_INTERNER_BLOCK_SIZE / 4) {
+    char *copy = (*interner->_allocator->alloc)(size, sizeof(char));
+    if (copy == NULL) {
+      *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED;
+      return NULL;
+    }
+    memcpy(copy, view.data, view.len);
+    copy[view.len] = '\0';
+
+    // Keep the current block last, since new copies are bumped from it
+    size_t num_blocks = act_vectorLen(interner->_blocks, &vec_err);
+    ACT_VEC_PUSH(interner->_blocks, copy, &vec_err);
+    if (vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+      (*interner->_allocator->free)(copy);
+      *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED;
+      return NULL;
+    }
+    if (num_blocks != 0) {
+      interner->_blocks[num_blocks] = interner->_blocks[num_blocks - 1];
+      interner->_blocks[num_blocks - 1] = copy;
+    }
+    return copy;
+  }
+
+  if (interner->_block_cap - interner->_block_len < size) {
+    char *block = (*interner->_allocator->alloc)(STRING_INTERNER_BLOCK_SIZE,
+                                                 sizeof(char));
+    if (block == NULL) {
+      *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED;
+      return NULL;
+    }
+    ACT_VEC_PUSH(interner->_blocks, block, &vec_err);
+    if (vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+      (*interner->_allocator->free)(block);
+      *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED;
+      return NULL;
+    }
+    interner->_block_len = 0;
+    interner->_block_cap = STRING_INTERNER_BLOCK_SIZE;
+  }
+
+  size_t num_blocks = act_vectorLen(interner->_blocks, &vec_err);
+  char *copy = interner->_blocks[num_blocks - 1] + interner->_block_len;
+  memcpy(copy, view.data, view.len);
+  copy[view.len] = '\0';
+  interner->_block_len += size;
+
+  return copy;
+}
+
+act_InternId act_stringInternerIntern(act_StringInterner *interner,
+                                      act_StringView view, int *error_code) {
+  *error_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+
+  if (interner == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_INTERNER;
+    return 0;
+  }
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_STRING;
+    return 0;
+  }
+  if (view.data == NULL) {
+    view.data = "";
+  }
+
+  // Keep the load factor at or below one half
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t num_entries = act_vectorLen(interner->_entries, &vec_err);
+  if (2 * (num_entries + 1) > interner->_num_slots) {
+    act__stringInternerGrow(interner, error_code);
+    if (*error_code != ACT_STRING_INTERNER_ERROR_SUCCESS) {
+      return 0;
+    }
+  }
+
+  uint64_t hash = act_stringViewHash(view);
+  size_t slot = act__stringInternerProbe(interner, view, hash);
+  if (interner->_slots[slot] != 0) {
+    return interner->_slots[slot] - 1;
+  }
+
+  const char *copy = act__stringInternerCopy(interner, view, error_code);
+  if (copy == NULL) {
+    return 0;
+  }
+
+  act_InternEntry entry = {._data = copy, ._len = view.len, ._hash = hash};
+  ACT_VEC_PUSH(interner->_entries, entry, &vec_err);
+  if (vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    *error_code = ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED;
+    return 0;
+  }
+  interner->_slots[slot] = (act_InternId)(num_entries + 1);
+
+  return (act_InternId)num_entries;
+}
+
+act_InternId act_stringInternerInternCstr(act_StringInterner *interner,
+                                          const char *cstr, int *error_code) {
+  if (cstr == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_STRING;
+    return 0;
+  }
+
+  return act_stringInternerIntern(interner, act_stringViewFromCstr(cstr),
+                                  error_code);
+}
+
+act_InternId act_stringInternerInternString(act_StringInterner *interner,
+                                            const act_String *string,
+                                            int *error_code) {
+  if (string == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_STRING;
+    return 0;
+  }
+
+  return act_stringInternerIntern(interner, act_stringAsView(*string),
+                                  error_code);
+}
+
+act_InternId act_stringInternerFind(const act_StringInterner *interner,
+                                    act_StringView view, int *error_code) {
+  *error_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+
+  if (interner == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_INTERNER;
+    return 0;
+  }
+  if (view.data == NULL && view.len != 0) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_STRING;
+    return 0;
+  }
+  if (view.data == NULL) {
+    view.data = "";
+  }
+
+  if (interner->_num_slots == 0) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NOT_FOUND;
+    return 0;
+  }
+
+  size_t slot = act__stringInternerProbe(interner, view,
+                                         act_stringViewHash(view));
+  if (interner->_slots[slot] == 0) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NOT_FOUND;
+    return 0;
+  }
+
+  return interner->_slots[slot] - 1;
+}
+
+act_StringView act_stringInternerGet(const act_StringInterner *interner,
+                                     act_InternId id, int *error_code) {
+  *error_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+
+  if (interner == NULL) {
+    *error_code = ACT_STRING_INTERNER_ERROR_NULL_INTERNER;
+    return (act_StringView){0};
+  }
+  if (id >= act_stringInternerLen(interner)) {
+    *error_code = ACT_STRING_INTERNER_ERROR_INVALID_ID;
+    return (act_StringView){0};
+  }
+
+  const act_InternEntry *entry = &interner->_entries[id];
+  return (act_StringView){.data = entry->_data, .len = entry->_len};
+}
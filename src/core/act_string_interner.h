@@ -0,0 +1,197 @@
+#ifndef ACT_STRING_INTERNER_H
+#define ACT_STRING_INTERNER_H
+
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_string_interner.h
+///
+/// This header defines a string interning pool, which maps every distinct
+/// string to a single canonical, immutable copy with a stable id.
+///
+/// Two interned strings are equal if and only if their ids (or the pointers
+/// of their canonical views) are equal, so no byte-wise comparison is needed.
+
+/// @brief The id of an interned string.
+///
+/// Ids are dense, starting at zero, in the order the strings were first
+/// interned.
+typedef uint32_t act_InternId;
+
+/// @brief **[PRIVATE]** An entry of the #act_StringInterner.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly.
+typedef struct act_InternEntry {
+  /// @cond
+  /// @internal The canonical copy of the string.
+  const char *_data;
+
+  /// @internal The length of the string.
+  size_t _len;
+
+  /// @internal The hash of the string.
+  uint64_t _hash;
+  /// @endcond
+} act_InternEntry;
+
+/// @brief **[PRIVATE]** A pool of interned strings.
+///
+/// The canonical copies live in arena blocks owned by the interner, and are
+/// only freed when the interner is freed.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_stringInternerIntern, #act_stringInternerGet
+typedef struct act_StringInterner {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The interned strings, indexed by id.
+  ACT_VEC(act_InternEntry) _entries;
+
+  /// @internal The arena blocks holding the canonical copies.
+  ACT_VEC(char *) _blocks;
+
+  /// @internal The number of bytes used in the current block.
+  size_t _block_len;
+
+  /// @internal The number of bytes allocated for the current block.
+  size_t _block_cap;
+
+  /// @internal The hash table, storing `id + 1` (zero marks an empty slot).
+  act_InternId *_slots;
+
+  /// @internal The number of slots (always a power of two).
+  size_t _num_slots;
+  /// @endcond
+} act_StringInterner;
+
+/// @brief The possible error values.
+typedef enum act_StringInternerError {
+  /// Successful operation.
+  ACT_STRING_INTERNER_ERROR_SUCCESS = 0x0,
+
+  /// The given interner was **NULL**.
+  ACT_STRING_INTERNER_ERROR_NULL_INTERNER,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_STRING_INTERNER_ERROR_NULL_ALLOCATOR,
+
+  /// The given string was **NULL**.
+  ACT_STRING_INTERNER_ERROR_NULL_STRING,
+
+  /// A failure during allocation.
+  ACT_STRING_INTERNER_ERROR_ALLOCATION_FAILED,
+
+  /// The string has not been interned.
+  ACT_STRING_INTERNER_ERROR_NOT_FOUND,
+
+  /// The id does not belong to the interner.
+  ACT_STRING_INTERNER_ERROR_INVALID_ID,
+} act_StringInternerError;
+
+/// @brief Creates a new #act_StringInterner.
+///
+/// @param[in]  allocator   The allocator used to make internal memory
+///                         allocations.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation.
+///
+/// @return A new, empty interner.
+///
+/// @sa #act_stringInternerFree
+act_StringInterner act_stringInternerNew(const act_Allocator *allocator,
+                                         int *error_code);
+
+/// @brief Frees all memory allocated by the #act_StringInterner.
+///
+/// All canonical views returned by the interner become invalid.
+///
+/// @param[in]  interner    The interner to free.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation.
+void act_stringInternerFree(act_StringInterner *interner, int *error_code);
+
+/// @brief Returns the number of distinct strings in the #act_StringInterner.
+///
+/// @param interner The interner to get the length of.
+///
+/// @return The number of interned strings.
+size_t act_stringInternerLen(const act_StringInterner *interner);
+
+/// @brief Interns the given view, copying it into the pool if it has not been
+/// seen before.
+///
+/// @param[in]  interner    The interner to add the string to.
+/// @param[in]  view        The string to intern.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation.
+///
+/// @return The id of the canonical copy of @a view.
+///
+/// @note This function @em possibly allocates memory if the string is new.
+act_InternId act_stringInternerIntern(act_StringInterner *interner,
+                                      act_StringView view, int *error_code);
+
+/// @brief Interns the given C-string.
+///
+/// @param[in]  interner    The interner to add the string to.
+/// @param[in]  cstr        The C-string to intern.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation.
+///
+/// @return The id of the canonical copy of @a cstr.
+///
+/// @sa #act_stringInternerIntern
+act_InternId act_stringInternerInternCstr(act_StringInterner *interner,
+                                          const char *cstr, int *error_code);
+
+/// @brief Interns the given #act_String.
+///
+/// @param[in]  interner    The interner to add the string to.
+/// @param[in]  string      The string to intern.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation.
+///
+/// @return The id of the canonical copy of @a string.
+///
+/// @sa #act_stringInternerIntern
+act_InternId act_stringInternerInternString(act_StringInterner *interner,
+                                            const act_String *string,
+                                            int *error_code);
+
+/// @brief Looks up the id of a string without interning it.
+///
+/// @param[in]  interner    The interner to search.
+/// @param[in]  view        The string to look for.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation; #ACT_STRING_INTERNER_ERROR_NOT_FOUND if
+///                         the string has not been interned.
+///
+/// @return The id of @a view, if found.
+act_InternId act_stringInternerFind(const act_StringInterner *interner,
+                                    act_StringView view, int *error_code);
+
+/// @brief Returns the canonical copy of an interned string.
+///
+/// The returned view is null-terminated, immutable, and stays valid (at the
+/// same address) until the interner is freed.
+///
+/// @param[in]  interner    The interner the id belongs to.
+/// @param[in]  id          The id of the interned string.
+/// @param[out] error_code  The error code (#act_StringInternerError) of the
+///                         operation.
+///
+/// @return The canonical view of the string with id @a id.
+act_StringView act_stringInternerGet(const act_StringInterner *interner,
+                                     act_InternId id, int *error_code);
+
+#endif /* !ACT_STRING_INTERNER_H */
@@ -0,0 +1,623 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "act_thread_pool.h"
+#include "act_deque.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+/// The size of a cache line.
+#define ACT__THREAD_POOL_CACHE_LINE 64
+
+/// The number of pieces per worker a parallel for loop is split into by
+/// default.
+#define ACT__THREAD_POOL_PIECES_PER_THREAD 8
+
+/// A task waiting to run.
+typedef struct act__ThreadPoolTask {
+  /// The function to run.
+  act_ThreadPoolTaskFn fn;
+
+  /// The argument of the function.
+  void *arg;
+
+  /// The number of unfinished tasks of the group the task belongs to.
+  _Atomic size_t *outstanding;
+} act__ThreadPoolTask;
+
+/// A Chase-Lev deque of tasks, with a fixed capacity.
+typedef struct act__ThreadPoolDeque {
+  /// Keeps the indices off the cache lines of neighbouring workers.
+  char pad0[ACT__THREAD_POOL_CACHE_LINE];
+
+  /// The index of the oldest task, moved by thieves (and the owner, for the
+  /// last task).
+  _Atomic int64_t top;
+
+  /// Keeps the owner's index on a separate cache line from the thieves'.
+  char pad1[ACT__THREAD_POOL_CACHE_LINE];
+
+  /// The index after the newest task, only moved by the owner.
+  _Atomic int64_t bottom;
+
+  /// Keeps the indices off the cache lines of the tasks.
+  char pad2[ACT__THREAD_POOL_CACHE_LINE];
+
+  /// The ring of tasks.
+  _Atomic(act__ThreadPoolTask *) tasks[ACT_THREAD_POOL_DEQUE_CAPACITY];
+} act__ThreadPoolDeque;
+
+/// A worker thread.
+typedef struct act__ThreadPoolWorker {
+  /// The worker's own tasks.
+  act__ThreadPoolDeque deque;
+
+  /// The state of the pool the worker belongs to.
+  act__ThreadPoolState *state;
+
+  /// The thread.
+  pthread_t thread;
+
+  /// The state of the generator that picks the first worker to steal from.
+  uint64_t rng;
+
+  /// The index of the worker.
+  size_t index;
+} act__ThreadPoolWorker;
+
+struct act__ThreadPoolState {
+  /// The allocator used to make necessary allocations.
+  const act_Allocator *allocator;
+
+  /// The workers.
+  act__ThreadPoolWorker *workers;
+
+  /// The number of workers.
+  size_t num_threads;
+
+  /// The lock of the queue of tasks submitted from outside the pool.
+  pthread_mutex_t injector_lock;
+
+  /// The tasks submitted from outside the pool.
+  act_Deque injector;
+
+  /// The lock that sleeping workers wait on.
+  pthread_mutex_t sleep_lock;
+
+  /// Signalled when tasks are pushed, or the pool shuts down.
+  pthread_cond_t wake;
+
+  /// Whether the workers should exit (guarded by the sleep lock).
+  bool shutdown;
+
+  /// The number of tasks pushed but not yet taken (may briefly be negative).
+  _Atomic intptr_t pending;
+
+  /// The number of sleeping workers.
+  _Atomic size_t sleeping;
+
+  /// The number of unfinished tasks submitted with #act_threadPoolSubmit.
+  _Atomic size_t outstanding;
+};
+
+/// The worker running on this thread (**NULL** outside of any pool).
+static _Thread_local act__ThreadPoolWorker *act__thread_pool_worker = NULL;
+
+/// Returns the worker running on this thread, if it belongs to the pool.
+static act__ThreadPoolWorker *
+act__threadPoolSelf(const act__ThreadPoolState *state) {
+  act__ThreadPoolWorker *self = act__thread_pool_worker;
+  return self != NULL && self->state == state ? self : NULL;
+}
+
+/// Pushes a task onto the bottom of the owner's deque, unless it is full.
+static bool act__threadPoolDequePush(act__ThreadPoolDeque *deque,
+                                     act__ThreadPoolTask *task) {
+  int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+  int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  if (bottom - top >= ACT_THREAD_POOL_DEQUE_CAPACITY) {
+    return false;
+  }
+
+  atomic_store_explicit(
+      &deque->tasks[bottom & (ACT_THREAD_POOL_DEQUE_CAPACITY - 1)], task,
+      memory_order_relaxed);
+  atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+  return true;
+}
+
+/// Takes the newest task from the bottom of the owner's deque.
+static act__ThreadPoolTask *
+act__threadPoolDequeTake(act__ThreadPoolDeque *deque) {
+  int64_t bottom =
+      atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+  if (top > bottom) {
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return NULL;
+  }
+
+  act__ThreadPoolTask *task = atomic_load_explicit(
+      &deque->tasks[bottom & (ACT_THREAD_POOL_DEQUE_CAPACITY - 1)],
+      memory_order_relaxed);
+
+  // The last task may be stolen at the same time
+  if (top == bottom) {
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+      task = NULL;
+    }
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+  }
+  return task;
+}
+
+/// Steals the oldest task from the top of another worker's deque.
+static act__ThreadPoolTask *
+act__threadPoolDequeSteal(act__ThreadPoolDeque *deque) {
+  int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+  if (top >= bottom) {
+    return NULL;
+  }
+
+  act__ThreadPoolTask *task = atomic_load_explicit(
+      &deque->tasks[top & (ACT_THREAD_POOL_DEQUE_CAPACITY - 1)],
+      memory_order_relaxed);
+  if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                               memory_order_seq_cst,
+                                               memory_order_relaxed)) {
+    return NULL;
+  }
+  return task;
+}
+
+/// Queues a task: on the worker's own deque if called from one, otherwise on
+/// the shared queue. Wakes a sleeping worker to run it.
+static bool act__threadPoolPush(act__ThreadPoolState *state,
+                                act__ThreadPoolTask *task) {
+  act__ThreadPoolWorker *self = act__threadPoolSelf(state);
+  if (self != NULL) {
+    if (!act__threadPoolDequePush(&self->deque, task)) {
+      return false;
+    }
+  } else {
+    int deque_err = ACT_DEQUE_ERROR_SUCCESS;
+    pthread_mutex_lock(&state->injector_lock);
+    act_dequePushBack(&state->injector, &task, &deque_err);
+    pthread_mutex_unlock(&state->injector_lock);
+    if (deque_err != ACT_DEQUE_ERROR_SUCCESS) {
+      return false;
+    }
+  }
+
+  // A worker going to sleep counts itself before checking for tasks, so
+  // either it sees this task, or this sees it sleeping
+  atomic_fetch_add(&state->pending, 1);
+  if (atomic_load(&state->sleeping) > 0) {
+    pthread_mutex_lock(&state->sleep_lock);
+    pthread_cond_signal(&state->wake);
+    pthread_mutex_unlock(&state->sleep_lock);
+  }
+  return true;
+}
+
+/// Finds a task to run: the worker's own newest task, or else one stolen from
+/// another worker, or else one from the shared queue.
+static act__ThreadPoolTask *act__threadPoolFind(act__ThreadPoolState *state,
+                                                act__ThreadPoolWorker *self) {
+  act__ThreadPoolTask *task = NULL;
+  if (self != NULL) {
+    task = act__threadPoolDequeTake(&self->deque);
+  }
+
+  if (task == NULL) {
+    size_t start = 0;
+    if (self != NULL) {
+      self->rng ^= self->rng << 13;
+      self->rng ^= self->rng >> 7;
+      self->rng ^= self->rng << 17;
+      start = (size_t)(self->rng % state->num_threads);
+    }
+    for (size_t i = 0; i < state->num_threads && task == NULL; i++) {
+      act__ThreadPoolWorker *victim =
+          &state->workers[(start + i) % state->num_threads];
+      if (victim != self) {
+        task = act__threadPoolDequeSteal(&victim->deque);
+      }
+    }
+  }
+
+  if (task == NULL) {
+    int deque_err = ACT_DEQUE_ERROR_SUCCESS;
+    pthread_mutex_lock(&state->injector_lock);
+    act_dequePopFront(&state->injector, &task, &deque_err);
+    pthread_mutex_unlock(&state->injector_lock);
+  }
+
+  if (task != NULL) {
+    atomic_fetch_sub(&state->pending, 1);
+  }
+  return task;
+}
+
+/// Runs a task, frees it, and counts it as finished.
+static void act__threadPoolRun(act__ThreadPoolState *state,
+                               act__ThreadPoolTask *task) {
+  _Atomic size_t *outstanding = task->outstanding;
+  task->fn(task->arg);
+  (*state->allocator->free)(task);
+  atomic_fetch_sub_explicit(outstanding, 1, memory_order_release);
+}
+
+/// Runs tasks until a group has no unfinished tasks left.
+static void act__threadPoolHelp(act__ThreadPoolState *state,
+                                _Atomic size_t *outstanding) {
+  act__ThreadPoolWorker *self = act__threadPoolSelf(state);
+  while (atomic_load_explicit(outstanding, memory_order_acquire) != 0) {
+    act__ThreadPoolTask *task = act__threadPoolFind(state, self);
+    if (task != NULL) {
+      act__threadPoolRun(state, task);
+    } else {
+      sched_yield();
+    }
+  }
+}
+
+/// The loop of a worker thread.
+static void *act__threadPoolWorkerMain(void *arg) {
+  act__ThreadPoolWorker *worker = arg;
+  act__ThreadPoolState *state = worker->state;
+  act__thread_pool_worker = worker;
+
+  for (;;) {
+    act__ThreadPoolTask *task = act__threadPoolFind(state, worker);
+    if (task != NULL) {
+      act__threadPoolRun(state, task);
+      continue;
+    }
+
+    // A task is being pushed, or was just taken by someone else
+    if (atomic_load(&state->pending) > 0) {
+      sched_yield();
+      continue;
+    }
+
+    pthread_mutex_lock(&state->sleep_lock);
+    atomic_fetch_add(&state->sleeping, 1);
+    while (!state->shutdown && atomic_load(&state->pending) <= 0) {
+      pthread_cond_wait(&state->wake, &state->sleep_lock);
+    }
+    atomic_fetch_sub(&state->sleeping, 1);
+    bool shutdown = state->shutdown;
+    pthread_mutex_unlock(&state->sleep_lock);
+
+    if (shutdown) {
+      break;
+    }
+  }
+
+  act__thread_pool_worker = NULL;
+  return NULL;
+}
+
+/// Pins a worker to the @em idx-th CPU (modulo their number) that the process
+/// may run on.
+static void act__threadPoolPin(pthread_t thread, size_t idx) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return;
+  }
+
+  size_t count = (size_t)CPU_COUNT(&allowed);
+  if (count == 0) {
+    return;
+  }
+
+  size_t target = idx % count;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      pthread_setaffinity_np(thread, sizeof(set), &set);
+      return;
+    }
+  }
+#else
+  (void)thread;
+  (void)idx;
+#endif
+}
+
+/// Stops and joins the first @em started workers, and frees the state.
+static void act__threadPoolShutdown(act__ThreadPoolState *state,
+                                    size_t started) {
+  pthread_mutex_lock(&state->sleep_lock);
+  state->shutdown = true;
+  pthread_cond_broadcast(&state->wake);
+  pthread_mutex_unlock(&state->sleep_lock);
+
+  for (size_t i = 0; i < started; i++) {
+    pthread_join(state->workers[i].thread, NULL);
+  }
+
+  int deque_err = ACT_DEQUE_ERROR_SUCCESS;
+  act_dequeFree(&state->injector, &deque_err);
+  pthread_cond_destroy(&state->wake);
+  pthread_mutex_destroy(&state->sleep_lock);
+  pthread_mutex_destroy(&state->injector_lock);
+
+  const act_Allocator *allocator = state->allocator;
+  (*allocator->free)(state->workers);
+  (*allocator->free)(state);
+}
+
+act_ThreadPool act_threadPoolNew(const act_Allocator *allocator,
+                                 size_t num_threads, bool pin_threads,
+                                 int *error_code) {
+  *error_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+
+  if (allocator == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_ALLOCATOR;
+    return (act_ThreadPool){0};
+  }
+
+  if (num_threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    num_threads = cpus > 0 ? (size_t)cpus : 1;
+  }
+
+  act__ThreadPoolState *state = (*allocator->alloc)(1, sizeof(*state));
+  act__ThreadPoolWorker *workers =
+      (*allocator->alloc)(num_threads, sizeof(*workers));
+  if (state == NULL || workers == NULL) {
+    if (state != NULL) {
+      (*allocator->free)(state);
+    }
+    if (workers != NULL) {
+      (*allocator->free)(workers);
+    }
+    *error_code = ACT_THREAD_POOL_ERROR_ALLOCATION_FAILED;
+    return (act_ThreadPool){0};
+  }
+
+  int deque_err = ACT_DEQUE_ERROR_SUCCESS;
+  state->allocator = allocator;
+  state->workers = workers;
+  state->num_threads = num_threads;
+  state->injector = act_dequeNew(allocator, sizeof(act__ThreadPoolTask *),
+                                 &deque_err);
+  state->shutdown = false;
+  atomic_init(&state->pending, 0);
+  atomic_init(&state->sleeping, 0);
+  atomic_init(&state->outstanding, 0);
+
+  if (pthread_mutex_init(&state->injector_lock, NULL) != 0 ||
+      pthread_mutex_init(&state->sleep_lock, NULL) != 0 ||
+      pthread_cond_init(&state->wake, NULL) != 0) {
+    (*allocator->free)(workers);
+    (*allocator->free)(state);
+    *error_code = ACT_THREAD_POOL_ERROR_THREAD_FAILED;
+    return (act_ThreadPool){0};
+  }
+
+  for (size_t i = 0; i < num_threads; i++) {
+    act__ThreadPoolWorker *worker = &workers[i];
+    atomic_init(&worker->deque.top, 0);
+    atomic_init(&worker->deque.bottom, 0);
+    worker->state = state;
+    worker->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+    worker->index = i;
+
+    if (pthread_create(&worker->thread, NULL, act__threadPoolWorkerMain,
+                       worker) != 0) {
+      act__threadPoolShutdown(state, i);
+      *error_code = ACT_THREAD_POOL_ERROR_THREAD_FAILED;
+      return (act_ThreadPool){0};
+    }
+    if (pin_threads) {
+      act__threadPoolPin(worker->thread, i);
+    }
+  }
+
+  return (act_ThreadPool){._allocator = allocator, ._state = state};
+}
+
+void act_threadPoolFree(act_ThreadPool *pool, int *error_code) {
+  *error_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+
+  if (pool == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_POOL;
+    return;
+  }
+
+  if (pool->_state != NULL) {
+    act__threadPoolHelp(pool->_state, &pool->_state->outstanding);
+    act__threadPoolShutdown(pool->_state, pool->_state->num_threads);
+  }
+  *pool = (act_ThreadPool){0};
+}
+
+size_t act_threadPoolNumThreads(const act_ThreadPool *pool) {
+  return pool->_state == NULL ? 0 : pool->_state->num_threads;
+}
+
+void act_threadPoolSubmit(act_ThreadPool *pool, act_ThreadPoolTaskFn fn,
+                          void *arg, int *error_code) {
+  *error_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+
+  if (pool == NULL || pool->_state == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_POOL;
+    return;
+  }
+  if (fn == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_FUNCTION;
+    return;
+  }
+
+  act__ThreadPoolState *state = pool->_state;
+  act__ThreadPoolTask *task = (*state->allocator->alloc)(1, sizeof(*task));
+  if (task == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_ALLOCATION_FAILED;
+    return;
+  }
+  *task = (act__ThreadPoolTask){
+      .fn = fn,
+      .arg = arg,
+      .outstanding = &state->outstanding,
+  };
+
+  atomic_fetch_add_explicit(&state->outstanding, 1, memory_order_relaxed);
+  if (!act__threadPoolPush(state, task)) {
+    act__threadPoolRun(state, task);
+  }
+}
+
+void act_threadPoolWait(act_ThreadPool *pool, int *error_code) {
+  *error_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+
+  if (pool == NULL || pool->_state == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_POOL;
+    return;
+  }
+
+  act__threadPoolHelp(pool->_state, &pool->_state->outstanding);
+}
+
+/// The state shared by the pieces of a parallel for loop.
+typedef struct act__ParallelFor {
+  /// The pool the loop runs on.
+  act__ThreadPoolState *state;
+
+  /// The body of the loop.
+  act_ParallelForFn fn;
+
+  /// The argument of the body.
+  void *arg;
+
+  /// The elements of the vector.
+  char *data;
+
+  /// The size of an element.
+  size_t data_size;
+
+  /// The max number of elements in a piece.
+  size_t grain;
+
+  /// The number of unfinished pieces that were split off.
+  _Atomic size_t outstanding;
+} act__ParallelFor;
+
+/// A piece of a parallel for loop that was split off.
+typedef struct act__ParallelForPiece {
+  /// The task that runs the piece (first, so the task frees the piece).
+  act__ThreadPoolTask task;
+
+  /// The loop the piece belongs to.
+  act__ParallelFor *loop;
+
+  /// The index of the first element of the piece.
+  size_t start;
+
+  /// The number of elements in the piece.
+  size_t len;
+} act__ParallelForPiece;
+
+/// Runs a range of a parallel for loop, splitting off its second half until
+/// it is no larger than the grain.
+static void act__parallelForRange(act__ParallelFor *loop, size_t start,
+                                  size_t len);
+
+/// Runs a piece that was split off.
+static void act__parallelForRunPiece(void *arg) {
+  act__ParallelForPiece *piece = arg;
+  act__parallelForRange(piece->loop, piece->start, piece->len);
+}
+
+static void act__parallelForRange(act__ParallelFor *loop, size_t start,
+                                  size_t len) {
+  while (len > loop->grain) {
+    size_t half = len / 2;
+    act__ParallelForPiece *piece =
+        (*loop->state->allocator->alloc)(1, sizeof(*piece));
+    if (piece == NULL) {
+      break;
+    }
+    *piece = (act__ParallelForPiece){
+        .task =
+            {
+                .fn = act__parallelForRunPiece,
+                .arg = piece,
+                .outstanding = &loop->outstanding,
+            },
+        .loop = loop,
+        .start = start + half,
+        .len = len - half,
+    };
+
+    atomic_fetch_add_explicit(&loop->outstanding, 1, memory_order_relaxed);
+    if (!act__threadPoolPush(loop->state, &piece->task)) {
+      atomic_fetch_sub_explicit(&loop->outstanding, 1, memory_order_relaxed);
+      (*loop->state->allocator->free)(piece);
+      break;
+    }
+    len = half;
+  }
+
+  loop->fn(loop->data + start * loop->data_size, start, len, loop->arg);
+}
+
+void act_parallelFor(act_ThreadPool *pool, act_Vector *vec, size_t grain,
+                     act_ParallelForFn fn, void *arg, int *error_code) {
+  *error_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+
+  if (pool == NULL || pool->_state == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_POOL;
+    return;
+  }
+  if (vec == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_VECTOR;
+    return;
+  }
+  if (fn == NULL) {
+    *error_code = ACT_THREAD_POOL_ERROR_NULL_FUNCTION;
+    return;
+  }
+
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  size_t len = act_vectorLen(vec, &vec_err);
+  if (len == 0) {
+    return;
+  }
+
+  act__ThreadPoolState *state = pool->_state;
+  if (grain == 0) {
+    grain = len / (state->num_threads * ACT__THREAD_POOL_PIECES_PER_THREAD);
+    grain = grain > 0 ? grain : 1;
+  }
+
+  act__ParallelFor loop = {
+      .state = state,
+      .fn = fn,
+      .arg = arg,
+      .data = vec,
+      .data_size = act_vectorDataSize(vec, &vec_err),
+      .grain = grain,
+  };
+  atomic_init(&loop.outstanding, 0);
+
+  // The calling thread runs the first piece, then helps with the rest
+  act__parallelForRange(&loop, 0, len);
+  act__threadPoolHelp(state, &loop.outstanding);
+}
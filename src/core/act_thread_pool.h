@@ -0,0 +1,181 @@
+#ifndef ACT_THREAD_POOL_H
+#define ACT_THREAD_POOL_H
+
+#include "act_allocator.h"
+#include "act_utils.h"
+#include "act_vector.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// @file act_thread_pool.h
+///
+/// This header defines a work-stealing thread pool, and a parallel for loop
+/// over the elements of an #act_Vector built on it.
+///
+/// Every worker has its own Chase-Lev deque of tasks: it pushes and pops
+/// tasks at the bottom without contention, while idle workers steal the
+/// oldest tasks from the top of other workers' deques. Tasks submitted from
+/// outside the pool go through a shared queue. Workers with nothing to run or
+/// steal sleep until more tasks are submitted.
+///
+/// #act_parallelFor splits a range in half recursively, pushing one half for
+/// others to steal, until the pieces are no larger than the grain; big pieces
+/// are stolen first, so the work spreads out in a few steals. A thread that
+/// waits for tasks to finish helps run them, so the pool may be used from its
+/// own tasks.
+
+/// The number of tasks a worker's deque holds; tasks pushed to a full deque
+/// are run right away instead.
+#define ACT_THREAD_POOL_DEQUE_CAPACITY 1024
+
+/// @brief The state shared by the threads of a pool.
+///
+/// This type is private; its definition is only visible to the thread pool
+/// implementation.
+typedef struct act__ThreadPoolState act__ThreadPoolState;
+
+/// @brief A task run by an #act_ThreadPool.
+///
+/// @param arg The argument given when the task was submitted.
+typedef void (*act_ThreadPoolTaskFn)(void *arg);
+
+/// @brief The body of an #act_parallelFor loop, run on a piece of the vector.
+///
+/// @param elements The first element of the piece.
+/// @param start    The index of the first element of the piece.
+/// @param len      The number of elements in the piece.
+/// @param arg      The argument given to #act_parallelFor.
+typedef void (*act_ParallelForFn)(void *elements, size_t start, size_t len,
+                                  void *arg);
+
+/// @brief **[PRIVATE]** A pool of worker threads that steal work from each
+/// other.
+///
+/// @note All parameters of this struct are **private** and should not be
+/// accessed directly; use the associated functions to access them instead.
+///
+/// @sa #act_threadPoolSubmit, #act_parallelFor
+typedef struct act_ThreadPool {
+  /// @cond
+  /// @internal The allocator used to make necessary allocations.
+  const act_Allocator *_allocator;
+
+  /// @internal The state shared with the workers.
+  act__ThreadPoolState *_state;
+  /// @endcond
+} act_ThreadPool;
+
+/// @brief The possible error values.
+typedef enum act_ThreadPoolError {
+  /// Successful operation.
+  ACT_THREAD_POOL_ERROR_SUCCESS = 0x0,
+
+  /// The given pool was **NULL**.
+  ACT_THREAD_POOL_ERROR_NULL_POOL,
+
+  /// The given allocator pointer was **NULL**.
+  ACT_THREAD_POOL_ERROR_NULL_ALLOCATOR,
+
+  /// The given function was **NULL**.
+  ACT_THREAD_POOL_ERROR_NULL_FUNCTION,
+
+  /// The given vector was **NULL**.
+  ACT_THREAD_POOL_ERROR_NULL_VECTOR,
+
+  /// A failure during allocation.
+  ACT_THREAD_POOL_ERROR_ALLOCATION_FAILED,
+
+  /// A failure creating a thread, or initializing a lock.
+  ACT_THREAD_POOL_ERROR_THREAD_FAILED,
+} act_ThreadPoolError;
+
+/// @brief Creates a new #act_ThreadPool, and starts its workers.
+///
+/// @param[in]  allocator    The allocator used to make internal memory
+///                          allocations; it must be thread-safe.
+/// @param[in]  num_threads  The number of workers (zero for one per online
+///                          CPU).
+/// @param[in]  pin_threads  Whether to pin each worker to its own CPU (where
+///                          supported), round-robin over the CPUs the process
+///                          may run on.
+/// @param[out] error_code   The error code (#act_ThreadPoolError) of the
+///                          operation.
+///
+/// @return A new pool.
+///
+/// @note This function allocates the workers and their deques.
+///
+/// @sa #act_threadPoolFree
+act_ThreadPool act_threadPoolNew(const act_Allocator *allocator,
+                                 size_t num_threads, bool pin_threads,
+                                 int *error_code);
+
+/// @brief Waits for all tasks of the #act_ThreadPool to finish, stops its
+/// workers, and frees all memory it allocated.
+///
+/// This must not be called from a task of the pool.
+///
+/// @param[in]  pool        The pool to free.
+/// @param[out] error_code  The error code (#act_ThreadPoolError) of the
+///                         operation.
+void act_threadPoolFree(act_ThreadPool *pool, int *error_code);
+
+/// @brief Returns the number of workers of the #act_ThreadPool.
+///
+/// @param pool The pool to get the number of workers of.
+///
+/// @return The number of workers.
+size_t act_threadPoolNumThreads(const act_ThreadPool *pool);
+
+/// @brief Submits a task to the #act_ThreadPool.
+///
+/// A task submitted from one of the pool's workers goes to the bottom of its
+/// own deque (or is run right away, if the deque is full).
+///
+/// @param[in]  pool        The pool to run the task on.
+/// @param[in]  fn          The task.
+/// @param[in]  arg         The argument given to the task.
+/// @param[out] error_code  The error code (#act_ThreadPoolError) of the
+///                         operation.
+///
+/// @note This function allocates the task, which is freed once it has run.
+///
+/// @sa #act_threadPoolWait
+void act_threadPoolSubmit(act_ThreadPool *pool, act_ThreadPoolTaskFn fn,
+                          void *arg, int *error_code);
+
+/// @brief Waits until every task submitted to the #act_ThreadPool has
+/// finished, helping to run them meanwhile.
+///
+/// This must not be called from a task of the pool, which would wait for
+/// itself to finish.
+///
+/// @param[in]  pool        The pool to wait for.
+/// @param[out] error_code  The error code (#act_ThreadPoolError) of the
+///                         operation.
+void act_threadPoolWait(act_ThreadPool *pool, int *error_code);
+
+/// @brief Runs @em fn over every element of the #act_Vector on the
+/// #act_ThreadPool, in pieces of at most @em grain elements, and waits for it
+/// to finish.
+///
+/// The pieces are disjoint and cover the vector, and may run in any order
+/// and on any thread, including the calling one. This may be called from a
+/// task of the pool (including from @em fn).
+///
+/// @param[in]  pool        The pool to run the loop on.
+/// @param[in]  vec         The vector to run the loop over.
+/// @param[in]  grain       The max number of elements in a piece (zero to
+///                         split the vector into a few pieces per worker).
+/// @param[in]  fn          The body of the loop.
+/// @param[in]  arg         The argument given to @em fn.
+/// @param[out] error_code  The error code (#act_ThreadPoolError) of the
+///                         operation.
+///
+/// @note This function allocates a task for each piece it splits off; if
+/// that fails, the rest of the piece is run without splitting it.
+void act_parallelFor(act_ThreadPool *pool, act_Vector *vec, size_t grain,
+                     act_ParallelForFn fn, void *arg, int *error_code);
+
+#endif /* !ACT_THREAD_POOL_H */
@@ -166,6 +166,40 @@ const act_Allocator *act_vectorAllocator(const act_Vector *vec,
   return header->allocator;
 }
 
+act_Vector *act_vectorReserve(act_Vector *vec, size_t additional,
+                              int *error_code) {
+  *error_code = ACT_VECTOR_ERROR_SUCCESS;
+
+  if (vec == NULL) {
+    *error_code = ACT_VECTOR_ERROR_NULL_VECTOR;
+    return NULL;
+  }
+
+  act_VectorHeader *header = act__vectorGetMutHeader(vec, error_code);
+  size_t len = header->len;
+  if (header->capacity - len >= additional) {
+    return vec;
+  }
+
+  size_t new_cap = 2 * header->capacity;
+  if (new_cap < len + additional) {
+    new_cap = len + additional;
+  }
+
+  act_Vector *new_vec = act_vectorWithCapacity(
+      header->allocator, header->data_size, new_cap, error_code);
+  if (new_vec == NULL || *error_code != ACT_VECTOR_ERROR_SUCCESS) {
+    *error_code = ACT_VECTOR_ERROR_RESIZE_FAILED;
+    return NULL;
+  }
+  memcpy(new_vec, vec, header->data_size * len);
+  act__vectorGetMutHeader(new_vec, error_code)->len = len;
+
+  act_vectorFree(vec, error_code);
+
+  return new_vec;
+}
+
 void act__vectorIncrLen(act_Vector *vec, int *error_code) {
   *error_code = ACT_VECTOR_ERROR_SUCCESS;
 
@@ -185,3 +219,13 @@ void act__vectorDecrLen(act_Vector *vec, int *error_code) {
   ACT_ASSERT_OR(header != NULL, *error_code = ACT_VECTOR_ERROR_NULL_HEADER);
   header->len--;
 }
+
+void act__vectorSetLen(act_Vector *vec, size_t len, int *error_code) {
+  *error_code = ACT_VECTOR_ERROR_SUCCESS;
+
+  ACT_ASSERT_OR(vec != NULL, *error_code = ACT_VECTOR_ERROR_NULL_VECTOR);
+
+  act_VectorHeader *header = act__vectorGetMutHeader(vec, error_code);
+  ACT_ASSERT_OR(header != NULL, *error_code = ACT_VECTOR_ERROR_NULL_HEADER);
+  header->len = len;
+}
@@ -0,0 +1,255 @@
+#include "act_allocator.h"
+#include "act_btree.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compareU32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+/// A key large enough that nodes only hold the minimum fanout.
+typedef struct BigKey {
+  uint32_t id;
+  char padding[196];
+} BigKey;
+
+static int compareBigKey(const void *a, const void *b) {
+  return compareU32(&((const BigKey *)a)->id, &((const BigKey *)b)->id);
+}
+
+/// A simple LCG, so tests are deterministic.
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+/// The number of nodes allocated (and not yet freed) by #NODE_ALLOCATOR.
+static size_t live_nodes = 0;
+
+/// The size of every allocation made by #NODE_ALLOCATOR.
+static size_t node_size = 0;
+
+static void *countingAlloc(size_t nelems, size_t elem_size) {
+  if (node_size == 0) {
+    node_size = nelems * elem_size;
+  }
+  TEST_CHECK(nelems * elem_size == node_size);
+  live_nodes++;
+  return calloc(nelems, elem_size);
+}
+
+static void countingFree(const void *ptr) {
+  live_nodes--;
+  free((void *)ptr);
+}
+
+/// An allocator that checks every node has the same size.
+static const act_Allocator NODE_ALLOCATOR = {
+    .alloc = countingAlloc,
+    .resize = NULL,
+    .free = countingFree,
+};
+
+/// The number of keys the trees are checked against.
+#define NUM_KEYS 4096
+
+void test_canCreateNewBTree(void) {
+  int err_code = ACT_BTREE_ERROR_SUCCESS;
+  act_BTree tree = ACT_BTREE_NEW(uint32_t, uint64_t, compareU32, &GPA,
+                                 &err_code);
+
+  TEST_CHECK(err_code == ACT_BTREE_ERROR_SUCCESS);
+  TEST_CHECK(act_btreeLen(&tree) == 0);
+  TEST_CHECK(act_btreeNodeSize(&tree) % 64 == 0);
+
+  uint32_t key = 1;
+  TEST_CHECK(act_btreeGet(&tree, &key, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_BTREE_ERROR_NOT_FOUND);
+  TEST_CHECK(!act_btreeRemove(&tree, &key, NULL, &err_code));
+  TEST_CHECK(err_code == ACT_BTREE_ERROR_NOT_FOUND);
+
+  act_BTreeIter iter = act_btreeRange(&tree, NULL, NULL, &err_code);
+  TEST_CHECK(!act_btreeIterNext(&iter, NULL, NULL));
+  iter = act_btreeRangeReverse(&tree, &key, NULL, &err_code);
+  TEST_CHECK(!act_btreeIterNext(&iter, NULL, NULL));
+
+  act_btreeNew(&GPA, 0, 8, compareU32, &err_code);
+  TEST_CHECK(err_code == ACT_BTREE_ERROR_INVALID_KEY_SIZE);
+  act_btreeNew(&GPA, 4, 8, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_BTREE_ERROR_NULL_COMPARATOR);
+  act_btreeNew(NULL, 4, 8, compareU32, &err_code);
+  TEST_CHECK(err_code == ACT_BTREE_ERROR_NULL_ALLOCATOR);
+
+  act_btreeFree(&tree, &err_code);
+
+  if (err_code != ACT_BTREE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInsertAndRemoveFromBTree(void) {
+  int err_code = ACT_BTREE_ERROR_SUCCESS;
+
+  // Small keys make wide nodes, big keys make a deep tree
+  const size_t KEY_SIZES[] = {sizeof(uint32_t), sizeof(BigKey)};
+  const act_SortCompareFn COMPARATORS[] = {compareU32, compareBigKey};
+  for (size_t k = 0; k < 2; k++) {
+    node_size = 0;
+    act_BTree tree = act_btreeNew(&NODE_ALLOCATOR, KEY_SIZES[k],
+                                  sizeof(uint64_t), COMPARATORS[k],
+                                  &err_code);
+
+    bool present[NUM_KEYS] = {false};
+    uint64_t values[NUM_KEYS] = {0};
+    uint64_t state = 7;
+    BigKey key = {0};
+    for (size_t i = 0; i < 20000; i++) {
+      key.id = (uint32_t)(nextRandom(&state) % NUM_KEYS);
+
+      // Insert more than remove at first, then drain the tree
+      if (nextRandom(&state) % 8 < (i < 12000 ? 3u : 7u)) {
+        uint64_t removed = 0;
+        bool was_present = present[key.id];
+        TEST_CHECK(act_btreeRemove(&tree, &key, &removed, &err_code) ==
+                   was_present);
+        TEST_CHECK(!was_present || removed == values[key.id]);
+        present[key.id] = false;
+      } else {
+        uint64_t value = nextRandom(&state);
+        TEST_CHECK(act_btreeInsert(&tree, &key, &value, &err_code) ==
+                   !present[key.id]);
+        TEST_CHECK(err_code == ACT_BTREE_ERROR_SUCCESS);
+        present[key.id] = true;
+        values[key.id] = value;
+      }
+
+      // Check every key now and then
+      if (i % 2000 == 1999) {
+        size_t expected_len = 0;
+        bool ok = true;
+        for (key.id = 0; key.id < NUM_KEYS; key.id++) {
+          const uint64_t *value = act_btreeGet(&tree, &key, &err_code);
+          ok &= (value != NULL) == present[key.id];
+          ok &= value == NULL || *value == values[key.id];
+          expected_len += present[key.id];
+        }
+
+        // The leaves stay linked in order through splits and merges
+        const BigKey *next = NULL;
+        uint32_t expected_id = 0;
+        act_BTreeIter iter = act_btreeRange(&tree, NULL, NULL, &err_code);
+        while (act_btreeIterNext(&iter, (const void **)&next, NULL)) {
+          while (!present[expected_id]) {
+            expected_id++;
+          }
+          ok &= next->id == expected_id++;
+        }
+
+        TEST_CHECK(ok);
+        TEST_CHECK(act_btreeLen(&tree) == expected_len);
+        TEST_MSG("key size %zu, step %zu", KEY_SIZES[k], i);
+      }
+    }
+    err_code = ACT_BTREE_ERROR_SUCCESS;
+
+    // Remove what's left, which frees every node
+    for (key.id = 0; key.id < NUM_KEYS; key.id++) {
+      TEST_CHECK(act_btreeRemove(&tree, &key, NULL, &err_code) ==
+                 present[key.id]);
+    }
+    TEST_CHECK(act_btreeLen(&tree) == 0);
+    TEST_CHECK(live_nodes == 0);
+    TEST_CHECK(node_size == act_btreeNodeSize(&tree));
+    err_code = ACT_BTREE_ERROR_SUCCESS;
+
+    act_btreeFree(&tree, &err_code);
+  }
+
+  if (err_code != ACT_BTREE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canIterateRangeOfBTree(void) {
+  int err_code = ACT_BTREE_ERROR_SUCCESS;
+  node_size = 0;
+  act_BTree tree = ACT_BTREE_NEW(uint32_t, uint32_t, compareU32,
+                                 &NODE_ALLOCATOR, &err_code);
+
+  // Insert the even keys, in a scrambled order
+  for (uint32_t i = 0; i < NUM_KEYS; i++) {
+    uint32_t key = (i * 2654435761u) % NUM_KEYS * 2;
+    uint32_t value = key + 1;
+    act_btreeInsert(&tree, &key, &value, &err_code);
+  }
+  TEST_CHECK(act_btreeLen(&tree) == NUM_KEYS);
+
+  const uint32_t BOUNDS[][2] = {{0, 2 * NUM_KEYS}, {1, 2},      {3, 4},
+                                {3, 5},           {100, 1001}, {101, 1000},
+                                {7000, 8100},     {9000, 100}, {0, 0}};
+  for (size_t b = 0; b < sizeof(BOUNDS) / sizeof(*BOUNDS); b++) {
+    uint32_t low = BOUNDS[b][0];
+    uint32_t high = BOUNDS[b][1];
+    uint32_t first = (low + 1) / 2 * 2;
+    size_t expected = high > first ? (high - first + 1) / 2 : 0;
+
+    const uint32_t *key = NULL;
+    uint32_t *value = NULL;
+    size_t count = 0;
+    bool ok = true;
+    act_BTreeIter iter = act_btreeRange(&tree, &low, &high, &err_code);
+    while (act_btreeIterNext(&iter, (const void **)&key, (void **)&value)) {
+      ok &= *key == first + 2 * count && *value == *key + 1;
+      count++;
+    }
+    TEST_CHECK(ok && count == expected);
+    TEST_MSG("forward [%u, %u): %zu entries", low, high, count);
+
+    count = 0;
+    iter = act_btreeRangeReverse(&tree, &low, &high, &err_code);
+    while (act_btreeIterNext(&iter, (const void **)&key, NULL)) {
+      ok &= *key == first + 2 * (expected - 1 - count);
+      count++;
+    }
+    TEST_CHECK(ok && count == expected);
+    TEST_MSG("reverse [%u, %u): %zu entries", low, high, count);
+  }
+
+  // Unbounded ranges cover the whole tree, in either direction
+  const uint32_t *key = NULL;
+  uint32_t low = 8000;
+  size_t count = 0;
+  act_BTreeIter iter = act_btreeRange(&tree, &low, NULL, &err_code);
+  while (act_btreeIterNext(&iter, (const void **)&key, NULL)) {
+    TEST_CHECK(*key == low + 2 * count);
+    count++;
+  }
+  TEST_CHECK(count == NUM_KEYS - low / 2);
+
+  count = 0;
+  iter = act_btreeRangeReverse(&tree, NULL, NULL, &err_code);
+  while (act_btreeIterNext(&iter, (const void **)&key, NULL)) {
+    TEST_CHECK(*key == 2 * (NUM_KEYS - 1 - count));
+    count++;
+  }
+  TEST_CHECK(count == NUM_KEYS);
+
+  act_btreeFree(&tree, &err_code);
+  TEST_CHECK(live_nodes == 0);
+
+  if (err_code != ACT_BTREE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[BTREE] Can create new act_BTree", test_canCreateNewBTree},
+    {"[BTREE] Can insert into and remove from act_BTree",
+     test_canInsertAndRemoveFromBTree},
+    {"[BTREE] Can iterate over a range of act_BTree",
+     test_canIterateRangeOfBTree},
+    {NULL, NULL}};
@@ -0,0 +1,201 @@
+#include "act_allocator.h"
+#include "act_concurrent_map.h"
+#include "act_string.h"
+#include "acutest.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void test_canInsertAndGetFromConcurrentMap(void) {
+  int err_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+  act_ConcurrentMap map = act_concurrentMapNew(&GPA, sizeof(int), 4, &err_code);
+  if (err_code != ACT_CONCURRENT_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  char key[32];
+  for (int i = 0; i < 1000; i++) {
+    snprintf(key, sizeof(key), "key-%d", i);
+    TEST_CHECK(act_concurrentMapInsert(&map, act_stringViewFromCstr(key), &i,
+                                       &err_code));
+  }
+  TEST_CHECK(act_concurrentMapLen(&map) == 1000);
+
+  act_ConcurrentMapReader *reader =
+      act_concurrentMapRegisterReader(&map, &err_code);
+  TEST_ASSERT(reader != NULL);
+
+  int value = 0;
+  TEST_CHECK(act_concurrentMapGet(&map, reader,
+                                  act_stringViewFromCstr("key-123"), &value,
+                                  &err_code));
+  TEST_CHECK(value == 123);
+
+  act_String lookup = act_stringFromCstr(&GPA, "key-999", &str_err);
+  TEST_CHECK(
+      act_concurrentMapGetString(&map, reader, &lookup, &value, &err_code));
+  TEST_CHECK(value == 999);
+
+  // Replacing a value keeps a single entry
+  value = -1;
+  TEST_CHECK(!act_concurrentMapInsert(&map, act_stringViewFromCstr("key-123"),
+                                      &value, &err_code));
+  TEST_CHECK(act_concurrentMapLen(&map) == 1000);
+
+  int removed = 0;
+  TEST_CHECK(act_concurrentMapRemove(&map, act_stringViewFromCstr("key-123"),
+                                     &removed, &err_code));
+  TEST_CHECK(removed == -1);
+  TEST_CHECK(!act_concurrentMapGet(&map, reader,
+                                   act_stringViewFromCstr("key-123"), NULL,
+                                   &err_code));
+  TEST_CHECK(err_code == ACT_CONCURRENT_MAP_ERROR_NOT_FOUND);
+  TEST_CHECK(act_concurrentMapLen(&map) == 999);
+
+  // Growing keeps the entries, so all that is retired are the old tables and
+  // the replaced and removed entries
+  TEST_CHECK(act_concurrentMapReclaim(&map, &err_code) > 0);
+  TEST_CHECK(act_concurrentMapReclaim(&map, &err_code) == 0);
+
+  act_concurrentMapGet(&map, NULL, act_stringViewFromCstr("key-1"), NULL,
+                       &err_code);
+  TEST_CHECK(err_code == ACT_CONCURRENT_MAP_ERROR_NULL_READER);
+
+  // The record of an unregistered reader is reused
+  act_concurrentMapUnregisterReader(&map, reader, &err_code);
+  TEST_CHECK(act_concurrentMapRegisterReader(&map, &err_code) == reader);
+
+  act_stringFree(&lookup, &str_err);
+  act_concurrentMapFree(&map, &err_code);
+
+  if (err_code != ACT_CONCURRENT_MAP_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// The state shared by the threads of the concurrent test.
+typedef struct ConcurrentTestState {
+  act_ConcurrentMap *map;
+  atomic_bool done;
+  atomic_size_t bad_reads;
+  atomic_size_t hits;
+} ConcurrentTestState;
+
+/// The number of distinct keys used by the concurrent test.
+#define NUM_TEST_KEYS 512
+
+/// Values are `key * 1000 + version`, so readers can check them.
+static void *readerThread(void *arg) {
+  ConcurrentTestState *state = arg;
+  int err = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+  act_ConcurrentMapReader *reader =
+      act_concurrentMapRegisterReader(state->map, &err);
+  if (reader == NULL) {
+    atomic_fetch_add(&state->bad_reads, 1);
+    return NULL;
+  }
+
+  char key[32];
+  size_t hits = 0;
+  size_t i = 0;
+  while (!atomic_load(&state->done)) {
+    int k = (int)(i++ % NUM_TEST_KEYS);
+    snprintf(key, sizeof(key), "key-%d", k);
+
+    int64_t value = 0;
+    if (act_concurrentMapGet(state->map, reader, act_stringViewFromCstr(key),
+                             &value, &err)) {
+      hits++;
+      if (value / 1000 != k) {
+        atomic_fetch_add(&state->bad_reads, 1);
+      }
+    } else if (err != ACT_CONCURRENT_MAP_ERROR_NOT_FOUND) {
+      atomic_fetch_add(&state->bad_reads, 1);
+    }
+  }
+  atomic_fetch_add(&state->hits, hits);
+  act_concurrentMapUnregisterReader(state->map, reader, &err);
+
+  return NULL;
+}
+
+/// Inserts, replaces, and removes keys while the readers run.
+static void *writerThread(void *arg) {
+  ConcurrentTestState *state = arg;
+  char key[32];
+  for (int64_t round = 0; round < 20; round++) {
+    for (int k = 0; k < NUM_TEST_KEYS; k++) {
+      snprintf(key, sizeof(key), "key-%d", k);
+      int err = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+      int64_t value = k * 1000 + round;
+      if ((k + round) % 3 == 0) {
+        act_concurrentMapRemove(state->map, act_stringViewFromCstr(key), NULL,
+                                &err);
+      } else {
+        act_concurrentMapInsert(state->map, act_stringViewFromCstr(key),
+                                &value, &err);
+      }
+    }
+
+    // Freeing retired memory is safe while the readers run
+    int err = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+    act_concurrentMapReclaim(state->map, &err);
+  }
+
+  return NULL;
+}
+
+void test_canReadConcurrentMapWhileWriting(void) {
+  int err_code = ACT_CONCURRENT_MAP_ERROR_SUCCESS;
+  act_ConcurrentMap map = act_concurrentMapNew(
+      &GPA, sizeof(int64_t), ACT_CONCURRENT_MAP_DEFAULT_SHARDS, &err_code);
+  if (err_code != ACT_CONCURRENT_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  ConcurrentTestState state = {.map = &map};
+  atomic_init(&state.done, false);
+  atomic_init(&state.bad_reads, 0);
+  atomic_init(&state.hits, 0);
+
+  const size_t NUM_READERS = 4;
+  const size_t NUM_WRITERS = 2;
+  pthread_t readers[4];
+  pthread_t writers[2];
+  for (size_t i = 0; i < NUM_READERS; i++) {
+    TEST_ASSERT(pthread_create(&readers[i], NULL, readerThread, &state) == 0);
+  }
+  for (size_t i = 0; i < NUM_WRITERS; i++) {
+    TEST_ASSERT(pthread_create(&writers[i], NULL, writerThread, &state) == 0);
+  }
+  for (size_t i = 0; i < NUM_WRITERS; i++) {
+    pthread_join(writers[i], NULL);
+  }
+  atomic_store(&state.done, true);
+  for (size_t i = 0; i < NUM_READERS; i++) {
+    pthread_join(readers[i], NULL);
+  }
+
+  TEST_CHECK(atomic_load(&state.bad_reads) == 0);
+  TEST_CHECK(act_concurrentMapLen(&map) <= NUM_TEST_KEYS);
+
+  // With no lookups in progress, all retired memory is freed
+  act_concurrentMapReclaim(&map, &err_code);
+  TEST_CHECK(act_concurrentMapReclaim(&map, &err_code) == 0);
+  act_concurrentMapFree(&map, &err_code);
+
+  if (err_code != ACT_CONCURRENT_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[CONCURRENT MAP] Can insert into and get from act_ConcurrentMap",
+     test_canInsertAndGetFromConcurrentMap},
+    {"[CONCURRENT MAP] Can read act_ConcurrentMap while writing",
+     test_canReadConcurrentMapWhileWriting},
+    {NULL, NULL}};
@@ -0,0 +1,177 @@
+#include "act_allocator.h"
+#include "act_deque.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// A simple LCG, so tests are deterministic.
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+/// The max number of elements the reference model holds.
+#define MODEL_SIZE 100000
+
+void test_canCreateNewDeque(void) {
+  int err_code = ACT_DEQUE_ERROR_SUCCESS;
+  act_Deque deque = ACT_DEQUE_NEW(uint64_t, &GPA, &err_code);
+
+  TEST_CHECK(err_code == ACT_DEQUE_ERROR_SUCCESS);
+  TEST_CHECK(act_dequeLen(&deque) == 0);
+  TEST_CHECK(act_dequeCapacity(&deque) == 0);
+
+  uint64_t value = 0;
+  TEST_CHECK(!act_dequePopFront(&deque, &value, &err_code));
+  TEST_CHECK(err_code == ACT_DEQUE_ERROR_EMPTY);
+  TEST_CHECK(!act_dequePopBack(&deque, &value, &err_code));
+  TEST_CHECK(err_code == ACT_DEQUE_ERROR_EMPTY);
+  TEST_CHECK(act_dequeAt(&deque, 0, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_DEQUE_ERROR_OUT_OF_BOUNDS);
+
+  act_dequeNew(&GPA, 0, &err_code);
+  TEST_CHECK(err_code == ACT_DEQUE_ERROR_INVALID_DATA_SIZE);
+  act_dequeNew(NULL, 8, &err_code);
+  TEST_CHECK(err_code == ACT_DEQUE_ERROR_NULL_ALLOCATOR);
+
+  act_dequeReserve(&deque, 100, &err_code);
+  TEST_CHECK(act_dequeCapacity(&deque) == 128);
+
+  act_dequeFree(&deque, &err_code);
+
+  if (err_code != ACT_DEQUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canPushAndPopAtBothEnds(void) {
+  int err_code = ACT_DEQUE_ERROR_SUCCESS;
+  act_Deque deque = ACT_DEQUE_NEW(uint32_t, &GPA, &err_code);
+
+  // The model is a window into an array, starting in the middle
+  uint32_t *model = calloc(2 * MODEL_SIZE, sizeof(uint32_t));
+  size_t front = MODEL_SIZE;
+  size_t back = MODEL_SIZE;
+
+  uint64_t state = 11;
+  bool ok = true;
+  for (uint32_t i = 0; i < 200000; i++) {
+    uint64_t op = nextRandom(&state) % 10;
+    uint32_t value = 0;
+
+    // Push slightly more than pop, so the deque grows while it wraps
+    if (op < 3) {
+      act_dequePushBack(&deque, &i, &err_code);
+      model[back++] = i;
+    } else if (op < 6) {
+      act_dequePushFront(&deque, &i, &err_code);
+      model[--front] = i;
+    } else if (op < 8) {
+      ok &= act_dequePopBack(&deque, &value, &err_code) == (front != back);
+      ok &= front == back || value == model[--back];
+    } else {
+      ok &= act_dequePopFront(&deque, &value, &err_code) == (front != back);
+      ok &= front == back || value == model[front++];
+    }
+    ok &= act_dequeLen(&deque) == back - front;
+
+    if (i % 20000 == 0) {
+      for (size_t j = front; j < back; j++) {
+        const uint32_t *at = act_dequeAt(&deque, j - front, &err_code);
+        ok &= at != NULL && *at == model[j];
+      }
+    }
+  }
+  TEST_CHECK(ok);
+
+  size_t capacity = act_dequeCapacity(&deque);
+  TEST_CHECK(capacity >= act_dequeLen(&deque));
+  TEST_CHECK((capacity & (capacity - 1)) == 0);
+
+  act_dequeClear(&deque);
+  TEST_CHECK(act_dequeLen(&deque) == 0);
+  TEST_CHECK(act_dequeCapacity(&deque) == capacity);
+
+  free(model);
+  act_dequeFree(&deque, &err_code);
+
+  if (err_code != ACT_DEQUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canCopyDequeInBulk(void) {
+  int err_code = ACT_DEQUE_ERROR_SUCCESS;
+  act_Deque deque = ACT_DEQUE_NEW(uint64_t, &GPA, &err_code);
+
+  uint64_t batch[100];
+  uint64_t out[100];
+  uint64_t next_in = 0;
+  uint64_t next_out = 0;
+
+  // A queue that never holds more than 100 elements keeps its capacity, and
+  // wraps around it over and over
+  uint64_t state = 13;
+  bool ok = true;
+  act_dequeReserve(&deque, 100, &err_code);
+  size_t capacity = act_dequeCapacity(&deque);
+  for (size_t round = 0; round < 1000; round++) {
+    size_t count = nextRandom(&state) % (101 - act_dequeLen(&deque));
+    for (size_t i = 0; i < count; i++) {
+      batch[i] = next_in++;
+    }
+    act_dequePushBackMany(&deque, batch, count, &err_code);
+
+    // The spans hold every element, in order
+    act_DequeSpan first;
+    act_DequeSpan second;
+    act_dequeSpans(&deque, &first, &second);
+    ok &= first.len + second.len == act_dequeLen(&deque);
+    memcpy(out, first.data, first.len * sizeof(uint64_t));
+    memcpy(out + first.len, second.data, second.len * sizeof(uint64_t));
+    for (size_t i = 0; i < act_dequeLen(&deque); i++) {
+      ok &= out[i] == next_out + i;
+    }
+
+    size_t popped = act_dequePopFrontMany(
+        &deque, out, nextRandom(&state) % 101, &err_code);
+    for (size_t i = 0; i < popped; i++) {
+      ok &= out[i] == next_out++;
+    }
+  }
+  TEST_CHECK(ok);
+  TEST_CHECK(act_dequeCapacity(&deque) == capacity);
+
+  // A bulk push that grows the deque unwraps it
+  size_t len = act_dequeLen(&deque);
+  for (size_t i = 0; i < 100; i++) {
+    batch[i] = next_in++;
+  }
+  act_dequePushBackMany(&deque, batch, 100, &err_code);
+  act_dequePushBackMany(&deque, batch, 100, &err_code);
+  TEST_CHECK(act_dequeLen(&deque) == len + 200);
+  TEST_CHECK(act_dequeCapacity(&deque) > capacity);
+  act_DequeSpan first;
+  act_DequeSpan second;
+  act_dequeSpans(&deque, &first, &second);
+  TEST_CHECK(second.len == 0);
+  TEST_CHECK(*(const uint64_t *)first.data == next_out);
+
+  TEST_CHECK(act_dequePopFrontMany(&deque, NULL, 1000, &err_code) ==
+             len + 200);
+  TEST_CHECK(act_dequeLen(&deque) == 0);
+
+  act_dequeFree(&deque, &err_code);
+
+  if (err_code != ACT_DEQUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[DEQUE] Can create new act_Deque", test_canCreateNewDeque},
+    {"[DEQUE] Can push and pop at both ends of act_Deque",
+     test_canPushAndPopAtBothEnds},
+    {"[DEQUE] Can copy act_Deque in bulk", test_canCopyDequeInBulk},
+    {NULL, NULL}};
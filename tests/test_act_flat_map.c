@@ -0,0 +1,217 @@
+#include "act_allocator.h"
+#include "act_flat_map.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compareU32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int compareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/// A simple LCG, so tests are deterministic.
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+/// The number of keys the maps are checked against.
+#define NUM_KEYS 4096
+
+/// Checks that the map holds exactly the present keys, with their values, in
+/// order.
+static void checkAgainst(const act_FlatMap *map, const bool *present,
+                         const uint64_t *values) {
+  int err_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const uint32_t *keys = act_flatMapKeys(map);
+  const uint64_t *map_values = act_flatMapValues(map);
+
+  size_t idx = 0;
+  bool ok = true;
+  for (uint32_t key = 0; key < NUM_KEYS; key++) {
+    const uint64_t *value = act_flatMapGet(map, &key, &err_code);
+    ok &= (value != NULL) == present[key];
+    if (present[key]) {
+      ok &= value != NULL && *value == values[key];
+      ok &= keys[idx] == key && map_values[idx] == values[key];
+      idx++;
+    }
+  }
+  TEST_CHECK(ok);
+  TEST_CHECK(act_flatMapLen(map) == idx);
+  TEST_CHECK(act_vectorLen(keys, &vec_err) == idx);
+}
+
+void test_canCreateNewFlatMap(void) {
+  int err_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+  act_FlatMap map = ACT_FLAT_MAP_NEW(uint64_t, double, compareU64,
+                                     ACT_FLAT_MAP_LOOKUP_BINARY, &GPA,
+                                     &err_code);
+
+  TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_SUCCESS);
+  TEST_CHECK(act_flatMapLen(&map) == 0);
+
+  uint64_t key = 1;
+  TEST_CHECK(act_flatMapGet(&map, &key, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_NOT_FOUND);
+  TEST_CHECK(!act_flatMapContains(&map, &key));
+
+  act_flatMapNew(&GPA, 0, 8, compareU64, ACT_FLAT_MAP_LOOKUP_BINARY,
+                 &err_code);
+  TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_INVALID_KEY_SIZE);
+  act_flatMapNew(&GPA, 8, 8, NULL, ACT_FLAT_MAP_LOOKUP_BINARY, &err_code);
+  TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_NULL_COMPARATOR);
+  act_flatMapNew(&GPA, 8, 8, compareU64, (act_FlatMapLookup)7, &err_code);
+  TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_INVALID_LOOKUP);
+
+  act_flatMapFree(&map, &err_code);
+
+  if (err_code != ACT_FLAT_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInsertAndRemoveFromFlatMap(void) {
+  int err_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+  const act_FlatMapLookup LOOKUPS[] = {ACT_FLAT_MAP_LOOKUP_BINARY,
+                                       ACT_FLAT_MAP_LOOKUP_EYTZINGER};
+  for (size_t l = 0; l < 2; l++) {
+    act_FlatMap map = ACT_FLAT_MAP_NEW(uint32_t, uint64_t, compareU32,
+                                       LOOKUPS[l], &GPA, &err_code);
+
+    // Interleave inserts and removals, checking against plain arrays
+    bool present[NUM_KEYS] = {false};
+    uint64_t values[NUM_KEYS] = {0};
+    uint64_t state = 3;
+    for (size_t i = 0; i < 5000; i++) {
+      uint32_t key = (uint32_t)(nextRandom(&state) % NUM_KEYS);
+      if (nextRandom(&state) % 3 == 0) {
+        uint64_t removed = 0;
+        bool was_present = present[key];
+        TEST_CHECK(act_flatMapRemove(&map, &key, &removed, &err_code) ==
+                   was_present);
+        TEST_CHECK(!was_present || removed == values[key]);
+        present[key] = false;
+      } else {
+        uint64_t value = nextRandom(&state);
+        TEST_CHECK(act_flatMapInsert(&map, &key, &value, &err_code) ==
+                   !present[key]);
+        present[key] = true;
+        values[key] = value;
+      }
+    }
+    err_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+    checkAgainst(&map, present, values);
+
+    act_flatMapFree(&map, &err_code);
+  }
+
+  if (err_code != ACT_FLAT_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInsertBatchIntoFlatMap(void) {
+  int err_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  const act_FlatMapLookup LOOKUPS[] = {ACT_FLAT_MAP_LOOKUP_BINARY,
+                                       ACT_FLAT_MAP_LOOKUP_EYTZINGER};
+  const size_t BATCH_LENS[] = {0, 1, 10, 500, 3000, 20};
+  for (size_t l = 0; l < 2; l++) {
+    act_FlatMap map = ACT_FLAT_MAP_NEW(uint32_t, uint64_t, compareU32,
+                                       LOOKUPS[l], &GPA, &err_code);
+    bool present[NUM_KEYS] = {false};
+    uint64_t values[NUM_KEYS] = {0};
+    uint64_t state = 5;
+
+    // Batches have keys already in the map, and the same key more than once
+    for (size_t b = 0; b < sizeof(BATCH_LENS) / sizeof(*BATCH_LENS); b++) {
+      ACT_VEC(uint32_t) keys = ACT_VEC_NEW(uint32_t, &GPA, &vec_err);
+      ACT_VEC(uint64_t) batch_values = ACT_VEC_NEW(uint64_t, &GPA, &vec_err);
+      size_t expected_added = 0;
+      for (size_t i = 0; i < BATCH_LENS[b]; i++) {
+        uint32_t key = (uint32_t)(nextRandom(&state) % NUM_KEYS);
+        uint64_t value = nextRandom(&state);
+        ACT_VEC_PUSH(keys, key, &vec_err);
+        ACT_VEC_PUSH(batch_values, value, &vec_err);
+        expected_added += !present[key];
+        present[key] = true;
+        values[key] = value;
+      }
+
+      size_t added =
+          act_flatMapInsertBatch(&map, keys, batch_values, &err_code);
+      TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_SUCCESS);
+      TEST_CHECK(added == expected_added);
+      checkAgainst(&map, present, values);
+      TEST_MSG("lookup %zu, batch %zu", l, b);
+
+      act_vectorFree(keys, &vec_err);
+      act_vectorFree(batch_values, &vec_err);
+    }
+
+    // The batch's vectors must match
+    ACT_VEC(uint32_t) keys = ACT_VEC_NEW(uint32_t, &GPA, &vec_err);
+    uint32_t key = 1;
+    ACT_VEC_PUSH(keys, key, &vec_err);
+    ACT_VEC(uint64_t) no_values = ACT_VEC_NEW(uint64_t, &GPA, &vec_err);
+    act_flatMapInsertBatch(&map, keys, no_values, &err_code);
+    TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_INVALID_BATCH);
+    act_flatMapInsertBatch(&map, no_values, no_values, &err_code);
+    TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_INVALID_BATCH);
+    act_vectorFree(keys, &vec_err);
+    act_vectorFree(no_values, &vec_err);
+    err_code = ACT_FLAT_MAP_ERROR_SUCCESS;
+
+    act_flatMapFree(&map, &err_code);
+  }
+
+  // A map with no values is a set
+  act_FlatMap set =
+      act_flatMapNew(&GPA, sizeof(uint64_t), 0, compareU64,
+                     ACT_FLAT_MAP_LOOKUP_EYTZINGER, &err_code);
+  ACT_VEC(uint64_t) keys = ACT_VEC_NEW(uint64_t, &GPA, &vec_err);
+  for (uint64_t key = 100; key > 0; key--) {
+    uint64_t doubled = key * 2;
+    ACT_VEC_PUSH(keys, doubled, &vec_err);
+  }
+  TEST_CHECK(act_flatMapInsertBatch(&set, keys, NULL, &err_code) == 100);
+  uint64_t key = 42;
+  TEST_CHECK(act_flatMapContains(&set, &key));
+  key = 43;
+  TEST_CHECK(!act_flatMapContains(&set, &key));
+
+  // Single inserts into a set take no value
+  TEST_CHECK(act_flatMapInsert(&set, &key, NULL, &err_code));
+  TEST_CHECK(!act_flatMapInsert(&set, &key, NULL, &err_code));
+  TEST_CHECK(err_code == ACT_FLAT_MAP_ERROR_SUCCESS);
+  TEST_CHECK(act_flatMapContains(&set, &key));
+  TEST_CHECK(act_flatMapLen(&set) == 101);
+  act_vectorFree(keys, &vec_err);
+  act_flatMapFree(&set, &err_code);
+
+  if (err_code != ACT_FLAT_MAP_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[FLAT MAP] Can create new act_FlatMap", test_canCreateNewFlatMap},
+    {"[FLAT MAP] Can insert into and remove from act_FlatMap",
+     test_canInsertAndRemoveFromFlatMap},
+    {"[FLAT MAP] Can insert batch into act_FlatMap",
+     test_canInsertBatchIntoFlatMap},
+    {NULL, NULL}};
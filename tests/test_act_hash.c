@@ -0,0 +1,90 @@
+#include "act_hash.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Counts the number of differing bits between two hashes.
+static int countDiffBits(uint64_t hash1, uint64_t hash2) {
+  return __builtin_popcountll(hash1 ^ hash2);
+}
+
+void test_canHashBytes(void) {
+  char buf[256];
+  for (size_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = (char)(i * 31 + 7);
+  }
+
+  // Hashes are deterministic, and distinct for every prefix length
+  uint64_t hashes[sizeof(buf) + 1];
+  for (size_t len = 0; len <= sizeof(buf); len++) {
+    hashes[len] = act_hashBytes(buf, len, ACT_HASH_DEFAULT_SEED);
+    TEST_CHECK(hashes[len] == act_hashBytes(buf, len, ACT_HASH_DEFAULT_SEED));
+    for (size_t prev = 0; prev < len; prev++) {
+      TEST_CHECK_(hashes[prev] != hashes[len], "len %zu vs %zu", prev, len);
+    }
+  }
+  TEST_CHECK(act_hashBytes(NULL, 0, ACT_HASH_DEFAULT_SEED) == hashes[0]);
+
+  // The hash only depends on the bytes, not their alignment
+  char unaligned[sizeof(buf) + 1];
+  memcpy(unaligned + 1, buf, sizeof(buf));
+  TEST_CHECK(act_hashBytes(unaligned + 1, 100, ACT_HASH_DEFAULT_SEED) ==
+             hashes[100]);
+
+  // Different seeds give different hashes
+  TEST_CHECK(act_hashBytes(buf, 100, 1) != hashes[100]);
+  TEST_CHECK(act_hashBytes(buf, 100, 1) != act_hashBytes(buf, 100, 2));
+}
+
+void test_canHashWithAvalanche(void) {
+  // Flipping any input bit flips about half of the output bits
+  const size_t LENS[] = {1, 3, 8, 16, 17, 48, 100};
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    uint8_t buf[100] = {0};
+    size_t len = LENS[l];
+    uint64_t base = act_hashBytes(buf, len, ACT_HASH_DEFAULT_SEED);
+
+    int total_diff = 0;
+    for (size_t bit = 0; bit < len * 8; bit++) {
+      buf[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+      int diff =
+          countDiffBits(base, act_hashBytes(buf, len, ACT_HASH_DEFAULT_SEED));
+      buf[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+
+      TEST_CHECK_(diff > 8, "len %zu, bit %zu", len, bit);
+      total_diff += diff;
+    }
+
+    double avg_diff = (double)total_diff / (double)(len * 8);
+    TEST_CHECK_(avg_diff > 28 && avg_diff < 36, "len %zu: %f", len, avg_diff);
+  }
+}
+
+void test_canHashIntegers(void) {
+  TEST_CHECK(act_hashU64(42, ACT_HASH_DEFAULT_SEED) ==
+             act_hashU64(42, ACT_HASH_DEFAULT_SEED));
+  TEST_CHECK(act_hashU64(42, ACT_HASH_DEFAULT_SEED) != act_hashU64(42, 1));
+
+  // Consecutive integers land in distinct buckets of a small table
+  const size_t NUM_BUCKETS = 64;
+  size_t counts[64] = {0};
+  for (uint64_t i = 0; i < 64 * NUM_BUCKETS; i++) {
+    counts[act_hashU64(i, ACT_HASH_DEFAULT_SEED) % NUM_BUCKETS]++;
+  }
+  for (size_t i = 0; i < NUM_BUCKETS; i++) {
+    TEST_CHECK_(counts[i] > 32 && counts[i] < 96, "bucket %zu: %zu", i,
+                counts[i]);
+  }
+
+  // Combining is order dependent
+  uint64_t h1 = act_hashU64(1, ACT_HASH_DEFAULT_SEED);
+  uint64_t h2 = act_hashU64(2, ACT_HASH_DEFAULT_SEED);
+  TEST_CHECK(act_hashCombine(h1, h2) != act_hashCombine(h2, h1));
+}
+
+TEST_LIST = {
+    {"[HASH] Can hash bytes", test_canHashBytes},
+    {"[HASH] Can hash bytes with avalanche", test_canHashWithAvalanche},
+    {"[HASH] Can hash integers", test_canHashIntegers},
+    {NULL, NULL}};
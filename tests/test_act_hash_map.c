@@ -0,0 +1,242 @@
+#include "act_allocator.h"
+#include "act_hash_map.h"
+#include "act_string.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_canCreateNewHashMap(void) {
+  int err_code = ACT_HASH_MAP_ERROR_SUCCESS;
+  act_HashMap map = ACT_HASH_MAP_NEW(uint64_t, double, &GPA, &err_code);
+
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_SUCCESS);
+  TEST_CHECK(act_hashMapLen(&map) == 0);
+  TEST_CHECK(act_hashMapCapacity(&map) == 0);
+  TEST_CHECK(act_hashMapLoadFactor(&map) == 0.0f);
+  TEST_CHECK(act_hashMapMaxLoadFactor(&map) ==
+             ACT_HASH_MAP_DEFAULT_MAX_LOAD_FACTOR);
+
+  uint64_t key = 1;
+  TEST_CHECK(act_hashMapGet(&map, &key, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_NOT_FOUND);
+
+  act_hashMapNew(&GPA, 0, 8, &err_code);
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_INVALID_KEY_SIZE);
+
+  act_hashMapFree(&map, &err_code);
+
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInsertAndGetFromHashMap(void) {
+  int err_code = ACT_HASH_MAP_ERROR_SUCCESS;
+  act_HashMap map = ACT_HASH_MAP_NEW(uint64_t, uint64_t, &GPA, &err_code);
+
+  const uint64_t NUM_KEYS = 10000;
+  for (uint64_t key = 0; key < NUM_KEYS; key++) {
+    uint64_t value = key * key;
+    TEST_CHECK(act_hashMapInsert(&map, &key, &value, &err_code));
+  }
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+  TEST_CHECK(act_hashMapLen(&map) == NUM_KEYS);
+  TEST_CHECK(act_hashMapLoadFactor(&map) <=
+             act_hashMapMaxLoadFactor(&map));
+
+  for (uint64_t key = 0; key < NUM_KEYS; key++) {
+    uint64_t *value = act_hashMapGet(&map, &key, &err_code);
+    TEST_ASSERT(value != NULL);
+    TEST_CHECK(*value == key * key);
+  }
+  uint64_t missing = NUM_KEYS;
+  TEST_CHECK(!act_hashMapContains(&map, &missing));
+
+  // Inserting an existing key replaces its value
+  uint64_t key = 7;
+  uint64_t value = 0;
+  TEST_CHECK(!act_hashMapInsert(&map, &key, &value, &err_code));
+  TEST_CHECK(*(uint64_t *)act_hashMapGet(&map, &key, &err_code) == 0);
+  TEST_CHECK(act_hashMapLen(&map) == NUM_KEYS);
+
+  act_hashMapFree(&map, &err_code);
+
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canRemoveFromHashMap(void) {
+  int err_code = ACT_HASH_MAP_ERROR_SUCCESS;
+  act_HashMap map = ACT_HASH_MAP_NEW(uint32_t, uint32_t, &GPA, &err_code);
+
+  // Interleave inserts and removals, checking against a plain array
+  const uint32_t NUM_KEYS = 4096;
+  bool present[4096] = {false};
+  uint32_t state = 12345;
+  for (size_t i = 0; i < 50000; i++) {
+    state = state * 1103515245u + 12345u;
+    uint32_t key = (state >> 8) % NUM_KEYS;
+    if (state & 1) {
+      uint32_t value = key + 1;
+      act_hashMapInsert(&map, &key, &value, &err_code);
+      present[key] = true;
+    } else {
+      uint32_t value = 0;
+      bool removed = act_hashMapRemove(&map, &key, &value, &err_code);
+      TEST_CHECK(removed == present[key]);
+      TEST_CHECK(!removed || value == key + 1);
+      present[key] = false;
+    }
+  }
+
+  // Every remaining key is still reachable after all the shifting
+  size_t num_present = 0;
+  for (uint32_t key = 0; key < NUM_KEYS; key++) {
+    TEST_CHECK_(act_hashMapContains(&map, &key) == present[key], "key %u",
+                key);
+    num_present += present[key];
+  }
+  TEST_CHECK(act_hashMapLen(&map) == num_present);
+
+  act_hashMapClear(&map, &err_code);
+  TEST_CHECK(act_hashMapLen(&map) == 0);
+  uint32_t key = 0;
+  TEST_CHECK(!act_hashMapRemove(&map, &key, NULL, &err_code));
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_NOT_FOUND);
+
+  act_hashMapFree(&map, &err_code);
+
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canReserveHashMap(void) {
+  int err_code = ACT_HASH_MAP_ERROR_SUCCESS;
+  act_HashMap map = ACT_HASH_MAP_NEW(uint64_t, uint8_t, &GPA, &err_code);
+
+  act_hashMapSetMaxLoadFactor(&map, 1.5f, &err_code);
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_INVALID_LOAD_FACTOR);
+  act_hashMapSetMaxLoadFactor(&map, 0.5f, &err_code);
+  TEST_CHECK(act_hashMapMaxLoadFactor(&map) == 0.5f);
+
+  // Inserting up to the reserved size never rehashes
+  act_hashMapReserve(&map, 1000, &err_code);
+  size_t capacity = act_hashMapCapacity(&map);
+  TEST_CHECK(capacity >= 2000);
+  for (uint64_t key = 0; key < 1000; key++) {
+    uint8_t value = (uint8_t)key;
+    act_hashMapInsert(&map, &key, &value, &err_code);
+  }
+  TEST_CHECK(act_hashMapCapacity(&map) == capacity);
+  TEST_CHECK(act_hashMapLoadFactor(&map) <= 0.5f);
+
+  act_hashMapFree(&map, &err_code);
+
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canIterateHashMap(void) {
+  int err_code = ACT_HASH_MAP_ERROR_SUCCESS;
+  act_HashMap map = ACT_HASH_MAP_NEW(int, int, &GPA, &err_code);
+
+  int key_sum = 0;
+  for (int key = 1; key <= 100; key++) {
+    int value = -key;
+    act_hashMapInsert(&map, &key, &value, &err_code);
+    key_sum += key;
+  }
+
+  size_t count = 0;
+  int iter_sum = 0;
+  const void *key = NULL;
+  void *value = NULL;
+  act_HashMapIter iter = act_hashMapIter(&map);
+  while (act_hashMapIterNext(&iter, &key, &value)) {
+    TEST_CHECK(*(const int *)key == -*(int *)value);
+    iter_sum += *(const int *)key;
+    count++;
+  }
+  TEST_CHECK(count == 100);
+  TEST_CHECK(iter_sum == key_sum);
+
+  act_hashMapFree(&map, &err_code);
+
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canUseStringKeysInHashMap(void) {
+  int err_code = ACT_HASH_MAP_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+  act_HashMap map = act_hashMapNewStringKeys(&GPA, sizeof(int), &err_code);
+
+  // Keys are copied, so the inserted buffer can be reused
+  char key[32];
+  for (int i = 0; i < 500; i++) {
+    snprintf(key, sizeof(key), "header-%d", i);
+    act_hashMapInsertStr(&map, act_stringViewFromCstr(key), &i, &err_code);
+  }
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+  TEST_CHECK(act_hashMapLen(&map) == 500);
+
+  int *value =
+      act_hashMapGetStr(&map, act_stringViewFromCstr("header-42"), &err_code);
+  TEST_ASSERT(value != NULL);
+  TEST_CHECK(*value == 42);
+
+  act_String lookup = act_stringFromCstr(&GPA, "header-7", &str_err);
+  value = act_hashMapGetString(&map, &lookup, &err_code);
+  TEST_ASSERT(value != NULL);
+  TEST_CHECK(*value == 7);
+
+  // Iteration yields the map's own act_String keys
+  act_HashMapIter iter = act_hashMapIter(&map);
+  const void *iter_key = NULL;
+  size_t count = 0;
+  while (act_hashMapIterNext(&iter, &iter_key, NULL)) {
+    const act_String *str = iter_key;
+    TEST_CHECK(strncmp(act_stringAsCstr(*str), "header-", 7) == 0);
+    count++;
+  }
+  TEST_CHECK(count == 500);
+
+  int removed = 0;
+  TEST_CHECK(act_hashMapRemoveStr(&map, act_stringViewFromCstr("header-7"),
+                                  &removed, &err_code));
+  TEST_CHECK(removed == 7);
+  TEST_CHECK(act_hashMapGetString(&map, &lookup, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_NOT_FOUND);
+
+  // Byte-key functions are rejected on string-key maps
+  TEST_CHECK(act_hashMapGet(&map, "header-1", &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_HASH_MAP_ERROR_WRONG_KEY_KIND);
+
+  act_stringFree(&lookup, &str_err);
+  act_hashMapFree(&map, &err_code);
+
+  if (err_code != ACT_HASH_MAP_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[HASH MAP] Can create new act_HashMap", test_canCreateNewHashMap},
+    {"[HASH MAP] Can insert into and get from act_HashMap",
+     test_canInsertAndGetFromHashMap},
+    {"[HASH MAP] Can remove from act_HashMap", test_canRemoveFromHashMap},
+    {"[HASH MAP] Can reserve space in act_HashMap", test_canReserveHashMap},
+    {"[HASH MAP] Can iterate over act_HashMap", test_canIterateHashMap},
+    {"[HASH MAP] Can use act_String keys in act_HashMap",
+     test_canUseStringKeysInHashMap},
+    {NULL, NULL}};
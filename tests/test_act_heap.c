@@ -0,0 +1,230 @@
+#include "act_allocator.h"
+#include "act_heap.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+static int compareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+typedef struct Deadline {
+  uint32_t id;
+  uint32_t due;
+} Deadline;
+
+static int compareDeadline(const void *a, const void *b) {
+  const Deadline *x = a;
+  const Deadline *y = b;
+  return (x->due > y->due) - (x->due < y->due);
+}
+
+/// A simple LCG, so tests are deterministic.
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+void test_canCreateNewHeap(void) {
+  int err_code = ACT_HEAP_ERROR_SUCCESS;
+  act_Heap heap = ACT_HEAP_NEW(uint64_t, compareU64, &GPA, &err_code);
+
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_SUCCESS);
+  TEST_CHECK(act_heapLen(&heap) == 0);
+  TEST_CHECK(act_heapTop(&heap, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_EMPTY);
+  TEST_CHECK(!act_heapPop(&heap, NULL, &err_code));
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_EMPTY);
+
+  act_heapNew(&GPA, sizeof(uint64_t), compareU64, 3, &err_code);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_INVALID_ARITY);
+  act_heapNew(&GPA, sizeof(uint64_t), NULL, ACT_HEAP_ARITY_BINARY, &err_code);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_NULL_COMPARATOR);
+
+  act_heapFree(&heap, &err_code);
+
+  if (err_code != ACT_HEAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canPushAndPopFromHeap(void) {
+  int err_code = ACT_HEAP_ERROR_SUCCESS;
+  const act_HeapArity ARITIES[] = {ACT_HEAP_ARITY_BINARY,
+                                   ACT_HEAP_ARITY_QUATERNARY};
+
+  for (size_t a = 0; a < 2; a++) {
+    act_Heap heap = act_heapNew(&GPA, sizeof(uint64_t), compareU64,
+                                ARITIES[a], &err_code);
+
+    const size_t NUM_VALUES = 5000;
+    uint64_t state = 42;
+    for (size_t i = 0; i < NUM_VALUES; i++) {
+      uint64_t value = nextRandom(&state) % 1000;
+      act_heapPush(&heap, &value, &err_code);
+    }
+    TEST_CHECK(act_heapLen(&heap) == NUM_VALUES);
+
+    // Values come out in non-decreasing order
+    uint64_t prev = 0;
+    size_t popped = 0;
+    uint64_t value = 0;
+    while (act_heapPop(&heap, &value, &err_code)) {
+      TEST_CHECK(value >= prev);
+      prev = value;
+      popped++;
+    }
+    TEST_CHECK(popped == NUM_VALUES);
+    TEST_CHECK(act_heapLen(&heap) == 0);
+
+    act_heapFree(&heap, &err_code);
+  }
+
+  if (err_code != ACT_HEAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canHeapifyVector(void) {
+  int err_code = ACT_HEAP_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  const size_t NUM_VALUES = 1000;
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &vec_err);
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    uint64_t value = NUM_VALUES - i;
+    ACT_VEC_PUSH(vec, value, &vec_err);
+  }
+
+  act_Heap heap =
+      act_heapFromVector(vec, compareU64, ACT_HEAP_ARITY_QUATERNARY, &err_code);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_SUCCESS);
+  TEST_CHECK(act_heapLen(&heap) == NUM_VALUES);
+  TEST_CHECK(*(const uint64_t *)act_heapTop(&heap, &err_code) == 1);
+
+  // Extending with more values than the heap holds rebuilds it
+  uint64_t more[2000];
+  for (size_t i = 0; i < 2000; i++) {
+    more[i] = 5000 - i;
+  }
+  act_heapExtend(&heap, more, 2000, &err_code);
+  TEST_CHECK(act_heapLen(&heap) == 3000);
+
+  uint64_t prev = 0;
+  uint64_t value = 0;
+  for (size_t i = 0; i < 1500; i++) {
+    act_heapPop(&heap, &value, &err_code);
+    TEST_CHECK(value >= prev);
+    prev = value;
+  }
+
+  // The remaining elements go back to the caller
+  ACT_VEC(uint64_t) rest = act_heapIntoVector(&heap, &err_code);
+  TEST_CHECK(act_vectorLen(rest, &vec_err) == 1500);
+  TEST_CHECK(act_heapLen(&heap) == 0);
+  act_vectorFree(rest, &vec_err);
+  act_heapFree(&heap, &err_code);
+
+  if (err_code != ACT_HEAP_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canReplaceHeapTop(void) {
+  int err_code = ACT_HEAP_ERROR_SUCCESS;
+  act_Heap heap = ACT_HEAP_NEW(Deadline, compareDeadline, &GPA, &err_code);
+
+  for (uint32_t id = 0; id < 10; id++) {
+    Deadline deadline = {.id = id, .due = 100 + id * 10};
+    act_heapPush(&heap, &deadline, &err_code);
+  }
+
+  // Reschedule the earliest deadline to the end
+  Deadline late = {.id = 99, .due = 1000};
+  Deadline earliest = {0};
+  TEST_CHECK(act_heapReplaceTop(&heap, &late, &earliest, &err_code));
+  TEST_CHECK(earliest.id == 0 && earliest.due == 100);
+  TEST_CHECK(act_heapLen(&heap) == 10);
+
+  const Deadline *top = act_heapTop(&heap, &err_code);
+  TEST_CHECK(top->id == 1 && top->due == 110);
+
+  Deadline deadline = {0};
+  for (size_t i = 0; i < 10; i++) {
+    act_heapPop(&heap, &deadline, &err_code);
+  }
+  TEST_CHECK(deadline.id == 99);
+
+  act_heapClear(&heap, &err_code);
+  act_heapFree(&heap, &err_code);
+
+  if (err_code != ACT_HEAP_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canKeepTopK(void) {
+  int err_code = ACT_HEAP_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  const size_t K = 100;
+  const size_t NUM_VALUES = 10000;
+  act_TopK top_k =
+      act_topKNew(&GPA, sizeof(uint64_t), K, compareU64, &err_code);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_SUCCESS);
+
+  // Nothing to peek at yet
+  TEST_CHECK(act_topKThreshold(&top_k, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_EMPTY);
+
+  uint64_t *values = malloc(NUM_VALUES * sizeof(uint64_t));
+  uint64_t state = 13;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    values[i] = nextRandom(&state) % 5000;
+    act_topKPush(&top_k, &values[i], &err_code);
+    TEST_CHECK(err_code == ACT_HEAP_ERROR_SUCCESS);
+  }
+  TEST_CHECK(act_topKLen(&top_k) == K);
+
+  // The threshold is the k-th greatest value
+  qsort(values, NUM_VALUES, sizeof(uint64_t), compareU64);
+  const uint64_t *threshold = act_topKThreshold(&top_k, &err_code);
+  TEST_CHECK(*threshold == values[NUM_VALUES - K]);
+
+  // Values not above the threshold are turned away
+  uint64_t low = 0;
+  TEST_CHECK(!act_topKPush(&top_k, &low, &err_code));
+
+  ACT_VEC(uint64_t) sorted = act_topKIntoSortedVector(&top_k, &err_code);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(sorted, &vec_err) == K);
+  for (size_t i = 0; i < K; i++) {
+    TEST_CHECK(sorted[i] == values[NUM_VALUES - 1 - i]);
+  }
+
+  act_vectorFree(sorted, &vec_err);
+  act_topKFree(&top_k, &err_code);
+  free(values);
+
+  // Keeping nothing is an error
+  act_topKNew(&GPA, sizeof(uint64_t), 0, compareU64, &err_code);
+  TEST_CHECK(err_code == ACT_HEAP_ERROR_INVALID_K);
+  err_code = ACT_HEAP_ERROR_SUCCESS;
+
+  if (err_code != ACT_HEAP_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[HEAP] Can create new act_Heap", test_canCreateNewHeap},
+    {"[HEAP] Can push to and pop from act_Heap", test_canPushAndPopFromHeap},
+    {"[HEAP] Can heapify act_Vector", test_canHeapifyVector},
+    {"[HEAP] Can replace top of act_Heap", test_canReplaceHeapTop},
+    {"[HEAP] Can keep top k elements", test_canKeepTopK},
+    {NULL, NULL}};
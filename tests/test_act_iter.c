@@ -0,0 +1,278 @@
+#include "act_allocator.h"
+#include "act_iter.h"
+#include "act_string.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// The number of elements in the vectors of the tests.
+#define NUM_VALUES 1000
+
+/// A pair yielded by a zip of a **uint64_t** and a **double** iterator.
+typedef struct Pair {
+  uint64_t id;
+  double score;
+} Pair;
+
+/// Keeps the even values, counting the calls.
+static bool isEven(const void *element, void *arg) {
+  (*(size_t *)arg)++;
+  return *(const uint64_t *)element % 2 == 0;
+}
+
+/// Squares a value, counting the calls.
+static void square(const void *element, void *out, void *arg) {
+  (*(size_t *)arg)++;
+  uint64_t value = *(const uint64_t *)element;
+  *(uint64_t *)out = value * value;
+}
+
+/// Parses a token of decimal digits.
+static void parseToken(const void *element, void *out, void *arg) {
+  (void)arg;
+  const act_StringView *token = element;
+  uint64_t value = 0;
+  for (size_t i = 0; i < token->len; i++) {
+    value = value * 10 + (uint64_t)(token->data[i] - '0');
+  }
+  *(uint64_t *)out = value;
+}
+
+/// Adds a value to the accumulator.
+static void addValue(void *acc, const void *element, void *arg) {
+  (void)arg;
+  *(uint64_t *)acc += *(const uint64_t *)element;
+}
+
+/// Adds the length of a chunk to the accumulator.
+static void addChunkLen(const void *element, void *arg) {
+  *(size_t *)arg += ((const act_IterChunk *)element)->len;
+}
+
+void test_canIterateOverSources(void) {
+  int err_code = ACT_ITER_ERROR_SUCCESS;
+  ACT_VEC(uint64_t) values =
+      ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err_code);
+  for (uint64_t i = 0; i < NUM_VALUES; i++) {
+    ACT_VEC_PUSH(values, i, &err_code);
+  }
+
+  // Vector sources yield pointers into the vector
+  act_Iter iter = act_iterFromVector(values, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_SUCCESS);
+  TEST_CHECK(act_iterDataSize(&iter) == sizeof(uint64_t));
+  bool ok = true;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    ok &= act_iterNext(&iter) == &values[i];
+  }
+  TEST_CHECK(ok);
+  TEST_CHECK(act_iterNext(&iter) == NULL);
+
+  const char *text = "h\xC3\xA9llo \xE2\x82\xAC";
+  iter = act_iterFromView(act_stringViewFromCstr(text));
+  act_Vector *bytes = act_iterCollect(&iter, &GPA, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(bytes, &err_code) == strlen(text));
+  TEST_CHECK(memcmp(bytes, text, strlen(text)) == 0);
+  act_vectorFree(bytes, &err_code);
+
+  iter = act_iterCodepoints(act_stringViewFromCstr(text));
+  uint32_t *codepoints = act_iterCollect(&iter, &GPA, &err_code);
+  uint32_t expected[] = {'h', 0xE9, 'l', 'l', 'o', ' ', 0x20AC};
+  TEST_CHECK(act_vectorLen(codepoints, &err_code) == 7);
+  TEST_CHECK(memcmp(codepoints, expected, sizeof(expected)) == 0);
+  act_vectorFree(codepoints, &err_code);
+
+  // Splits yield the same tokens as act_stringViewSplitAll
+  const char *lines[] = {"a,,bc,", "", "abc", ","};
+  for (size_t l = 0; l < 4; l++) {
+    act_StringView view = act_stringViewFromCstr(lines[l]);
+    ACT_VEC(act_StringView)
+    all = act_stringViewSplitAll(&GPA, view, ',', &err_code);
+    iter = act_iterSplit(view, ',');
+    act_StringView *tokens = act_iterCollect(&iter, &GPA, &err_code);
+
+    size_t len = act_vectorLen(all, &err_code);
+    ok = act_vectorLen(tokens, &err_code) == len;
+    for (size_t i = 0; ok && i < len; i++) {
+      ok &= tokens[i].data == all[i].data && tokens[i].len == all[i].len;
+    }
+    TEST_CHECK(ok);
+    TEST_MSG("line: \"%s\"", lines[l]);
+    act_vectorFree(tokens, &err_code);
+    act_vectorFree(all, &err_code);
+  }
+
+  iter = act_iterFromVector(NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_VECTOR);
+  TEST_CHECK(act_iterNext(&iter) == NULL);
+  act_iterCollect(&iter, &GPA, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_ITER);
+
+  act_vectorFree(values, &err_code);
+  if (err_code != ACT_ITER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canChainIterAdapters(void) {
+  int err_code = ACT_ITER_ERROR_SUCCESS;
+  ACT_VEC(uint64_t) values =
+      ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err_code);
+  ACT_VEC(double) scores = ACT_VEC_WCAP(double, &GPA, NUM_VALUES, &err_code);
+  for (uint64_t i = 0; i < NUM_VALUES; i++) {
+    ACT_VEC_PUSH(values, i, &err_code);
+    ACT_VEC_PUSH(scores, (double)i / 4, &err_code);
+  }
+
+  // Only the elements that reach the end are computed
+  size_t tested = 0;
+  size_t squared = 0;
+  act_Iter source = act_iterFromVector(values, &err_code);
+  act_Iter evens = act_iterFilter(&source, isEven, &tested, &err_code);
+  act_Iter squares = act_iterMap(&evens, sizeof(uint64_t), square, &squared,
+                                 &err_code);
+  act_Iter first = act_iterTake(&squares, 10, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_SUCCESS);
+  TEST_CHECK(tested == 0 && squared == 0);
+
+  uint64_t *result = act_iterCollect(&first, &GPA, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(result, &err_code) == 10);
+  bool ok = true;
+  for (uint64_t i = 0; i < 10; i++) {
+    ok &= result[i] == 4 * i * i;
+  }
+  TEST_CHECK(ok);
+  TEST_CHECK(tested == 19 && squared == 10);
+  act_vectorFree(result, &err_code);
+
+  // Zips stop at the shorter iterator
+  act_Iter ids = act_iterFromVector(values, &err_code);
+  act_Iter all_scores = act_iterFromVector(scores, &err_code);
+  act_Iter some_scores = act_iterTake(&all_scores, 100, &err_code);
+  act_Iter pairs = act_iterZip(&ids, &some_scores, &err_code);
+  TEST_CHECK(act_iterDataSize(&pairs) == sizeof(Pair));
+  Pair *zipped = act_iterCollect(&pairs, &GPA, &err_code);
+  TEST_CHECK(act_vectorLen(zipped, &err_code) == 100);
+  ok = true;
+  for (uint64_t i = 0; i < 100; i++) {
+    ok &= zipped[i].id == i && zipped[i].score == (double)i / 4;
+  }
+  TEST_CHECK(ok);
+  act_vectorFree(zipped, &err_code);
+
+  act_iterMap(&source, 0, square, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_INVALID_DATA_SIZE);
+  act_iterMap(&source, ACT_ITER_MAX_DATA_SIZE + 1, square, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_INVALID_DATA_SIZE);
+  act_iterFilter(&source, NULL, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_FUNCTION);
+  act_iterTake(NULL, 1, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_ITER);
+
+  err_code = ACT_ITER_ERROR_SUCCESS;
+  act_vectorFree(scores, &err_code);
+  act_vectorFree(values, &err_code);
+  if (err_code != ACT_ITER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canChunkIter(void) {
+  int err_code = ACT_ITER_ERROR_SUCCESS;
+  ACT_VEC(uint64_t) values =
+      ACT_VEC_WCAP(uint64_t, &GPA, NUM_VALUES, &err_code);
+  for (uint64_t i = 0; i < NUM_VALUES; i++) {
+    ACT_VEC_PUSH(values, i, &err_code);
+  }
+
+  // Chunks of a vector are spans of it
+  act_Iter source = act_iterFromVector(values, &err_code);
+  act_Iter chunks = act_iterChunk(&source, 64, &GPA, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_SUCCESS);
+  const act_IterChunk *chunk;
+  size_t total = 0;
+  bool ok = true;
+  while ((chunk = act_iterNext(&chunks)) != NULL) {
+    ok &= chunk->data == &values[total];
+    ok &= chunk->len == (NUM_VALUES - total < 64 ? NUM_VALUES - total : 64);
+    total += chunk->len;
+  }
+  TEST_CHECK(ok && total == NUM_VALUES);
+  act_iterFree(&chunks, &err_code);
+
+  // Chunks of other iterators are gathered
+  size_t tested = 0;
+  source = act_iterFromVector(values, &err_code);
+  act_Iter evens = act_iterFilter(&source, isEven, &tested, &err_code);
+  chunks = act_iterChunk(&evens, 64, &GPA, &err_code);
+  uint64_t next = 0;
+  ok = true;
+  while ((chunk = act_iterNext(&chunks)) != NULL) {
+    const uint64_t *run = chunk->data;
+    for (size_t i = 0; i < chunk->len; i++) {
+      ok &= run[i] == next;
+      next += 2;
+    }
+  }
+  TEST_CHECK(ok && next == NUM_VALUES);
+  act_iterFree(&chunks, &err_code);
+
+  total = 0;
+  source = act_iterFromView(act_stringViewFromCstr("abcdefghij"));
+  chunks = act_iterChunk(&source, 3, &GPA, &err_code);
+  TEST_CHECK(act_iterForEach(&chunks, addChunkLen, &total, &err_code) == 4);
+  TEST_CHECK(total == 10);
+  act_iterFree(&chunks, &err_code);
+
+  act_iterChunk(&source, 0, &GPA, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_INVALID_LEN);
+  act_iterChunk(&source, 3, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_ALLOCATOR);
+
+  err_code = ACT_ITER_ERROR_SUCCESS;
+  act_vectorFree(values, &err_code);
+  if (err_code != ACT_ITER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canReduceIter(void) {
+  int err_code = ACT_ITER_ERROR_SUCCESS;
+
+  // Parse and add up the fields of a line, without splitting it up front
+  act_Iter fields =
+      act_iterSplit(act_stringViewFromCstr("12,7,30,1000,0"), ',');
+  act_Iter numbers =
+      act_iterMap(&fields, sizeof(uint64_t), parseToken, NULL, &err_code);
+  uint64_t sum = 5;
+  act_iterReduce(&numbers, &sum, addValue, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_SUCCESS);
+  TEST_CHECK(sum == 1054);
+
+  // The pipeline is consumed
+  act_iterReduce(&numbers, &sum, addValue, NULL, &err_code);
+  TEST_CHECK(sum == 1054);
+
+  act_iterReduce(&numbers, NULL, addValue, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_ELEMENT);
+  act_iterReduce(&numbers, &sum, NULL, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_FUNCTION);
+  act_iterForEach(&numbers, NULL, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_ITER_ERROR_NULL_FUNCTION);
+
+  err_code = ACT_ITER_ERROR_SUCCESS;
+  if (err_code != ACT_ITER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[ITER] Can iterate over sources", test_canIterateOverSources},
+    {"[ITER] Can chain act_Iter adapters", test_canChainIterAdapters},
+    {"[ITER] Can chunk act_Iter", test_canChunkIter},
+    {"[ITER] Can reduce act_Iter", test_canReduceIter},
+    {NULL, NULL}};
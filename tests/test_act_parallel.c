@@ -0,0 +1,296 @@
+#include "act_allocator.h"
+#include "act_parallel.h"
+#include "act_thread_pool.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// The number of elements in the tests (not a multiple of the block size).
+#define NUM_VALUES 1000003
+
+/// An affine function @em a * x + @em b (modulo 2^64); composing them is
+/// associative, but not commutative.
+typedef struct Affine {
+  uint64_t a;
+  uint64_t b;
+} Affine;
+
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 11;
+}
+
+/// Applies @em element after @em acc.
+static void composeAffine(void *acc, const void *element, void *arg) {
+  (void)arg;
+  Affine *f = acc;
+  const Affine *g = element;
+  *f = (Affine){.a = f->a * g->a, .b = f->b * g->a + g->b};
+}
+
+/// Maps a value to its half, as a double.
+static void halveValue(const void *element, void *out, void *arg) {
+  (void)arg;
+  *(double *)out = (double)*(const uint64_t *)element / 2;
+}
+
+/// The argument of the filters.
+typedef struct Divisor {
+  uint64_t divisor;
+  _Atomic size_t calls;
+} Divisor;
+
+/// Keeps the multiples of the divisor, counting the calls.
+static bool isMultiple(const void *element, void *arg) {
+  Divisor *divisor = arg;
+  atomic_fetch_add(&divisor->calls, 1);
+  return *(const uint64_t *)element % divisor->divisor == 0;
+}
+
+/// Returns a vector of @em len random values below @em max.
+static uint64_t *randomValues(size_t len, uint64_t max, int *err_code) {
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, len, err_code);
+  uint64_t state = 42;
+  for (size_t i = 0; i < len; i++) {
+    ACT_VEC_PUSH(vec, nextRandom(&state) % max, err_code);
+  }
+  return vec;
+}
+
+void test_canMapInParallel(void) {
+  int err_code = ACT_PARALLEL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, false, &err_code);
+  ACT_VEC(uint64_t) values = randomValues(NUM_VALUES, 1000, &err_code);
+
+  double *halves = act_parallelMap(&pool, values, sizeof(double), halveValue,
+                                   NULL, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(halves, &err_code) == NUM_VALUES);
+  TEST_CHECK(act_vectorDataSize(halves, &err_code) == sizeof(double));
+  bool ok = true;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    ok &= halves[i] == (double)values[i] / 2;
+  }
+  TEST_CHECK(ok);
+  act_vectorFree(halves, &err_code);
+
+  act_Vector *empty = ACT_VEC_NEW(uint64_t, &GPA, &err_code);
+  act_Vector *mapped = act_parallelMap(&pool, empty, sizeof(double),
+                                       halveValue, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(mapped, &err_code) == 0);
+  act_vectorFree(mapped, &err_code);
+
+  act_parallelMap(&pool, values, 0, halveValue, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_INVALID_DATA_SIZE);
+  act_parallelMap(&pool, values, 8, NULL, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_NULL_FUNCTION);
+  act_parallelMap(NULL, values, 8, halveValue, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_NULL_POOL);
+
+  act_vectorFree(empty, &err_code);
+  act_vectorFree(values, &err_code);
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_PARALLEL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canFilterInParallel(void) {
+  int err_code = ACT_PARALLEL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, false, &err_code);
+  ACT_VEC(uint64_t) values = randomValues(NUM_VALUES, 1000000, &err_code);
+
+  // Every divisor keeps a different share of the elements, in order
+  uint64_t divisors[] = {1, 2, 7, 1000, 2000000};
+  for (size_t d = 0; d < 5; d++) {
+    Divisor divisor = {.divisor = divisors[d]};
+    uint64_t *kept = act_parallelFilter(&pool, values, isMultiple, &divisor,
+                                        &err_code);
+    TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+    TEST_CHECK(atomic_load(&divisor.calls) == NUM_VALUES);
+
+    size_t len = act_vectorLen(kept, &err_code);
+    size_t j = 0;
+    bool ok = true;
+    for (size_t i = 0; i < NUM_VALUES; i++) {
+      if (values[i] % divisors[d] == 0) {
+        ok &= j < len && kept[j++] == values[i];
+      }
+    }
+    TEST_CHECK(ok && j == len);
+    act_vectorFree(kept, &err_code);
+  }
+
+  Divisor divisor = {.divisor = 1};
+  act_Vector *empty = ACT_VEC_NEW(uint64_t, &GPA, &err_code);
+  act_Vector *filtered =
+      act_parallelFilter(&pool, empty, isMultiple, &divisor, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(filtered, &err_code) == 0);
+  act_vectorFree(filtered, &err_code);
+
+  act_parallelFilter(&pool, NULL, isMultiple, &divisor, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_NULL_VECTOR);
+
+  act_vectorFree(empty, &err_code);
+  act_vectorFree(values, &err_code);
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_PARALLEL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canReduceInParallel(void) {
+  int err_code = ACT_PARALLEL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, false, &err_code);
+
+  // The elements are combined in order
+  ACT_VEC(Affine) functions = ACT_VEC_WCAP(Affine, &GPA, NUM_VALUES, &err_code);
+  uint64_t state = 7;
+  Affine expected = {.a = 1, .b = 0};
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    Affine f = {.a = nextRandom(&state) | 1, .b = nextRandom(&state)};
+    ACT_VEC_PUSH(functions, f, &err_code);
+    composeAffine(&expected, &f, NULL);
+  }
+  Affine identity = {.a = 1, .b = 0};
+  Affine result;
+  act_parallelReduce(&pool, functions, &identity, &result, composeAffine,
+                     NULL, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+  TEST_CHECK(result.a == expected.a && result.b == expected.b);
+
+  ACT_VEC(uint64_t) values = randomValues(NUM_VALUES, 1 << 20, &err_code);
+  ACT_VEC(int64_t) signed_values =
+      ACT_VEC_WCAP(int64_t, &GPA, NUM_VALUES, &err_code);
+  ACT_VEC(double) doubles = ACT_VEC_WCAP(double, &GPA, NUM_VALUES, &err_code);
+  uint64_t sum = 0;
+  int64_t signed_sum = 0;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    int64_t value = (int64_t)values[i] - (1 << 19);
+    ACT_VEC_PUSH(signed_values, value, &err_code);
+    ACT_VEC_PUSH(doubles, (double)values[i], &err_code);
+    sum += values[i];
+    signed_sum += value;
+  }
+  TEST_CHECK(act_parallelSumU64(&pool, values, &err_code) == sum);
+  TEST_CHECK(act_parallelSumI64(&pool, signed_values, &err_code) ==
+             signed_sum);
+  TEST_CHECK(act_parallelSumF64(&pool, doubles, &err_code) == (double)sum);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+
+  act_parallelSumU64(&pool, functions, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_INVALID_DATA_SIZE);
+  act_parallelReduce(&pool, functions, NULL, &result, composeAffine, NULL,
+                     &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_NULL_ELEMENT);
+
+  act_Vector *empty = ACT_VEC_NEW(uint64_t, &GPA, &err_code);
+  TEST_CHECK(act_parallelSumU64(&pool, empty, &err_code) == 0);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+
+  act_vectorFree(empty, &err_code);
+  act_vectorFree(doubles, &err_code);
+  act_vectorFree(signed_values, &err_code);
+  act_vectorFree(values, &err_code);
+  act_vectorFree(functions, &err_code);
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_PARALLEL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canScanInParallel(void) {
+  int err_code = ACT_PARALLEL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, false, &err_code);
+
+  ACT_VEC(Affine) inclusive = ACT_VEC_WCAP(Affine, &GPA, NUM_VALUES, &err_code);
+  ACT_VEC(Affine) exclusive = ACT_VEC_WCAP(Affine, &GPA, NUM_VALUES, &err_code);
+  uint64_t state = 11;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    Affine f = {.a = nextRandom(&state) | 1, .b = nextRandom(&state)};
+    ACT_VEC_PUSH(inclusive, f, &err_code);
+    ACT_VEC_PUSH(exclusive, f, &err_code);
+  }
+  Affine identity = {.a = 1, .b = 0};
+  act_parallelInclusiveScan(&pool, inclusive, &identity, composeAffine, NULL,
+                            &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+  act_parallelExclusiveScan(&pool, exclusive, &identity, composeAffine, NULL,
+                            &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+
+  // Each exclusive prefix, then the element, gives the inclusive prefix, and
+  // the exclusive prefixes are the inclusive prefixes shifted by one
+  state = 11;
+  bool ok = exclusive[0].a == 1 && exclusive[0].b == 0;
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    Affine f = {.a = nextRandom(&state) | 1, .b = nextRandom(&state)};
+    Affine prefix = exclusive[i];
+    composeAffine(&prefix, &f, NULL);
+    ok &= prefix.a == inclusive[i].a && prefix.b == inclusive[i].b;
+    if (i > 0) {
+      ok &= exclusive[i].a == inclusive[i - 1].a &&
+            exclusive[i].b == inclusive[i - 1].b;
+    }
+  }
+  TEST_CHECK(ok);
+
+  // Numeric scans, of two copies of the same values
+  ACT_VEC(uint64_t) values = randomValues(NUM_VALUES, 1000, &err_code);
+  ACT_VEC(uint64_t) prefixes = randomValues(NUM_VALUES, 1000, &err_code);
+  ACT_VEC(double) doubles = ACT_VEC_WCAP(double, &GPA, NUM_VALUES, &err_code);
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    ACT_VEC_PUSH(doubles, (double)values[i], &err_code);
+  }
+  act_parallelInclusiveScanU64(&pool, values, &err_code);
+  act_parallelExclusiveScanU64(&pool, prefixes, &err_code);
+  act_parallelExclusiveScanF64(&pool, doubles, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_SUCCESS);
+  ok = prefixes[0] == 0;
+  for (size_t i = 1; i < NUM_VALUES; i++) {
+    ok &= prefixes[i] == values[i - 1] && doubles[i] == (double)prefixes[i];
+  }
+  TEST_CHECK(ok);
+
+  ACT_VEC(int64_t) signed_values = ACT_VEC_NEW(int64_t, &GPA, &err_code);
+  int64_t signed_input[] = {5, -3, -10, 4, 0};
+  int64_t signed_expected[] = {5, 2, -8, -4, -4};
+  for (size_t i = 0; i < 5; i++) {
+    ACT_VEC_PUSH(signed_values, signed_input[i], &err_code);
+  }
+  act_parallelInclusiveScanI64(&pool, signed_values, &err_code);
+  ok = true;
+  for (size_t i = 0; i < 5; i++) {
+    ok &= signed_values[i] == signed_expected[i];
+  }
+  TEST_CHECK(ok);
+
+  act_parallelInclusiveScanF64(&pool, inclusive, &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_INVALID_DATA_SIZE);
+  act_parallelExclusiveScan(&pool, exclusive, &identity, NULL, NULL,
+                            &err_code);
+  TEST_CHECK(err_code == ACT_PARALLEL_ERROR_NULL_FUNCTION);
+
+  err_code = ACT_PARALLEL_ERROR_SUCCESS;
+  act_vectorFree(signed_values, &err_code);
+  act_vectorFree(doubles, &err_code);
+  act_vectorFree(prefixes, &err_code);
+  act_vectorFree(values, &err_code);
+  act_vectorFree(exclusive, &err_code);
+  act_vectorFree(inclusive, &err_code);
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_PARALLEL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[PARALLEL] Can map in parallel", test_canMapInParallel},
+    {"[PARALLEL] Can filter in parallel", test_canFilterInParallel},
+    {"[PARALLEL] Can reduce in parallel", test_canReduceInParallel},
+    {"[PARALLEL] Can scan in parallel", test_canScanInParallel},
+    {NULL, NULL}};
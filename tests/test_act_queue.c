@@ -0,0 +1,294 @@
+#include "act_allocator.h"
+#include "act_queue.h"
+#include "acutest.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// The number of elements each producer hands over in the threaded tests.
+#define NUM_ITEMS 200000
+
+void test_canPushAndPopFromSpscQueue(void) {
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+  act_SpscQueue queue =
+      act_spscQueueNew(&GPA, sizeof(uint64_t), 100, &err_code);
+
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_SUCCESS);
+  TEST_CHECK(act_spscQueueCapacity(&queue) == 128);
+
+  uint64_t value = 0;
+  TEST_CHECK(!act_spscQueuePop(&queue, &value, &err_code));
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_EMPTY);
+
+  // Fill the queue, then check it's FIFO
+  for (uint64_t i = 0; i < 128; i++) {
+    TEST_CHECK(act_spscQueuePush(&queue, &i, &err_code));
+  }
+  TEST_CHECK(!act_spscQueuePush(&queue, &value, &err_code));
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_FULL);
+  TEST_CHECK(act_spscQueueLen(&queue) == 128);
+  for (uint64_t i = 0; i < 128; i++) {
+    TEST_CHECK(act_spscQueuePop(&queue, &value, &err_code) && value == i);
+  }
+
+  // Batches wrap around the end of the ring
+  uint64_t batch[100];
+  uint64_t out[100];
+  uint64_t next_in = 0;
+  uint64_t next_out = 0;
+  bool ok = true;
+  for (size_t round = 0; round < 100; round++) {
+    for (size_t i = 0; i < 100; i++) {
+      batch[i] = next_in + i;
+    }
+    size_t pushed = act_spscQueuePushMany(&queue, batch, 100, &err_code);
+    ok &= pushed == 100 || err_code == ACT_QUEUE_ERROR_FULL;
+    next_in += pushed;
+
+    size_t popped = act_spscQueuePopMany(&queue, out, 70, &err_code);
+    for (size_t i = 0; i < popped; i++) {
+      ok &= out[i] == next_out++;
+    }
+  }
+  TEST_CHECK(ok);
+  TEST_CHECK(act_spscQueueLen(&queue) == next_in - next_out);
+
+  act_spscQueueNew(&GPA, 0, 8, &err_code);
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_INVALID_DATA_SIZE);
+  act_spscQueueNew(&GPA, 8, 0, &err_code);
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_INVALID_CAPACITY);
+
+  act_spscQueueFree(&queue, &err_code);
+
+  if (err_code != ACT_QUEUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canPushAndPopFromMpmcQueue(void) {
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  // An odd element size makes slots that aren't a power of two apart
+  typedef struct Item {
+    uint32_t id;
+    char tag[9];
+  } Item;
+  act_MpmcQueue queue = act_mpmcQueueNew(&GPA, sizeof(Item), 1, &err_code);
+  TEST_CHECK(act_mpmcQueueCapacity(&queue) == 2);
+  act_mpmcQueueFree(&queue, &err_code);
+
+  queue = act_mpmcQueueNew(&GPA, sizeof(Item), 64, &err_code);
+  Item item = {0};
+  TEST_CHECK(!act_mpmcQueuePop(&queue, &item, &err_code));
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_EMPTY);
+
+  for (uint32_t i = 0; i < 64; i++) {
+    item = (Item){.id = i, .tag = "item"};
+    TEST_CHECK(act_mpmcQueuePush(&queue, &item, &err_code));
+  }
+  TEST_CHECK(!act_mpmcQueuePush(&queue, &item, &err_code));
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_FULL);
+  TEST_CHECK(act_mpmcQueueLen(&queue) == 64);
+
+  // Batches pop what's there, and push what fits
+  Item out[100];
+  TEST_CHECK(act_mpmcQueuePopMany(&queue, out, 40, &err_code) == 40);
+  TEST_CHECK(out[0].id == 0 && out[39].id == 39);
+  TEST_CHECK(act_mpmcQueuePushMany(&queue, out, 100, &err_code) == 40);
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_FULL);
+  TEST_CHECK(act_mpmcQueuePopMany(&queue, out, 100, &err_code) == 64);
+  TEST_CHECK(out[0].id == 40 && out[23].id == 63 && out[24].id == 0 &&
+             out[63].id == 39);
+  TEST_CHECK(act_mpmcQueueLen(&queue) == 0);
+
+  // Empty batches are no-ops, with or without a buffer
+  TEST_CHECK(act_mpmcQueuePushMany(&queue, NULL, 0, &err_code) == 0);
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_SUCCESS);
+  TEST_CHECK(act_mpmcQueuePopMany(&queue, NULL, 0, &err_code) == 0);
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_SUCCESS);
+  act_mpmcQueuePushMany(&queue, NULL, 1, &err_code);
+  TEST_CHECK(err_code == ACT_QUEUE_ERROR_NULL_ELEMENT);
+  err_code = ACT_QUEUE_ERROR_SUCCESS;
+
+  act_mpmcQueueFree(&queue, &err_code);
+
+  if (err_code != ACT_QUEUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// The consumer of #test_canHandOverBetweenThreadsWithSpscQueue.
+static void *spscConsumer(void *arg) {
+  act_SpscQueue *queue = arg;
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+  uint64_t out[32];
+  uint64_t expected = 0;
+  bool ok = true;
+  while (expected < NUM_ITEMS) {
+    size_t popped = act_spscQueuePopMany(queue, out, 32, &err_code);
+    if (popped == 0) {
+      sched_yield();
+    }
+    for (size_t i = 0; i < popped; i++) {
+      ok &= out[i] == expected++;
+    }
+  }
+  return ok ? arg : NULL;
+}
+
+void test_canHandOverBetweenThreadsWithSpscQueue(void) {
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+  act_SpscQueue queue =
+      act_spscQueueNew(&GPA, sizeof(uint64_t), 256, &err_code);
+
+  pthread_t consumer;
+  TEST_ASSERT(pthread_create(&consumer, NULL, spscConsumer, &queue) == 0);
+
+  // Mix single and batch pushes
+  uint64_t batch[16];
+  for (uint64_t next = 0; next < NUM_ITEMS;) {
+    if (next % 3 == 0) {
+      if (!act_spscQueuePush(&queue, &next, &err_code)) {
+        sched_yield();
+        continue;
+      }
+      next++;
+      continue;
+    }
+
+    size_t count = NUM_ITEMS - next < 16 ? NUM_ITEMS - next : 16;
+    for (size_t i = 0; i < count; i++) {
+      batch[i] = next + i;
+    }
+    size_t pushed = act_spscQueuePushMany(&queue, batch, count, &err_code);
+    if (pushed == 0) {
+      sched_yield();
+    }
+    next += pushed;
+  }
+
+  void *result = NULL;
+  pthread_join(consumer, &result);
+  TEST_CHECK(result != NULL);
+  TEST_CHECK(act_spscQueueLen(&queue) == 0);
+
+  act_spscQueueFree(&queue, &err_code);
+
+  if (err_code != ACT_QUEUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// The shared state of #test_canHandOverBetweenThreadsWithMpmcQueue.
+typedef struct MpmcState {
+  act_MpmcQueue queue;
+  atomic_uint next_producer;
+  atomic_size_t consumed;
+  atomic_size_t bad_orders;
+  atomic_uint_least64_t sum;
+} MpmcState;
+
+/// The number of producers (and consumers) in the MPMC test.
+#define NUM_THREADS 4
+
+/// Pushes the ids of one producer (tagged with it), in order.
+static void *mpmcProducer(void *arg) {
+  MpmcState *state = arg;
+  uint64_t producer = atomic_fetch_add(&state->next_producer, 1);
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+  uint64_t batch[8];
+  for (uint64_t next = 0; next < NUM_ITEMS;) {
+    size_t count = (next % 5) + 1;
+    count = NUM_ITEMS - next < count ? NUM_ITEMS - next : count;
+    for (size_t i = 0; i < count; i++) {
+      batch[i] = producer << 32 | (next + i);
+    }
+    size_t pushed =
+        act_mpmcQueuePushMany(&state->queue, batch, count, &err_code);
+    if (pushed == 0) {
+      sched_yield();
+    }
+    next += pushed;
+  }
+  return NULL;
+}
+
+/// Pops until every element is consumed, checking each producer's elements
+/// arrive in order.
+static void *mpmcConsumer(void *arg) {
+  MpmcState *state = arg;
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+  int64_t last[NUM_THREADS] = {-1, -1, -1, -1};
+  uint64_t out[8];
+  uint64_t sum = 0;
+  while (atomic_load(&state->consumed) < NUM_THREADS * NUM_ITEMS) {
+    size_t popped = act_mpmcQueuePopMany(&state->queue, out, 8, &err_code);
+    if (popped == 0) {
+      sched_yield();
+      continue;
+    }
+    for (size_t i = 0; i < popped; i++) {
+      uint64_t producer = out[i] >> 32;
+      int64_t id = (int64_t)(out[i] & 0xFFFFFFFF);
+      if (id <= last[producer]) {
+        atomic_fetch_add(&state->bad_orders, 1);
+      }
+      last[producer] = id;
+      sum += (uint64_t)id;
+    }
+    atomic_fetch_add(&state->consumed, popped);
+  }
+  atomic_fetch_add(&state->sum, sum);
+  return NULL;
+}
+
+void test_canHandOverBetweenThreadsWithMpmcQueue(void) {
+  int err_code = ACT_QUEUE_ERROR_SUCCESS;
+  MpmcState state = {
+      .queue = act_mpmcQueueNew(&GPA, sizeof(uint64_t), 64, &err_code),
+  };
+  atomic_init(&state.next_producer, 0);
+  atomic_init(&state.consumed, 0);
+  atomic_init(&state.bad_orders, 0);
+  atomic_init(&state.sum, 0);
+
+  pthread_t producers[NUM_THREADS];
+  pthread_t consumers[NUM_THREADS];
+  for (size_t i = 0; i < NUM_THREADS; i++) {
+    TEST_ASSERT(pthread_create(&consumers[i], NULL, mpmcConsumer, &state) ==
+                0);
+    TEST_ASSERT(pthread_create(&producers[i], NULL, mpmcProducer, &state) ==
+                0);
+  }
+  for (size_t i = 0; i < NUM_THREADS; i++) {
+    pthread_join(producers[i], NULL);
+    pthread_join(consumers[i], NULL);
+  }
+
+  // Every element arrived exactly once
+  uint64_t expected_sum =
+      (uint64_t)NUM_THREADS * NUM_ITEMS * (NUM_ITEMS - 1) / 2;
+  TEST_CHECK(atomic_load(&state.consumed) == NUM_THREADS * NUM_ITEMS);
+  TEST_CHECK(atomic_load(&state.sum) == expected_sum);
+  TEST_CHECK(atomic_load(&state.bad_orders) == 0);
+  TEST_CHECK(act_mpmcQueueLen(&state.queue) == 0);
+
+  act_mpmcQueueFree(&state.queue, &err_code);
+
+  if (err_code != ACT_QUEUE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[QUEUE] Can push and pop from act_SpscQueue",
+     test_canPushAndPopFromSpscQueue},
+    {"[QUEUE] Can push and pop from act_MpmcQueue",
+     test_canPushAndPopFromMpmcQueue},
+    {"[QUEUE] Can hand over between threads with act_SpscQueue",
+     test_canHandOverBetweenThreadsWithSpscQueue},
+    {"[QUEUE] Can hand over between threads with act_MpmcQueue",
+     test_canHandOverBetweenThreadsWithMpmcQueue},
+    {NULL, NULL}};
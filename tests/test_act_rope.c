@@ -0,0 +1,180 @@
+#include "act_allocator.h"
+#include "act_rope.h"
+#include "act_string.h"
+#include "acutest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_canCreateRopeFromString(void) {
+  int err_code = ACT_ROPE_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+
+  act_Rope empty = act_ropeNew(&GPA, &err_code);
+  TEST_CHECK(act_ropeLen(&empty) == 0);
+  act_ropeFree(&empty, &err_code);
+
+  act_String str = act_stringFromCstr(&GPA, "Hello World!", &str_err);
+  act_Rope rope = act_ropeFromString(&str, &err_code);
+  TEST_CHECK(act_ropeLen(&rope) == 12);
+  TEST_CHECK(act_ropeCharAt(&rope, 6, &err_code) == 'W');
+
+  act_String back = act_ropeToString(&rope, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(back), "Hello World!") == 0);
+  TEST_CHECK(act_stringLen(back) == 12);
+
+  act_stringFree(&str, &str_err);
+  act_stringFree(&back, &str_err);
+  act_ropeFree(&rope, &err_code);
+
+  if (err_code != ACT_ROPE_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInsertAndDeleteInRope(void) {
+  int err_code = ACT_ROPE_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+
+  act_Rope rope =
+      act_ropeFromView(&GPA, act_stringViewFromCstr("Hello!"), &err_code);
+  act_ropeInsert(&rope, 5, act_stringViewFromCstr(" World"), &err_code);
+  act_ropeInsert(&rope, 0, act_stringViewFromCstr(">> "), &err_code);
+  act_ropeDelete(&rope, 3, 6, &err_code);
+  if (err_code != ACT_ROPE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  act_String str = act_ropeToString(&rope, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), ">> World!") == 0);
+  act_stringFree(&str, &str_err);
+
+  act_ropeDelete(&rope, 5, 10, &err_code);
+  TEST_CHECK(err_code == ACT_ROPE_ERROR_INDEX_OUT_OF_BOUNDS);
+
+  act_ropeFree(&rope, &err_code);
+
+  if (err_code != ACT_ROPE_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canEditLargeRope(void) {
+  int err_code = ACT_ROPE_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+
+  // Mirror random edits in a flat buffer and compare the results
+  const size_t INITIAL_LEN = 50000;
+  const size_t MAX_LEN = 200000;
+  char *expected = malloc(MAX_LEN);
+  for (size_t i = 0; i < INITIAL_LEN; i++) {
+    expected[i] = (char)('a' + (i % 26));
+  }
+  size_t len = INITIAL_LEN;
+
+  act_Rope rope = act_ropeFromView(
+      &GPA, (act_StringView){.data = expected, .len = len}, &err_code);
+
+  srand(42);
+  char piece[3000];
+  for (size_t op = 0; op < 2000; op++) {
+    size_t idx = (size_t)rand() % (len + 1);
+    if (rand() % 3 != 0 && len < MAX_LEN - sizeof(piece)) {
+      size_t piece_len = 1 + (size_t)rand() % (rand() % 8 == 0 ? 3000 : 4);
+      for (size_t i = 0; i < piece_len; i++) {
+        piece[i] = (char)('A' + rand() % 26);
+      }
+      act_ropeInsert(&rope, idx,
+                     (act_StringView){.data = piece, .len = piece_len},
+                     &err_code);
+      memmove(expected + idx + piece_len, expected + idx, len - idx);
+      memcpy(expected + idx, piece, piece_len);
+      len += piece_len;
+    } else {
+      size_t del_len = (size_t)rand() % (len - idx + 1);
+      del_len = del_len > 500 ? 500 : del_len;
+      act_ropeDelete(&rope, idx, del_len, &err_code);
+      memmove(expected + idx, expected + idx + del_len, len - idx - del_len);
+      len -= del_len;
+    }
+    TEST_ASSERT(err_code == ACT_ROPE_ERROR_SUCCESS);
+    TEST_ASSERT(act_ropeLen(&rope) == len);
+  }
+
+  act_String str = act_ropeToString(&rope, &err_code);
+  TEST_CHECK(act_stringLen(str) == len);
+  TEST_CHECK(memcmp(act_stringAsCstr(str), expected, len) == 0);
+  act_stringFree(&str, &str_err);
+
+  // Split in the middle and put the halves back in swapped order
+  size_t mid = len / 3;
+  act_Rope back = act_ropeSplit(&rope, mid, &err_code);
+  TEST_CHECK(act_ropeLen(&rope) == mid);
+  TEST_CHECK(act_ropeLen(&back) == len - mid);
+  act_ropeConcat(&back, &rope, &err_code);
+  TEST_CHECK(act_ropeLen(&rope) == 0);
+  TEST_CHECK(act_ropeCharAt(&back, 0, &err_code) == expected[mid]);
+  TEST_CHECK(act_ropeCharAt(&back, len - mid, &err_code) == expected[0]);
+
+  // Iterating the chunks visits every character in order
+  size_t offset = 0;
+  bool matches = true;
+  act_StringView chunk;
+  act_RopeChunkIter iter = act_ropeChunkIter(&back);
+  while (act_ropeChunkIterNext(&iter, &chunk)) {
+    for (size_t i = 0; i < chunk.len; i++) {
+      matches &= chunk.data[i] == expected[(mid + offset + i) % len];
+    }
+    offset += chunk.len;
+  }
+  TEST_CHECK(matches);
+  TEST_CHECK(offset == len);
+
+  free(expected);
+  act_ropeFree(&rope, &err_code);
+  act_ropeFree(&back, &err_code);
+
+  if (err_code != ACT_ROPE_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canAppendManySmallPiecesToRope(void) {
+  int err_code = ACT_ROPE_ERROR_SUCCESS;
+
+  // Keystroke-sized edits are merged into chunks instead of one per edit
+  const size_t NUM_EDITS = 100000;
+  act_Rope rope = act_ropeNew(&GPA, &err_code);
+  for (size_t i = 0; i < NUM_EDITS; i++) {
+    char c = (char)('a' + (i % 26));
+    act_ropeInsert(&rope, act_ropeLen(&rope),
+                   (act_StringView){.data = &c, .len = 1}, &err_code);
+  }
+  TEST_CHECK(act_ropeLen(&rope) == NUM_EDITS);
+
+  size_t num_chunks = 0;
+  act_StringView chunk;
+  act_RopeChunkIter iter = act_ropeChunkIter(&rope);
+  while (act_ropeChunkIterNext(&iter, &chunk)) {
+    num_chunks++;
+  }
+  TEST_CHECK(num_chunks <= NUM_EDITS / 500);
+  TEST_MSG("chunks: %zu", num_chunks);
+
+  act_ropeFree(&rope, &err_code);
+
+  if (err_code != ACT_ROPE_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[ROPE] Can create act_Rope from act_String", test_canCreateRopeFromString},
+    {"[ROPE] Can insert and delete in act_Rope", test_canInsertAndDeleteInRope},
+    {"[ROPE] Can edit large act_Rope", test_canEditLargeRope},
+    {"[ROPE] Can append many small pieces to act_Rope",
+     test_canAppendManySmallPiecesToRope},
+    {NULL, NULL}};
@@ -0,0 +1,513 @@
+#include "act_allocator.h"
+#include "act_sort.h"
+#include "act_string.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+typedef struct Record {
+  uint32_t key;
+  uint32_t order;
+  char payload[92];
+} Record;
+
+static int compareRecord(const void *a, const void *b) {
+  const Record *x = a;
+  const Record *y = b;
+  return (x->key > y->key) - (x->key < y->key);
+}
+
+static int compareU32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int compareI64(const void *a, const void *b) {
+  int64_t x = *(const int64_t *)a;
+  int64_t y = *(const int64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int compareF64(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static uint64_t recordKey(const void *element) {
+  return ((const Record *)element)->key;
+}
+
+static int compareView(const void *a, const void *b) {
+  return act_stringViewLexCompare(*(const act_StringView *)a,
+                                  *(const act_StringView *)b);
+}
+
+/// A simple LCG, so tests are deterministic.
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+/// Fills the vector with one of several patterns that trip up quicksorts.
+static ACT_VEC(uint64_t) makePattern(size_t pattern, size_t len, int *err) {
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, len, err);
+  uint64_t state = pattern + 1;
+  for (size_t i = 0; i < len; i++) {
+    uint64_t value = 0;
+    switch (pattern) {
+    case 0: // Random
+      value = nextRandom(&state);
+      break;
+    case 1: // Sorted
+      value = i;
+      break;
+    case 2: // Reversed
+      value = len - i;
+      break;
+    case 3: // All equal
+      value = 7;
+      break;
+    case 4: // Few distinct values
+      value = nextRandom(&state) % 4;
+      break;
+    case 5: // Organ pipe
+      value = i < len / 2 ? i : len - i;
+      break;
+    default: // Sorted, with a few random swaps
+      value = i % 100 == 0 ? nextRandom(&state) : i;
+      break;
+    }
+    ACT_VEC_PUSH(vec, value, err);
+  }
+  return vec;
+}
+
+void test_canSortVector(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {0, 1, 2, 23, 24, 100, 129, 1000, 50000};
+
+  for (size_t pattern = 0; pattern < 7; pattern++) {
+    for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+      size_t len = LENS[l];
+      ACT_VEC(uint64_t) vec = makePattern(pattern, len, &vec_err);
+      ACT_VEC(uint64_t) expected = makePattern(pattern, len, &vec_err);
+      qsort(expected, len, sizeof(uint64_t), compareU64);
+
+      act_vectorSort(vec, compareU64, &err_code);
+      TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+      TEST_CHECK(memcmp(vec, expected, len * sizeof(uint64_t)) == 0);
+      TEST_MSG("pattern %zu, length %zu", pattern, len);
+
+      act_vectorFree(vec, &vec_err);
+      act_vectorFree(expected, &vec_err);
+    }
+  }
+
+  act_vectorSort(NULL, compareU64, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_NULL_VECTOR);
+  err_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canSortVectorStably(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  // Records are larger than the scratch space kept on the stack
+  const size_t NUM_RECORDS = 20000;
+  ACT_VEC(Record) vec = ACT_VEC_WCAP(Record, &GPA, NUM_RECORDS, &vec_err);
+  uint64_t state = 3;
+  for (uint32_t i = 0; i < NUM_RECORDS; i++) {
+    Record record = {.key = (uint32_t)(nextRandom(&state) % 64), .order = i};
+    ACT_VEC_PUSH(vec, record, &vec_err);
+  }
+
+  act_vectorSortStable(vec, compareRecord, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+  for (size_t i = 1; i < NUM_RECORDS; i++) {
+    TEST_CHECK(vec[i - 1].key < vec[i].key ||
+               (vec[i - 1].key == vec[i].key &&
+                vec[i - 1].order < vec[i].order));
+  }
+
+  // The unstable sort works on large elements too
+  act_vectorSort(vec, compareRecord, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+  for (size_t i = 1; i < NUM_RECORDS; i++) {
+    TEST_CHECK(vec[i - 1].key <= vec[i].key);
+  }
+
+  act_vectorFree(vec, &vec_err);
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canSortVectorInParallel(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t THREADS[] = {0, 2, 3, 8};
+
+  for (size_t pattern = 0; pattern < 7; pattern++) {
+    for (size_t t = 0; t < sizeof(THREADS) / sizeof(*THREADS); t++) {
+      const size_t LEN = 100003;
+      ACT_VEC(uint64_t) vec = makePattern(pattern, LEN, &vec_err);
+      ACT_VEC(uint64_t) expected = makePattern(pattern, LEN, &vec_err);
+      qsort(expected, LEN, sizeof(uint64_t), compareU64);
+
+      act_vectorSortParallel(vec, compareU64, THREADS[t], &err_code);
+      TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+      TEST_CHECK(memcmp(vec, expected, LEN * sizeof(uint64_t)) == 0);
+      TEST_MSG("pattern %zu, %zu threads", pattern, THREADS[t]);
+
+      act_vectorFree(vec, &vec_err);
+      act_vectorFree(expected, &vec_err);
+    }
+  }
+
+  const size_t NUM_RECORDS = 50000;
+  ACT_VEC(Record) records = ACT_VEC_WCAP(Record, &GPA, NUM_RECORDS, &vec_err);
+  uint64_t state = 5;
+  for (uint32_t i = 0; i < NUM_RECORDS; i++) {
+    Record record = {.key = (uint32_t)(nextRandom(&state) % 16), .order = i};
+    ACT_VEC_PUSH(records, record, &vec_err);
+  }
+
+  act_vectorSortStableParallel(records, compareRecord, 4, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+  for (size_t i = 1; i < NUM_RECORDS; i++) {
+    TEST_CHECK(records[i - 1].key < records[i].key ||
+               (records[i - 1].key == records[i].key &&
+                records[i - 1].order < records[i].order));
+  }
+
+  act_vectorFree(records, &vec_err);
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canSelectNthElement(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {1, 2, 23, 100, 1000, 50000};
+
+  for (size_t pattern = 0; pattern < 7; pattern++) {
+    for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+      size_t len = LENS[l];
+      ACT_VEC(uint64_t) expected = makePattern(pattern, len, &vec_err);
+      qsort(expected, len, sizeof(uint64_t), compareU64);
+
+      const size_t NTHS[] = {0, len / 3, len / 2, len - 1};
+      for (size_t n = 0; n < sizeof(NTHS) / sizeof(*NTHS); n++) {
+        size_t nth = NTHS[n];
+        ACT_VEC(uint64_t) vec = makePattern(pattern, len, &vec_err);
+
+        act_vectorNthElement(vec, nth, compareU64, &err_code);
+        TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+        TEST_CHECK(vec[nth] == expected[nth]);
+        for (size_t i = 0; i < len; i++) {
+          if ((i < nth && vec[i] > vec[nth]) ||
+              (i > nth && vec[i] < vec[nth])) {
+            TEST_CHECK(false);
+            break;
+          }
+        }
+        TEST_MSG("pattern %zu, length %zu, nth %zu", pattern, len, nth);
+
+        act_vectorFree(vec, &vec_err);
+      }
+
+      act_vectorFree(expected, &vec_err);
+    }
+  }
+
+  // Records are larger than the scratch space kept on the stack
+  const size_t NUM_RECORDS = 5000;
+  ACT_VEC(Record) records = ACT_VEC_WCAP(Record, &GPA, NUM_RECORDS, &vec_err);
+  uint64_t state = 5;
+  for (uint32_t i = 0; i < NUM_RECORDS; i++) {
+    Record record = {.key = (uint32_t)nextRandom(&state), .order = i};
+    ACT_VEC_PUSH(records, record, &vec_err);
+  }
+  act_vectorNthElement(records, 100, compareRecord, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+  size_t smaller = 0;
+  for (size_t i = 0; i < NUM_RECORDS; i++) {
+    smaller += records[i].key < records[100].key;
+  }
+  TEST_CHECK(smaller == 100);
+  act_vectorFree(records, &vec_err);
+
+  // The index must be in bounds
+  ACT_VEC(uint64_t) empty = ACT_VEC_NEW(uint64_t, &GPA, &vec_err);
+  act_vectorNthElement(empty, 0, compareU64, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_INDEX_OUT_OF_BOUNDS);
+  act_vectorFree(empty, &vec_err);
+  err_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canPartialSortVector(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {0, 1, 2, 23, 100, 1000, 50000};
+
+  for (size_t pattern = 0; pattern < 7; pattern++) {
+    for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+      size_t len = LENS[l];
+      ACT_VEC(uint64_t) expected = makePattern(pattern, len, &vec_err);
+      qsort(expected, len, sizeof(uint64_t), compareU64);
+
+      const size_t KS[] = {0, 1, 10, len / 2, len, len + 5};
+      for (size_t n = 0; n < sizeof(KS) / sizeof(*KS); n++) {
+        size_t k = KS[n];
+        size_t sorted = k < len ? k : len;
+        ACT_VEC(uint64_t) vec = makePattern(pattern, len, &vec_err);
+
+        act_vectorPartialSort(vec, k, compareU64, &err_code);
+        TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+        TEST_CHECK(memcmp(vec, expected, sorted * sizeof(uint64_t)) == 0);
+        TEST_MSG("pattern %zu, length %zu, k %zu", pattern, len, k);
+
+        // The rest are the remaining elements
+        qsort(vec + sorted, len - sorted, sizeof(uint64_t), compareU64);
+        TEST_CHECK(memcmp(vec, expected, len * sizeof(uint64_t)) == 0);
+
+        act_vectorFree(vec, &vec_err);
+      }
+
+      act_vectorFree(expected, &vec_err);
+    }
+  }
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canRadixSortVector(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {0, 1, 100, 255, 256, 100000};
+
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    const size_t LEN = LENS[l];
+    ACT_VEC(uint32_t) u32s = ACT_VEC_WCAP(uint32_t, &GPA, LEN, &vec_err);
+    ACT_VEC(uint64_t) u64s = ACT_VEC_WCAP(uint64_t, &GPA, LEN, &vec_err);
+    ACT_VEC(int64_t) i64s = ACT_VEC_WCAP(int64_t, &GPA, LEN, &vec_err);
+    ACT_VEC(double) f64s = ACT_VEC_WCAP(double, &GPA, LEN, &vec_err);
+    uint64_t state = 11;
+    for (size_t i = 0; i < LEN; i++) {
+      uint64_t bits = nextRandom(&state) << 31 ^ nextRandom(&state);
+      uint32_t u32 = (uint32_t)bits;
+      int64_t i64 = (int64_t)(bits << 2);
+      double f64 = ((double)(bits % 2000001) - 1e6) * 1e-3;
+      ACT_VEC_PUSH(u32s, u32, &vec_err);
+      ACT_VEC_PUSH(u64s, bits, &vec_err);
+      ACT_VEC_PUSH(i64s, i64, &vec_err);
+      ACT_VEC_PUSH(f64s, f64, &vec_err);
+    }
+    if (LEN > 2) {
+      f64s[0] = INFINITY;
+      f64s[1] = -INFINITY;
+    }
+
+    uint32_t *u32_expected = malloc(LEN * sizeof(uint32_t) + 1);
+    uint64_t *u64_expected = malloc(LEN * sizeof(uint64_t) + 1);
+    int64_t *i64_expected = malloc(LEN * sizeof(int64_t) + 1);
+    double *f64_expected = malloc(LEN * sizeof(double) + 1);
+    memcpy(u32_expected, u32s, LEN * sizeof(uint32_t));
+    memcpy(u64_expected, u64s, LEN * sizeof(uint64_t));
+    memcpy(i64_expected, i64s, LEN * sizeof(int64_t));
+    memcpy(f64_expected, f64s, LEN * sizeof(double));
+    qsort(u32_expected, LEN, sizeof(uint32_t), compareU32);
+    qsort(u64_expected, LEN, sizeof(uint64_t), compareU64);
+    qsort(i64_expected, LEN, sizeof(int64_t), compareI64);
+    qsort(f64_expected, LEN, sizeof(double), compareF64);
+
+    act_vectorRadixSortU32(u32s, NULL, &err_code);
+    TEST_CHECK(memcmp(u32s, u32_expected, LEN * sizeof(uint32_t)) == 0);
+    act_vectorRadixSortU64(u64s, &GPA, &err_code);
+    TEST_CHECK(memcmp(u64s, u64_expected, LEN * sizeof(uint64_t)) == 0);
+    act_vectorRadixSortI64(i64s, NULL, &err_code);
+    TEST_CHECK(memcmp(i64s, i64_expected, LEN * sizeof(int64_t)) == 0);
+    act_vectorRadixSortF64(f64s, NULL, &err_code);
+    TEST_CHECK(memcmp(f64s, f64_expected, LEN * sizeof(double)) == 0);
+    TEST_MSG("length %zu", LEN);
+
+    free(u32_expected);
+    free(u64_expected);
+    free(i64_expected);
+    free(f64_expected);
+    act_vectorFree(u32s, &vec_err);
+    act_vectorFree(u64s, &vec_err);
+    act_vectorFree(i64s, &vec_err);
+    act_vectorFree(f64s, &vec_err);
+  }
+
+  // The element type must match
+  ACT_VEC(uint32_t) wrong = ACT_VEC_NEW(uint32_t, &GPA, &vec_err);
+  act_vectorRadixSortU64(wrong, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_INVALID_DATA_SIZE);
+  act_vectorFree(wrong, &vec_err);
+  err_code = ACT_SORT_ERROR_SUCCESS;
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canRadixSortVectorByKey(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {50, 20000};
+
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    const size_t LEN = LENS[l];
+    ACT_VEC(Record) vec = ACT_VEC_WCAP(Record, &GPA, LEN, &vec_err);
+    uint64_t state = 13;
+    for (uint32_t i = 0; i < LEN; i++) {
+      Record record = {.key = (uint32_t)(nextRandom(&state) % 1000),
+                       .order = i};
+      record.payload[0] = (char)i;
+      ACT_VEC_PUSH(vec, record, &vec_err);
+    }
+
+    act_vectorRadixSortByKey(vec, recordKey, NULL, &err_code);
+    TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+    for (size_t i = 0; i < LEN; i++) {
+      TEST_CHECK(vec[i].payload[0] == (char)vec[i].order);
+      if (i > 0) {
+        TEST_CHECK(vec[i - 1].key < vec[i].key ||
+                   (vec[i - 1].key == vec[i].key &&
+                    vec[i - 1].order < vec[i].order));
+      }
+    }
+
+    act_vectorFree(vec, &vec_err);
+  }
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// Builds pseudorandom URL-like strings into @em storage, with long shared
+/// prefixes, duplicates, prefixes of each other, and embedded null bytes.
+static ACT_VEC(act_StringView)
+    makeUrlViews(char *storage, size_t len, int *err) {
+  static const char *const HOSTS[] = {"https://example.com/",
+                                      "https://example.com/api/v1/users/",
+                                      "https://example.org/", "http://a/", ""};
+  ACT_VEC(act_StringView) views =
+      ACT_VEC_WCAP(act_StringView, &GPA, len, err);
+  uint64_t state = 17;
+  for (size_t i = 0; i < len; i++) {
+    char *str = storage + i * 64;
+    const char *host = HOSTS[nextRandom(&state) % 5];
+    size_t host_len = strlen(host);
+    memcpy(str, host, host_len);
+    size_t path_len = nextRandom(&state) % 12;
+    for (size_t c = 0; c < path_len; c++) {
+      str[host_len + c] = (char)("ab/\0\xFF"[nextRandom(&state) % 5]);
+    }
+    act_StringView view = {.data = str, .len = host_len + path_len};
+    ACT_VEC_PUSH(views, view, err);
+  }
+  return views;
+}
+
+void test_canSortStringVector(void) {
+  int err_code = ACT_SORT_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+  const size_t LENS[] = {0, 1, 10, 1000, 30000};
+
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    const size_t LEN = LENS[l];
+    char *storage = malloc(LEN * 64 + 1);
+    ACT_VEC(act_StringView) views = makeUrlViews(storage, LEN, &vec_err);
+    ACT_VEC(act_StringView) parallel = makeUrlViews(storage, LEN, &vec_err);
+    ACT_VEC(act_StringView) expected = makeUrlViews(storage, LEN, &vec_err);
+    qsort(expected, LEN, sizeof(act_StringView), compareView);
+
+    act_vectorSortStringViews(views, &err_code);
+    TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+    act_vectorSortStringViewsParallel(parallel, 4, &err_code);
+    TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+    for (size_t i = 0; i < LEN; i++) {
+      TEST_CHECK(compareView(&views[i], &expected[i]) == 0);
+      TEST_CHECK(compareView(&parallel[i], &expected[i]) == 0);
+    }
+    TEST_MSG("length %zu", LEN);
+
+    act_vectorFree(views, &vec_err);
+    act_vectorFree(parallel, &vec_err);
+    act_vectorFree(expected, &vec_err);
+    free(storage);
+  }
+
+  // Owned strings are moved, not copied
+  const char *const WORDS[] = {"pear", "apple", "", "peach", "apple pie",
+                               "app"};
+  const char *const SORTED[] = {"", "app", "apple", "apple pie", "peach",
+                                "pear"};
+  ACT_VEC(act_String) strings = ACT_VEC_NEW(act_String, &GPA, &vec_err);
+  for (size_t i = 0; i < 6; i++) {
+    act_String str = act_stringFromCstr(&GPA, WORDS[i], &str_err);
+    ACT_VEC_PUSH(strings, str, &vec_err);
+  }
+
+  act_vectorSortStrings(strings, &err_code);
+  TEST_CHECK(err_code == ACT_SORT_ERROR_SUCCESS);
+  for (size_t i = 0; i < 6; i++) {
+    TEST_CHECK(strcmp(act_stringAsCstr(strings[i]), SORTED[i]) == 0);
+    act_stringFree(&strings[i], &str_err);
+  }
+  act_vectorFree(strings, &vec_err);
+
+  if (err_code != ACT_SORT_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[SORT] Can sort act_Vector", test_canSortVector},
+    {"[SORT] Can stably sort act_Vector", test_canSortVectorStably},
+    {"[SORT] Can sort act_Vector in parallel", test_canSortVectorInParallel},
+    {"[SORT] Can select nth element of act_Vector", test_canSelectNthElement},
+    {"[SORT] Can partially sort act_Vector", test_canPartialSortVector},
+    {"[SORT] Can radix sort act_Vector", test_canRadixSortVector},
+    {"[SORT] Can radix sort act_Vector by key", test_canRadixSortVectorByKey},
+    {"[SORT] Can sort act_Vector of strings", test_canSortStringVector},
+    {NULL, NULL}};
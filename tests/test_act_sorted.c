@@ -0,0 +1,382 @@
+#include "act_allocator.h"
+#include "act_sorted.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int compareU32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static int compareU64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+typedef struct Entry {
+  uint32_t key;
+  uint32_t value;
+  char name[16];
+} Entry;
+
+/// Compares an entry to a bare key.
+static int compareEntryKey(const void *entry, const void *key) {
+  uint32_t x = ((const Entry *)entry)->key;
+  uint32_t y = *(const uint32_t *)key;
+  return (x > y) - (x < y);
+}
+
+/// A simple LCG, so tests are deterministic.
+static uint64_t nextRandom(uint64_t *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 33;
+}
+
+/// Returns a sorted vector of @em len even values, with runs of duplicates.
+static ACT_VEC(uint64_t) makeSorted(size_t len, int *err) {
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, len, err);
+  uint64_t value = 2;
+  for (size_t i = 0; i < len; i++) {
+    ACT_VEC_PUSH(vec, value, err);
+    value += i % 5 == 0 ? 0 : 2;
+  }
+  return vec;
+}
+
+void test_canSearchSortedVector(void) {
+  int err_code = ACT_SORTED_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {0, 1, 2, 3, 7, 8, 100, 1000};
+
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    size_t len = LENS[l];
+    ACT_VEC(uint64_t) vec = makeSorted(len, &vec_err);
+    uint64_t max = len == 0 ? 0 : vec[len - 1];
+
+    for (uint64_t key = 0; key <= max + 2; key++) {
+      // The expected bounds, by linear scan
+      size_t lower = 0;
+      while (lower < len && vec[lower] < key) {
+        lower++;
+      }
+      size_t upper = lower;
+      while (upper < len && vec[upper] == key) {
+        upper++;
+      }
+
+      TEST_CHECK(act_vectorLowerBound(vec, &key, compareU64, &err_code) ==
+                 lower);
+      TEST_CHECK(act_vectorUpperBound(vec, &key, compareU64, &err_code) ==
+                 upper);
+      size_t index = SIZE_MAX;
+      bool found =
+          act_vectorBinarySearch(vec, &key, compareU64, &index, &err_code);
+      TEST_CHECK(found == (lower != upper));
+      TEST_CHECK(index == lower);
+      TEST_MSG("length %zu, key %llu", len, (unsigned long long)key);
+    }
+
+    act_vectorFree(vec, &vec_err);
+  }
+
+  // The key may be part of an element
+  ACT_VEC(Entry) entries = ACT_VEC_NEW(Entry, &GPA, &vec_err);
+  for (uint32_t i = 0; i < 50; i++) {
+    Entry entry = {.key = i * 3, .value = i};
+    ACT_VEC_PUSH(entries, entry, &vec_err);
+  }
+  uint32_t key = 42;
+  size_t index = 0;
+  TEST_CHECK(act_vectorBinarySearch(entries, &key, compareEntryKey, &index,
+                                    &err_code));
+  TEST_CHECK(entries[index].value == 14);
+  key = 43;
+  TEST_CHECK(!act_vectorBinarySearch(entries, &key, compareEntryKey, NULL,
+                                     &err_code));
+  act_vectorFree(entries, &vec_err);
+
+  act_vectorLowerBound(NULL, &key, compareU64, &err_code);
+  TEST_CHECK(err_code == ACT_SORTED_ERROR_NULL_VECTOR);
+  err_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (err_code != ACT_SORTED_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canMergeSortedVectors(void) {
+  int err_code = ACT_SORTED_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  // Entries are tagged with the vector they came from
+  ACT_VEC(Entry) a = ACT_VEC_NEW(Entry, &GPA, &vec_err);
+  ACT_VEC(Entry) b = ACT_VEC_NEW(Entry, &GPA, &vec_err);
+  uint64_t state = 7;
+  uint32_t a_key = 0;
+  uint32_t b_key = 0;
+  for (size_t i = 0; i < 500; i++) {
+    a_key += (uint32_t)(nextRandom(&state) % 3);
+    b_key += (uint32_t)(nextRandom(&state) % 4);
+    Entry a_entry = {.key = a_key, .value = 0};
+    Entry b_entry = {.key = b_key, .value = 1};
+    ACT_VEC_PUSH(a, a_entry, &vec_err);
+    ACT_VEC_PUSH(b, b_entry, &vec_err);
+  }
+
+  ACT_VEC(Entry) merged = act_vectorMerge(a, b, compareEntryKey, &err_code);
+  TEST_CHECK(err_code == ACT_SORTED_ERROR_SUCCESS);
+  TEST_CHECK(act_vectorLen(merged, &vec_err) == 1000);
+  for (size_t i = 1; i < 1000; i++) {
+    TEST_CHECK(merged[i - 1].key < merged[i].key ||
+               (merged[i - 1].key == merged[i].key &&
+                merged[i - 1].value <= merged[i].value));
+  }
+  act_vectorFree(merged, &vec_err);
+
+  // Merging with an empty vector copies the other one
+  ACT_VEC(Entry) empty = ACT_VEC_NEW(Entry, &GPA, &vec_err);
+  merged = act_vectorMerge(empty, a, compareEntryKey, &err_code);
+  TEST_CHECK(act_vectorLen(merged, &vec_err) == 500);
+  TEST_CHECK(memcmp(merged, a, 500 * sizeof(Entry)) == 0);
+  act_vectorFree(merged, &vec_err);
+
+  // The data sizes must match
+  ACT_VEC(uint64_t) other = ACT_VEC_NEW(uint64_t, &GPA, &vec_err);
+  TEST_CHECK(act_vectorMerge(a, other, compareU64, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_SORTED_ERROR_INVALID_DATA_SIZE);
+  err_code = ACT_SORTED_ERROR_SUCCESS;
+
+  act_vectorFree(a, &vec_err);
+  act_vectorFree(b, &vec_err);
+  act_vectorFree(empty, &vec_err);
+  act_vectorFree(other, &vec_err);
+
+  if (err_code != ACT_SORTED_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canSearchEytzingerIndex(void) {
+  int err_code = ACT_SORTED_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+  const size_t LENS[] = {0, 1, 2, 3, 7, 8, 15, 16, 100, 1000};
+
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    size_t len = LENS[l];
+    ACT_VEC(uint64_t) vec = makeSorted(len, &vec_err);
+    ACT_VEC(uint32_t) vec32 = ACT_VEC_WCAP(uint32_t, &GPA, len, &vec_err);
+    for (size_t i = 0; i < len; i++) {
+      uint32_t value = (uint32_t)vec[i];
+      ACT_VEC_PUSH(vec32, value, &vec_err);
+    }
+    act_EytzingerIndex index =
+        act_eytzingerIndexNew(vec, compareU64, &err_code);
+    act_EytzingerIndex index32 =
+        act_eytzingerIndexNew(vec32, compareU32, &err_code);
+    TEST_CHECK(err_code == ACT_SORTED_ERROR_SUCCESS);
+    TEST_CHECK(act_eytzingerIndexLen(&index) == len);
+
+    uint64_t max = len == 0 ? 0 : vec[len - 1];
+    for (uint64_t key = 0; key <= max + 2; key++) {
+      size_t lower = act_vectorLowerBound(vec, &key, compareU64, &err_code);
+      const uint64_t *expected = lower < len ? &vec[lower] : NULL;
+
+      const uint64_t *found =
+          act_eytzingerIndexLowerBound(&index, &key, &err_code);
+      TEST_CHECK((found == NULL) == (expected == NULL));
+      TEST_CHECK(found == NULL || *found == *expected);
+
+      const uint64_t *found64 =
+          act_eytzingerIndexLowerBoundU64(&index, key, &err_code);
+      TEST_CHECK(found64 == found);
+      TEST_CHECK(found == NULL ||
+                 act_eytzingerIndexRank(&index, found, &err_code) == lower);
+
+      const uint32_t *found32 =
+          act_eytzingerIndexLowerBoundU32(&index32, (uint32_t)key, &err_code);
+      TEST_CHECK((found32 == NULL) == (expected == NULL));
+      TEST_CHECK(found32 == NULL || *found32 == *expected);
+
+      const uint64_t *exact = act_eytzingerIndexFind(&index, &key, &err_code);
+      TEST_CHECK((exact != NULL) == (expected != NULL && *expected == key));
+      TEST_MSG("length %zu, key %llu", len, (unsigned long long)key);
+    }
+
+    // Ranks are only defined for the index's elements
+    act_eytzingerIndexRank(&index, vec, &err_code);
+    TEST_CHECK(err_code == ACT_SORTED_ERROR_INVALID_ELEMENT);
+
+    // The typed searches need the matching element type
+    act_eytzingerIndexLowerBoundU32(&index, 0, &err_code);
+    TEST_CHECK(err_code == ACT_SORTED_ERROR_INVALID_DATA_SIZE);
+    err_code = ACT_SORTED_ERROR_SUCCESS;
+
+    act_eytzingerIndexFree(&index, &err_code);
+    act_eytzingerIndexFree(&index32, &err_code);
+    act_vectorFree(vec, &vec_err);
+    act_vectorFree(vec32, &vec_err);
+  }
+
+  // The index is searched by the comparator it was built with
+  ACT_VEC(Entry) entries = ACT_VEC_NEW(Entry, &GPA, &vec_err);
+  for (uint32_t i = 0; i < 1000; i++) {
+    Entry entry = {.key = i * 7, .value = i};
+    ACT_VEC_PUSH(entries, entry, &vec_err);
+  }
+  act_EytzingerIndex index =
+      act_eytzingerIndexNew(entries, compareEntryKey, &err_code);
+  act_vectorFree(entries, &vec_err);
+  uint32_t key = 700;
+  const Entry *entry = act_eytzingerIndexFind(&index, &key, &err_code);
+  TEST_CHECK(entry != NULL && entry->value == 100);
+  key = 701;
+  TEST_CHECK(act_eytzingerIndexFind(&index, &key, &err_code) == NULL);
+  entry = act_eytzingerIndexLowerBound(&index, &key, &err_code);
+  TEST_CHECK(entry != NULL && entry->value == 101);
+  act_eytzingerIndexFree(&index, &err_code);
+
+  // A freed index can't be searched
+  act_eytzingerIndexLowerBound(&index, &key, &err_code);
+  TEST_CHECK(err_code == ACT_SORTED_ERROR_NULL_INDEX);
+  err_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (err_code != ACT_SORTED_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// Returns a sorted set of @em len values, with gaps of up to @em max_gap
+/// between them, scaled by @em scale.
+static ACT_VEC(uint64_t) makeSet(size_t len, uint64_t max_gap, uint64_t scale,
+                                 uint64_t *state, int *err) {
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, len, err);
+  uint64_t value = 0;
+  for (size_t i = 0; i < len; i++) {
+    value += (1 + nextRandom(state) % max_gap) * scale;
+    ACT_VEC_PUSH(vec, value, err);
+  }
+  return vec;
+}
+
+/// Computes a set operation by a plain merge: 0 is the intersection, 1 the
+/// union and 2 the difference.
+static size_t referenceSetOp(int op, const uint64_t *a, size_t a_len,
+                             const uint64_t *b, size_t b_len, uint64_t *out) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t count = 0;
+  while (i < a_len || j < b_len) {
+    bool in_a = i < a_len && (j == b_len || a[i] <= b[j]);
+    bool in_b = j < b_len && (i == a_len || b[j] <= a[i]);
+    uint64_t value = in_a ? a[i] : b[j];
+    if ((op == 0 && in_a && in_b) || op == 1 || (op == 2 && in_a && !in_b)) {
+      out[count++] = value;
+    }
+    i += in_a;
+    j += in_b;
+  }
+  return count;
+}
+
+void test_canComputeSetOperations(void) {
+  int err_code = ACT_SORTED_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  // Balanced, skewed and empty sets, dense and sparse
+  const size_t LENS[][2] = {{0, 0},     {0, 10},   {10, 0},    {3, 5},
+                            {7, 9},     {100, 90}, {1000, 1000}, {5000, 40},
+                            {40, 5000}, {1, 1000}, {4099, 4101}};
+  const uint64_t GAPS[] = {1, 2, 4, 50};
+  uint64_t state = 17;
+
+  for (size_t l = 0; l < sizeof(LENS) / sizeof(*LENS); l++) {
+    for (size_t g = 0; g < sizeof(GAPS) / sizeof(*GAPS); g++) {
+      size_t a_len = LENS[l][0];
+      size_t b_len = LENS[l][1];
+      // The gaps are scaled up for the 64-bit sets, to use the high bits
+      ACT_VEC(uint64_t) a = makeSet(a_len, GAPS[g], 1, &state, &vec_err);
+      ACT_VEC(uint64_t) b = makeSet(b_len, GAPS[g], 1, &state, &vec_err);
+      ACT_VEC(uint32_t) a32 = ACT_VEC_WCAP(uint32_t, &GPA, a_len, &vec_err);
+      ACT_VEC(uint32_t) b32 = ACT_VEC_WCAP(uint32_t, &GPA, b_len, &vec_err);
+      for (size_t i = 0; i < a_len; i++) {
+        uint32_t value = (uint32_t)a[i];
+        ACT_VEC_PUSH(a32, value, &vec_err);
+        a[i] <<= 30;
+      }
+      for (size_t i = 0; i < b_len; i++) {
+        uint32_t value = (uint32_t)b[i];
+        ACT_VEC_PUSH(b32, value, &vec_err);
+        b[i] <<= 30;
+      }
+
+      uint64_t *expected = malloc((a_len + b_len + 1) * sizeof(uint64_t));
+      ACT_VEC(uint64_t) dst = ACT_VEC_NEW(uint64_t, &GPA, &vec_err);
+      ACT_VEC(uint32_t) dst32 = ACT_VEC_NEW(uint32_t, &GPA, &vec_err);
+      for (int op = 0; op < 3; op++) {
+        size_t len = referenceSetOp(op, a, a_len, b, b_len, expected);
+        if (op == 0) {
+          dst = act_vectorIntersectU64(dst, a, b, &err_code);
+          dst32 = act_vectorIntersectU32(dst32, a32, b32, &err_code);
+        } else if (op == 1) {
+          dst = act_vectorUnionU64(dst, a, b, &err_code);
+          dst32 = act_vectorUnionU32(dst32, a32, b32, &err_code);
+        } else {
+          dst = act_vectorDifferenceU64(dst, a, b, &err_code);
+          dst32 = act_vectorDifferenceU32(dst32, a32, b32, &err_code);
+        }
+        TEST_CHECK(err_code == ACT_SORTED_ERROR_SUCCESS);
+
+        TEST_CHECK(act_vectorLen(dst, &vec_err) == len);
+        TEST_CHECK(memcmp(dst, expected, len * sizeof(uint64_t)) == 0);
+        TEST_CHECK(act_vectorLen(dst32, &vec_err) == len);
+        bool same = true;
+        for (size_t i = 0; i < len && same; i++) {
+          same = dst32[i] == (uint32_t)(expected[i] >> 30);
+        }
+        TEST_CHECK(same);
+        TEST_MSG("op %d, lengths %zu and %zu, gap %llu", op, a_len, b_len,
+                 (unsigned long long)GAPS[g]);
+      }
+
+      free(expected);
+      act_vectorFree(a, &vec_err);
+      act_vectorFree(b, &vec_err);
+      act_vectorFree(a32, &vec_err);
+      act_vectorFree(b32, &vec_err);
+      act_vectorFree(dst, &vec_err);
+      act_vectorFree(dst32, &vec_err);
+    }
+  }
+
+  // The destination can't be a source, and the element types must match
+  ACT_VEC(uint64_t) set = makeSet(10, 3, 1, &state, &vec_err);
+  ACT_VEC(uint32_t) set32 = ACT_VEC_NEW(uint32_t, &GPA, &vec_err);
+  TEST_CHECK(act_vectorUnionU64(set, set, set, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_SORTED_ERROR_ALIASED_VECTOR);
+  TEST_CHECK(act_vectorUnionU32(set32, set, set, &err_code) == NULL);
+  TEST_CHECK(err_code == ACT_SORTED_ERROR_INVALID_DATA_SIZE);
+  act_vectorFree(set, &vec_err);
+  act_vectorFree(set32, &vec_err);
+  err_code = ACT_SORTED_ERROR_SUCCESS;
+
+  if (err_code != ACT_SORTED_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[SORTED] Can search sorted act_Vector", test_canSearchSortedVector},
+    {"[SORTED] Can merge sorted act_Vector", test_canMergeSortedVectors},
+    {"[SORTED] Can search act_EytzingerIndex", test_canSearchEytzingerIndex},
+    {"[SORTED] Can compute set operations on sorted act_Vector",
+     test_canComputeSetOperations},
+    {NULL, NULL}};
@@ -1,6 +1,7 @@
 #include "act_allocator.h"
 #include "act_string.h"
 #include "act_utils.h"
+#include "act_vector.h"
 #include "acutest.h"
 #include <stdbool.h>
 #include <stdio.h>
@@ -266,6 +267,462 @@ void test_canConcatString(void) {
   }
 }
 
+void test_canJoinStrings(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  ACT_VEC(act_String) strings = ACT_VEC_NEW(act_String, &GPA, &vec_err);
+  const char *words[] = {"a", "bb", "", "ccc"};
+  for (size_t i = 0; i < 4; i++) {
+    act_String word = act_stringFromCstr(&GPA, words[i], &err_code);
+    ACT_VEC_PUSH(strings, word, &vec_err);
+  }
+
+  act_String joined = act_stringJoin(strings, ", ", &err_code);
+  TEST_CHECK(err_code == ACT_STRING_ERROR_SUCCESS);
+  TEST_CHECK(strcmp(act_stringAsCstr(joined), "a, bb, , ccc") == 0);
+  TEST_CHECK(act_stringLen(joined) == 12);
+  TEST_CHECK(act_stringCapacity(joined) == 13);
+  act_stringFree(&joined, &err_code);
+
+  for (size_t i = 0; i < 4; i++) {
+    act_stringFree(&strings[i], &err_code);
+  }
+  act_vectorFree(strings, &vec_err);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canSplitAllString(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+  int vec_err = ACT_VECTOR_ERROR_SUCCESS;
+
+  act_String str = act_stringFromCstr(&GPA, "id,,name,value", &err_code);
+
+  ACT_VEC(act_StringView) tokens = act_stringSplitAll(str, ',', &err_code);
+  TEST_ASSERT(tokens != NULL);
+  TEST_CHECK(act_vectorLen(tokens, &vec_err) == 4);
+  TEST_CHECK(act_vectorCapacity(tokens, &vec_err) == 4);
+  TEST_CHECK(tokens[0].len == 2 && strncmp(tokens[0].data, "id", 2) == 0);
+  TEST_CHECK(tokens[1].len == 0);
+  TEST_CHECK(tokens[2].len == 4 && strncmp(tokens[2].data, "name", 4) == 0);
+  TEST_CHECK(tokens[3].len == 5 && strncmp(tokens[3].data, "value", 5) == 0);
+  act_vectorFree(tokens, &vec_err);
+
+  // Trailing delimiters and empty views yield empty tokens
+  tokens = act_stringViewSplitAll(&GPA, act_stringViewFromCstr("x,"), ',',
+                                  &err_code);
+  TEST_CHECK(act_vectorLen(tokens, &vec_err) == 2);
+  TEST_CHECK(tokens[1].len == 0);
+  act_vectorFree(tokens, &vec_err);
+
+  tokens = act_stringViewSplitAll(&GPA, act_stringViewFromCstr(""), ',',
+                                  &err_code);
+  TEST_CHECK(act_vectorLen(tokens, &vec_err) == 1);
+  TEST_CHECK(tokens[0].len == 0);
+  act_vectorFree(tokens, &vec_err);
+
+  act_stringFree(&str, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS ||
+      vec_err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canShareStringBuffer(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  act_String str = act_stringFromCstr(&GPA, "payload", &err_code);
+  TEST_CHECK(act_stringRefCount(str) == 1);
+
+  // Shared copies point at the same buffer
+  act_String shared = act_stringShare(&str, &err_code);
+  act_String copy = act_stringCopy(&shared, &err_code);
+  TEST_CHECK(act_stringRefCount(str) == 3);
+  TEST_CHECK(act_stringAsCstr(copy) == act_stringAsCstr(str));
+
+  // Mutating a shared string clones it first
+  act_stringPushChar(&copy, '!', &err_code);
+  TEST_CHECK(act_stringAsCstr(copy) != act_stringAsCstr(str));
+  TEST_CHECK(strcmp(act_stringAsCstr(copy), "payload!") == 0);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "payload") == 0);
+  TEST_CHECK(act_stringRefCount(str) == 2);
+  TEST_CHECK(act_stringRefCount(copy) == 1);
+
+  act_stringPopChar(&shared, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(shared), "payloa") == 0);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "payload") == 0);
+  TEST_CHECK(act_stringRefCount(str) == 1);
+
+  // A uniquely referenced string is mutated in place
+  const char *data = act_stringAsCstr(str);
+  act_stringPopChar(&str, &err_code);
+  TEST_CHECK(act_stringAsCstr(str) == data);
+
+  act_stringFree(&str, &err_code);
+  act_stringFree(&shared, &err_code);
+  act_stringFree(&copy, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInsertAndDeleteInString(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  act_String str = act_stringFromCstr(&GPA, "Hello World", &err_code);
+
+  act_stringInsertCstrAtIdx(&str, 5, ",", &err_code);
+  act_stringInsertCharAtIdx(&str, 12, '!', &err_code);
+  act_stringInsertCstrAtIdx(&str, 0, ">> ", &err_code);
+  TEST_CHECK(act_stringLen(str) == 16);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), ">> Hello, World!") == 0);
+
+  act_stringDeleteFromIdx(&str, 0, 3, &err_code);
+  act_stringDeleteFromIdx(&str, 5, 1, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "Hello World!") == 0);
+
+  // Out of bounds edits are rejected
+  act_stringInsertCharAtIdx(&str, 13, '?', &err_code);
+  TEST_CHECK(err_code == ACT_STRING_ERROR_INDEX_OUT_OF_BOUNDS);
+  act_stringDeleteFromIdx(&str, 10, 3, &err_code);
+  TEST_CHECK(err_code == ACT_STRING_ERROR_INDEX_OUT_OF_BOUNDS);
+
+  // Other operations see the edited contents
+  act_stringInsertCstrAtIdx(&str, 6, "big ", &err_code);
+  act_stringPushChar(&str, '!', &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "Hello big World!!") == 0);
+  TEST_CHECK(act_stringPopChar(&str, &err_code) == '!');
+  act_stringDeleteFromIdx(&str, 5, 4, &err_code);
+  TEST_CHECK(act_stringFindFirstIdxOfChar(str, 'W', &err_code) == 6);
+
+  // Compacting closes the gap up front, so later reads never write
+  act_stringInsertCstrAtIdx(&str, 6, "big ", &err_code);
+  act_stringCompact(&str, &err_code);
+  TEST_CHECK(err_code == ACT_STRING_ERROR_SUCCESS);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "Hello big World!") == 0);
+  act_stringDeleteFromIdx(&str, 6, 4, &err_code);
+  act_stringCompact(NULL, &err_code);
+  TEST_CHECK(err_code == ACT_STRING_ERROR_NULL_STRING);
+  err_code = ACT_STRING_ERROR_SUCCESS;
+
+  // Shared buffers are cloned before being edited
+  act_String shared = act_stringShare(&str, &err_code);
+  act_stringDeleteFromIdx(&shared, 0, 6, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(shared), "World!") == 0);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "Hello World!") == 0);
+
+  act_stringFree(&str, &err_code);
+  act_stringFree(&shared, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canEditStringAtCursor(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  const size_t NUM_EDITS = 1000;
+  act_String str = act_stringNew(&GPA, &err_code);
+
+  // Type at a moving cursor, with backspaces, like a text editor would
+  size_t cursor = 0;
+  for (size_t i = 0; i < NUM_EDITS; i++) {
+    act_stringInsertCharAtIdx(&str, cursor++, (char)('a' + (i % 26)),
+                              &err_code);
+    if (i % 10 == 9) {
+      act_stringDeleteFromIdx(&str, --cursor, 1, &err_code);
+    }
+    if (i % 100 == 99) {
+      cursor /= 2;
+    }
+  }
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  // Replay the same edits on a plain buffer
+  char expected[1024] = {0};
+  size_t len = 0;
+  cursor = 0;
+  for (size_t i = 0; i < NUM_EDITS; i++) {
+    memmove(expected + cursor + 1, expected + cursor, len - cursor);
+    expected[cursor++] = (char)('a' + (i % 26));
+    len++;
+    if (i % 10 == 9) {
+      cursor--;
+      memmove(expected + cursor, expected + cursor + 1, len - cursor - 1);
+      len--;
+    }
+    if (i % 100 == 99) {
+      cursor /= 2;
+    }
+  }
+  expected[len] = '\0';
+
+  TEST_CHECK(act_stringLen(str) == len);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), expected) == 0);
+
+  act_stringFree(&str, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canValidateUtf8(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  const char *valid[] = {
+      "",
+      "plain ascii",
+      "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80",
+      "\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80",
+      "\xF0\x90\x80\x80\xF4\x8F\xBF\xBF",
+  };
+  for (size_t i = 0; i < sizeof(valid) / sizeof(*valid); i++) {
+    TEST_CHECK_(act_stringViewValidateUtf8(act_stringViewFromCstr(valid[i]),
+                                           &err_code),
+                "valid[%zu]", i);
+    TEST_CHECK(err_code == ACT_STRING_ERROR_SUCCESS);
+  }
+
+  const char *invalid[] = {
+      "\x80",             // Lone continuation
+      "\xC0\xAF",         // Overlong 2-byte
+      "\xE0\x80\xAF",     // Overlong 3-byte
+      "\xF0\x80\x80\xAF", // Overlong 4-byte
+      "\xED\xA0\x80",     // Surrogate
+      "\xF4\x90\x80\x80", // Above U+10FFFF
+      "\xF5\x80\x80\x80", // Invalid lead
+      "\xFF",             // Invalid byte
+      "\xE2\x82",         // Truncated
+      "\xC3\xA9\xA9",     // Extra continuation
+  };
+
+  // Place each invalid sequence at every offset of a longer string, so that
+  // both the vectorized blocks and the scalar tail see it
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(*invalid); i++) {
+    size_t seq_len = strlen(invalid[i]);
+    for (size_t offset = 0; offset + seq_len <= 64; offset++) {
+      char buf[64];
+      for (size_t j = 0; j < sizeof(buf); j++) {
+        buf[j] = (char)('a' + (j % 26));
+      }
+      memcpy(buf + offset, invalid[i], seq_len);
+
+      act_StringView view = {.data = buf, .len = sizeof(buf)};
+      TEST_CHECK_(!act_stringViewValidateUtf8(view, &err_code),
+                  "invalid[%zu] at %zu", i, offset);
+      TEST_CHECK(err_code == ACT_STRING_ERROR_INVALID_UTF8);
+
+      // Cutting the string just before the sequence makes it valid again
+      view.len = offset;
+      TEST_CHECK(act_stringViewValidateUtf8(view, &err_code));
+    }
+  }
+
+  // Multi-byte sequences straddling the vectorized blocks
+  act_String str = act_stringNew(&GPA, &err_code);
+  for (size_t i = 0; i < 100; i++) {
+    act_stringPushCstr(&str, i % 2 ? "\xF0\x9F\x98\x80" : "\xE2\x82\xAC",
+                       &err_code);
+    act_stringPushChar(&str, 'x', &err_code);
+  }
+  TEST_CHECK(act_stringValidateUtf8(str, &err_code));
+  TEST_CHECK(act_stringCountCodepoints(str) == 200);
+
+  act_stringPopChar(&str, &err_code);
+  act_stringPopChar(&str, &err_code);
+  TEST_CHECK(!act_stringValidateUtf8(str, &err_code));
+  TEST_CHECK(err_code == ACT_STRING_ERROR_INVALID_UTF8);
+
+  act_stringFree(&str, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canIterateStringCodepoints(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  act_String str = act_stringFromCstr(
+      &GPA, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", &err_code);
+  TEST_CHECK(act_stringCountCodepoints(str) == 4);
+
+  const uint32_t expected[] = {0x61, 0xE9, 0x20AC, 0x1F600};
+  size_t count = 0;
+  uint32_t codepoint = 0;
+  act_StringCodepointIter iter = act_stringCodepointIter(str);
+  while (act_stringCodepointIterNext(&iter, &codepoint)) {
+    TEST_ASSERT(count < 4);
+    TEST_CHECK(codepoint == expected[count]);
+    count++;
+  }
+  TEST_CHECK(count == 4);
+
+  // Every maximal invalid prefix becomes one replacement character
+  act_StringView invalid =
+      act_stringViewFromCstr("\xE2\x82x\xF0\x9F\xFFy\x80");
+  const uint32_t replaced[] = {ACT_STRING_REPLACEMENT_CHAR, 'x',
+                               ACT_STRING_REPLACEMENT_CHAR,
+                               ACT_STRING_REPLACEMENT_CHAR, 'y',
+                               ACT_STRING_REPLACEMENT_CHAR};
+  count = 0;
+  iter = act_stringViewCodepointIter(invalid);
+  while (act_stringCodepointIterNext(&iter, &codepoint)) {
+    TEST_ASSERT(count < 6);
+    TEST_CHECK_(codepoint == replaced[count], "codepoint %zu", count);
+    count++;
+  }
+  TEST_CHECK(count == 6);
+
+  act_stringFree(&str, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canConvertStringCase(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  // Long enough to cover both the vectorized blocks and the scalar tail
+  const char *mixed =
+      "Content-Type: Text/HTML; charset=UTF-8 [@`{~] caf\xC3\x89";
+  const char *lower =
+      "content-type: text/html; charset=utf-8 [@`{~] caf\xC3\x89";
+  const char *upper =
+      "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8 [@`{~] CAF\xC3\x89";
+
+  act_String str = act_stringFromCstr(&GPA, mixed, &err_code);
+  act_String shared = act_stringShare(&str, &err_code);
+
+  act_stringToLower(&str, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), lower) == 0);
+  TEST_CHECK(strcmp(act_stringAsCstr(shared), mixed) == 0);
+
+  act_stringToUpper(&str, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), upper) == 0);
+  TEST_CHECK(act_stringLen(str) == strlen(mixed));
+
+  // Views are converted into a caller-provided buffer
+  char buf[64] = {0};
+  act_stringViewToLower(act_stringViewFromCstr(mixed), buf, &err_code);
+  TEST_CHECK(strcmp(buf, lower) == 0);
+  act_stringViewToUpper((act_StringView){.data = buf, .len = strlen(buf)}, buf,
+                        &err_code);
+  TEST_CHECK(strcmp(buf, upper) == 0);
+
+  act_stringFree(&str, &err_code);
+  act_stringFree(&shared, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canCompareStringsIgnoringCase(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  act_String str1 =
+      act_stringFromCstr(&GPA, "X-Forwarded-For-Some-Long-Header", &err_code);
+  act_String str2 =
+      act_stringFromCstr(&GPA, "x-forwarded-for-some-long-HEADER", &err_code);
+  TEST_CHECK(act_stringEqualsIgnoreCase(str1, str2));
+
+  act_stringPushChar(&str2, 's', &err_code);
+  TEST_CHECK(!act_stringEqualsIgnoreCase(str1, str2));
+
+  // Only letters are folded ('@' and '`' differ from 'A' and 'a' by 0x20)
+  act_StringView view = act_stringViewFromCstr("HOST");
+  TEST_CHECK(act_stringViewEqualsIgnoreCase(view,
+                                            act_stringViewFromCstr("host")));
+  TEST_CHECK(!act_stringViewEqualsIgnoreCase(act_stringViewFromCstr("@"),
+                                             act_stringViewFromCstr("`")));
+  TEST_CHECK(!act_stringViewEqualsIgnoreCase(
+      act_stringViewFromCstr("0123456789abcdef@"),
+      act_stringViewFromCstr("0123456789ABCDEF`")));
+  TEST_CHECK(!act_stringViewEqualsIgnoreCase(
+      act_stringViewFromCstr("[0123456789abcdef"),
+      act_stringViewFromCstr("{0123456789ABCDEF")));
+
+  act_stringFree(&str1, &err_code);
+  act_stringFree(&str2, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canCompareStringsLexicographically(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  act_String apple = act_stringFromCstr(&GPA, "apple", &err_code);
+  act_String apples = act_stringFromCstr(&GPA, "apples", &err_code);
+  act_String banana = act_stringFromCstr(&GPA, "banana", &err_code);
+  TEST_CHECK(act_stringLexCompare(apple, apples) < 0);
+  TEST_CHECK(act_stringLexCompare(apples, banana) < 0);
+  TEST_CHECK(act_stringLexCompare(banana, apple) > 0);
+  TEST_CHECK(act_stringLexCompare(apple, apple) == 0);
+
+  // Bytes are unsigned, and embedded null bytes are compared too
+  act_StringView high = {.data = "\xC3\xA9", .len = 2};
+  act_StringView with_null = {.data = "a\0b", .len = 3};
+  TEST_CHECK(act_stringViewLexCompare(act_stringViewFromCstr("z"), high) < 0);
+  TEST_CHECK(act_stringViewLexCompare(act_stringViewFromCstr("a"),
+                                      with_null) < 0);
+  TEST_CHECK(act_stringViewLexCompare(with_null,
+                                      act_stringViewFromCstr("a0")) < 0);
+  TEST_CHECK(act_stringViewLexCompare(act_stringViewFromCstr(""),
+                                      act_stringViewFromCstr("")) == 0);
+
+  act_stringFree(&apple, &err_code);
+  act_stringFree(&apples, &err_code);
+  act_stringFree(&banana, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canHashString(void) {
+  int err_code = ACT_STRING_ERROR_SUCCESS;
+
+  act_String str = act_stringFromCstr(&GPA, "Accept-Encoding", &err_code);
+  act_StringView view = act_stringViewFromCstr("Accept-Encoding");
+
+  uint64_t hash = act_stringHash(&str);
+  TEST_CHECK(hash == act_stringViewHash(view));
+  TEST_CHECK(act_stringHash(&str) == hash);
+
+  // Modifying the string drops the cached hash
+  act_stringToLower(&str, &err_code);
+  TEST_CHECK(act_stringHash(&str) != hash);
+  TEST_CHECK(act_stringHash(&str) ==
+             act_stringViewHash(act_stringViewFromCstr("accept-encoding")));
+
+  act_stringInsertCharAtIdx(&str, 0, 'x', &err_code);
+  act_stringDeleteFromIdx(&str, 0, 1, &err_code);
+  act_stringPushChar(&str, 's', &err_code);
+  act_stringPopChar(&str, &err_code);
+  TEST_CHECK(act_stringHash(&str) ==
+             act_stringViewHash(act_stringViewFromCstr("accept-encoding")));
+
+  act_stringFree(&str, &err_code);
+
+  if (err_code != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
 TEST_LIST = {
     {"[STRING] Can create new act_String", test_canCreateNewString},
     {"[STRING] Can create act_String with capacity",
@@ -282,4 +739,21 @@ TEST_LIST = {
     {"[STRING] Can copy act_String", test_canCopyString},
     {"[STRING] Can concat act_String", test_canConcatString},
     {"[STRING] Can shrink act_String to fit length", test_canShrinkStringToFit},
+    {"[STRING] Can join act_String vector", test_canJoinStrings},
+    {"[STRING] Can split act_String at every delimiter",
+     test_canSplitAllString},
+    {"[STRING] Can share act_String buffer", test_canShareStringBuffer},
+    {"[STRING] Can insert into and delete from act_String",
+     test_canInsertAndDeleteInString},
+    {"[STRING] Can edit act_String at a moving cursor",
+     test_canEditStringAtCursor},
+    {"[STRING] Can validate UTF-8 in act_String", test_canValidateUtf8},
+    {"[STRING] Can iterate over act_String codepoints",
+     test_canIterateStringCodepoints},
+    {"[STRING] Can convert case of act_String", test_canConvertStringCase},
+    {"[STRING] Can compare act_String ignoring case",
+     test_canCompareStringsIgnoringCase},
+    {"[STRING] Can compare act_String lexicographically",
+     test_canCompareStringsLexicographically},
+    {"[STRING] Can hash act_String", test_canHashString},
     {NULL, NULL}};
@@ -0,0 +1,175 @@
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_string_builder.h"
+#include "acutest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// The number of buffers allocated (and not yet freed) by #STRING_ALLOCATOR.
+static size_t live_buffers = 0;
+
+static void *countingAlloc(size_t nelems, size_t elem_size) {
+  live_buffers++;
+  return calloc(nelems, elem_size);
+}
+
+static void *countingResize(void *ptr, size_t nelems, size_t elem_size) {
+  if (ptr == NULL) {
+    live_buffers++;
+  }
+  return realloc(ptr, nelems * elem_size);
+}
+
+static void countingFree(const void *ptr) {
+  if (ptr != NULL) {
+    live_buffers--;
+  }
+  free((void *)ptr);
+}
+
+/// An allocator, distinct from the builder's, that counts its live buffers.
+static const act_Allocator STRING_ALLOCATOR = {
+    .alloc = countingAlloc,
+    .resize = countingResize,
+    .free = countingFree,
+};
+
+void test_canCreateNewStringBuilder(void) {
+  int err_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+  act_StringBuilder builder = act_stringBuilderNew(&GPA, &err_code);
+
+  TEST_CHECK(err_code == ACT_STRING_BUILDER_ERROR_SUCCESS);
+  TEST_CHECK(act_stringBuilderLen(&builder) == 0);
+  TEST_CHECK(act_stringBuilderNumChunks(&builder) == 0);
+
+  act_stringBuilderFree(&builder, &err_code);
+
+  if (err_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canBuildStringFromChunks(void) {
+  int err_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+
+  act_String world = act_stringFromCstr(&GPA, "World", &str_err);
+  act_String owned = act_stringFromCstr(&GPA, "!!", &str_err);
+  act_String owned_share = act_stringShare(&owned, &str_err);
+  act_String foreign = act_stringFromCstr(&STRING_ALLOCATOR, "?", &str_err);
+
+  act_StringBuilder builder = act_stringBuilderNew(&GPA, &err_code);
+  act_stringBuilderPushCstr(&builder, "Hello", &err_code);
+  act_stringBuilderPushChar(&builder, ',', &err_code);
+  act_stringBuilderPushChar(&builder, ' ', &err_code);
+  act_stringBuilderPushString(&builder, &world, &err_code);
+  act_stringBuilderPushOwnedString(&builder, owned, &err_code);
+  act_stringBuilderPushOwnedString(&builder, foreign, &err_code);
+  if (err_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  // Consecutive copied characters are merged into one chunk
+  TEST_CHECK(act_stringBuilderNumChunks(&builder) == 5);
+  TEST_CHECK(act_stringBuilderLen(&builder) == 15);
+
+  act_String str = act_stringBuilderBuild(&builder, &err_code);
+  TEST_CHECK(strcmp(act_stringAsCstr(str), "Hello, World!!?") == 0);
+  TEST_CHECK(act_stringLen(str) == 15);
+  TEST_CHECK(act_stringCapacity(str) == 16);
+
+  act_stringFree(&str, &str_err);
+  act_stringFree(&world, &str_err);
+  act_stringBuilderFree(&builder, &err_code);
+
+  // Owned buffers are freed with the allocator of their string
+  TEST_CHECK(live_buffers == 0);
+
+  // Handing over a shared string leaves the other references intact
+  TEST_CHECK(strcmp(act_stringAsCstr(owned_share), "!!") == 0);
+  act_stringFree(&owned_share, &str_err);
+
+  if (err_code != ACT_STRING_BUILDER_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canBuildLargeStringFromCopies(void) {
+  int err_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+
+  const size_t NUM_PIECES = 5000;
+  act_StringBuilder builder = act_stringBuilderNew(&GPA, &err_code);
+  for (size_t i = 0; i < NUM_PIECES; i++) {
+    char piece[2] = {(char)('a' + (i % 26)), '\0'};
+    act_stringBuilderPushCopy(&builder, act_stringViewFromCstr(piece),
+                              &err_code);
+  }
+  if (err_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  act_String str = act_stringBuilderBuild(&builder, &err_code);
+  TEST_CHECK(act_stringLen(str) == NUM_PIECES);
+  for (size_t i = 0; i < NUM_PIECES; i++) {
+    TEST_CHECK_(act_stringAsCstr(str)[i] == (char)('a' + (i % 26)),
+                "index %zu", i);
+  }
+
+  act_stringFree(&str, &str_err);
+  act_stringBuilderFree(&builder, &err_code);
+
+  if (err_code != ACT_STRING_BUILDER_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canWriteStringBuilderToFd(void) {
+  int err_code = ACT_STRING_BUILDER_ERROR_SUCCESS;
+
+  int fds[2];
+  TEST_ASSERT(pipe(fds) == 0);
+
+  act_StringBuilder builder = act_stringBuilderNew(&GPA, &err_code);
+  for (size_t i = 0; i < 100; i++) {
+    act_stringBuilderPushCstr(&builder, "ab", &err_code);
+  }
+
+  size_t written = act_stringBuilderWriteFd(&builder, fds[1], &err_code);
+  close(fds[1]);
+  TEST_CHECK(err_code == ACT_STRING_BUILDER_ERROR_SUCCESS);
+  TEST_CHECK(written == 200);
+
+  char buf[256] = {0};
+  size_t total = 0;
+  ssize_t n = 0;
+  while ((n = read(fds[0], buf + total, sizeof(buf) - total)) > 0) {
+    total += (size_t)n;
+  }
+  close(fds[0]);
+
+  TEST_CHECK(total == 200);
+  TEST_CHECK(strncmp(buf, "abababab", 8) == 0);
+  TEST_CHECK(strncmp(buf + 192, "abababab", 8) == 0);
+
+  act_stringBuilderFree(&builder, &err_code);
+
+  if (err_code != ACT_STRING_BUILDER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[STRING BUILDER] Can create new act_StringBuilder",
+     test_canCreateNewStringBuilder},
+    {"[STRING BUILDER] Can build act_String from chunks",
+     test_canBuildStringFromChunks},
+    {"[STRING BUILDER] Can build large act_String from copies",
+     test_canBuildLargeStringFromCopies},
+    {"[STRING BUILDER] Can write act_StringBuilder to file descriptor",
+     test_canWriteStringBuilderToFd},
+    {NULL, NULL}};
@@ -0,0 +1,134 @@
+#include "act_allocator.h"
+#include "act_string.h"
+#include "act_string_interner.h"
+#include "acutest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Returns memory filled with garbage, as allocators need not zero it.
+static void *dirtyAlloc(size_t nelems, size_t elem_size) {
+  void *ptr = malloc(nelems * elem_size);
+  if (ptr != NULL) {
+    memset(ptr, 0xA5, nelems * elem_size);
+  }
+  return ptr;
+}
+
+static void *dirtyResize(void *ptr, size_t nelems, size_t elem_size) {
+  return realloc(ptr, nelems * elem_size);
+}
+
+static void dirtyFree(const void *ptr) { free((void *)ptr); }
+
+/// An allocator that does not zero the memory it returns.
+static const act_Allocator DIRTY_ALLOCATOR = {
+    .alloc = dirtyAlloc,
+    .resize = dirtyResize,
+    .free = dirtyFree,
+};
+
+void test_canCreateNewStringInterner(void) {
+  int err_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+  act_StringInterner interner = act_stringInternerNew(&GPA, &err_code);
+
+  TEST_CHECK(err_code == ACT_STRING_INTERNER_ERROR_SUCCESS);
+  TEST_CHECK(act_stringInternerLen(&interner) == 0);
+
+  act_stringInternerFind(&interner, act_stringViewFromCstr("x"), &err_code);
+  TEST_CHECK(err_code == ACT_STRING_INTERNER_ERROR_NOT_FOUND);
+
+  act_stringInternerFree(&interner, &err_code);
+
+  if (err_code != ACT_STRING_INTERNER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInternStrings(void) {
+  int err_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+  int str_err = ACT_STRING_ERROR_SUCCESS;
+  act_StringInterner interner = act_stringInternerNew(&GPA, &err_code);
+
+  act_String host = act_stringFromCstr(&GPA, "host", &str_err);
+
+  act_InternId id1 = act_stringInternerInternCstr(&interner, "host", &err_code);
+  act_InternId id2 = act_stringInternerInternCstr(&interner, "region", &err_code);
+  act_InternId id3 = act_stringInternerInternString(&interner, &host, &err_code);
+  if (err_code != ACT_STRING_INTERNER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+
+  TEST_CHECK(id1 == 0);
+  TEST_CHECK(id2 == 1);
+  TEST_CHECK(id3 == id1);
+  TEST_CHECK(act_stringInternerLen(&interner) == 2);
+
+  // Equal strings share a single canonical copy
+  act_StringView canon1 = act_stringInternerGet(&interner, id1, &err_code);
+  act_StringView canon3 = act_stringInternerGet(&interner, id3, &err_code);
+  TEST_CHECK(canon1.data == canon3.data);
+  TEST_CHECK(canon1.data != act_stringAsCstr(host));
+  TEST_CHECK(strcmp(canon1.data, "host") == 0);
+
+  TEST_CHECK(act_stringInternerFind(&interner, act_stringViewFromCstr("region"),
+                                    &err_code) == id2);
+
+  act_stringInternerGet(&interner, 2, &err_code);
+  TEST_CHECK(err_code == ACT_STRING_INTERNER_ERROR_INVALID_ID);
+
+  act_stringFree(&host, &str_err);
+  act_stringInternerFree(&interner, &err_code);
+
+  if (err_code != ACT_STRING_INTERNER_ERROR_SUCCESS ||
+      str_err != ACT_STRING_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canInternManyStrings(void) {
+  int err_code = ACT_STRING_INTERNER_ERROR_SUCCESS;
+  act_StringInterner interner =
+      act_stringInternerNew(&DIRTY_ALLOCATOR, &err_code);
+
+  // Enough strings to grow the table and fill several arena blocks
+  const size_t NUM_STRINGS = 20000;
+  char buf[32];
+  for (size_t round = 0; round < 2; round++) {
+    for (size_t i = 0; i < NUM_STRINGS; i++) {
+      snprintf(buf, sizeof(buf), "label-%zu", i);
+      act_InternId id =
+          act_stringInternerInternCstr(&interner, buf, &err_code);
+      TEST_ASSERT(id == i);
+    }
+  }
+  TEST_CHECK(act_stringInternerLen(&interner) == NUM_STRINGS);
+
+  // Canonical copies do not move as the pool grows
+  act_StringView first = act_stringInternerGet(&interner, 0, &err_code);
+  TEST_CHECK(strcmp(first.data, "label-0") == 0);
+
+  // Large strings are interned too
+  char large[20000];
+  memset(large, 'z', sizeof(large) - 1);
+  large[sizeof(large) - 1] = '\0';
+  act_InternId large_id =
+      act_stringInternerInternCstr(&interner, large, &err_code);
+  TEST_CHECK(act_stringInternerInternCstr(&interner, large, &err_code) ==
+             large_id);
+  snprintf(buf, sizeof(buf), "label-%d", 12345);
+  TEST_CHECK(act_stringInternerInternCstr(&interner, buf, &err_code) == 12345);
+
+  act_stringInternerFree(&interner, &err_code);
+
+  if (err_code != ACT_STRING_INTERNER_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[STRING INTERNER] Can create new act_StringInterner",
+     test_canCreateNewStringInterner},
+    {"[STRING INTERNER] Can intern act_String", test_canInternStrings},
+    {"[STRING INTERNER] Can intern many strings", test_canInternManyStrings},
+    {NULL, NULL}};
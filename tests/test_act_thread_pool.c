@@ -0,0 +1,213 @@
+#include "act_allocator.h"
+#include "act_thread_pool.h"
+#include "act_vector.h"
+#include "acutest.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// The number of elements in the parallel for tests.
+#define NUM_ELEMENTS 1000000
+
+/// Adds one to a shared counter.
+static void incrementCounter(void *arg) {
+  atomic_fetch_add((_Atomic size_t *)arg, 1);
+}
+
+/// Adds one to every element of a piece, and counts the pieces.
+static void incrementElements(void *elements, size_t start, size_t len,
+                              void *arg) {
+  uint64_t *values = elements;
+  for (size_t i = 0; i < len; i++) {
+    values[i] += start + i + 1;
+  }
+  atomic_fetch_add((_Atomic size_t *)arg, 1);
+}
+
+/// The argument of the nested loops.
+typedef struct NestedLoop {
+  act_ThreadPool *pool;
+  act_Vector *inner;
+  _Atomic size_t sum;
+} NestedLoop;
+
+/// Adds up the elements of a piece.
+static void sumElements(void *elements, size_t start, size_t len, void *arg) {
+  (void)start;
+  uint64_t *values = elements;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < len; i++) {
+    sum += values[i];
+  }
+  atomic_fetch_add(&((NestedLoop *)arg)->sum, sum);
+}
+
+/// Runs a loop over the inner vector for every element of a piece.
+static void runInnerLoops(void *elements, size_t start, size_t len,
+                          void *arg) {
+  (void)elements;
+  (void)start;
+  NestedLoop *nested = arg;
+  for (size_t i = 0; i < len; i++) {
+    int err_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+    act_parallelFor(nested->pool, nested->inner, 16, sumElements, nested,
+                    &err_code);
+  }
+}
+
+/// Runs a loop over the inner vector from a submitted task.
+static void runInnerLoop(void *arg) {
+  runInnerLoops(NULL, 0, 1, arg);
+}
+
+void test_canCreateNewThreadPool(void) {
+  int err_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 3, false, &err_code);
+
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+  TEST_CHECK(act_threadPoolNumThreads(&pool) == 3);
+
+  act_threadPoolFree(&pool, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+  TEST_CHECK(act_threadPoolNumThreads(&pool) == 0);
+
+  pool = act_threadPoolNew(&GPA, 0, true, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+  TEST_CHECK(act_threadPoolNumThreads(&pool) > 0);
+  act_threadPoolFree(&pool, &err_code);
+
+  act_threadPoolNew(NULL, 1, false, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_NULL_ALLOCATOR);
+  act_threadPoolSubmit(&pool, incrementCounter, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_NULL_POOL);
+  act_threadPoolFree(NULL, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_NULL_POOL);
+
+  err_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_THREAD_POOL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canSubmitToThreadPool(void) {
+  int err_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, true, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+
+  _Atomic size_t counter = 0;
+  for (size_t round = 0; round < 10; round++) {
+    for (size_t i = 0; i < 1000; i++) {
+      act_threadPoolSubmit(&pool, incrementCounter, &counter, &err_code);
+    }
+    act_threadPoolWait(&pool, &err_code);
+    TEST_CHECK(atomic_load(&counter) == (round + 1) * 1000);
+  }
+
+  act_threadPoolSubmit(&pool, NULL, NULL, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_NULL_FUNCTION);
+
+  // Freeing waits for the tasks still queued
+  for (size_t i = 0; i < 1000; i++) {
+    act_threadPoolSubmit(&pool, incrementCounter, &counter, &err_code);
+  }
+  act_threadPoolFree(&pool, &err_code);
+  TEST_CHECK(atomic_load(&counter) == 11000);
+
+  if (err_code != ACT_THREAD_POOL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canRunParallelFor(void) {
+  int err_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, false, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+
+  ACT_VEC(uint64_t) vec = ACT_VEC_WCAP(uint64_t, &GPA, NUM_ELEMENTS, &err_code);
+  for (size_t i = 0; i < NUM_ELEMENTS; i++) {
+    ACT_VEC_PUSH(vec, 0, &err_code);
+  }
+
+  // Every element is in exactly one piece, of at most the grain
+  size_t grains[] = {1000, 0, NUM_ELEMENTS};
+  for (size_t g = 0; g < 3; g++) {
+    _Atomic size_t pieces = 0;
+    act_parallelFor(&pool, vec, grains[g], incrementElements, &pieces,
+                    &err_code);
+    TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+    TEST_CHECK(grains[g] == 0 || atomic_load(&pieces) >=
+                                     (NUM_ELEMENTS + grains[g] - 1) /
+                                         grains[g]);
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < NUM_ELEMENTS; i++) {
+    ok &= vec[i] == 3 * (i + 1);
+  }
+  TEST_CHECK(ok);
+
+  act_Vector *empty = ACT_VEC_NEW(uint64_t, &GPA, &err_code);
+  _Atomic size_t pieces = 0;
+  act_parallelFor(&pool, empty, 0, incrementElements, &pieces, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+  TEST_CHECK(atomic_load(&pieces) == 0);
+
+  act_parallelFor(&pool, NULL, 0, incrementElements, &pieces, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_NULL_VECTOR);
+  act_parallelFor(&pool, vec, 0, NULL, &pieces, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_NULL_FUNCTION);
+
+  act_vectorFree(empty, &err_code);
+  act_vectorFree(vec, &err_code);
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_THREAD_POOL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+void test_canNestParallelFor(void) {
+  int err_code = ACT_THREAD_POOL_ERROR_SUCCESS;
+  act_ThreadPool pool = act_threadPoolNew(&GPA, 4, false, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+
+  ACT_VEC(uint64_t) outer = ACT_VEC_WCAP(uint64_t, &GPA, 100, &err_code);
+  ACT_VEC(uint64_t) inner = ACT_VEC_WCAP(uint64_t, &GPA, 1000, &err_code);
+  for (uint64_t i = 0; i < 1000; i++) {
+    if (i < 100) {
+      ACT_VEC_PUSH(outer, i, &err_code);
+    }
+    ACT_VEC_PUSH(inner, i, &err_code);
+  }
+
+  // Loops inside of loops, and inside of submitted tasks, help rather than
+  // block the workers
+  NestedLoop nested = {.pool = &pool, .inner = inner};
+  atomic_init(&nested.sum, 0);
+  act_parallelFor(&pool, outer, 1, runInnerLoops, &nested, &err_code);
+  TEST_CHECK(err_code == ACT_THREAD_POOL_ERROR_SUCCESS);
+  TEST_CHECK(atomic_load(&nested.sum) == 100 * 499500);
+
+  atomic_store(&nested.sum, 0);
+  for (size_t i = 0; i < 50; i++) {
+    act_threadPoolSubmit(&pool, runInnerLoop, &nested, &err_code);
+  }
+  act_threadPoolWait(&pool, &err_code);
+  TEST_CHECK(atomic_load(&nested.sum) == 50 * 499500);
+
+  act_vectorFree(inner, &err_code);
+  act_vectorFree(outer, &err_code);
+  act_threadPoolFree(&pool, &err_code);
+  if (err_code != ACT_THREAD_POOL_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
+TEST_LIST = {
+    {"[THREAD POOL] Can create new act_ThreadPool",
+     test_canCreateNewThreadPool},
+    {"[THREAD POOL] Can submit tasks to act_ThreadPool",
+     test_canSubmitToThreadPool},
+    {"[THREAD POOL] Can run act_parallelFor", test_canRunParallelFor},
+    {"[THREAD POOL] Can nest act_parallelFor", test_canNestParallelFor},
+    {NULL, NULL}};
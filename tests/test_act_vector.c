@@ -125,6 +125,32 @@ void test_canShrinkToFitVector(void) {
   }
 }
 
+void test_canReserveVector(void) {
+  int err = ACT_VECTOR_ERROR_SUCCESS;
+
+  ACT_VEC(int) vec = ACT_VEC_NEW(int, &GPA, &err);
+  for (int i = 0; i < 3; i++) {
+    ACT_VEC_PUSH(vec, i, &err);
+  }
+
+  vec = act_vectorReserve(vec, 100, &err);
+  TEST_ASSERT(vec != NULL);
+  TEST_CHECK(act_vectorCapacity(vec, &err) >= 103);
+  TEST_CHECK(act_vectorLen(vec, &err) == 3);
+  TEST_CHECK(vec[0] == 0 && vec[1] == 1 && vec[2] == 2);
+
+  // Reserving space that's already there doesn't move the vector
+  const int *same = vec;
+  vec = act_vectorReserve(vec, 50, &err);
+  TEST_CHECK(vec == same);
+
+  act_vectorFree(vec, &err);
+
+  if (err != ACT_VECTOR_ERROR_SUCCESS) {
+    exit(EXIT_FAILURE);
+  }
+}
+
 TEST_LIST = {
     {"[VECTOR] Can create new act_vector_t", test_canCreateNewVector},
     {"[VECTOR] Can create new act_vector_t with capacity",
@@ -134,4 +160,5 @@ TEST_LIST = {
     {"[VECTOR] Can resize act_vector_t", test_canResizeVector},
     {"[VECTOR] Can shrink act_vector_t to fit length",
      test_canShrinkToFitVector},
+    {"[VECTOR] Can reserve space in act_vector_t", test_canReserveVector},
     {NULL, NULL}};